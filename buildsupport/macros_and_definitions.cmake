@@ -694,6 +694,11 @@ CommandLine configuration in those files instead.
     add_definitions(-DNS3_ASSERT_ENABLE)
   endif()
 
+  # Make reference counts thread-safe for MultithreadedSimulatorImpl
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+  endif()
+
   # Enable examples as tests suites
   if(${NS3_EXAMPLES})
     set(NS3_ENABLE_EXAMPLES "1")
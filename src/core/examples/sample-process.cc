@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <vector>
+#include "ns3/command-line.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/process.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+/**
+ * \file
+ * \ingroup core-examples
+ * \ingroup process
+ * Example program which runs many on-off traffic generators written as
+ * processes.
+ */
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * An on-off traffic generator, which sends bursts of packets separated
+ * by random off times.  Sending is only counted here.
+ */
+class OnOffProcess : public Process
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] off The random variable of the off times, in seconds.
+   */
+  OnOffProcess (Ptr<RandomVariableStream> off)
+    : m_off (off),
+      m_sent (0)
+  {}
+
+  /**
+   * Get the number of packets sent.
+   *
+   * \returns The number of packets.
+   */
+  uint64_t GetSent (void) const
+  {
+    return m_sent;
+  }
+
+private:
+  virtual void DoRun (void)
+  {
+    NS_PROCESS_BEGIN ();
+    for (;;)
+      {
+        for (m_burst = 0; m_burst < 10; ++m_burst)
+          {
+            m_sent++;
+            NS_PROCESS_SLEEP (MilliSeconds (1));
+          }
+        NS_PROCESS_SLEEP (Seconds (m_off->GetValue ()));
+      }
+    NS_PROCESS_END ();
+  }
+
+  Ptr<RandomVariableStream> m_off;  //!< The off times.
+  uint32_t m_burst;                 //!< The packets sent in this burst.
+  uint64_t m_sent;                  //!< The packets sent.
+};
+
+} // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t processes = 10000;
+  double stop = 10;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("processes", "number of traffic generators", processes);
+  cmd.AddValue ("stop", "simulation time, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  Ptr<ExponentialRandomVariable> off = CreateObject<ExponentialRandomVariable> ();
+  off->SetAttribute ("Mean", DoubleValue (0.1));
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+
+  std::vector<Ptr<OnOffProcess> > generators;
+  for (uint32_t i = 0; i < processes; ++i)
+    {
+      Ptr<OnOffProcess> generator = Create<OnOffProcess> (off);
+      generator->Start (Seconds (start->GetValue (0, 1)));
+      generators.push_back (generator);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (stop));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  uint64_t sent = 0;
+  for (std::vector<Ptr<OnOffProcess> >::const_iterator i = generators.begin ();
+       i != generators.end (); ++i)
+    {
+      sent += (*i)->GetSent ();
+    }
+  std::cout << processes << " processes sent " << sent << " packets in "
+            << ms << " ms" << std::endl;
+
+  generators.clear ();
+  Simulator::Destroy ();
+  return 0;
+}
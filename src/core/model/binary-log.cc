@@ -0,0 +1,970 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-log.h"
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+#include "fatal-error.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>    // getenv
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLog and the binary log record implementations.
+ */
+
+// No NS_LOG_COMPONENT_DEFINE: the binary log records the log statements.
+
+namespace ns3 {
+
+std::atomic<bool> BinaryLog::m_open (false);
+
+namespace {
+
+/** The first bytes of a binary log. */
+const char g_magic[8] = "NS3BLOG";
+/** The version of the binary log format. */
+const uint32_t g_version = 1;
+/** The size above which the buffer of a thread is handed to the writer. */
+const std::size_t g_blockSize = 64 * 1024;
+/** The number of blocks the writer may fall behind before the loggers wait. */
+const std::size_t g_maxBlocks = 64;
+
+/** The entries of a binary log. */
+enum Entry
+{
+  SITE = 'S',   //!< A BinaryLogSite definition.
+  RECORD = 'R'  //!< A BinaryLogRecord.
+};
+
+/**
+ * \ingroup logging
+ * The file and the writer thread of the binary log.
+ */
+class BinaryLogWriter
+{
+public:
+  BinaryLogWriter ();
+  ~BinaryLogWriter ();
+  /**
+   * Open the file and start the writer thread.
+   * \param [in] filename The file.
+   */
+  void Open (const std::string &filename);
+  /** Stop the writer thread and close the file. */
+  void Close (void);
+  /** Wait until the writer thread has written the queued blocks. */
+  void Flush (void);
+  /**
+   * Queue a block, and replace it with an empty one.
+   * \param [in,out] block The block.
+   */
+  void Submit (std::vector<char> &block);
+  /**
+   * Define a statement.
+   * \param [in] kind The kind of statement.
+   * \param [in] component The name of the log component.
+   * \param [in] function The name of the function.
+   * \returns The id of the statement.
+   */
+  uint32_t Define (uint8_t kind, const std::string &component, const std::string &function);
+
+private:
+  /** The writer thread. */
+  void Run (void);
+  /** Write the file header. */
+  void WriteHeader (void);
+
+  std::mutex m_mutex;                    //!< Protects the members below.
+  std::condition_variable m_ready;       //!< Signals the queued blocks.
+  std::condition_variable m_written;     //!< Signals the written blocks.
+  std::deque<std::vector<char> > m_queue;  //!< The blocks to write.
+  std::vector<std::vector<char> > m_free;  //!< The written blocks, for reuse.
+  std::vector<char> m_sites;             //!< The statement definitions.
+  uint32_t m_nSites;                     //!< The number of statements.
+  std::FILE *m_file;                     //!< The file, or 0 if closed.
+  std::thread m_thread;                  //!< The writer thread.
+  bool m_stop;                           //!< Whether the writer must stop.
+  bool m_writing;                        //!< Whether the writer is writing a block.
+  bool m_header;                         //!< Whether the header is written.
+};
+
+/**
+ * \ingroup logging
+ * Get the binary log writer.
+ * \returns The writer.
+ */
+BinaryLogWriter &
+GetWriter (void)
+{
+  static BinaryLogWriter writer;
+  return writer;
+}
+
+/**
+ * \ingroup logging
+ * The buffers of a logging thread.
+ */
+struct ThreadBuffer
+{
+  ThreadBuffer ()
+  {
+    data.reserve (g_blockSize + g_blockSize / 4);
+  }
+  ~ThreadBuffer ()
+  {
+    if (!data.empty ())
+      {
+        GetWriter ().Submit (data);
+      }
+  }
+  std::vector<char> data;    //!< The records not handed to the writer yet.
+  std::ostringstream text;   //!< The stream to format text.
+};
+
+/**
+ * \ingroup logging
+ * Get the buffers of the calling thread.
+ * \returns The buffers.
+ */
+ThreadBuffer &
+GetThreadBuffer (void)
+{
+  static thread_local ThreadBuffer buffer;
+  return buffer;
+}
+
+/**
+ * \ingroup logging
+ * Append a value to a vector of bytes.
+ * \param [in,out] bytes The vector.
+ * \param [in] v The value.
+ */
+template <typename T>
+void
+Put (std::vector<char> &bytes, T v)
+{
+  const char *p = reinterpret_cast<const char *> (&v);
+  bytes.insert (bytes.end (), p, p + sizeof (v));
+}
+
+/**
+ * \ingroup logging
+ * Append a string, preceded by its length, to a vector of bytes.
+ * \param [in,out] bytes The vector.
+ * \param [in] s The string.
+ */
+void
+PutString (std::vector<char> &bytes, const std::string &s)
+{
+  Put<uint32_t> (bytes, s.size ());
+  bytes.insert (bytes.end (), s.begin (), s.end ());
+}
+
+/**
+ * \ingroup logging
+ * Read a value from a stream.
+ * \param [in] is The stream.
+ * \param [out] v The value.
+ * \returns \c true if the value was read.
+ */
+template <typename T>
+bool
+Get (std::istream &is, T &v)
+{
+  return static_cast<bool> (is.read (reinterpret_cast<char *> (&v), sizeof (v)));
+}
+
+/**
+ * \ingroup logging
+ * Read a string, preceded by its length, from a stream.
+ * \param [in] is The stream.
+ * \param [out] s The string.
+ * \returns \c true if the string was read.
+ */
+bool
+GetString (std::istream &is, std::string &s)
+{
+  uint32_t size;
+  if (!Get (is, size))
+    {
+      return false;
+    }
+  s.resize (size);
+  return size == 0 || static_cast<bool> (is.read (&s[0], size));
+}
+
+/**
+ * \ingroup logging
+ * Open the binary log named by the \c NS_BINARY_LOG environment variable.
+ */
+class EnvironmentBinaryLog
+{
+public:
+  EnvironmentBinaryLog ()
+  {
+    const char *filename = std::getenv ("NS_BINARY_LOG");
+    if (filename != 0 && *filename != 0)
+      {
+        BinaryLog::Open (filename);
+      }
+  }
+};
+
+/** Open the binary log named by the environment before \c main(). */
+EnvironmentBinaryLog g_environmentBinaryLog;
+
+} // unnamed namespace
+
+BinaryLogWriter::BinaryLogWriter ()
+  : m_nSites (0),
+    m_file (0),
+    m_stop (false),
+    m_writing (false),
+    m_header (false)
+{}
+
+BinaryLogWriter::~BinaryLogWriter ()
+{
+  BinaryLog::Close ();
+}
+
+void
+BinaryLogWriter::Open (const std::string &filename)
+{
+  std::FILE *file = std::fopen (filename.c_str (), "wb");
+  if (file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open binary log " << filename);
+    }
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_file = file;
+  m_header = false;
+  if (!m_sites.empty ())
+    {
+      // the statements defined while an earlier binary log was open
+      m_queue.push_back (m_sites);
+    }
+  m_thread = std::thread (&BinaryLogWriter::Run, this);
+}
+
+void
+BinaryLogWriter::Close (void)
+{
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_stop = true;
+    m_ready.notify_one ();
+  }
+  m_thread.join ();
+  if (!m_header)
+    {
+      WriteHeader ();
+    }
+  std::unique_lock<std::mutex> lock (m_mutex);
+  std::fclose (m_file);
+  m_file = 0;
+  m_stop = false;
+}
+
+void
+BinaryLogWriter::Flush (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (!m_queue.empty () || m_writing)
+    {
+      m_written.wait (lock);
+    }
+  // the writer is idle until it gets the lock back
+  std::fflush (m_file);
+}
+
+void
+BinaryLogWriter::Submit (std::vector<char> &block)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (m_file == 0)
+    {
+      block.clear ();
+      return;
+    }
+  while (m_queue.size () >= g_maxBlocks)
+    {
+      m_written.wait (lock);
+    }
+  m_queue.push_back (std::vector<char> ());
+  m_queue.back ().swap (block);
+  if (!m_free.empty ())
+    {
+      block.swap (m_free.back ());
+      m_free.pop_back ();
+    }
+  else
+    {
+      block.reserve (g_blockSize + g_blockSize / 4);
+    }
+  m_ready.notify_one ();
+}
+
+uint32_t
+BinaryLogWriter::Define (uint8_t kind, const std::string &component, const std::string &function)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  uint32_t id = ++m_nSites;
+  std::vector<char> site;
+  Put<uint8_t> (site, SITE);
+  Put (site, id);
+  Put (site, kind);
+  PutString (site, component);
+  PutString (site, function);
+  m_sites.insert (m_sites.end (), site.begin (), site.end ());
+  if (m_file != 0)
+    {
+      // queued before any record which uses the id
+      m_queue.push_back (site);
+      m_ready.notify_one ();
+    }
+  return id;
+}
+
+void
+BinaryLogWriter::WriteHeader (void)
+{
+  // Written with the first block rather than by Open, in case the
+  // program sets the Time resolution after the file is opened.
+  std::vector<char> header (g_magic, g_magic + sizeof (g_magic));
+  Put (header, g_version);
+  Put<uint32_t> (header, Time::GetResolution ());
+  std::fwrite (&header[0], 1, header.size (), m_file);
+  m_header = true;
+}
+
+void
+BinaryLogWriter::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (m_queue.empty () && !m_stop)
+        {
+          m_ready.wait (lock);
+        }
+      if (m_queue.empty ())
+        {
+          break;
+        }
+      std::vector<char> block;
+      block.swap (m_queue.front ());
+      m_queue.pop_front ();
+      m_writing = true;
+      lock.unlock ();
+
+      if (!m_header)
+        {
+          WriteHeader ();
+        }
+      std::fwrite (&block[0], 1, block.size (), m_file);
+      block.clear ();
+
+      lock.lock ();
+      m_writing = false;
+      if (m_free.size () < g_maxBlocks)
+        {
+          m_free.push_back (std::vector<char> ());
+          m_free.back ().swap (block);
+        }
+      m_written.notify_all ();
+    }
+}
+
+void
+BinaryLog::Open (const std::string &filename)
+{
+  Close ();
+  GetWriter ().Open (filename);
+  m_open.store (true);
+}
+
+void
+BinaryLog::Close (void)
+{
+  if (!m_open.exchange (false))
+    {
+      return;
+    }
+  ThreadBuffer &buffer = GetThreadBuffer ();
+  BinaryLogWriter &writer = GetWriter ();
+  if (!buffer.data.empty ())
+    {
+      writer.Submit (buffer.data);
+    }
+  writer.Close ();
+}
+
+void
+BinaryLog::Flush (void)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  ThreadBuffer &buffer = GetThreadBuffer ();
+  BinaryLogWriter &writer = GetWriter ();
+  if (!buffer.data.empty ())
+    {
+      writer.Submit (buffer.data);
+    }
+  writer.Flush ();
+}
+
+bool
+BinaryLog::Decode (std::istream &is, std::ostream &os)
+{
+  char magic[sizeof (g_magic)];
+  uint32_t version;
+  uint32_t resolution;
+  if (!is.read (magic, sizeof (magic))
+      || std::memcmp (magic, g_magic, sizeof (magic)) != 0
+      || !Get (is, version) || version != g_version
+      || !Get (is, resolution) || resolution >= Time::LAST)
+    {
+      return false;
+    }
+  if (resolution != Time::GetResolution ())
+    {
+      Time::SetResolution (static_cast<Time::Unit> (resolution));
+    }
+
+  struct Site
+  {
+    uint8_t kind;
+    std::string component;
+    std::string function;
+  };
+  std::vector<Site> sites (1);
+  while (true)
+    {
+      int entry = is.get ();
+      if (entry == std::istream::traits_type::eof ())
+        {
+          return true;
+        }
+      if (entry == SITE)
+        {
+          uint32_t id;
+          Site site;
+          if (!Get (is, id) || !Get (is, site.kind)
+              || !GetString (is, site.component) || !GetString (is, site.function))
+            {
+              return false;
+            }
+          if (id >= sites.size ())
+            {
+              sites.resize (id + 1);
+            }
+          sites[id] = site;
+          continue;
+        }
+      uint32_t id;
+      uint32_t flags;
+      if (entry != RECORD || !Get (is, id) || !Get (is, flags)
+          || id == 0 || id >= sites.size ())
+        {
+          return false;
+        }
+      const Site &site = sites[id];
+      if (flags & LOG_PREFIX_TIME)
+        {
+          int64_t ticks;
+          if (!Get (is, ticks))
+            {
+              return false;
+            }
+          // the format of DefaultTimePrinter
+          std::ios_base::fmtflags ff = os.flags ();
+          std::streamsize oldPrecision = os.precision ();
+          os << std::fixed;
+          switch (Time::GetResolution ())
+            {
+              // *NS_CHECK_STYLE_OFF*
+            case Time::US :    os << std::setprecision (6);   break;
+            case Time::NS :    os << std::setprecision (9);   break;
+            case Time::PS :    os << std::setprecision (12);  break;
+            case Time::FS :    os << std::setprecision (15);  break;
+              // *NS_CHECK_STYLE_ON*
+
+            default:
+              os << std::setprecision (5);
+            }
+          os << TimeStep (ticks).As (Time::S);
+          os << std::setprecision (oldPrecision);
+          os.flags (ff);
+          os << " ";
+        }
+      if (flags & LOG_PREFIX_NODE)
+        {
+          uint32_t context;
+          if (!Get (is, context))
+            {
+              return false;
+            }
+          if (context == Simulator::NO_CONTEXT)
+            {
+              os << "-1 ";
+            }
+          else
+            {
+              os << context << " ";
+            }
+        }
+      const char *separator = "";
+      if (site.kind == BinaryLogSite::FUNCTION)
+        {
+          os << site.component << ":" << site.function << "(";
+        }
+      else
+        {
+          if (flags & LOG_PREFIX_FUNC)
+            {
+              os << site.component << ":" << site.function << "(): ";
+            }
+          if (flags & LOG_PREFIX_LEVEL)
+            {
+              enum LogLevel level = static_cast<enum LogLevel> (flags & ~LOG_PREFIX_ALL);
+              os << "[" << LogComponent::GetLevelLabel (level) << "] ";
+            }
+        }
+      while (true)
+        {
+          int tag = is.get ();
+          if (tag == BinaryLogRecord::END)
+            {
+              break;
+            }
+          os << separator;
+          bool ok = true;
+          switch (tag)
+            {
+            case BinaryLogRecord::INT:
+              {
+                int64_t v;
+                ok = Get (is, v);
+                os << v;
+                break;
+              }
+            case BinaryLogRecord::UINT:
+              {
+                uint64_t v;
+                ok = Get (is, v);
+                os << v;
+                break;
+              }
+            case BinaryLogRecord::DOUBLE:
+              {
+                double v;
+                ok = Get (is, v);
+                os << v;
+                break;
+              }
+            case BinaryLogRecord::CHAR:
+              {
+                char v;
+                ok = Get (is, v);
+                os << v;
+                break;
+              }
+            case BinaryLogRecord::POINTER:
+              {
+                uint64_t v;
+                ok = Get (is, v);
+                os << reinterpret_cast<const void *> (static_cast<uintptr_t> (v));
+                break;
+              }
+            case BinaryLogRecord::STRING:
+              {
+                std::string v;
+                ok = GetString (is, v);
+                os << v;
+                break;
+              }
+            case BinaryLogRecord::QUOTED:
+              {
+                std::string v;
+                ok = GetString (is, v);
+                os << "\"" << v << "\"";
+                break;
+              }
+            case BinaryLogRecord::TIME:
+              {
+                int64_t v;
+                ok = Get (is, v);
+                os << TimeStep (v);
+                break;
+              }
+            default:
+              ok = false;
+            }
+          if (!ok)
+            {
+              return false;
+            }
+          if (site.kind == BinaryLogSite::FUNCTION)
+            {
+              separator = ", ";
+            }
+        }
+      if (site.kind == BinaryLogSite::FUNCTION)
+        {
+          os << ")";
+        }
+      os << "\n";
+    }
+}
+
+uint32_t
+BinaryLogSite::Register (const LogComponent &log, const char *function)
+{
+  static std::mutex mutex;
+  std::unique_lock<std::mutex> lock (mutex);
+  uint32_t id = m_id.load (std::memory_order_relaxed);
+  if (id == 0)
+    {
+      id = GetWriter ().Define (m_kind, log.Name (), function);
+      m_id.store (id, std::memory_order_release);
+    }
+  return id;
+}
+
+BinaryLogRecord::BinaryLogRecord (BinaryLogSite &site, const LogComponent &log,
+                                  const char *function, uint32_t level)
+  : m_buffer (&GetThreadBuffer ().data),
+    m_text (0)
+{
+  uint32_t id = site.GetId (log, function);
+  uint32_t flags = level & ~LOG_PREFIX_ALL;
+  if (log.IsEnabled (LOG_PREFIX_FUNC))
+    {
+      flags |= LOG_PREFIX_FUNC;
+    }
+  if (log.IsEnabled (LOG_PREFIX_LEVEL))
+    {
+      flags |= LOG_PREFIX_LEVEL;
+    }
+  // like NS_LOG_APPEND_TIME_PREFIX and NS_LOG_APPEND_NODE_PREFIX,
+  // which print nothing until the simulator is created
+  bool time = log.IsEnabled (LOG_PREFIX_TIME) && LogGetTimePrinter () != 0;
+  bool node = log.IsEnabled (LOG_PREFIX_NODE) && LogGetNodePrinter () != 0;
+  flags |= time ? LOG_PREFIX_TIME : 0;
+  flags |= node ? LOG_PREFIX_NODE : 0;
+
+  Put<uint8_t> (*m_buffer, RECORD);
+  Put (*m_buffer, id);
+  Put (*m_buffer, flags);
+  if (time)
+    {
+      Put (*m_buffer, Simulator::Now ().GetTimeStep ());
+    }
+  if (node)
+    {
+      Put (*m_buffer, Simulator::GetContext ());
+    }
+}
+
+BinaryLogRecord::~BinaryLogRecord ()
+{
+  if (m_text != 0)
+    {
+      FlushText ();
+    }
+  m_buffer->push_back (END);
+  if (m_buffer->size () >= g_blockSize)
+    {
+      GetWriter ().Submit (*m_buffer);
+    }
+}
+
+template <typename S, typename T>
+BinaryLogRecord &
+BinaryLogRecord::Append (enum Tag tag, T v)
+{
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else
+    {
+      S s = static_cast<S> (v);
+      Add (tag, &s, sizeof (s));
+    }
+  return *this;
+}
+
+void
+BinaryLogRecord::AddString (enum Tag tag, const char *data, std::size_t size)
+{
+  uint32_t length = size;
+  std::size_t offset = m_buffer->size ();
+  m_buffer->resize (offset + 1 + sizeof (length) + size);
+  char *p = &(*m_buffer)[offset];
+  *p = static_cast<char> (tag);
+  std::memcpy (p + 1, &length, sizeof (length));
+  std::memcpy (p + 1 + sizeof (length), data, size);
+}
+
+std::ostream &
+BinaryLogRecord::GetText (void)
+{
+  if (m_text == 0)
+    {
+      m_text = &GetThreadBuffer ().text;
+      m_text->str ("");
+      m_text->clear ();
+      m_text->flags (std::ios_base::skipws | std::ios_base::dec);
+      m_text->precision (6);
+      m_text->width (0);
+      m_text->fill (' ');
+    }
+  return *m_text;
+}
+
+void
+BinaryLogRecord::FlushText (void)
+{
+  std::string text = m_text->str ();
+  m_text = 0;
+  AddString (STRING, text.data (), text.size ());
+}
+
+BinaryLogRecord &
+BinaryLogRecord::operator<< (bool v)
+{
+  return Append<uint64_t> (UINT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (char v)
+{
+  return Append<char> (CHAR, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (signed char v)
+{
+  return Append<char> (CHAR, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned char v)
+{
+  return Append<char> (CHAR, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (short v)
+{
+  return Append<int64_t> (INT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned short v)
+{
+  return Append<uint64_t> (UINT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (int v)
+{
+  return Append<int64_t> (INT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned int v)
+{
+  return Append<uint64_t> (UINT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (long v)
+{
+  return Append<int64_t> (INT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned long v)
+{
+  return Append<uint64_t> (UINT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (long long v)
+{
+  return Append<int64_t> (INT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned long long v)
+{
+  return Append<uint64_t> (UINT, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (float v)
+{
+  return Append<double> (DOUBLE, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (double v)
+{
+  return Append<double> (DOUBLE, v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const void *v)
+{
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else
+    {
+      uint64_t address = reinterpret_cast<uintptr_t> (v);
+      Add (POINTER, &address, sizeof (address));
+    }
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const char *v)
+{
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else if (v != 0)
+    {
+      AddString (STRING, v, std::strlen (v));
+    }
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (char *v)
+{
+  return *this << static_cast<const char *> (v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const signed char *v)
+{
+  return *this << reinterpret_cast<const char *> (v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (signed char *v)
+{
+  return *this << reinterpret_cast<const char *> (v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const unsigned char *v)
+{
+  return *this << reinterpret_cast<const char *> (v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (unsigned char *v)
+{
+  return *this << reinterpret_cast<const char *> (v);
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const std::string &v)
+{
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else
+    {
+      AddString (STRING, v.data (), v.size ());
+    }
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const Time &v)
+{
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else
+    {
+      int64_t ticks = v.GetTimeStep ();
+      Add (TIME, &ticks, sizeof (ticks));
+    }
+  return *this;
+}
+
+BinaryLogRecord &
+BinaryLogRecord::operator<< (std::ostream & (*manip)(std::ostream &))
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (std::ios_base & (*manip)(std::ios_base &))
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::setw (0)) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::setprecision (0)) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::setfill ('0')) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::setbase (10)) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::setiosflags (std::ios_base::fixed)) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+BinaryLogRecord &
+BinaryLogRecord::operator<< (decltype (std::resetiosflags (std::ios_base::fixed)) manip)
+{
+  GetText () << manip;
+  return *this;
+}
+
+void
+BinaryLogRecord::AddQuoted (const std::string &v)
+{
+  if (m_text != 0)
+    {
+      *m_text << "\"" << v << "\"";
+    }
+  else
+    {
+      AddString (QUOTED, v.data (), v.size ());
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,485 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_BINARY_LOG_H
+#define NS3_BINARY_LOG_H
+
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLog and the binary log record declarations.
+ */
+
+namespace ns3 {
+
+class LogComponent;
+class Time;
+template <typename T>
+class Ptr;
+template <typename U>
+U * PeekPointer (const Ptr<U> &p);
+
+/**
+ * \ingroup logging
+ * Whether BinaryLogRecord stores a type raw, through its own output
+ * operator, rather than formatting it as text.
+ */
+template <typename T>
+struct BinaryLogStoresRaw : std::false_type
+{};
+/** A std::string is stored raw. */
+template <>
+struct BinaryLogStoresRaw<std::string> : std::true_type
+{};
+/** A Time is stored raw. */
+template <>
+struct BinaryLogStoresRaw<Time> : std::true_type
+{};
+/** A Ptr is stored as its pointer. */
+template <typename T>
+struct BinaryLogStoresRaw<Ptr<T> > : std::true_type
+{};
+
+/**
+ * \ingroup logging
+ *
+ * \brief Record the NS_LOG statements in a binary file.
+ *
+ * By default the NS_LOG macros format each message through
+ * \c std::clog, synchronously, which dominates the run time of a
+ * simulation as soon as one busy component is enabled.  While a binary
+ * log is open, the enabled NS_LOG, NS_LOG_FUNCTION and
+ * NS_LOG_FUNCTION_NOARGS statements instead append a record to a
+ * buffer owned by the logging thread: the id of the statement, the
+ * level and the prefixes, the simulation time and context, and the
+ * arguments, with the integers, floating point numbers, pointers,
+ * Time and strings stored raw.  Full buffers are handed to a writer
+ * thread which appends them to the file, so the simulation never
+ * waits on the disk unless the writer falls behind by more than a few
+ * megabytes.
+ *
+ * The file is turned back into the text NS_LOG would have printed with
+ * Decode(), or with the \c print-binary-log program:
+ *
+ * \code
+ *   $ NS_LOG="WifiPhy=level_debug|prefix_all" NS_BINARY_LOG=run.log ./my-sim
+ *   $ ./build/utils/print-binary-log run.log
+ * \endcode
+ *
+ * A program can also call Open() and Close() itself, while no
+ * simulation is running.  The \c NS_BINARY_LOG environment variable
+ * opens the file before \c main() and the file is closed at exit.
+ * The writer thread does not survive a \c fork(), so the binary log
+ * must be closed before Checkpoint::Fork().
+ *
+ * The decoded text differs from the \c std::clog output in a few ways:
+ * - the time prefix is always printed by the DefaultTimePrinter and
+ *   the node prefix by the DefaultNodePrinter;
+ * - the NS_LOG_APPEND_CONTEXT prefixes are not recorded;
+ * - the records of each thread are in order, but those of different
+ *   threads are only ordered up to a buffer, so the output of a
+ *   MultithreadedSimulatorImpl run interleaves blocks of records;
+ * - the stream state of \c std::clog does not carry over from one
+ *   message to the next.
+ *
+ * The file uses the byte order of the machine which wrote it.
+ */
+class BinaryLog
+{
+public:
+  /**
+   * Open a binary log, and start recording the enabled NS_LOG
+   * statements in it.  An open binary log is closed first.
+   *
+   * \param [in] filename The file to write.
+   */
+  static void Open (const std::string &filename);
+  /**
+   * Write the buffered records of the calling thread, wait for the
+   * writer thread and close the file.  The NS_LOG statements print to
+   * \c std::clog again.
+   */
+  static void Close (void);
+  /**
+   * Write the buffered records of the calling thread and wait until
+   * the writer thread has written them to the file.  The buffers of
+   * the other threads are written when they are full, or when their
+   * thread exits.
+   */
+  static void Flush (void);
+  /**
+   * Check whether a binary log is open.
+   * \returns \c true if the NS_LOG statements are recorded in a binary log.
+   */
+  static bool IsOpen (void);
+  /**
+   * Print the records of a binary log, as NS_LOG would have printed them.
+   *
+   * \param [in] is The binary log.
+   * \param [out] os The stream to print on.
+   * \returns \c false if \p is is not a binary log, or is truncated.
+   */
+  static bool Decode (std::istream &is, std::ostream &os);
+
+private:
+  friend class BinaryLogRecord;
+  friend class BinaryLogSite;
+
+  /** Whether a binary log is open. */
+  static std::atomic<bool> m_open;
+};
+
+/**
+ * \ingroup logging
+ *
+ * The static id of an NS_LOG statement in a binary log.
+ *
+ * Each statement defines one, which is assigned an id, and whose
+ * component and function names are written to the binary log, the
+ * first time the statement is recorded.  The constructor is a
+ * \c constexpr so that the sites are initialized statically.
+ */
+class BinaryLogSite
+{
+public:
+  /** The kind of statement. */
+  enum Kind
+  {
+    MESSAGE = 0,  //!< An NS_LOG message.
+    FUNCTION = 1  //!< An NS_LOG_FUNCTION or NS_LOG_FUNCTION_NOARGS.
+  };
+  /**
+   * Constructor.
+   * \param [in] kind The kind of statement.
+   */
+  constexpr BinaryLogSite (enum Kind kind)
+    : m_id (0),
+      m_kind (kind)
+  {}
+  /**
+   * Get the id of this statement, assigning it on first use.
+   * \param [in] log The log component of the statement.
+   * \param [in] function The function of the statement.
+   * \returns The id of the statement.
+   */
+  uint32_t GetId (const LogComponent &log, const char *function)
+  {
+    uint32_t id = m_id.load (std::memory_order_acquire);
+    return id != 0 ? id : Register (log, function);
+  }
+
+private:
+  /**
+   * Assign the id and write the names to the binary log.
+   * \param [in] log The log component of the statement.
+   * \param [in] function The function of the statement.
+   * \returns The id of the statement.
+   */
+  uint32_t Register (const LogComponent &log, const char *function);
+
+  std::atomic<uint32_t> m_id; //!< The id, or 0 if not assigned yet.
+  enum Kind m_kind;           //!< The kind of statement.
+};
+
+/**
+ * \ingroup logging
+ *
+ * One record of a binary log, which the NS_LOG macros stream the
+ * message into.
+ *
+ * The record is appended to the buffer of the calling thread as the
+ * arguments are streamed, and terminated by the destructor.  Once a
+ * stream manipulator such as \c std::setw or \c std::hex has been
+ * streamed, the rest of the message is formatted as text, so that the
+ * manipulator applies.
+ */
+class BinaryLogRecord
+{
+public:
+  /**
+   * Start a record.
+   * \param [in] site The statement.
+   * \param [in] log The log component of the statement.
+   * \param [in] function The function of the statement.
+   * \param [in] level The LogLevel of the message.
+   */
+  BinaryLogRecord (BinaryLogSite &site, const LogComponent &log,
+                   const char *function, uint32_t level);
+  /** Terminate the record. */
+  ~BinaryLogRecord ();
+
+  /**
+   * \name Record an argument.
+   * \param [in] v The argument.
+   * \returns This record.
+   * @{
+   */
+  BinaryLogRecord & operator<< (bool v);
+  BinaryLogRecord & operator<< (char v);
+  BinaryLogRecord & operator<< (signed char v);
+  BinaryLogRecord & operator<< (unsigned char v);
+  BinaryLogRecord & operator<< (short v);
+  BinaryLogRecord & operator<< (unsigned short v);
+  BinaryLogRecord & operator<< (int v);
+  BinaryLogRecord & operator<< (unsigned int v);
+  BinaryLogRecord & operator<< (long v);
+  BinaryLogRecord & operator<< (unsigned long v);
+  BinaryLogRecord & operator<< (long long v);
+  BinaryLogRecord & operator<< (unsigned long long v);
+  BinaryLogRecord & operator<< (float v);
+  BinaryLogRecord & operator<< (double v);
+  BinaryLogRecord & operator<< (const void *v);
+  BinaryLogRecord & operator<< (const char *v);
+  BinaryLogRecord & operator<< (char *v);
+  BinaryLogRecord & operator<< (const signed char *v);
+  BinaryLogRecord & operator<< (signed char *v);
+  BinaryLogRecord & operator<< (const unsigned char *v);
+  BinaryLogRecord & operator<< (unsigned char *v);
+  BinaryLogRecord & operator<< (const std::string &v);
+  BinaryLogRecord & operator<< (const Time &v);
+  template <typename T>
+  typename std::enable_if<!std::is_function<T>::value && !std::is_volatile<T>::value,
+                          BinaryLogRecord &>::type
+  operator<< (T *v);
+  template <typename T>
+  BinaryLogRecord & operator<< (const Ptr<T> &v);
+  template <typename T>
+  typename std::enable_if<!BinaryLogStoresRaw<typename std::decay<T>::type>::value,
+                          BinaryLogRecord &>::type
+  operator<< (T &&v);
+  /**@}*/
+
+  /**
+   * \name Apply a stream manipulator to the rest of the message.
+   * \param [in] manip The manipulator.
+   * \returns This record.
+   * @{
+   */
+  BinaryLogRecord & operator<< (std::ostream & (*manip)(std::ostream &));
+  BinaryLogRecord & operator<< (std::ios_base & (*manip)(std::ios_base &));
+  BinaryLogRecord & operator<< (decltype (std::setw (0)) manip);
+  BinaryLogRecord & operator<< (decltype (std::setprecision (0)) manip);
+  BinaryLogRecord & operator<< (decltype (std::setfill ('0')) manip);
+  BinaryLogRecord & operator<< (decltype (std::setbase (10)) manip);
+  BinaryLogRecord & operator<< (decltype (std::setiosflags (std::ios_base::fixed)) manip);
+  BinaryLogRecord & operator<< (decltype (std::resetiosflags (std::ios_base::fixed)) manip);
+  /**@}*/
+
+  /**
+   * Record a string function parameter, which is printed quoted.
+   * \param [in] v The parameter.
+   */
+  void AddQuoted (const std::string &v);
+
+private:
+  /** The argument tags. */
+  enum Tag
+  {
+    END = 0,        //!< The end of the record.
+    INT = 'i',      //!< An \c int64_t.
+    UINT = 'u',     //!< A \c uint64_t.
+    DOUBLE = 'd',   //!< A \c double.
+    CHAR = 'c',     //!< A \c char.
+    POINTER = 'p',  //!< A \c uint64_t address.
+    STRING = 's',   //!< A \c uint32_t length, and the characters.
+    QUOTED = 'q',   //!< A STRING printed quoted.
+    TIME = 't'      //!< A Time, as an \c int64_t number of time steps.
+  };
+  friend class BinaryLog;
+
+  /**
+   * Append a tagged value.
+   * \param [in] tag The tag.
+   * \param [in] data The value.
+   * \param [in] size The size of the value.
+   */
+  void Add (enum Tag tag, const void *data, std::size_t size)
+  {
+    std::size_t offset = m_buffer->size ();
+    m_buffer->resize (offset + 1 + size);
+    (*m_buffer)[offset] = static_cast<char> (tag);
+    std::memcpy (&(*m_buffer)[offset + 1], data, size);
+  }
+  /**
+   * Append an argument, or format it if in text mode.
+   * \tparam S The type the argument is stored as.
+   * \tparam T \deduced The type of the argument.
+   * \param [in] tag The tag.
+   * \param [in] v The argument.
+   * \returns This record.
+   */
+  template <typename S, typename T>
+  BinaryLogRecord & Append (enum Tag tag, T v);
+  /**
+   * Append a tagged string.
+   * \param [in] tag The tag, STRING or QUOTED.
+   * \param [in] data The characters.
+   * \param [in] size The number of characters.
+   */
+  void AddString (enum Tag tag, const char *data, std::size_t size);
+  /**
+   * Append the pending text, and leave the text mode.
+   */
+  void FlushText (void);
+  /**
+   * Get the stream used to format text, and enter the text mode.
+   * \returns The stream.
+   */
+  std::ostream & GetText (void);
+
+  std::vector<char> *m_buffer;  //!< The buffer of the calling thread.
+  std::ostringstream *m_text;   //!< The text stream, if in text mode.
+};
+
+/**
+ * \ingroup logging
+ *
+ * Record NS_LOG_FUNCTION parameters in a BinaryLogRecord, with the
+ * same conventions as ParameterLogger.
+ */
+class BinaryParameterLogger
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] record The record of the statement.
+   */
+  BinaryParameterLogger (BinaryLogRecord &record)
+    : m_record (record)
+  {}
+  /**
+   * Record a parameter.
+   * \param [in] param The parameter.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  template <typename T>
+  BinaryParameterLogger & operator<< (const T &param)
+  {
+    m_record << param;
+    return *this;
+  }
+  /**
+   * Record each element of a vector.
+   * \param [in] vector The parameters.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  template <typename T>
+  BinaryParameterLogger & operator<< (const std::vector<T> &vector)
+  {
+    for (auto i : vector)
+      {
+        *this << i;
+      }
+    return *this;
+  }
+  /**
+   * Record a string, which is printed quoted.
+   * \param [in] param The parameter.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  BinaryParameterLogger & operator<< (const std::string &param)
+  {
+    m_record.AddQuoted (param);
+    return *this;
+  }
+  /**
+   * Record a C-string, which is printed quoted.
+   * \param [in] param The parameter.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  BinaryParameterLogger & operator<< (const char *param)
+  {
+    m_record.AddQuoted (param);
+    return *this;
+  }
+  /**
+   * Record an int8_t, which is printed as a number.
+   * \param [in] param The parameter.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  BinaryParameterLogger & operator<< (int8_t param)
+  {
+    m_record << static_cast<int16_t> (param);
+    return *this;
+  }
+  /**
+   * Record a uint8_t, which is printed as a number.
+   * \param [in] param The parameter.
+   * \returns This BinaryParameterLogger, so it's chainable.
+   */
+  BinaryParameterLogger & operator<< (uint8_t param)
+  {
+    m_record << static_cast<uint16_t> (param);
+    return *this;
+  }
+
+private:
+  BinaryLogRecord &m_record;  //!< The record of the statement.
+};
+
+inline bool
+BinaryLog::IsOpen (void)
+{
+  return m_open.load (std::memory_order_relaxed);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_function<T>::value && !std::is_volatile<T>::value,
+                        BinaryLogRecord &>::type
+BinaryLogRecord::operator<< (T *v)
+{
+  return *this << static_cast<const void *> (v);
+}
+
+template <typename T>
+BinaryLogRecord &
+BinaryLogRecord::operator<< (const Ptr<T> &v)
+{
+  return *this << static_cast<const void *> (PeekPointer (v));
+}
+
+template <typename T>
+typename std::enable_if<!BinaryLogStoresRaw<typename std::decay<T>::type>::value,
+                        BinaryLogRecord &>::type
+BinaryLogRecord::operator<< (T &&v)
+{
+  // Taken by forwarding reference, as some output operators take their
+  // argument by non-const reference, like the text logging does.
+  if (m_text != 0)
+    {
+      *m_text << v;
+    }
+  else
+    {
+      GetText () << v;
+      FlushText ();
+    }
+  return *this;
+}
+
+} // namespace ns3
+
+#endif /* NS3_BINARY_LOG_H */
@@ -0,0 +1,404 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "abort.h"
+#include "log.h"
+#include "binary-log.h"
+#include "config.h"
+#include "object-ptr-container.h"
+#include "pointer.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulation-instance.h"
+#include "simulator.h"
+#include "string.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#ifndef __WIN32__
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+namespace {
+
+/** The variant of this process. */
+uint32_t g_variant = 0;
+
+#ifndef __WIN32__
+/** The child variants of this process. */
+std::vector<pid_t> g_children;
+#endif
+
+/** Flush the output buffers, before they are copied or dropped. */
+void
+FlushOutput (void)
+{
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+}
+
+/** Protects the fork callbacks. */
+std::mutex g_forkCallbacksMutex;
+/** The functions which stop the background threads before a fork. */
+std::vector<Callback<void> > g_forkCallbacks;
+
+/** The first bytes of a checkpoint file. */
+const char MAGIC[8] = {'n', 's', '3', 'c', 'k', 'p', 't', '1'};
+
+/** An attribute found in the configuration namespace. */
+struct AttributeEntry
+{
+  Ptr<Object> object;   //!< The object.
+  std::string name;     //!< The name of the attribute.
+  std::string value;    //!< The serialized value of the attribute.
+};
+
+/** The attributes of the configuration namespace, by path. */
+typedef std::map<std::string, AttributeEntry> AttributeMap;
+
+/**
+ * Gather the attributes which can be set of an object, and of the
+ * objects it refers to, like the AttributeIterator of ConfigStore.
+ *
+ * \param [in] path The path of the object.
+ * \param [in] object The object.
+ * \param [in,out] visited The objects already gathered.
+ * \param [in,out] attributes The attributes, by path.
+ */
+void
+GatherAttributes (std::string path, Ptr<Object> object,
+                  std::set<Object *> &visited, AttributeMap &attributes)
+{
+  if (!visited.insert (PeekPointer (object)).second)
+    {
+      return;
+    }
+  for (TypeId tid = object->GetInstanceTypeId (); tid.HasParent (); tid = tid.GetParent ())
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); ++i)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              PointerValue ptr;
+              object->GetAttribute (info.name, ptr);
+              Ptr<Object> item = ptr.Get<Object> ();
+              if (item != 0)
+                {
+                  GatherAttributes (path + "/" + info.name, item, visited, attributes);
+                }
+              continue;
+            }
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              ObjectPtrContainerValue container;
+              object->GetAttribute (info.name, container);
+              for (ObjectPtrContainerValue::Iterator j = container.Begin (); j != container.End (); ++j)
+                {
+                  if (j->second != 0)
+                    {
+                      std::ostringstream oss;
+                      oss << path << "/" << info.name << "/" << j->first;
+                      GatherAttributes (oss.str (), j->second, visited, attributes);
+                    }
+                }
+              continue;
+            }
+          if ((info.flags & TypeId::ATTR_SET) && info.accessor->HasSetter ())
+            {
+              StringValue value;
+              object->GetAttribute (info.name, value);
+              AttributeEntry &entry = attributes[path + "/" + info.name];
+              entry.object = object;
+              entry.name = info.name;
+              entry.value = value.Get ();
+            }
+        }
+    }
+  Object::AggregateIterator i = object->GetAggregateIterator ();
+  while (i.HasNext ())
+    {
+      Ptr<Object> aggregate = const_cast<Object *> (PeekPointer (i.Next ()));
+      GatherAttributes (path + "/$" + aggregate->GetInstanceTypeId ().GetName (),
+                        aggregate, visited, attributes);
+    }
+}
+
+/**
+ * Gather the attributes of the configuration namespace.
+ * \returns The attributes, by path.
+ */
+AttributeMap
+GatherAttributes (void)
+{
+  AttributeMap attributes;
+  std::set<Object *> visited;
+  for (std::size_t i = 0; i < Config::GetRootNamespaceObjectN (); ++i)
+    {
+      GatherAttributes ("", Config::GetRootNamespaceObject (i), visited, attributes);
+    }
+  return attributes;
+}
+
+/**
+ * Write a value to a binary stream.
+ * \param [in] os The stream.
+ * \param [in] v The value.
+ */
+template <typename T>
+void
+Put (std::ostream &os, T v)
+{
+  os.write (reinterpret_cast<const char *> (&v), sizeof (v));
+}
+
+/**
+ * Write a string, preceded by its length, to a binary stream.
+ * \param [in] os The stream.
+ * \param [in] s The string.
+ */
+void
+PutString (std::ostream &os, const std::string &s)
+{
+  Put<uint32_t> (os, s.size ());
+  os.write (s.data (), s.size ());
+}
+
+/**
+ * Read a value from a binary stream.
+ * \param [in] is The stream.
+ * \param [out] v The value.
+ * \returns \c true if the value was read.
+ */
+template <typename T>
+bool
+Get (std::istream &is, T &v)
+{
+  return static_cast<bool> (is.read (reinterpret_cast<char *> (&v), sizeof (v)));
+}
+
+/**
+ * Read a string, preceded by its length, from a binary stream.
+ * \param [in] is The stream.
+ * \param [out] s The string.
+ * \returns \c true if the string was read.
+ */
+bool
+GetString (std::istream &is, std::string &s)
+{
+  uint32_t size;
+  if (!Get (is, size))
+    {
+      return false;
+    }
+  s.resize (size);
+  return size == 0 || static_cast<bool> (is.read (&s[0], size));
+}
+
+} // unnamed namespace
+
+uint32_t
+Checkpoint::Fork (uint32_t variants)
+{
+  NS_LOG_FUNCTION (variants);
+  NS_ABORT_MSG_IF (variants == 0, "Checkpoint::Fork(): no variant");
+#ifdef __WIN32__
+  NS_FATAL_ERROR ("Checkpoint::Fork() is not supported on Windows");
+#else
+  NS_ABORT_MSG_IF (SimulationInstance::GetCurrent () != SimulationInstance::GetDefault (),
+                   "Checkpoint::Fork() cannot be called from an Ensemble replication");
+  NS_ABORT_MSG_IF (BinaryLog::IsOpen (),
+                   "Checkpoint::Fork(): close the binary log first, the variants would write to the same file");
+  {
+    std::lock_guard<std::mutex> lock (g_forkCallbacksMutex);
+    for (std::vector<Callback<void> >::const_iterator i = g_forkCallbacks.begin ();
+         i != g_forkCallbacks.end (); ++i)
+      {
+        (*i)();
+      }
+  }
+  FlushOutput ();
+  for (uint32_t i = 1; i < variants; ++i)
+    {
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "Checkpoint::Fork(): " << std::strerror (errno));
+      if (pid == 0)
+        {
+          g_children.clear ();
+          g_variant = i;
+          return g_variant;
+        }
+      NS_LOG_INFO ("variant " << i << " is process " << pid);
+      g_children.push_back (pid);
+    }
+  g_variant = 0;
+#endif
+  return g_variant;
+}
+
+uint32_t
+Checkpoint::GetVariant (void)
+{
+  return g_variant;
+}
+
+uint32_t
+Checkpoint::Wait (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t failed = 0;
+#ifndef __WIN32__
+  for (std::vector<pid_t>::const_iterator i = g_children.begin (); i != g_children.end (); ++i)
+    {
+      int status;
+      pid_t pid;
+      do
+        {
+          pid = waitpid (*i, &status, 0);
+        }
+      while (pid < 0 && errno == EINTR);
+      if (pid < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_INFO ("process " << *i << " failed");
+          failed++;
+        }
+    }
+  g_children.clear ();
+#endif
+  return failed;
+}
+
+void
+Checkpoint::Exit (int status)
+{
+  NS_LOG_FUNCTION (status);
+  FlushOutput ();
+  std::_Exit (status);
+}
+
+void
+Checkpoint::AddForkCallback (Callback<void> callback)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::lock_guard<std::mutex> lock (g_forkCallbacksMutex);
+  g_forkCallbacks.push_back (callback);
+}
+
+void
+Checkpoint::Save (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream os (filename.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (os, "Checkpoint::Save(): could not open " << filename);
+  os.write (MAGIC, sizeof (MAGIC));
+  Put<int64_t> (os, Simulator::Now ().GetTimeStep ());
+  Put<uint32_t> (os, RngSeedManager::GetSeed ());
+  Put<uint64_t> (os, RngSeedManager::GetRun ());
+
+  AttributeMap attributes = GatherAttributes ();
+  Put<uint64_t> (os, attributes.size ());
+  for (AttributeMap::const_iterator i = attributes.begin (); i != attributes.end (); ++i)
+    {
+      PutString (os, i->first);
+      PutString (os, i->second.value);
+    }
+  RandomVariableStream::SaveStreams (os);
+  NS_ABORT_MSG_UNLESS (os, "Checkpoint::Save(): could not write " << filename);
+  NS_LOG_INFO ("saved " << attributes.size () << " attributes at " << Simulator::Now ());
+}
+
+bool
+Checkpoint::Restore (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  char magic[sizeof (MAGIC)];
+  int64_t now;
+  uint32_t seed;
+  uint64_t run;
+  uint64_t n;
+  if (!is.read (magic, sizeof (magic))
+      || std::memcmp (magic, MAGIC, sizeof (MAGIC)) != 0
+      || !Get (is, now) || !Get (is, seed) || !Get (is, run) || !Get (is, n))
+    {
+      NS_LOG_WARN ("Checkpoint::Restore(): " << filename << " is not a checkpoint");
+      return false;
+    }
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+
+  AttributeMap attributes = GatherAttributes ();
+  uint32_t set = 0;
+  for (uint64_t k = 0; k < n; ++k)
+    {
+      std::string path;
+      std::string value;
+      if (!GetString (is, path) || !GetString (is, value))
+        {
+          return false;
+        }
+      AttributeMap::const_iterator i = attributes.find (path);
+      if (i == attributes.end () || i->second.value == value)
+        {
+          continue;
+        }
+      if (i->second.object->SetAttributeFailSafe (i->second.name, StringValue (value)))
+        {
+          set++;
+        }
+      else
+        {
+          NS_LOG_WARN ("Checkpoint::Restore(): could not set " << path << " to " << value);
+        }
+    }
+  if (RandomVariableStream::RestoreStreams (is) < 0)
+    {
+      return false;
+    }
+  NS_LOG_INFO ("set " << set << " attributes saved at " << TimeStep (now));
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "callback.h"
+#include <stdint.h>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Run several variants of a simulation from one warmed-up state.
+ *
+ * The pending events of a simulation are arbitrary C++ callbacks bound
+ * to live objects, so the simulation state cannot be written to a file
+ * and read back.  Instead, Fork() takes a copy-on-write snapshot of the
+ * whole process with \c fork(): every variant starts with the same
+ * pending events, objects, attribute values, random number stream
+ * positions and packets, and the memory is only duplicated as the
+ * variants diverge.
+ *
+ * The variants run concurrently, one process each:
+ *
+ * \code
+ *   // build the topology
+ *   Simulator::Stop (Seconds (3600));
+ *   Simulator::Run ();                       // the warm-up phase
+ *   uint32_t variant = Checkpoint::Fork (4);
+ *   Config::Set ("/NodeList/0/...", ...);    // depends on variant
+ *   Simulator::Stop (Seconds (600));
+ *   Simulator::Run ();
+ *   // write the results, to files named after variant
+ *   Simulator::Destroy ();
+ *   if (variant != 0)
+ *     {
+ *       Checkpoint::Exit (0);
+ *     }
+ *   return Checkpoint::Wait () == 0 ? 0 : 1;
+ * \endcode
+ *
+ * Fork() must be called between two calls to Simulator::Run, from the
+ * main thread of the program rather than from an Ensemble replication.
+ * Since the random number streams are copied, all the variants draw
+ * the same random numbers unless they reconfigure their random
+ * variables.  Fork() is not available on Windows.
+ *
+ * A child process only has the thread which called Fork().  Fork()
+ * first calls the functions registered with AddForkCallback(), which
+ * flush the output of the background threads, such as the writer of
+ * AsyncFileWriter, and stop them; they start again in each variant
+ * when they are next needed.  The binary log must be closed before
+ * Fork(), which aborts otherwise.  The files opened before Fork(), such
+ * as the trace files, are shared by the variants: they write at the
+ * same file offset, so their output is interleaved.  Open the trace
+ * files of a variant after Fork(), under names which depend on the
+ * variant.
+ *
+ * Save() and Restore() keep the part of the state which can be written
+ * to a file: the values of the attributes of the objects reachable from
+ * the configuration namespace (as ConfigStore does), and the positions
+ * of the random number streams.  The pending events and the private
+ * state of the models (routing tables, sockets, queued packets) cannot
+ * be written, so Restore() is meant for a program which builds the
+ * same topology again, to continue with the attribute values and the
+ * random numbers of the saved simulation.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * Fork the process into several variants.
+   *
+   * The calling process is variant 0, and each of the other variants
+   * is a child process.  Standard output is flushed first so that
+   * buffered output is not duplicated.
+   *
+   * \param [in] variants The number of variants, including this one.
+   * \returns The index of the variant, in [0, \pname{variants}).
+   */
+  static uint32_t Fork (uint32_t variants);
+  /**
+   * Get the index of the variant of this process.
+   * \returns The value returned by the last call to Fork(), or 0.
+   */
+  static uint32_t GetVariant (void);
+  /**
+   * Wait for the end of the child variants of this process.
+   * \returns The number of variants which exited with a non-zero status
+   *          or because of a signal.
+   */
+  static uint32_t Wait (void);
+  /**
+   * End a child variant, without returning to the caller.
+   *
+   * Standard output is flushed, but the static objects of the process
+   * are not destroyed: they belong to the process which called Fork().
+   *
+   * \param [in] status The exit status reported to Wait().
+   */
+  static void Exit (int status);
+  /**
+   * Register a function which Fork() calls before forking, to flush the
+   * output of a background thread and stop it.
+   *
+   * \param [in] callback The function.
+   */
+  static void AddForkCallback (Callback<void> callback);
+
+  /**
+   * Write the attribute values and the random number stream positions
+   * of the current simulation to a binary file.
+   *
+   * \param [in] filename The name of the file.
+   */
+  static void Save (std::string filename);
+  /**
+   * Read a file written by Save() and apply it to the current simulation.
+   *
+   * The attributes found at the same path and whose value differs are
+   * set, then the random variables with the same stream indices
+   * continue from the saved positions.  The seed and run number are
+   * set as well.  The attributes and streams which no longer exist are
+   * skipped.
+   *
+   * \param [in] filename The name of the file.
+   * \returns \c true if the file could be read.
+   */
+  static bool Restore (std::string filename);
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
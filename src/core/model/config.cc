@@ -18,7 +18,7 @@
  * Authors: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "config.h"
-#include "singleton.h"
+#include "simulation-instance.h"
 #include "object.h"
 #include "global-value.h"
 #include "object-ptr-container.h"
@@ -26,6 +26,8 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -182,6 +184,8 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into a list of index ranges.
  */
 class ArrayMatcher
 {
@@ -199,8 +203,27 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Test if every index matches the Config Path.
+   *
+   * \returns \c true if the specification contains \c "*".
+   */
+  bool MatchesAll (void) const;
+  /**
+   * Get the indices which match the Config Path.
+   *
+   * \param [in] n The number of indices to consider.
+   * \returns The matching indices smaller than \pname{n}, in increasing order.
+   */
+  std::vector<std::size_t> GetIndices (std::size_t n) const;
 
 private:
+  /**
+   * Parse a Config path specification, or one of its alternatives.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -209,80 +232,115 @@ private:
    * \returns \c true if the string could be converted.
    */
   bool StringToUint32 (std::string str, uint32_t *value) const;
+
+  /** A range of matching indices. */
+  struct Range
+  {
+    uint32_t min;  //!< The first matching index.
+    uint32_t max;  //!< The last matching index.
+  };
+
   /** The Config path element. */
   std::string m_element;
+  /** Whether every index matches. */
+  bool m_all;
+  /** The matching indices. */
+  std::vector<Range> m_ranges;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      Parse (element.substr (0, tmp - 0));
+      Parse (element.substr (tmp + 1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
-      uint32_t min;
-      uint32_t max;
-      if (StringToUint32 (lowerBound, &min)
-          && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
-        }
-      else
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
+      Range range;
+      if (StringToUint32 (lowerBound, &range.min)
+          && StringToUint32 (upperBound, &range.max)
+          && range.min <= range.max)
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          m_ranges.push_back (range);
         }
+      return;
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  Range range;
+  if (StringToUint32 (element, &range.min))
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+      range.max = range.min;
+      m_ranges.push_back (range);
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
+    {
+      NS_LOG_DEBUG ("Array " << i << " matches *");
       return true;
     }
+  for (std::vector<Range>::const_iterator j = m_ranges.begin (); j != m_ranges.end (); ++j)
+    {
+      if (i >= j->min && i <= j->max)
+        {
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
   return false;
 }
+bool
+ArrayMatcher::MatchesAll (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_all;
+}
+std::vector<std::size_t>
+ArrayMatcher::GetIndices (std::size_t n) const
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (!m_all);
+  std::vector<std::size_t> indices;
+  for (std::vector<Range>::const_iterator j = m_ranges.begin (); j != m_ranges.end (); ++j)
+    {
+      for (std::size_t i = j->min; i <= j->max && i < n; ++i)
+        {
+          indices.push_back (i);
+        }
+    }
+  std::sort (indices.begin (), indices.end ());
+  indices.erase (std::unique (indices.begin (), indices.end ()), indices.end ());
+  return indices;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -297,6 +355,13 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is split once into its elements, and the attributes
+ * which may match an element are looked up once per object type, so
+ * that the cost of a resolution grows with the number of objects
+ * visited rather than with the length of the path.  When an element
+ * selects indices of an object container, such as \c /NodeList/3, only
+ * these indices are visited.
  */
 class Resolver
 {
@@ -320,23 +385,58 @@ public:
   void Resolve (Ptr<Object> root);
 
 private:
+  /** An attribute which can be followed on a Config path. */
+  struct PathAttribute
+  {
+    /** The attribute name. */
+    std::string name;
+    /** The accessor used by ObjectBase::GetAttribute for this name. */
+    Ptr<const AttributeAccessor> accessor;
+    /** Whether the attribute can be read. */
+    bool gettable;
+    /** \c true for an object container, \c false for a pointer. */
+    bool container;
+  };
+  /** Container type for the attributes matching a path element. */
+  typedef std::vector<PathAttribute> PathAttributes;
+
   /** Ensure the Config path starts and ends with a '/'. */
   void Canonicalize (void);
+  /** Split the Config path into its elements. */
+  void Split (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] element The index of the next element.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t element, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] element The index of the element with the index.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
+   */
+  void DoArrayResolve (std::size_t element, Ptr<Object> root, const PathAttribute &attribute);
+  /**
+   * Get the pointer and container attributes of a type which match an
+   * element of the Config path.
+   *
+   * \param [in] tid The type of the current object.
+   * \param [in] element The index of the element.
+   * \returns The matching attributes.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  const PathAttributes & LookupAttributes (TypeId tid, std::size_t element);
+  /**
+   * Get the value of an attribute.
+   *
+   * \param [in] object The object.
+   * \param [in] attribute The attribute.
+   * \param [out] value The value.
+   */
+  void GetAttribute (Ptr<Object> object, const PathAttribute &attribute, AttributeValue &value) const;
   /**
    * Handle one object found on the path.
    *
@@ -361,6 +461,14 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<std::string> m_elements;
+  /** The index matcher of each element. */
+  std::vector<ArrayMatcher> m_matchers;
+  /** The TypeId of each \c $ element, once looked up. */
+  std::vector<TypeId> m_tids;
+  /** The attributes matching each element, by TypeId uid and element. */
+  std::map<std::pair<uint16_t, std::size_t>, PathAttributes> m_attributes;
 
 };  // class Resolver
 
@@ -369,6 +477,7 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  Split ();
 }
 Resolver::~Resolver ()
 {
@@ -394,12 +503,28 @@ Resolver::Canonicalize (void)
     }
 }
 
+void
+Resolver::Split (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::string::size_type cur = 0;
+  std::string::size_type next;
+  while ((next = m_path.find ("/", cur + 1)) != std::string::npos)
+    {
+      std::string item = m_path.substr (cur + 1, next - (cur + 1));
+      m_elements.push_back (item);
+      m_matchers.push_back (ArrayMatcher (item));
+      cur = next;
+    }
+  m_tids.resize (m_elements.size ());
+}
+
 void
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -424,14 +549,73 @@ Resolver::DoResolveOne (Ptr<Object> object)
   DoOne (object, GetResolvedPath ());
 }
 
+const Resolver::PathAttributes &
+Resolver::LookupAttributes (TypeId tid, std::size_t element)
+{
+  NS_LOG_FUNCTION (this << tid << element);
+  std::pair<uint16_t, std::size_t> key (tid.GetUid (), element);
+  std::map<std::pair<uint16_t, std::size_t>, PathAttributes>::const_iterator found = m_attributes.find (key);
+  if (found != m_attributes.end ())
+    {
+      return found->second;
+    }
+  PathAttributes &attributes = m_attributes[key];
+  const std::string &item = m_elements[element];
+  TypeId current;
+  TypeId next = tid;
+  do
+    {
+      current = next;
+      for (uint32_t i = 0; i < current.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = current.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          bool pointer = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0;
+          bool container = dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0;
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+          if (!pointer && !container)
+            {
+              continue;
+            }
+          // The value is read like ObjectBase::GetAttribute does, with
+          // the first attribute of this name.
+          struct TypeId::AttributeInformation actual;
+          tid.LookupAttributeByName (info.name, &actual);
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.accessor = actual.accessor;
+          attribute.gettable = (actual.flags & TypeId::ATTR_GET) && actual.accessor->HasGetter ();
+          attribute.container = container;
+          attributes.push_back (attribute);
+        }
+      next = current.GetParent ();
+    }
+  while (next != current);
+  return attributes;
+}
+
+void
+Resolver::GetAttribute (Ptr<Object> object, const PathAttribute &attribute, AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << object << attribute.name << &value);
+  if (!attribute.gettable
+      || !attribute.accessor->Get (PeekPointer (object), value))
+    {
+      // report the error
+      object->GetAttribute (attribute.name, value);
+    }
+}
+
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t element, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << element << root);
 
-  if (next == std::string::npos)
+  if (element == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +631,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const std::string &item = m_elements[element];
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +642,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.find ("Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (element + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +662,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (element + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -500,102 +682,126 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   if (dollarPos == 0)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject=" << tidString << " on path=" << GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
-      Ptr<Object> object = root->GetObject<Object> (tid);
+      if (m_tids[element].GetUid () == 0)
+        {
+          std::string tidString = item.substr (1, item.size () - 1);
+          m_tids[element] = TypeId::LookupByName (tidString);
+        }
+      NS_LOG_DEBUG ("GetObject=" << item << " on path=" << GetResolvedPath ());
+      Ptr<Object> object = root->GetObject<Object> (m_tids[element]);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject (" << tidString << ") failed on path=" << GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject (" << item << ") failed on path=" << GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (element + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-
-      do
+      const PathAttributes &attributes = LookupAttributes (root->GetInstanceTypeId (), element);
+      if (attributes.empty ())
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          NS_LOG_DEBUG ("Requested item=" << item << " does not exist on path=" << GetResolvedPath ());
+          return;
+        }
+      for (PathAttributes::const_iterator i = attributes.begin (); i != attributes.end (); ++i)
+        {
+          if (!i->container)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << i->name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              GetAttribute (root, *i, pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (i->name);
+              DoResolve (element + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << i->name << " on path=" << GetResolvedPath ());
+              m_workStack.push_back (i->name);
+              DoArrayResolve (element + 1, root, *i);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        }
-      while (nextTid != tid);
-
-      if (!foundMatch)
-        {
-          NS_LOG_DEBUG ("Requested item=" << item << " does not exist on path=" << GetResolvedPath ());
-          return;
         }
     }
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t element, Ptr<Object> root, const PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << element << root << attribute.name);
+  if (element == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const ArrayMatcher &matcher = m_matchers[element];
+
+  // Visit only the requested indices, if the container allows it.
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  std::size_t n;
+  if (attribute.gettable && accessor != 0
+      && accessor->GetIndexedN (PeekPointer (root), &n))
+    {
+      // Let the containers which index the types of their items skip
+      // those which cannot reach the next "$" element.
+      std::vector<std::string> rest;
+      for (std::size_t j = element + 1; j < m_elements.size (); j++)
+        {
+          rest.push_back (m_elements[j]);
+          if (m_elements[j][0] == '$')
+            {
+              break;
+            }
+        }
+      std::vector<std::size_t> indices;
+      bool indexed = !rest.empty () && rest.back ()[0] == '$'
+        && accessor->GetIndicesByPath (PeekPointer (root), rest, &indices);
+      if (indexed)
+        {
+          std::vector<std::size_t> matching;
+          for (std::vector<std::size_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+            {
+              if (*i < n && matcher.Matches (*i))
+                {
+                  matching.push_back (*i);
+                }
+            }
+          indices.swap (matching);
+        }
+      else if (!matcher.MatchesAll ())
+        {
+          indices = matcher.GetIndices (n);
+        }
+      // Otherwise, copying the container once is cheaper than getting
+      // each item by index.
+      if (indexed || !matcher.MatchesAll ())
+        {
+          for (std::vector<std::size_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+            {
+              std::ostringstream oss;
+              oss << *i;
+              m_workStack.push_back (oss.str ());
+              DoResolve (element + 1, accessor->GetByIndex (PeekPointer (root), *i));
+              m_workStack.pop_back ();
+            }
+          return;
+        }
+    }
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ObjectPtrContainerValue container;
+  GetAttribute (root, attribute, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -604,7 +810,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (element + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -612,9 +818,10 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
 
 /**
  * \ingroup config-impl
- * Config system implementation class.
+ * Config system implementation class, with the root namespace objects
+ * of each SimulationInstance.
  */
-class ConfigImpl : public Singleton<ConfigImpl>
+class ConfigImpl : public InstanceSingleton<ConfigImpl>
 {
 public:
   // Keep Set and SetFailSafe since their errors are triggered
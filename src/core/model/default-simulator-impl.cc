@@ -27,6 +27,7 @@
 #include "pointer.h"
 #include "assert.h"
 #include "log.h"
+#include "string.h"
 
 #include <cmath>
 
@@ -58,11 +59,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("ProfileFile",
+                   "The file of the event profile, written at Simulator::Destroy, "
+                   "or empty to disable the profile.  See ns3::DesProfile.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetProfileFile,
+                                       &DefaultSimulatorImpl::GetProfileFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
+  : m_eventsWithContext (EVENTS_WITH_CONTEXT_CAPACITY)
 {
   NS_LOG_FUNCTION (this);
   m_stop = false;
@@ -77,8 +86,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self ();
+  m_profile = 0;
 #ifdef STACK_TRACE_ENABLED
   os = std::ofstream("stacktrace.txt", std::ofstream::out);
 #endif
@@ -87,6 +96,29 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profile;
+}
+
+void
+DefaultSimulatorImpl::SetProfileFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_profileFile = filename;
+  if (filename.empty ())
+    {
+      delete m_profile;
+      m_profile = 0;
+    }
+  else if (m_profile == 0)
+    {
+      m_profile = new DesProfile ();
+    }
+}
+
+std::string
+DefaultSimulatorImpl::GetProfileFile (void) const
+{
+  return m_profileFile;
 }
 
 void
@@ -117,6 +149,10 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (m_profile != 0)
+    {
+      m_profile->Write (m_profileFile);
+    }
 }
 
 void
@@ -156,7 +192,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profile == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profile->Invoke (next.impl, m_currentContext);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -171,22 +214,15 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContext.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  // move all the events pushed so far
+  EventWithContext event;
+  while (m_eventsWithContext.Pop (event))
     {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
       Scheduler::Event ev;
       ev.impl = event.event;
       ev.key.m_ts = m_currentTs + event.timestamp;
@@ -195,6 +231,10 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_profile != 0)
+        {
+          m_profile->Schedule (ev.impl, ev.key.m_context, event.timestamp);
+        }
 
 #ifdef STACK_TRACE_ENABLED
     os << "SimulationTime: " << event.timestamp
@@ -260,6 +300,10 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_profile != 0)
+    {
+      m_profile->Schedule (event, ev.key.m_context, ev.key.m_ts - m_currentTs);
+    }
 
 #ifdef STACK_TRACE_ENABLED
   os << "SimulationTime: " << m_currentTs
@@ -287,6 +331,10 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       ev.key.m_uid = m_uid;
       m_uid++;
       m_unscheduledEvents++;
+      if (m_profile != 0)
+        {
+          m_profile->Schedule (event, context, ev.key.m_ts - m_currentTs);
+        }
 #ifdef STACK_TRACE_ENABLED
       os << "SimulationTime: " << m_currentTs
          << " CurrentEventID: " << m_currentUid
@@ -307,11 +355,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 #ifdef STACK_TRACE_ENABLED
     ev.stackTrace = to_string(boost::stacktrace::stacktrace());
 #endif
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -328,6 +372,10 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_profile != 0)
+    {
+      m_profile->Schedule (event, ev.key.m_context, 0);
+    }
 #ifdef STACK_TRACE_ENABLED
   os << "SimulationTime: " << m_currentTs
      << " CurrentEventID: " << m_currentUid
@@ -396,6 +444,10 @@ DefaultSimulatorImpl::Remove (const EventId &id)
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
+  if (m_profile != 0)
+    {
+      m_profile->Remove (event.impl, event.key.m_context);
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -25,7 +25,8 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
-#include "system-mutex.h"
+#include "mpsc-queue.h"
+#include "des-metrics.h"
 
 #include "ptr.h"
 
@@ -83,6 +84,17 @@ public:
 private:
   virtual void DoDispose (void);
 
+  /**
+   * Set the file of the event profile, and enable or disable the profile.
+   * \param [in] filename The file, or empty to disable the profile.
+   */
+  void SetProfileFile (std::string filename);
+  /**
+   * Get the file of the event profile.
+   * \returns The file, or empty if the profile is disabled.
+   */
+  std::string GetProfileFile (void) const;
+
   /** Process the next event. */
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
@@ -97,19 +109,22 @@ private:
     uint64_t timestamp;
     /** The event implementation. */
     EventImpl *event;
+#ifdef STACK_TRACE_ENABLED
+    /** The stack trace of the thread which scheduled the event. */
     std::string stackTrace;
+#endif
   };
-  /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
-  EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
+   * The capacity of the ring of #m_eventsWithContext.  Beyond it, the
+   * events of other threads spill into a locked list, since the main
+   * thread may not be running to move them.
+   */
+  static const uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 16384;
+  /**
+   * The events scheduled by other threads, not yet moved to the
    * primary event queue.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
-  SystemMutex m_eventsWithContextMutex;
+  MpscQueue<EventWithContext> m_eventsWithContext;
 
   /** Container type for the events to run at Simulator::Destroy() */
   typedef std::list<EventId> DestroyEvents;
@@ -138,6 +153,11 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** The file of the event profile. */
+  std::string m_profileFile;
+  /** The event profile, or 0 if disabled. */
+  DesProfile *m_profile;
   std::ofstream os;
 };
 
@@ -22,17 +22,27 @@
 /**
  * @file
  * @ingroup simulator
- * ns3::DesMetrics implementation.
+ * ns3::DesMetrics and ns3::DesProfile implementations.
  */
 
 #include "des-metrics.h"
+#include "event-impl.h"
 #include "simulator.h"
 #include "system-path.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <ctime>    // time_t, time()
+#include <map>
 #include <sstream>
 #include <string>
 
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
 namespace ns3 {
 
 /* static */
@@ -157,5 +167,225 @@ DesMetrics::Close (void)
 
 
 
+DesProfile::DesProfile ()
+{}
+
+DesProfile::Record &
+DesProfile::GetRecord (const EventImpl *event, uint32_t context)
+{
+  Key key;
+  key.type = &typeid (*event);
+  std::size_t size;
+  const void *function = event->PeekFunction (&size, &key.callback);
+  std::memset (key.function, 0, sizeof (key.function));
+  if (size != 0)
+    {
+      std::memcpy (key.function, function, std::min (size, sizeof (key.function)));
+    }
+  key.context = context;
+  std::unordered_map<Key, Record, KeyHash>::iterator i = m_records.find (key);
+  if (i == m_records.end ())
+    {
+      Record record = {0, 0, 0, 0, 0};
+      i = m_records.insert (std::make_pair (key, record)).first;
+    }
+  return i->second;
+}
+
+void
+DesProfile::Schedule (const EventImpl *event, uint32_t context, uint64_t delay)
+{
+  Record &record = GetRecord (event, context);
+  record.scheduled++;
+  m_delays[event] = delay;
+}
+
+uint64_t
+DesProfile::TakeDelay (const EventImpl *event)
+{
+  std::unordered_map<const EventImpl *, uint64_t>::iterator i = m_delays.find (event);
+  if (i == m_delays.end ())
+    {
+      return 0;
+    }
+  uint64_t delay = i->second;
+  m_delays.erase (i);
+  return delay;
+}
+
+void
+DesProfile::Invoke (EventImpl *event, uint32_t context)
+{
+  Record &record = GetRecord (event, context);
+  if (event->IsCancelled ())
+    {
+      record.cancelled += TakeDelay (event);
+      event->Invoke ();
+      return;
+    }
+  record.residency += TakeDelay (event);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::duration wall = std::chrono::steady_clock::now () - start;
+  record.executed++;
+  record.wall += std::chrono::duration_cast<std::chrono::nanoseconds> (wall).count ();
+}
+
+void
+DesProfile::Remove (const EventImpl *event, uint32_t context)
+{
+  GetRecord (event, context).cancelled += TakeDelay (event);
+}
+
+void
+DesProfile::Write (std::string filename) const
+{
+  // The same type may have several type_info in different libraries,
+  // so the records are merged by their frames.
+  std::map<std::string, Record> stacks;
+  for (std::unordered_map<Key, Record, KeyHash>::const_iterator i = m_records.begin ();
+       i != m_records.end (); ++i)
+    {
+      std::ostringstream stack;
+      stack << GetFrames (i->first) << ';';
+      if (i->first.context == Simulator::NO_CONTEXT)
+        {
+          stack << "no context";
+        }
+      else
+        {
+          stack << "node " << i->first.context;
+        }
+      Record &record = stacks[stack.str ()];
+      record.scheduled += i->second.scheduled;
+      record.residency += i->second.residency;
+      record.cancelled += i->second.cancelled;
+      record.executed += i->second.executed;
+      record.wall += i->second.wall;
+    }
+
+  std::ofstream wall (filename.c_str ());
+  std::ofstream count ((filename + ".count").c_str ());
+  std::ofstream residency ((filename + ".residency").c_str ());
+  std::ofstream cancelled ((filename + ".cancelled").c_str ());
+  for (std::map<std::string, Record>::const_iterator i = stacks.begin (); i != stacks.end (); ++i)
+    {
+      // The flame graph tools expect positive values.
+      if (i->second.wall != 0)
+        {
+          wall << i->first << ' ' << i->second.wall << std::endl;
+        }
+      if (i->second.executed != 0)
+        {
+          count << i->first << ' ' << i->second.executed << std::endl;
+        }
+      if (i->second.residency != 0)
+        {
+          residency << i->first << ' ' << i->second.residency << std::endl;
+        }
+      if (i->second.cancelled != 0)
+        {
+          cancelled << i->first << ' ' << i->second.cancelled << std::endl;
+        }
+    }
+}
+
+std::string
+DesProfile::GetFrames (const Key &key)
+{
+  std::ostringstream frames;
+  frames << GetFrames (*key.type);
+  uintptr_t address;
+  std::memcpy (&address, key.function, sizeof (address));
+  if (key.callback != 0)
+    {
+      frames << ';' << GetFrames (*key.callback);
+    }
+  else if (address != 0)
+    {
+      frames << ";0x" << std::hex << address;
+    }
+  return frames.str ();
+}
+
+std::string
+DesProfile::GetFrames (const std::type_info &type)
+{
+  std::string name = type.name ();
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+
+  // The EventImpl made by MakeEvent are local classes of MakeEvent,
+  // named like
+  //   ns3::MakeEvent<...>(void (ns3::A::*)(int), ns3::A*, int)::EventMemberImpl1
+  //   ns3::MakeEvent<...>(void (*)(int), int)::EventFunctionImpl1
+  // The first parameter of MakeEvent is the type of the event function.
+  std::string::size_type i = name.find ("MakeEvent");
+  if (i == std::string::npos)
+    {
+      return name;
+    }
+  i += 9;
+  int depth = 0;
+  if (i < name.size () && name[i] == '<')
+    {
+      for (; i < name.size (); ++i)
+        {
+          if (name[i] == '<')
+            {
+              depth++;
+            }
+          else if (name[i] == '>' && --depth == 0)
+            {
+              ++i;
+              break;
+            }
+        }
+    }
+  if (i >= name.size () || name[i] != '(')
+    {
+      return name;
+    }
+  std::string::size_type start = ++i;
+  for (; i < name.size (); ++i)
+    {
+      char c = name[i];
+      if (c == '(' || c == '<')
+        {
+          depth++;
+        }
+      else if ((c == ')' || c == '>') && depth > 0)
+        {
+          depth--;
+        }
+      else if ((c == ',' || c == ')') && depth == 0)
+        {
+          break;
+        }
+    }
+  std::string function = name.substr (start, i - start);
+
+  std::string::size_type member = function.find ("::*)");
+  if (member != std::string::npos)
+    {
+      std::string::size_type open = function.rfind ('(', member);
+      return function.substr (open + 1, member - open - 1) + ';'
+             + function.substr (0, open) + function.substr (member + 4);
+    }
+  std::string::size_type pointer = function.find ("(*)");
+  if (pointer != std::string::npos)
+    {
+      return "[function];" + function.substr (0, pointer) + function.substr (pointer + 3);
+    }
+  return name;
+}
+
 } // namespace ns3
 
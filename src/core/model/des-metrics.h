@@ -24,7 +24,7 @@
 /**
  * @file
  * @ingroup simulator
- * ns3::DesMetrics declaration.
+ * ns3::DesMetrics and ns3::DesProfile declarations.
  */
 
 #include "nstime.h"
@@ -34,6 +34,8 @@
 #include <stdint.h>    // uint32_t
 #include <fstream>
 #include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3 {
@@ -165,6 +167,175 @@ private:
 };  // class DesMetrics
 
 
+class EventImpl;
+
+/**
+ * @ingroup simulator
+ *
+ * @brief Event profile, aggregated per event function and context.
+ *
+ * Where DesMetrics writes a JSON record for each event, and must be
+ * enabled at configure time, DesProfile only updates the counters of
+ * the function and the context of each event, and can be enabled in
+ * any build with the DefaultSimulatorImpl::ProfileFile attribute:
+ * \verbatim
+   $ ./waf --run "my-program --ns3::DefaultSimulatorImpl::ProfileFile=my-program.folded" \endverbatim
+ *
+ * For each event function and context, it counts the scheduled and the
+ * executed events, and sums the wall clock time of the executed events
+ * and their delays, which is the (simulated) time they spend in the
+ * event queue.  The delays of the cancelled and removed events are
+ * summed apart.
+ *
+ * At Simulator::Destroy, it writes four files in the folded stack
+ * format of the flame graph tools
+ * (https://github.com/brendangregg/FlameGraph): the wall clock time,
+ * in nanoseconds, in the profile file; the number of executed events in
+ * the profile file with \c .count appended; and the queue residency of
+ * the executed and of the cancelled events, in time steps of the
+ * current resolution, in the profile file with \c .residency and
+ * \c .cancelled appended.  Each line holds the class, the signature, the
+ * function and the context of the event function, and the value:
+ * \verbatim
+ns3::YansWifiPhy;void (ns3::Ptr<ns3::Packet>, double);0x7f3a5c41e2b0;node 3 1254000 \endverbatim
+ *
+ * The event function is identified by the function or member function
+ * pointer bound by MakeEvent, written as the address of the function
+ * (for a virtual member function, its offset in the virtual table plus
+ * one), and labelled by the type of the EventImpl, which MakeEvent makes
+ * from the type of the function.  For the events which call a Callback,
+ * the function is the type of the implementation of the Callback.
+ * The functions with no class are under \c [function].
+ */
+class DesProfile
+{
+public:
+  /** Constructor. */
+  DesProfile ();
+
+  /**
+   * Count a scheduled event.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   * \param [in] delay The delay to the event, in time steps.
+   */
+  void Schedule (const EventImpl *event, uint32_t context, uint64_t delay);
+  /**
+   * Invoke an event, and count it, its wall clock time and its delay,
+   * or only its delay if it was cancelled.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+  /**
+   * Count the delay of an event removed before it expired.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context of the event.
+   */
+  void Remove (const EventImpl *event, uint32_t context);
+
+  /**
+   * Write the profile files.
+   *
+   * \param [in] filename The name of the wall clock time file, which is
+   *             also the prefix of the other files.
+   */
+  void Write (std::string filename) const;
+
+  /**
+   * Get the flame graph frames of an event function.
+   *
+   * \param [in] type The type of the EventImpl of the event.
+   * \returns The class and the signature of the event function,
+   *          separated by \c ;, or the name of \p type if it was not
+   *          made by MakeEvent.
+   */
+  static std::string GetFrames (const std::type_info &type);
+
+private:
+  /** The number of words of a function pointer kept in a Key. */
+  static const std::size_t FUNCTION_WORDS = 3;
+  /** The event function and the context of a record. */
+  struct Key
+  {
+    const std::type_info *type;      //!< The type of the EventImpl.
+    const std::type_info *callback;  //!< The type of the Callback implementation, or 0.
+    /** The function or member function pointer, zero-padded. */
+    uint64_t function[FUNCTION_WORDS];
+    uint32_t context;                //!< The context.
+    /**
+     * Equality operator.
+     * \param [in] other The other key.
+     * \returns \c true if the keys are equal.
+     */
+    bool operator == (const Key &other) const
+    {
+      return type == other.type && callback == other.callback
+             && function[0] == other.function[0] && function[1] == other.function[1]
+             && function[2] == other.function[2] && context == other.context;
+    }
+  };
+  /** Hash function of Key. */
+  struct KeyHash
+  {
+    /**
+     * Hash a key.
+     * \param [in] key The key.
+     * \returns The hash of the key.
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      return std::hash<const void *> () (key.type)
+             ^ std::hash<uint64_t> () (key.function[0] ^ key.function[1] ^ key.function[2])
+             ^ key.context;
+    }
+  };
+  /** The counters of an event function and context. */
+  struct Record
+  {
+    uint64_t scheduled;  //!< The number of scheduled events.
+    uint64_t residency;  //!< The sum of the delays of the executed events.
+    uint64_t cancelled;  //!< The sum of the delays of the cancelled events.
+    uint64_t executed;   //!< The number of executed events.
+    uint64_t wall;       //!< The wall clock time of the executed events, in ns.
+  };
+
+  /**
+   * Get the record of an event function and context.
+   *
+   * \param [in] event The event.
+   * \param [in] context The context.
+   * \returns The record.
+   */
+  Record & GetRecord (const EventImpl *event, uint32_t context);
+  /**
+   * Get the flame graph frames of the event function of a record.
+   *
+   * \param [in] key The key of the record.
+   * \returns The frames of the type of the EventImpl, followed by the
+   *          function.
+   */
+  static std::string GetFrames (const Key &key);
+
+  /**
+   * Remove the delay of a pending event.
+   *
+   * \param [in] event The event.
+   * \returns The delay given to Schedule().
+   */
+  uint64_t TakeDelay (const EventImpl *event);
+
+  /** The records, by event function and context. */
+  std::unordered_map<Key, Record, KeyHash> m_records;
+  /** The delays of the pending events. */
+  std::unordered_map<const EventImpl *, uint64_t> m_delays;
+
+};  // class DesProfile
+
+
 } // namespace ns3
 
 #endif /* DESMETRICS_H */
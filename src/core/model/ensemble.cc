@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ensemble.h"
+#include "simulation-instance.h"
+#include "simulator.h"
+#include "log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Ensemble implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ensemble");
+
+namespace {
+
+/**
+ * Run replications in one thread, until there is none left.
+ *
+ * \param [in,out] next The index of the next replication to run.
+ * \param [in] replications The number of replications.
+ * \param [in] replication The function which runs a replication.
+ */
+void
+RunReplications (std::atomic<uint32_t> *next, uint32_t replications,
+                 const Callback<void, uint32_t> *replication)
+{
+  for (uint32_t index = (*next)++; index < replications; index = (*next)++)
+    {
+      SimulationInstance *instance = new SimulationInstance ();
+      SimulationInstance::SetCurrent (instance);
+      NS_LOG_INFO ("replication " << index);
+      (*replication)(index);
+      Simulator::Destroy ();
+      // The singletons are deleted in their own instance.
+      delete instance;
+      SimulationInstance::SetCurrent (0);
+    }
+}
+
+} // unnamed namespace
+
+void
+Ensemble::Run (uint32_t replications, Callback<void, uint32_t> replication,
+               uint32_t threads)
+{
+  NS_LOG_FUNCTION (replications << threads);
+#ifdef NS3_MTP
+  if (threads == 0)
+    {
+      threads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+#else
+  threads = 1;
+#endif
+  threads = std::min (threads, replications);
+
+  std::atomic<uint32_t> next (0);
+  std::vector<std::thread> workers;
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      workers.push_back (std::thread (&RunReplications, &next, replications, &replication));
+    }
+  for (std::vector<std::thread>::iterator i = workers.begin (); i != workers.end (); ++i)
+    {
+      i->join ();
+    }
+}
+
+} // namespace ns3
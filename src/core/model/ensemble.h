@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "callback.h"
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Ensemble declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Run many independent replications of a simulation in one process.
+ *
+ * Each replication runs in its own SimulationInstance, on one of
+ * several threads: it has its own simulator, global values (so its
+ * own RngSeedManager seed, run and stream indices), configuration
+ * namespace, names, node list, channel list and simulation singletons.
+ * The process starts, and the modules initialize their static state,
+ * only once for all the replications:
+ *
+ * \code
+ *   void
+ *   Replication (uint32_t index)
+ *   {
+ *     RngSeedManager::SetRun (index + 1);
+ *     NodeContainer nodes;
+ *     nodes.Create (10);
+ *     // build the topology, install the applications
+ *     Simulator::Stop (Seconds (100));
+ *     Simulator::Run ();
+ *     // write the results, to files named after index
+ *   }
+ *
+ *   int
+ *   main (int argc, char *argv[])
+ *   {
+ *     // parse the command line, call Config::SetDefault
+ *     Ensemble::Run (1000, MakeCallback (&Replication));
+ *     return 0;
+ *   }
+ * \endcode
+ *
+ * A replication starts with the global values of the calling thread,
+ * and its own changes to them, like RngSeedManager::SetRun, stay in
+ * the replication.  With the same run, it draws the same random
+ * numbers as the same simulation run alone in a process.
+ *
+ * The rest of the process is shared by the replications:
+ * Config::SetDefault, LogComponentEnable and Time::SetResolution must
+ * be called before Run(), and the packet uids are unique in the whole
+ * process.  Models which keep state in their own static variables,
+ * instead of an InstanceSingleton or a SimulationSingleton, must not
+ * be used by concurrent replications.
+ *
+ * The reference counts of the attribute values and checkers shared by
+ * the replications are only atomic when ns-3 is built with \c NS3_MTP;
+ * without it, the replications run one after the other on a single
+ * thread.
+ */
+class Ensemble
+{
+public:
+  /**
+   * Run replications of a simulation, and wait for their end.
+   *
+   * Simulator::Destroy is called at the end of each replication.
+   *
+   * \param [in] replications The number of replications.
+   * \param [in] replication The function which runs a replication,
+   *             given its index in [0, \pname{replications}).
+   * \param [in] threads The number of threads, or 0 for one thread
+   *             per hardware thread.
+   */
+  static void Run (uint32_t replications, Callback<void, uint32_t> replication,
+                   uint32_t threads = 0);
+};
+
+} // namespace ns3
+
+#endif /* ENSEMBLE_H */
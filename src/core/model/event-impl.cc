@@ -19,6 +19,7 @@
  */
 
 #include "event-impl.h"
+#include "event-memory-pool.h"
 #include "log.h"
 
 /**
@@ -66,4 +67,24 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::PeekFunction (std::size_t *size, const std::type_info **callback) const
+{
+  *size = 0;
+  *callback = 0;
+  return 0;
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  return EventMemoryPool::Allocate (size);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  EventMemoryPool::Deallocate (p, size);
+}
+
 } // namespace ns3
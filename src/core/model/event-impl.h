@@ -21,6 +21,8 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
+#include <typeinfo>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +42,9 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The storage of every EventImpl subclass, including the arguments
+ * bound by MakeEvent(), is recycled through the EventMemoryPool.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -65,6 +70,33 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * Get what the event calls, to tell apart in profiles the events
+   * of the same EventImpl type.
+   *
+   * \param [out] size The size of the function or member function
+   *              pointer bound by MakeEvent(), or 0 if there is none.
+   * \param [out] callback The type of the implementation of the Callback
+   *              which the event calls through its operator(), or 0.
+   * \returns The address of the pointer, in the event.
+   */
+  virtual const void * PeekFunction (std::size_t *size,
+                                     const std::type_info **callback) const;
+
+  /**
+   * Allocate storage for an event from the EventMemoryPool.
+   *
+   * \param [in] size The size of the most derived event class.
+   * \returns The storage.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Give the storage of an event back to the EventMemoryPool.
+   *
+   * \param [in] p The storage.
+   * \param [in] size The size of the most derived event class.
+   */
+  static void operator delete (void *p, std::size_t size);
 
 protected:
   /**
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-memory-pool.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventMemoryPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventMemoryPool");
+
+namespace {
+
+/**
+ * Get the pool of the events, with free lists per thread.
+ * \returns The pool.
+ */
+SizeClassPool *
+GetPool (void)
+{
+  static SizeClassPool *pool = new SizeClassPool (EventMemoryPool::Granularity, 0,
+                                                  EventMemoryPool::MaxBlockSize,
+                                                  EventMemoryPool::MaxCachedBlocks,
+                                                  true);
+  return pool;
+}
+
+} // unnamed namespace
+
+void *
+EventMemoryPool::Allocate (std::size_t size)
+{
+  return GetPool ()->Allocate (size);
+}
+
+void
+EventMemoryPool::Deallocate (void *p, std::size_t size)
+{
+  GetPool ()->Deallocate (p, size);
+}
+
+EventMemoryPool::Statistics
+EventMemoryPool::GetStatistics (void)
+{
+  return GetPool ()->GetStatistics ();
+}
+
+bool
+EventMemoryPool::IsEnabled (void)
+{
+  return GetPool ()->IsEnabled ();
+}
+
+void
+EventMemoryPool::Trim (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetPool ()->Trim ();
+}
+
+} // namespace ns3
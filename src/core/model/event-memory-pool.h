@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_MEMORY_POOL_H
+#define EVENT_MEMORY_POOL_H
+
+#include "size-class-pool.h"
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventMemoryPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Size-class free lists for EventImpl storage.
+ *
+ * Every Simulator::Schedule call creates a new EventImpl subclass
+ * holding the bound function and arguments, and the event is
+ * deleted as soon as it has been invoked and the last EventId
+ * referring to it is gone.  EventImpl::operator new and
+ * EventImpl::operator delete route that storage through this pool,
+ * so that in steady state the schedule/invoke loop recycles the
+ * blocks of past events instead of calling the general-purpose
+ * allocator.
+ *
+ * This is a SizeClassPool whose size classes are multiples of
+ * \c Granularity bytes up to \c MaxBlockSize.  A block may be released
+ * by a different thread than the one which allocated it: this happens
+ * when foreign threads call Simulator::ScheduleWithContext.  The free
+ * lists are kept per thread, so each simulator thread recycles its own
+ * events without locking.  Simulator::Destroy releases the blocks
+ * cached by the calling thread.
+ */
+class EventMemoryPool
+{
+public:
+  /** Allocation counters of the pool of the calling thread. */
+  typedef SizeClassPool::Statistics Statistics;
+
+  /**
+   * Allocate storage for an event.
+   *
+   * \param [in] size The size of the event, in bytes.
+   * \returns A block of at least \pname{size} bytes.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release storage obtained from Allocate().
+   *
+   * \param [in] p The block.
+   * \param [in] size The size which was passed to Allocate().
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * Get the counters of the pool of the calling thread.
+   *
+   * \returns The pool statistics.
+   */
+  static Statistics GetStatistics (void);
+  /**
+   * Check whether the pool recycles blocks: it is bypassed under
+   * valgrind and AddressSanitizer.
+   *
+   * \returns \c true if released blocks are cached for reuse.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Give all the blocks cached by the calling thread back to the
+   * general-purpose allocator.  The counters are kept.
+   */
+  static void Trim (void);
+
+  /** Size classes are multiples of this many bytes. */
+  static const std::size_t Granularity = 16;
+  /** Largest size served from the free lists. */
+  static const std::size_t MaxBlockSize = 256;
+  /** Maximum number of blocks cached per size class. */
+  static const uint32_t MaxCachedBlocks = 65536;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_MEMORY_POOL_H */
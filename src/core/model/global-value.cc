@@ -23,11 +23,13 @@
 #include "string.h"
 #include "uinteger.h"
 #include "log.h"
+#include "simulation-instance.h"
 
 #include "ns3/core-config.h"
 
 #include <cstdlib>  // getenv
 #include <cstring>  // strlen
+#include <map>
 
 
 /**
@@ -40,6 +42,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalValue");
 
+/**
+ * \ingroup core
+ * The current values of the GlobalValues, in a SimulationInstance
+ * other than the default one.
+ */
+typedef std::map<const GlobalValue *, Ptr<AttributeValue> > InstanceValues;
+
 GlobalValue::GlobalValue (std::string name, std::string help,
                           const AttributeValue &initialValue,
                           Ptr<const AttributeChecker> checker)
@@ -117,7 +126,8 @@ void
 GlobalValue::GetValue (AttributeValue &value) const
 {
   NS_LOG_FUNCTION (&value);
-  bool ok = m_checker->Copy (*m_currentValue, value);
+  Ptr<AttributeValue> current = GetCurrentValue ();
+  bool ok = m_checker->Copy (*current, value);
   if (ok)
     {
       return;
@@ -127,7 +137,7 @@ GlobalValue::GetValue (AttributeValue &value) const
     {
       NS_FATAL_ERROR ("GlobalValue name=" << m_name << ": input value is not a string");
     }
-  str->Set (m_currentValue->SerializeToString (m_checker));
+  str->Set (current->SerializeToString (m_checker));
 }
 Ptr<const AttributeChecker>
 GlobalValue::GetChecker (void) const
@@ -147,7 +157,7 @@ GlobalValue::SetValue (const AttributeValue &value)
     {
       return 0;
     }
-  m_currentValue = v;
+  SetCurrentValue (v);
   return true;
 }
 
@@ -201,7 +211,35 @@ void
 GlobalValue::ResetInitialValue (void)
 {
   NS_LOG_FUNCTION (this);
-  m_currentValue = m_initialValue;
+  SetCurrentValue (m_initialValue);
+}
+
+Ptr<AttributeValue>
+GlobalValue::GetCurrentValue (void) const
+{
+  if (SimulationInstance::GetCurrent () != SimulationInstance::GetDefault ())
+    {
+      InstanceValues *values = InstanceSingleton<InstanceValues, GlobalValue>::Get ();
+      InstanceValues::const_iterator i = values->find (this);
+      if (i != values->end ())
+        {
+          return i->second;
+        }
+    }
+  return m_currentValue;
+}
+
+void
+GlobalValue::SetCurrentValue (Ptr<AttributeValue> value)
+{
+  if (SimulationInstance::GetCurrent () != SimulationInstance::GetDefault ())
+    {
+      (*InstanceSingleton<InstanceValues, GlobalValue>::Get ())[this] = value;
+    }
+  else
+    {
+      m_currentValue = value;
+    }
 }
 
 bool
@@ -49,6 +49,10 @@ class GlobalValueTestCase;
  *   - From the command line,
  *   - By explicit call to SetValue() or Bind().
  *
+ * A SimulationInstance other than the default one starts with the
+ * current values of the default instance, and keeps the values set
+ * while it is the current instance.
+ *
  * Instances of this class are expected to be allocated as static
  * global variables and should be used to store configurable global state.
  * For example:
@@ -194,6 +198,16 @@ private:
   static Vector * GetVector (void);
   /** Initialize from the \c NS_GLOBAL_VALUE environment variable. */
   void InitializeFromEnv (void);
+  /**
+   * Get the current value, in the current SimulationInstance.
+   * \returns The current value.
+   */
+  Ptr<AttributeValue> GetCurrentValue (void) const;
+  /**
+   * Set the current value, in the current SimulationInstance.
+   * \param [in] value The current value.
+   */
+  void SetCurrentValue (Ptr<AttributeValue> value);
 
   /** The name of this GlobalValue. */
   std::string m_name;
@@ -201,7 +215,7 @@ private:
   std::string m_help;
   /** The initial value. */
   Ptr<AttributeValue> m_initialValue;
-  /** The current value. */
+  /** The current value, in the default SimulationInstance. */
   Ptr<AttributeValue> m_currentValue;
   /** The AttributeChecker for this GlobalValue. */
   Ptr<const AttributeChecker> m_checker;
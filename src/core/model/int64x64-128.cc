@@ -114,7 +114,17 @@ int64x64_t::Div (const int64x64_t & o)
 {
   uint128_t a, b;
   bool negative = output_sign (_v, o._v, a, b);
-  int128_t result = Udiv (a, b);
+  int128_t result;
+  if ((b & HP_MASK_LO) == 0)
+    {
+      // Dividing by an integer, like the ratio of two Times, gives the
+      // same truncated quotient as Udiv with a single division.
+      result = a / (b >> 64);
+    }
+  else
+    {
+      result = Udiv (a, b);
+    }
   _v = negative ? -result : result;
 }
 
@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 #include <cmath>  // pow
+#include <cstring>  // memcpy
+#include <limits>
 
 #if defined(HAVE___UINT128_T) && !defined(HAVE_UINT128_T)
 typedef __uint128_t uint128_t;
@@ -84,7 +86,7 @@ public:
   static const enum impl_type implementation = int128_impl;
 
   /// Default constructor.
-  inline int64x64_t ()
+  constexpr int64x64_t ()
     : _v (0)
   {}
   /**
@@ -95,8 +97,39 @@ public:
   /**@{*/
   inline int64x64_t (const double value)
   {
-    const int64x64_t tmp ((long double)value);
-    _v = tmp._v;
+    // The rounding of the long double conversion below is exact when
+    // long double has at least 64 bits of mantissa, and gives the
+    // value rounded half up to the nearest 2^-64.  Compute the same
+    // value directly from the bits of the double, for the finite values
+    // of magnitude less than 2^63.
+    uint64_t bits;
+    std::memcpy (&bits, &value, sizeof (bits));
+    const int exponent = (bits >> 52) & 0x7ff;
+    if (std::numeric_limits<long double>::digits < 64 || exponent >= 1023 + 63)
+      {
+        const int64x64_t tmp ((long double)value);
+        _v = tmp._v;
+        return;
+      }
+    // value is (2^52 + mantissa) * 2^(exponent - 1075), and _v is
+    // value * 2^64.
+    const uint64_t mantissa = (bits & 0xfffffffffffffULL) | (1ULL << 52);
+    const int shift = exponent - 1075 + 64;
+    uint128_t magnitude;
+    if (shift >= 0)
+      {
+        magnitude = (uint128_t)mantissa << shift;
+      }
+    else if (shift > -54)
+      {
+        magnitude = (mantissa + (1ULL << (-shift - 1))) >> -shift;
+      }
+    else
+      {
+        // Less than 2^-65, including zero and the denormals.
+        magnitude = 0;
+      }
+    _v = (bits >> 63) ? -magnitude : magnitude;
   }
   inline int64x64_t (const long double value)
   {
@@ -134,36 +167,24 @@ public:
    * \param [in] v Integer value to represent.
    */
   /**@{*/
-  inline int64x64_t (const int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const long long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned long long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
+  constexpr int64x64_t (const int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
+  constexpr int64x64_t (const long int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
+  constexpr int64x64_t (const long long int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
+  constexpr int64x64_t (const unsigned int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
+  constexpr int64x64_t (const unsigned long int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
+  constexpr int64x64_t (const unsigned long long int v)
+    : _v ((int128_t)((uint128_t)v << 64))
+  {}
   /**@}*/
 
   /**
@@ -172,18 +193,16 @@ public:
    * \param [in] hi Integer portion.
    * \param [in] lo Fractional portion, already scaled to HP_MAX_64.
    */
-  explicit inline int64x64_t (const int64_t hi, const uint64_t lo)
-  {
-    _v = (int128_t)hi << 64;
-    _v |= lo;
-  }
+  explicit constexpr int64x64_t (const int64_t hi, const uint64_t lo)
+    : _v ((int128_t)((uint128_t)hi << 64 | lo))
+  {}
 
   /**
    * Copy constructor.
    *
    * \param [in] o Value to copy.
    */
-  inline int64x64_t (const int64x64_t & o)
+  constexpr int64x64_t (const int64x64_t & o)
     : _v (o._v)
   {}
   /**
@@ -390,7 +409,7 @@ private:
    *
    * \param [in] v Integer value to represent.
    */
-  inline int64x64_t (const int128_t v)
+  constexpr int64x64_t (const int128_t v)
     : _v (v)
   {}
 
@@ -75,7 +75,7 @@ public:
   static const enum impl_type implementation = ld_impl;
 
   /// Default constructor
-  inline int64x64_t ()
+  constexpr int64x64_t ()
     : _v (0)
   {}
   /**@{*/
@@ -84,10 +84,10 @@ public:
    *
    * \param [in] v Floating value to represent
    */
-  inline int64x64_t (double v)
+  constexpr int64x64_t (double v)
     : _v (v)
   {}
-  inline int64x64_t (long double v)
+  constexpr int64x64_t (long double v)
     : _v (v)
   {}
   /**@}*/
@@ -98,22 +98,22 @@ public:
    *
    * \param [in] v Integer value to represent
    */
-  inline int64x64_t (int v)
+  constexpr int64x64_t (int v)
     : _v (v)
   {}
-  inline int64x64_t (long int v)
+  constexpr int64x64_t (long int v)
     : _v (v)
   {}
-  inline int64x64_t (long long int v)
+  constexpr int64x64_t (long long int v)
     : _v (static_cast<double> (v))
   {}
-  inline int64x64_t (unsigned int v)
+  constexpr int64x64_t (unsigned int v)
     : _v (v)
   {}
-  inline int64x64_t (unsigned long int v)
+  constexpr int64x64_t (unsigned long int v)
     : _v (v)
   {}
-  inline int64x64_t (unsigned long long int v)
+  constexpr int64x64_t (unsigned long long int v)
     : _v (static_cast<double> (v))
   {}
   /**@}*/
@@ -139,7 +139,7 @@ public:
    *
    * \param [in] o Value to copy.
    */
-  inline int64x64_t (const int64x64_t & o)
+  constexpr int64x64_t (const int64x64_t & o)
     : _v (o._v)
   {}
   /**
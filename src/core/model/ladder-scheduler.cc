@@ -0,0 +1,366 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "type-id.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("Threshold",
+                   "Number of events in a bucket above which the bucket "
+                   "is spread over a new rung instead of being sorted.",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs in the ladder.",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_qSize (0),
+    m_threshold (50),
+    m_maxRungs (8)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  ++m_qSize;
+  uint64_t ts = ev.key.m_ts;
+
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+      if (m_bottomHead == m_bottom.size ())
+        {
+          // The ladder was empty.
+          Advance ();
+        }
+      return;
+    }
+
+  for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= rung.start + rung.current * rung.width)
+        {
+          uint64_t bucket = (ts - rung.start) / rung.width;
+          NS_ASSERT (bucket < rung.nBuckets);
+          rung.buckets[bucket].push_back (ev);
+          ++rung.count;
+          return;
+        }
+    }
+
+  InsertBottom (ev);
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  Bucket::iterator head = m_bottom.begin () + m_bottomHead;
+  Bucket::iterator pos = std::upper_bound (head, m_bottom.end (), ev);
+  if (pos == head && m_bottomHead > 0)
+    {
+      m_bottom[--m_bottomHead] = ev;
+    }
+  else
+    {
+      m_bottom.insert (pos, ev);
+    }
+
+  std::size_t size = m_bottom.size () - m_bottomHead;
+  if (size <= m_threshold || m_nRungs >= m_maxRungs)
+    {
+      return;
+    }
+  uint64_t start = m_bottom[m_bottomHead].key.m_ts;
+  if (start == m_bottom.back ().key.m_ts)
+    {
+      return;
+    }
+  // Bottom is too long to keep sorted: spread it over a new rung.
+  uint64_t end = m_topStart;
+  if (m_nRungs > 0)
+    {
+      const Rung &lowest = m_rungs[m_nRungs - 1];
+      end = lowest.start + lowest.current * lowest.width;
+    }
+  NS_LOG_LOGIC ("spilling " << size << " events from bottom");
+  m_bottom.erase (m_bottom.begin (), m_bottom.begin () + m_bottomHead);
+  m_bottomHead = 0;
+  SpawnRung (m_bottom, start, end);
+  Advance ();
+}
+
+void
+LadderScheduler::SpawnRung (Bucket &events, uint64_t start, uint64_t end)
+{
+  NS_LOG_FUNCTION (this << events.size () << start << end);
+  NS_ASSERT (m_nRungs < m_maxRungs);
+  NS_ASSERT (!events.empty () && end > start);
+
+  if (m_rungs.size () < m_maxRungs)
+    {
+      // Rungs are only created here and kept afterwards, so
+      // references to buckets are not invalidated by later calls.
+      m_rungs.resize (m_maxRungs);
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  ++m_nRungs;
+
+  uint64_t span = end - start;
+  uint64_t n = events.size ();
+  uint64_t width = span / n + ((span % n) ? 1 : 0);
+  uint64_t nBuckets = span / width + ((span % width) ? 1 : 0);
+  rung.start = start;
+  rung.width = width;
+  rung.nBuckets = static_cast<uint32_t> (nBuckets);
+  rung.current = 0;
+  rung.count = static_cast<uint32_t> (n);
+  if (rung.buckets.size () < nBuckets)
+    {
+      rung.buckets.resize (nBuckets);
+    }
+  NS_LOG_LOGIC ("rung " << m_nRungs - 1 << ": " << nBuckets <<
+                " buckets of width " << width);
+
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      uint64_t bucket = (i->key.m_ts - start) / width;
+      NS_ASSERT (bucket < nBuckets);
+      rung.buckets[bucket].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::RefillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottomHead == 0 && m_bottom.empty ());
+
+  while (true)
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          if (m_top.size () <= m_threshold || m_topMin == m_topMax)
+            {
+              // Small epoch: sort the Top directly.
+              m_topStart = m_topMax + 1;
+              m_bottom.swap (m_top);
+              std::sort (m_bottom.begin (), m_bottom.end ());
+              return;
+            }
+          uint64_t start = m_topMin;
+          SpawnRung (m_top, start, m_topMax + 1);
+          const Rung &first = m_rungs[0];
+          m_topStart = first.start + first.nBuckets * first.width;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets
+             && rung.buckets[rung.current].empty ())
+        {
+          ++rung.current;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          NS_ASSERT (rung.count == 0);
+          --m_nRungs;
+          continue;
+        }
+
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t bucketEnd = rung.start + (rung.current + 1) * rung.width;
+      ++rung.current;
+      rung.count -= bucket.size ();
+
+      if (bucket.size () > m_threshold && m_nRungs < m_maxRungs)
+        {
+          uint64_t minTs = bucket.front ().key.m_ts;
+          uint64_t maxTs = minTs;
+          for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+            {
+              minTs = std::min (minTs, i->key.m_ts);
+              maxTs = std::max (maxTs, i->key.m_ts);
+            }
+          if (minTs != maxTs)
+            {
+              SpawnRung (bucket, minTs, bucketEnd);
+              continue;
+            }
+        }
+
+      m_bottom.swap (bucket);
+      std::sort (m_bottom.begin (), m_bottom.end ());
+      return;
+    }
+}
+
+void
+LadderScheduler::Advance (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      if (m_qSize == 0)
+        {
+          Reset ();
+          return;
+        }
+      while (m_bottomHead < m_bottom.size ())
+        {
+          if (m_removed.empty ())
+            {
+              return;
+            }
+          std::unordered_set<uint32_t>::iterator i =
+            m_removed.find (m_bottom[m_bottomHead].key.m_uid);
+          if (i == m_removed.end ())
+            {
+              return;
+            }
+          m_removed.erase (i);
+          ++m_bottomHead;
+        }
+      m_bottom.clear ();
+      m_bottomHead = 0;
+      RefillBottom ();
+    }
+}
+
+void
+LadderScheduler::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+      Rung &rung = m_rungs[i];
+      for (uint32_t j = rung.current; j < rung.nBuckets; ++j)
+        {
+          rung.buckets[j].clear ();
+        }
+    }
+  m_nRungs = 0;
+  m_top.clear ();
+  m_topMin = 0;
+  m_topMax = 0;
+  m_topStart = 0;
+  m_bottom.clear ();
+  m_bottomHead = 0;
+  m_removed.clear ();
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Scheduler::Event ev = m_bottom[m_bottomHead];
+  ++m_bottomHead;
+  --m_qSize;
+  Advance ();
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  --m_qSize;
+  if (m_bottom[m_bottomHead].key == ev.key)
+    {
+      ++m_bottomHead;
+    }
+  else
+    {
+      m_removed.insert (ev.key.m_uid);
+    }
+  Advance ();
+}
+
+} // namespace ns3
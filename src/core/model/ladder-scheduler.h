@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+#include <unordered_set>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh
+ * and Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The event set is split in three tiers:
+ *
+ * - *Top*: an unsorted `std::vector` holding every event whose
+ *   time stamp is at or beyond the end of the current epoch.
+ * - *Rungs*: a small stack of calendar-like arrays of buckets.
+ *   When the rungs run dry the whole Top is spread over a new
+ *   first rung; a bucket holding more than \c Threshold events
+ *   is in turn spread over a finer rung below it, up to
+ *   \c MaxRungs levels.
+ * - *Bottom*: a short sorted `std::vector` from which events are
+ *   dequeued.  It is refilled by sorting the next non-empty
+ *   bucket of the lowest rung.
+ *
+ * Unlike the CalendarScheduler the bucket width is derived from the
+ * actual span of the events being spread, so there is never a global
+ * resize.  Buckets are `std::vector<>`, and the rung and bucket
+ * storage is kept across epochs, so in steady state no memory is
+ * allocated.
+ *
+ * Events removed with Remove() are not searched for; their uid is
+ * recorded and the event is dropped when it reaches the head of
+ * Bottom.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to Top or a bucket; short sorted insert in Bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Head of Bottom
+ * Remove()     | ~Constant       | `std::unordered_set::insert()`
+ * RemoveNext() | ~Constant       | Each event is moved at most \c MaxRungs + 1 times
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | Rung bucket arrays               | `std::vector`
+ * Per Event | `sizeof (Scheduler::Event)`<br/>(24 bytes) | `std::vector`
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Ladder bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A single rung of the ladder. */
+  struct Rung
+  {
+    std::vector<Bucket> buckets; /**< The buckets, reused across epochs. */
+    uint32_t nBuckets;           /**< Number of buckets in use. */
+    uint64_t start;              /**< Time stamp at the start of bucket 0. */
+    uint64_t width;              /**< Bucket width, in dimensionless time units. */
+    uint32_t current;            /**< Index of the next bucket to dequeue. */
+    uint32_t count;              /**< Number of events stored in this rung. */
+  };
+
+  /**
+   * Insert an event in Bottom, keeping it sorted.
+   *
+   * \param [in] ev The new Event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /**
+   * Distribute a set of events over a new rung.
+   *
+   * \param [in,out] events The events to spread; cleared on return.
+   * \param [in] start The time stamp at the start of the new rung.
+   * \param [in] end The time stamp just past the end of the new rung.
+   */
+  void SpawnRung (Bucket &events, uint64_t start, uint64_t end);
+  /**
+   * Move the next non-empty bucket of the lowest rung, or the Top
+   * if the rungs are empty, into Bottom.
+   */
+  void RefillBottom (void);
+  /**
+   * Restore the invariant that, when the scheduler is not empty,
+   * the head of Bottom is the earliest live event.
+   */
+  void Advance (void);
+  /** Forget all stored events, including removed ones. */
+  void Reset (void);
+
+  /** Top: unsorted events at or beyond \c m_topStart. */
+  Bucket m_top;
+  /** Earliest time stamp in Top. */
+  uint64_t m_topMin;
+  /** Latest time stamp in Top. */
+  uint64_t m_topMax;
+  /** Start of Top; events earlier than this live in the rungs or Bottom. */
+  uint64_t m_topStart;
+  /** The rungs; only the first \c m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Bottom: sorted events, dequeued from \c m_bottomHead. */
+  Bucket m_bottom;
+  /** Index of the earliest event in Bottom. */
+  std::size_t m_bottomHead;
+  /** Uids of removed events still stored in the ladder. */
+  std::unordered_set<uint32_t> m_removed;
+  /** Number of live events in queue. */
+  uint32_t m_qSize;
+  /** Bucket size above which a new rung is spawned. */
+  uint32_t m_threshold;
+  /** Maximum number of rungs. */
+  uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
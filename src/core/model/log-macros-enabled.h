@@ -179,6 +179,9 @@
  * NS_LOG (LOG_DEBUG, "a number="<<aNumber<<", anotherNumber="<<anotherNumber);
  * \endcode
  *
+ * While a BinaryLog is open, the message is recorded in it instead
+ * of printed on \c std::clog.
+ *
  * \param [in] level The log level
  * \param [in] msg The message to log
  * \internal
@@ -189,6 +192,17 @@
   do {                                                          \
       if (g_log.IsEnabled (level))                              \
         {                                                       \
+          if (ns3::BinaryLog::IsOpen ())                        \
+            {                                                   \
+              static ns3::BinaryLogSite                         \
+                binaryLogSite (ns3::BinaryLogSite::MESSAGE);    \
+              ns3::BinaryLogRecord binaryLogRecord (binaryLogSite, \
+                                                    g_log,      \
+                                                    __FUNCTION__, \
+                                                    level);     \
+              binaryLogRecord << msg;                           \
+              break;                                            \
+            }                                                   \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
@@ -211,6 +225,16 @@
   do {                                                          \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
+          if (ns3::BinaryLog::IsOpen ())                        \
+            {                                                   \
+              static ns3::BinaryLogSite                         \
+                binaryLogSite (ns3::BinaryLogSite::FUNCTION);   \
+              ns3::BinaryLogRecord binaryLogRecord (binaryLogSite, \
+                                                    g_log,      \
+                                                    __FUNCTION__, \
+                                                    ns3::LOG_FUNCTION); \
+              break;                                            \
+            }                                                   \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
@@ -247,6 +271,17 @@
     {                                                           \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
+          if (ns3::BinaryLog::IsOpen ())                        \
+            {                                                   \
+              static ns3::BinaryLogSite                         \
+                binaryLogSite (ns3::BinaryLogSite::FUNCTION);   \
+              ns3::BinaryLogRecord binaryLogRecord (binaryLogSite, \
+                                                    g_log,      \
+                                                    __FUNCTION__, \
+                                                    ns3::LOG_FUNCTION); \
+              ns3::BinaryParameterLogger (binaryLogRecord) << parameters; \
+              break;                                            \
+            }                                                   \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
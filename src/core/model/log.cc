@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "log.h"
+#include "simulation-instance.h"
 
 #include <list>
 #include <utility>
@@ -41,15 +42,19 @@ namespace ns3 {
 
 /**
  * \ingroup logging
- * The Log TimePrinter.
+ * The Log TimePrinter and NodePrinter of a SimulationInstance.
  * This is private to the logging implementation.
  */
-static TimePrinter g_logTimePrinter = 0;
-/**
- * \ingroup logging
- * The Log NodePrinter.
- */
-static NodePrinter g_logNodePrinter = 0;
+struct LogPrinters
+{
+  /** Constructor. */
+  LogPrinters ()
+    : time (0),
+      node (0)
+  {}
+  TimePrinter time;  //!< The Log TimePrinter.
+  NodePrinter node;  //!< The Log NodePrinter.
+};
 
 /**
  * \ingroup logging
@@ -619,7 +624,7 @@ static void CheckEnvironmentVariables (void)
 }
 void LogSetTimePrinter (TimePrinter printer)
 {
-  g_logTimePrinter = printer;
+  InstanceSingleton<LogPrinters>::Get ()->time = printer;
   /** \internal
    *  This is the only place where we are more or less sure that all log variables
    * are registered. See \bugid{1082} for details.
@@ -628,16 +633,16 @@ void LogSetTimePrinter (TimePrinter printer)
 }
 TimePrinter LogGetTimePrinter (void)
 {
-  return g_logTimePrinter;
+  return InstanceSingleton<LogPrinters>::Get ()->time;
 }
 
 void LogSetNodePrinter (NodePrinter printer)
 {
-  g_logNodePrinter = printer;
+  InstanceSingleton<LogPrinters>::Get ()->node = printer;
 }
 NodePrinter LogGetNodePrinter (void)
 {
-  return g_logNodePrinter;
+  return InstanceSingleton<LogPrinters>::Get ()->node;
 }
 
 
@@ -52,6 +52,14 @@ EventImpl * MakeEvent (void (*f)(void))
       (*m_function)();
     }
 
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
+
   private:
     F m_function;
   } *ev = new EventFunctionImpl0 (f);
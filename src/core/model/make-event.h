@@ -30,6 +30,10 @@ namespace ns3 {
 
 class EventImpl;
 
+template <typename R, typename T1, typename T2, typename T3, typename T4,
+          typename T5, typename T6, typename T7, typename T8, typename T9>
+class Callback;
+
 /**
  * \ingroup events
  * \defgroup makeeventmemptr MakeEvent from Member Function Pointer.
@@ -355,6 +359,53 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Get the type of the implementation of a Callback, which tells apart in
+ * profiles the events calling Callback::operator().
+ *
+ * This is the generic version, for the other classes.
+ *
+ * \tparam T \deduced The class type.
+ * \param [in] object The object.
+ * \returns 0.
+ */
+template <typename T>
+const std::type_info * GetEventCallbackType (const T &object)
+{
+  return 0;
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * \copybrief GetEventCallbackType(const T&)
+ *
+ * This is the version for Callback.
+ *
+ * \tparam R \deduced The return type of the Callback.
+ * \tparam T1 \deduced The type of the first argument.
+ * \tparam T2 \deduced The type of the second argument.
+ * \tparam T3 \deduced The type of the third argument.
+ * \tparam T4 \deduced The type of the fourth argument.
+ * \tparam T5 \deduced The type of the fifth argument.
+ * \tparam T6 \deduced The type of the sixth argument.
+ * \tparam T7 \deduced The type of the seventh argument.
+ * \tparam T8 \deduced The type of the eighth argument.
+ * \tparam T9 \deduced The type of the ninth argument.
+ * \param [in] callback The Callback.
+ * \returns The type of the implementation of \p callback, or 0 if it is null.
+ */
+template <typename R, typename T1, typename T2, typename T3, typename T4,
+          typename T5, typename T6, typename T7, typename T8, typename T9>
+const std::type_info * GetEventCallbackType (const Callback<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> &callback)
+{
+  if (callback.IsNull ())
+    {
+      return 0;
+    }
+  return &typeid (*PeekPointer (callback.GetImpl ()));
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -374,6 +425,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -404,6 +462,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -435,6 +500,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -468,6 +540,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -503,6 +582,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -541,6 +627,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -581,6 +674,13 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = GetEventCallbackType (EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+      return &m_function;
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -616,6 +716,13 @@ EventImpl * MakeEvent (void (*f)(U1), T1 a1)
     {
       (*m_function)(m_a1);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -646,6 +753,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2), T1 a1, T2 a2)
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -679,6 +793,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -714,6 +835,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -751,6 +879,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -790,6 +925,13 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * PeekFunction (std::size_t *size,
+                                       const std::type_info **callback) const
+    {
+      *size = sizeof (m_function);
+      *callback = 0;
+      return &m_function;
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "non-copyable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A lock-free queue with many producers and one consumer.
+ *
+ * The simulator implementations use it to receive the events that
+ * other threads, like the readers of FdNetDevice and TapBridge, schedule
+ * with Simulator::ScheduleWithContext.
+ *
+ * The queue is a ring of cells, each with a sequence number which tells
+ * whether the cell is free for the producer, or full for the consumer,
+ * of a given position.  A producer reserves a position with one atomic
+ * compare and swap, and the consumer takes the values without any
+ * atomic read-modify-write operation.  When the ring is full, Push()
+ * spills the values into a list protected by a mutex, until the consumer
+ * has emptied it: the consumer may not be running, before
+ * Simulator::Run() or after Simulator::Stop(), so Push() never waits
+ * for it.
+ *
+ * \tparam T \explicit The type of the values, which must be default
+ *           constructible and copy assignable.
+ */
+template <typename T>
+class MpscQueue : private NonCopyable
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] capacity The capacity of the queue, rounded up to a
+   *             power of two.
+   */
+  MpscQueue (std::size_t capacity = 1024);
+  /** Destructor. */
+  ~MpscQueue ();
+
+  /**
+   * Add a value to the ring, if it is not full.  Thread safe.  Unlike
+   * Push(), it does not keep the value behind the spilled values.
+   *
+   * \param [in] value The value.
+   * \returns \c true if the value was added.
+   */
+  bool TryPush (const T &value);
+  /**
+   * Add a value to the queue, spilling it out of the ring if the ring
+   * is full.  Thread safe, and never blocks for the consumer.
+   *
+   * \param [in] value The value.
+   */
+  void Push (const T &value);
+  /**
+   * Remove the oldest value of the queue.  Only called by the consumer.
+   *
+   * \param [out] value The value.
+   * \returns \c true if there was a value.
+   */
+  bool Pop (T &value);
+  /**
+   * Check if the queue is empty.  Only called by the consumer.
+   *
+   * \returns \c true if there is no value to Pop().
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /** A cell of the ring. */
+  struct Cell
+  {
+    /**
+     * The position the cell is free for, or the position plus one if
+     * the cell holds the value of that position.
+     */
+    std::atomic<std::size_t> sequence;
+    T value;  //!< The value.
+  };
+
+  /** Cache line size, to keep the producer and consumer positions apart. */
+  static const std::size_t CACHE_LINE = 64;
+
+  Cell *m_cells;       //!< The ring.
+  std::size_t m_mask;  //!< The size of the ring minus one.
+  /** Padding. */
+  char m_pad0[CACHE_LINE - sizeof (Cell *) - sizeof (std::size_t)];
+  /** The next position of the producers. */
+  std::atomic<std::size_t> m_tail;
+  /** Padding. */
+  char m_pad1[CACHE_LINE - sizeof (std::atomic<std::size_t>)];
+  /** The next position of the consumer. */
+  std::size_t m_head;
+
+  /** The values pushed while the ring was full, oldest first. */
+  std::deque<T> m_overflow;
+  /** Protects m_overflow. */
+  std::mutex m_overflowMutex;
+  /** The number of values in m_overflow, read without the mutex. */
+  std::atomic<std::size_t> m_overflowSize;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue (std::size_t capacity)
+{
+  std::size_t size = 2;
+  while (size < capacity)
+    {
+      size *= 2;
+    }
+  m_cells = new Cell[size];
+  m_mask = size - 1;
+  for (std::size_t i = 0; i < size; ++i)
+    {
+      m_cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+  m_tail.store (0, std::memory_order_relaxed);
+  m_head = 0;
+  m_overflowSize.store (0, std::memory_order_relaxed);
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue ()
+{
+  delete [] m_cells;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TryPush (const T &value)
+{
+  std::size_t position = m_tail.load (std::memory_order_relaxed);
+  for (;;)
+    {
+      Cell *cell = &m_cells[position & m_mask];
+      std::size_t sequence = cell->sequence.load (std::memory_order_acquire);
+      std::ptrdiff_t difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) position;
+      if (difference == 0)
+        {
+          // The cell is free: reserve it.
+          if (m_tail.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+            {
+              cell->value = value;
+              cell->sequence.store (position + 1, std::memory_order_release);
+              return true;
+            }
+          // position was updated by the failed compare_exchange
+        }
+      else if (difference < 0)
+        {
+          // The cell still holds the value of the previous lap: full.
+          return false;
+        }
+      else
+        {
+          // Another producer took this position.
+          position = m_tail.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push (const T &value)
+{
+  // Once values have spilled, keep the later ones behind them.
+  if (m_overflowSize.load (std::memory_order_acquire) == 0 && TryPush (value))
+    {
+      return;
+    }
+  std::lock_guard<std::mutex> lock (m_overflowMutex);
+  m_overflow.push_back (value);
+  m_overflowSize.store (m_overflow.size (), std::memory_order_release);
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &value)
+{
+  // Read the size of the overflow first: the values which a producer
+  // pushed to the ring before spilling are then visible in the ring.
+  std::size_t overflowSize = m_overflowSize.load (std::memory_order_acquire);
+  Cell *cell = &m_cells[m_head & m_mask];
+  if (cell->sequence.load (std::memory_order_acquire) != m_head + 1)
+    {
+      if (overflowSize == 0)
+        {
+          return false;
+        }
+      std::lock_guard<std::mutex> lock (m_overflowMutex);
+      value = m_overflow.front ();
+      m_overflow.pop_front ();
+      m_overflowSize.store (m_overflow.size (), std::memory_order_release);
+      return true;
+    }
+  value = cell->value;
+  cell->value = T ();
+  // Free the cell for the producer of the next lap.
+  cell->sequence.store (m_head + m_mask + 1, std::memory_order_release);
+  m_head++;
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_cells[m_head & m_mask].sequence.load (std::memory_order_acquire) != m_head + 1
+         && m_overflowSize.load (std::memory_order_acquire) == 0;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
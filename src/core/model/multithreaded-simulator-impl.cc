@@ -0,0 +1,886 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "make-event.h"
+#include "uinteger.h"
+#include "simulation-instance.h"
+
+#include "assert.h"
+#include "abort.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Marker of the contexts without an assigned partition. */
+const uint32_t NO_PARTITION = 0xffffffff;
+
+} // unnamed namespace
+
+thread_local MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::m_current = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The number of partitions, each run by its own thread; "
+                   "0 means one per hardware thread.  Without NS3_MTP "
+                   "a single partition is used.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::SetThreadCount,
+                                         &MultithreadedSimulatorImpl::GetThreadCount),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Lookahead",
+                   "The minimum delay of the events scheduled from one "
+                   "partition for another.  Zero disables parallelism.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::SetLookahead,
+                                     &MultithreadedSimulatorImpl::GetLookahead),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_nPartitions (0),
+    m_dirty (false),
+    m_threadCount (0),
+    m_lookahead (0),
+    m_windowEnd (0),
+    m_stop (false),
+    m_running (false),
+    m_started (false),
+    m_window (0),
+    m_pending (0),
+    m_quit (false),
+    m_eventsWithContextEmpty (true),
+    m_main (std::this_thread::get_id ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopThreads ();
+  ProcessEventsWithContext ();
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *p = *i;
+      while (!p->events->IsEmpty ())
+        {
+          Scheduler::Event next = p->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      for (uint32_t j = 0; j < p->outbox.size (); ++j)
+        {
+          for (uint32_t k = 0; k < p->outbox[j].size (); ++k)
+            {
+              p->outbox[j][k].impl->Unref ();
+            }
+        }
+      delete p;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  if (m_partitions.empty ())
+    {
+      Repartition ();
+      return;
+    }
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+      while (!(*i)->events->IsEmpty ())
+        {
+          scheduler->Insert ((*i)->events->RemoveNext ());
+        }
+      (*i)->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Repartition (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_running);
+  uint32_t n = m_threadCount;
+  if (n == 0)
+    {
+      n = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+  if (m_lookahead == 0)
+    {
+      n = 1;
+    }
+#ifndef NS3_MTP
+  // Without atomic reference counts, objects shared by the partitions
+  // would be corrupted: run a single partition, as Ensemble::Run does.
+  if (n > 1)
+    {
+      NS_LOG_WARN ("Built without NS3_MTP: running a single partition instead of " << n);
+      n = 1;
+    }
+#endif
+  Partition *oldGlobal = m_partitions.empty () ? 0 : m_partitions.back ();
+  std::vector<Partition *> old;
+  old.swap (m_partitions);
+  m_nPartitions = n;
+  for (uint32_t i = 0; i <= n; ++i)
+    {
+      Partition *p = new Partition ();
+      p->owner = this;
+      p->index = i;
+      p->events = m_schedulerFactory.Create<Scheduler> ();
+      // uids are allocated from 4, see DefaultSimulatorImpl
+      p->uid = oldGlobal ? oldGlobal->uid : 4;
+      p->currentUid = 0;
+      p->currentTs = oldGlobal ? oldGlobal->currentTs : 0;
+      p->currentContext = Simulator::NO_CONTEXT;
+      p->eventCount = 0;
+      p->stopTs = std::numeric_limits<uint64_t>::max ();
+      p->outbox.resize (n + 1);
+      m_partitions.push_back (p);
+    }
+  m_dirty = false;
+  // Before the first Run() all the uids come from the global
+  // partition, so the keys are unique across partitions.
+  for (std::vector<Partition *>::iterator i = old.begin (); i != old.end (); ++i)
+    {
+      while (!(*i)->events->IsEmpty ())
+        {
+          Scheduler::Event ev = (*i)->events->RemoveNext ();
+          Lookup (ev.key.m_context)->events->Insert (ev);
+        }
+      delete *i;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ABORT_MSG_IF (m_started, "Partitions must be assigned before Simulator::Run");
+  if (context >= m_partitionOf.size ())
+    {
+      m_partitionOf.resize (context + 1, NO_PARTITION);
+    }
+  m_partitionOf[context] = partition;
+  m_dirty = true;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  return Lookup (context)->index;
+}
+
+void
+MultithreadedSimulatorImpl::SetThreadCount (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  NS_ABORT_MSG_IF (m_started, "ThreadCount must be set before Simulator::Run");
+  m_threadCount = threads;
+  if (!m_partitions.empty ())
+    {
+      Repartition ();
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetThreadCount (void) const
+{
+  return m_threadCount;
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (Time lookahead)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  NS_ABORT_MSG_IF (m_started, "Lookahead must be set before Simulator::Run");
+  m_lookahead = lookahead.GetTimeStep ();
+  if (!m_partitions.empty ())
+    {
+      Repartition ();
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::Lookup (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return m_partitions[m_nPartitions];
+    }
+  uint32_t index = context;
+  if (context < m_partitionOf.size () && m_partitionOf[context] != NO_PARTITION)
+    {
+      index = m_partitionOf[context];
+    }
+  return m_partitions[index % m_nPartitions];
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::Current (void) const
+{
+  Partition *p = m_current;
+  if (p != 0 && p->owner == this)
+    {
+      return p;
+    }
+  return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemote (uint32_t context)
+{
+  Partition *p = m_current;
+  return p != 0 && p->owner->Lookup (context) != p;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition *p, EventImpl *impl, uint64_t ts, uint32_t context)
+{
+  Scheduler::Event ev;
+  ev.impl = impl;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = m_started ? p->uid++ : m_partitions[m_nPartitions]->uid++;
+  p->events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::StartThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_quit = false;
+  for (uint32_t i = 1; i < m_nPartitions; ++i)
+    {
+      m_threads.push_back (std::thread (&MultithreadedSimulatorImpl::DoWorker, this, i, m_window,
+                                        SimulationInstance::GetCurrent ()));
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_quit = true;
+  }
+  m_startCv.notify_all ();
+  for (std::vector<std::thread>::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      i->join ();
+    }
+  m_threads.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::DoWorker (uint32_t index, uint64_t window, SimulationInstance *instance)
+{
+  // the events use the singletons of the simulation
+  SimulationInstance::SetCurrent (instance);
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (!m_quit && m_window == window)
+          {
+            m_startCv.wait (lock);
+          }
+        if (m_quit)
+          {
+            SimulationInstance::SetCurrent (0);
+            return;
+          }
+        window = m_window;
+      }
+      Partition *p = m_partitions[index];
+      m_current = p;
+      ProcessWindow (p);
+      m_current = 0;
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        if (--m_pending == 0)
+          {
+            m_doneCv.notify_one ();
+          }
+      }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition *p)
+{
+  uint64_t end = m_windowEnd;
+  while (!p->events->IsEmpty ()
+         && p->events->PeekNext ().key.m_ts < end
+         && p->events->PeekNext ().key.m_ts <= p->stopTs
+         && !m_stop.load (std::memory_order_relaxed))
+    {
+      Scheduler::Event next = p->events->RemoveNext ();
+
+      NS_ASSERT (next.key.m_ts >= p->currentTs);
+      p->eventCount++;
+      p->currentTs = next.key.m_ts;
+      p->currentContext = next.key.m_context;
+      p->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvent (void)
+{
+  Partition *global = m_partitions[m_nPartitions];
+  Scheduler::Event next = global->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= global->currentTs);
+  global->eventCount++;
+  global->currentTs = next.key.m_ts;
+  global->currentContext = next.key.m_context;
+  global->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ExchangeEvents (void)
+{
+  for (uint32_t i = 0; i < m_nPartitions; ++i)
+    {
+      Partition *src = m_partitions[i];
+      for (uint32_t j = 0; j <= m_nPartitions; ++j)
+        {
+          std::vector<RemoteEvent> &outbox = src->outbox[j];
+          for (std::vector<RemoteEvent>::const_iterator k = outbox.begin (); k != outbox.end (); ++k)
+            {
+              Insert (m_partitions[j], k->impl, k->ts, k->context);
+            }
+          outbox.clear ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEventsWithContext (void)
+{
+  if (m_eventsWithContextEmpty)
+    {
+      return;
+    }
+
+  // swap queues
+  EventsWithContext eventsWithContext;
+  {
+    std::lock_guard<std::mutex> lock (m_eventsWithContextMutex);
+    m_eventsWithContext.swap (eventsWithContext);
+    m_eventsWithContextEmpty = true;
+  }
+  // No partition is running: the current time is the latest clock.
+  uint64_t now = 0;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      now = std::max (now, (*i)->currentTs);
+    }
+  while (!eventsWithContext.empty ())
+    {
+      EventWithContext event = eventsWithContext.front ();
+      eventsWithContext.pop_front ();
+      Insert (Lookup (event.context), event.event, now + event.timestamp, event.context);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = std::this_thread::get_id ();
+  if (m_dirty)
+    {
+      Repartition ();
+    }
+  if (!m_started)
+    {
+      // From now on each partition allocates its own uids.
+      uint32_t uid = m_partitions[m_nPartitions]->uid;
+      for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          (*i)->uid = uid;
+        }
+      m_started = true;
+    }
+  StartThreads ();
+  NS_LOG_INFO ("run " << m_nPartitions << " partitions, lookahead " << m_lookahead);
+
+  Partition *global = m_partitions[m_nPartitions];
+  Partition *saved = m_current;
+  m_current = global;
+  m_stop = false;
+  m_running = true;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      (*i)->stopTs = std::numeric_limits<uint64_t>::max ();
+    }
+  while (!m_stop)
+    {
+      ProcessEventsWithContext ();
+      ExchangeEvents ();
+
+      uint64_t next = std::numeric_limits<uint64_t>::max ();
+      for (uint32_t i = 0; i < m_nPartitions; ++i)
+        {
+          if (!m_partitions[i]->events->IsEmpty ())
+            {
+              next = std::min (next, m_partitions[i]->events->PeekNext ().key.m_ts);
+            }
+        }
+      bool haveGlobal = !global->events->IsEmpty ();
+      uint64_t nextGlobal = haveGlobal ? global->events->PeekNext ().key.m_ts : std::numeric_limits<uint64_t>::max ();
+      if (!haveGlobal && next == std::numeric_limits<uint64_t>::max ())
+        {
+          break;
+        }
+      // The earliest stop time requested from a partition.
+      uint64_t stopTs = std::numeric_limits<uint64_t>::max ();
+      for (uint32_t i = 0; i < m_nPartitions; ++i)
+        {
+          stopTs = std::min (stopTs, m_partitions[i]->stopTs);
+        }
+      if (std::min (next, nextGlobal) > stopTs)
+        {
+          m_stop = true;
+          break;
+        }
+      if (haveGlobal && nextGlobal <= next)
+        {
+          ProcessGlobalEvent ();
+          continue;
+        }
+
+      // A zero lookahead means a single partition: the window must
+      // still include the next event.
+      uint64_t width = std::max (m_lookahead, static_cast<uint64_t> (1));
+      uint64_t end = next + std::min (width, std::numeric_limits<uint64_t>::max () - next);
+      m_windowEnd = std::min (end, nextGlobal);
+      if (stopTs < m_windowEnd)
+        {
+          m_windowEnd = stopTs + 1;
+        }
+
+      // Run a lone active partition on this thread.
+      Partition *active = 0;
+      uint32_t nActive = 0;
+      for (uint32_t i = 0; i < m_nPartitions; ++i)
+        {
+          if (!m_partitions[i]->events->IsEmpty ()
+              && m_partitions[i]->events->PeekNext ().key.m_ts < m_windowEnd)
+            {
+              active = m_partitions[i];
+              nActive++;
+            }
+        }
+      if (nActive == 1)
+        {
+          m_current = active;
+          ProcessWindow (active);
+          m_current = global;
+          continue;
+        }
+
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_pending = m_nPartitions - 1;
+        m_window++;
+      }
+      m_startCv.notify_all ();
+      m_current = m_partitions[0];
+      ProcessWindow (m_partitions[0]);
+      m_current = global;
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        while (m_pending != 0)
+          {
+            m_doneCv.wait (lock);
+          }
+      }
+    }
+  m_running = false;
+  m_current = saved;
+  // No thread is left behind between two runs, see Checkpoint::Fork().
+  StopThreads ();
+
+  // Simulator::Now() outside of Run() is the time of the last event.
+  for (uint32_t i = 0; i < m_nPartitions; ++i)
+    {
+      global->currentTs = std::max (global->currentTs, m_partitions[i]->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Partition *p = Current ();
+  if (p != 0 && p->index != m_nPartitions)
+    {
+      // ProcessWindow() applies it to this partition, and Run() to
+      // the next windows, as the others may already be past it.
+      p->stopTs = std::min (p->stopTs, p->currentTs + delay.GetTimeStep ());
+      return;
+    }
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  Partition *p = Current ();
+  if (p == 0)
+    {
+      NS_ASSERT_MSG (!m_running && std::this_thread::get_id () == m_main,
+                     "Simulator::Schedule Thread-unsafe invocation!");
+      p = m_partitions[m_nPartitions];
+    }
+  uint64_t ts = p->currentTs + delay.GetTimeStep ();
+  uint32_t uid = Insert (p, event, ts, p->currentContext);
+  return EventId (event, ts, p->currentContext, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Partition *p = Current ();
+  if (p == 0)
+    {
+      if (!m_running && std::this_thread::get_id () == m_main)
+        {
+          Partition *global = m_partitions[m_nPartitions];
+          Insert (Lookup (context), event, global->currentTs + delay.GetTimeStep (), context);
+        }
+      else
+        {
+          EventWithContext ev;
+          ev.context = context;
+          // Current time added in ProcessEventsWithContext()
+          ev.timestamp = delay.GetTimeStep ();
+          ev.event = event;
+          {
+            std::lock_guard<std::mutex> lock (m_eventsWithContextMutex);
+            m_eventsWithContext.push_back (ev);
+            m_eventsWithContextEmpty = false;
+          }
+        }
+      return;
+    }
+
+  uint64_t ts = p->currentTs + delay.GetTimeStep ();
+  Partition *dst = Lookup (context);
+  // The global partition only runs while the others are paused.
+  if (dst == p || p->index == m_nPartitions)
+    {
+      Insert (dst, event, ts, context);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      // The destination may already have run past ts.
+      NS_LOG_WARN ("Event for context " << context << " at " << TimeStep (ts).As (Time::S) <<
+                   " violates the lookahead of " << TimeStep (m_lookahead).As (Time::S) <<
+                   " between partitions " << p->index << " and " << dst->index <<
+                   ", delayed to " << TimeStep (m_windowEnd).As (Time::S));
+      ts = m_windowEnd;
+    }
+  RemoteEvent ev;
+  ev.impl = event;
+  ev.ts = ts;
+  ev.context = context;
+  p->outbox[dst->index].push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  std::lock_guard<std::mutex> lock (m_destroyEventsMutex);
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Partition *p = Current ();
+  if (p == 0)
+    {
+      p = m_partitions[m_nPartitions];
+    }
+  return TimeStep (p->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - Now ().GetTimeStep ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  Partition *p = Current ();
+  if (p == 0 && m_dirty)
+    {
+      Repartition ();
+    }
+  Partition *owner = Lookup (id.GetContext ());
+  if (p != owner && (p == 0 || p->index != m_nPartitions))
+    {
+      if (p != 0 || m_running)
+        {
+          // The event may be running on another thread.
+          Cancel (id);
+          return;
+        }
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  owner->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      std::lock_guard<std::mutex> lock (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0)
+    {
+      return true;
+    }
+  const Partition *owner = Lookup (id.GetContext ());
+  if (id.GetTs () < owner->currentTs
+      || (id.GetTs () == owner->currentTs && id.GetUid () <= owner->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *p = Current ();
+  if (p == 0)
+    {
+      p = m_partitions[m_nPartitions];
+    }
+  return p->currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      count += (*i)->eventCount;
+    }
+  return count;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+      for (uint32_t j = 0; j < (*i)->outbox.size (); ++j)
+        {
+          if (!(*i)->outbox[j].empty ())
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,346 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "object-factory.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+class SimulationInstance;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A shared-memory parallel simulator implementation.
+ *
+ * Events are partitioned by their execution context: each context
+ * (normally a Node id) is assigned to one partition, and each
+ * partition has its own event queue and is run by its own thread.
+ * Events without a context (Simulator::NO_CONTEXT) are global: they
+ * run on the thread which called Simulator::Run, while all the
+ * partitions are paused.
+ *
+ * The partitions are synchronized conservatively.  The simulation
+ * advances in windows: if \c T is the timestamp of the earliest
+ * pending event, all the partitions concurrently run their events
+ * earlier than \c T + \c Lookahead (and earlier than the next global
+ * event), then wait for each other.  An event scheduled by one
+ * partition for a context of another partition is therefore required
+ * to be at least \c Lookahead in the future; it is appended to a
+ * per-partition outbox and inserted in the destination queue at the
+ * end of the window.  The outboxes are single-producer buffers which
+ * are only read once all the threads are stopped, so no lock is taken
+ * on the event path.  An event scheduled for another partition
+ * earlier than the end of the current window violates the lookahead:
+ * it is delayed to the end of the window, with a warning, as the
+ * destination may already have run past its timestamp.
+ *
+ * The lookahead is normally the smallest propagation delay of the
+ * links between partitions.  PartitionHelper computes the
+ * partitions and the lookahead from the channels of the topology.
+ * Without it, context \c c runs in partition \c c modulo the number
+ * of partitions.  When the lookahead is zero, a single partition is
+ * used and this implementation behaves like DefaultSimulatorImpl.
+ *
+ * The execution is deterministic: within a partition, events are
+ * ordered by timestamp and then by insertion order, and the events
+ * which cross partitions are inserted in partition order.  The order
+ * of events with equal timestamps may differ from
+ * DefaultSimulatorImpl.
+ *
+ * Models run concurrently, so any state shared between partitions
+ * must be protected.  In particular, the reference counts of objects
+ * referenced from more than one partition (net devices, channels)
+ * are only atomic when ns-3 is built with \c NS3_MTP, and packets
+ * must be deep copied when they cross partitions (see IsRemote()).
+ * Without \c NS3_MTP, a single partition is run whatever the
+ * \c ThreadCount attribute.
+ * Some restrictions remain compared to DefaultSimulatorImpl:
+ *
+ *   - Global events run before the partition events with the same
+ *     timestamp.
+ *   - Simulator::Stop() ends the current window of the other
+ *     partitions early.  Simulator::Stop(delay) called from a
+ *     partition stops this partition after its events up to the
+ *     stop time, and the others at the first window boundary after
+ *     it, so when the stop time falls within the current window, the
+ *     other partitions still run the rest of the window.
+ *   - Simulator::Remove(), Simulator::IsExpired() and
+ *     Simulator::GetDelayLeft() only give exact answers for events of
+ *     the calling partition; removing an event of another partition
+ *     cancels it.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * Assign a context to a partition.
+   *
+   * Must not be called while the simulation is running.
+   *
+   * \param [in] context The context, normally a Node id.
+   * \param [in] partition The partition, modulo the number of threads.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * Get the partition which runs the events of a context.
+   *
+   * \param [in] context The context.
+   * \returns The partition index, or the number of partitions for
+   *          Simulator::NO_CONTEXT.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * Set the number of threads, see the \c ThreadCount attribute.
+   * \param [in] threads The number of threads, or 0 for one per core.
+   */
+  void SetThreadCount (uint32_t threads);
+  /**
+   * Get the number of threads, see the \c ThreadCount attribute.
+   * \returns The number of threads.
+   */
+  uint32_t GetThreadCount (void) const;
+  /**
+   * Set the lookahead, see the \c Lookahead attribute.
+   * \param [in] lookahead The minimum delay of cross-partition events.
+   */
+  void SetLookahead (Time lookahead);
+  /**
+   * Get the lookahead, see the \c Lookahead attribute.
+   * \returns The minimum delay of cross-partition events.
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * Check whether the events of a context run on another thread than
+   * the calling event.
+   *
+   * Channels use this to deep copy the packets they deliver to
+   * another partition, so that no packet buffer is shared between
+   * threads.  This is always \c false unless a
+   * MultithreadedSimulatorImpl is running.
+   *
+   * \param [in] context The destination context.
+   * \returns \c true if \pname{context} belongs to another partition.
+   */
+  static bool IsRemote (uint32_t context);
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled for another partition. */
+  struct RemoteEvent
+  {
+    EventImpl *impl;  /**< The event. */
+    uint64_t ts;      /**< Absolute timestamp. */
+    uint32_t context; /**< The event context. */
+  };
+  /** The event queue and clock of one partition. */
+  struct Partition
+  {
+    /** The simulator this partition belongs to. */
+    MultithreadedSimulatorImpl *owner;
+    /** Index of this partition. */
+    uint32_t index;
+    /** The event queue. */
+    Ptr<Scheduler> events;
+    /** Next event unique id. */
+    uint32_t uid;
+    /** Unique id of the current event. */
+    uint32_t currentUid;
+    /** Timestamp of the current event. */
+    uint64_t currentTs;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /** The number of events run by this partition. */
+    uint64_t eventCount;
+    /** The time of the Simulator::Stop(delay) called from this partition. */
+    uint64_t stopTs;
+    /** Events for the other partitions, indexed by destination. */
+    std::vector<std::vector<RemoteEvent> > outbox;
+  };
+  /** Wrap an event with its execution context. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /** Event delay. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+
+  /** Create the partitions and move the pending events into them. */
+  void Repartition (void);
+  /** Start the worker threads, for the duration of Run(). */
+  void StartThreads (void);
+  /** Stop and join the worker threads. */
+  void StopThreads (void);
+  /**
+   * The loop of a worker thread.
+   * \param [in] index The partition run by this thread.
+   * \param [in] window The window number when the thread started.
+   * \param [in] instance The SimulationInstance of the simulation.
+   */
+  void DoWorker (uint32_t index, uint64_t window, SimulationInstance *instance);
+  /**
+   * Run the events of a partition earlier than m_windowEnd, and not
+   * later than its stop time.
+   * \param [in] p The partition.
+   */
+  void ProcessWindow (Partition *p);
+  /** Run the next global event. */
+  void ProcessGlobalEvent (void);
+  /** Move the outboxes of all the partitions into their destinations. */
+  void ExchangeEvents (void);
+  /** Move events from foreign threads into the event queues. */
+  void ProcessEventsWithContext (void);
+  /**
+   * Insert an event in the queue of a partition.
+   * \param [in] p The partition.
+   * \param [in] impl The event.
+   * \param [in] ts The absolute timestamp.
+   * \param [in] context The event context.
+   * \returns The event unique id.
+   */
+  uint32_t Insert (Partition *p, EventImpl *impl, uint64_t ts, uint32_t context);
+  /**
+   * Get the partition which runs the events of a context.
+   * \param [in] context The context.
+   * \returns The partition.
+   */
+  Partition * Lookup (uint32_t context) const;
+  /**
+   * Get the partition of the calling thread.
+   * \returns The partition, or 0 if the caller is not running an event.
+   */
+  Partition * Current (void) const;
+
+  /** The partitions, followed by the global partition. */
+  std::vector<Partition *> m_partitions;
+  /** Number of partitions, excluding the global partition. */
+  uint32_t m_nPartitions;
+  /** Partition assigned to each context with SetPartition(). */
+  std::vector<uint32_t> m_partitionOf;
+  /** Set when the partitions must be rebuilt before running. */
+  bool m_dirty;
+  /** The scheduler type of all the partitions. */
+  ObjectFactory m_schedulerFactory;
+  /** The \c ThreadCount attribute. */
+  uint32_t m_threadCount;
+  /** The \c Lookahead attribute, in time steps. */
+  uint64_t m_lookahead;
+  /** End of the current window, exclusive. */
+  uint64_t m_windowEnd;
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** Set while Run() is executing. */
+  bool m_running;
+  /** Set once Run() has been called: the partitions are then fixed. */
+  bool m_started;
+  /** The partition run by the calling thread. */
+  static thread_local Partition *m_current;
+
+  /** The worker threads, running partitions 1 and above. */
+  std::vector<std::thread> m_threads;
+  /** Protects the window counters. */
+  std::mutex m_mutex;
+  /** Signals the start of a window to the workers. */
+  std::condition_variable m_startCv;
+  /** Signals the end of a window to Run(). */
+  std::condition_variable m_doneCv;
+  /** Window number. */
+  uint64_t m_window;
+  /** Number of workers still running the current window. */
+  uint32_t m_pending;
+  /** Set to terminate the workers. */
+  bool m_quit;
+
+  /** Container type for the events from foreign threads. */
+  typedef std::list<struct EventWithContext> EventsWithContext;
+  /** The events from foreign threads. */
+  EventsWithContext m_eventsWithContext;
+  /** Flag \c true if m_eventsWithContext is empty. */
+  std::atomic<bool> m_eventsWithContextEmpty;
+  /** Protects m_eventsWithContext. */
+  std::mutex m_eventsWithContextMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Protects m_destroyEvents. */
+  mutable std::mutex m_destroyEventsMutex;
+
+  /** Thread which called the constructor or Run(). */
+  std::thread::id m_main;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
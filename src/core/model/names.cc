@@ -22,7 +22,7 @@
 #include "assert.h"
 #include "abort.h"
 #include "names.h"
-#include "singleton.h"
+#include "simulation-instance.h"
 
 /**
  * \file
@@ -114,9 +114,9 @@ NameNode::~NameNode ()
 
 /**
  * \ingroup config
- * The singleton root Names object.
+ * The root Names object of each SimulationInstance.
  */
-class NamesPriv : public Singleton<NamesPriv>
+class NamesPriv : public InstanceSingleton<NamesPriv>
 {
 public:
   /** Constructor. */
@@ -24,9 +24,6 @@
 #include "string.h"
 #include "ns3/core-config.h"
 
-#include <cstdlib>  // getenv
-#include <cstring>  // strlen
-
 /**
  * \file
  * \ingroup object
@@ -79,90 +76,83 @@ ObjectBase::NotifyConstructionCompleted (void)
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
-  // loop over the inheritance tree back to the Object base class.
+  // loop over the attributes of the inheritance tree, gathered
+  // once per TypeId.
   NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
-  do
+  Ptr<const TypeId::ConstructionInformation> construction = GetInstanceTypeId ().GetConstructionInformation ();
+  for (std::vector<struct TypeId::AttributeConstructionInformation>::const_iterator i = construction->attributes.begin ();
+       i != construction->attributes.end (); ++i)
     {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid=" << tid.GetName () << ", params=" << tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+      NS_LOG_DEBUG ("try to construct \"" << i->tidName << "::" <<
+                    i->name << "\"");
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = attributes.Find (i->checker);
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(i->flags & TypeId::ATTR_CONSTRUCT))
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
-          NS_LOG_DEBUG ("try to construct \"" << tid.GetName () << "::" <<
-                        info.name << "\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find (info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+          // Handle this attribute if it should not be
+          // set here.
+          if (value == 0)
             {
-              // Handle this attribute if it should not be
-              // set here.
-              if (value == 0)
-                {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
-                }
-              else
-                {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name=" << info.name << " tid=" << tid.GetName () << ": initial value cannot be set using attributes");
-                }
+              // Skip this attribute if it's not in the
+              // AttributeConstructionList.
+              continue;
             }
-
-          if (value != 0)
+          else
             {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                info.name << "\"");
-                  continue;
-                }
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name=" << i->name << " tid=" << i->tidName << ": initial value cannot be set using attributes");
             }
+        }
 
-          // No matching attribute value so we try to look at the env var.
-          const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0 && std::strlen (envVar) > 0)
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (i->accessor, i->checker, *value))
             {
-              std::string env = envVar;
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
-                {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next - cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
-                    {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
-                        {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                            info.name << "\" from env var");
-                              break;
-                            }
-                        }
-                    }
-                  cur = next + 1;
-                }
+              NS_LOG_DEBUG ("construct \"" << i->tidName << "::" <<
+                            i->name << "\"");
+              continue;
             }
+        }
+
+      // No matching attribute value so we set the initial value, or
+      // the value from the NS_ATTRIBUTE_DEFAULT env var.
+      if (i->checked)
+        {
+          i->accessor->Set (this, *i->initialValue);
+        }
+      else
+        {
+          DoSet (i->accessor, i->checker, *i->initialValue);
+        }
+      NS_LOG_DEBUG ("construct \"" << i->tidName << "::" <<
+                    i->name << "\" from initial value.");
+    }
+  NotifyConstructionCompleted ();
+}
 
-          // No matching attribute value so we try to set the default value.
-          DoSet (info.accessor, info.checker, *info.initialValue);
-          NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                        info.name << "\" from initial value.");
+void
+ObjectBase::ConstructSelf (const TypeId::ConstructionInformation &construction)
+{
+  NS_LOG_FUNCTION (this << &construction);
+  for (std::vector<struct TypeId::AttributeConstructionInformation>::const_iterator i = construction.attributes.begin ();
+       i != construction.attributes.end (); ++i)
+    {
+      if (i->checked)
+        {
+          i->accessor->Set (this, *i->initialValue);
+        }
+      else
+        {
+          DoSet (i->accessor, i->checker, *i->initialValue);
         }
-      tid = tid.GetParent ();
+      NS_LOG_DEBUG ("construct \"" << i->tidName << "::" <<
+                    i->name << "\"");
     }
-  while (tid != ObjectBase::GetTypeId ());
   NotifyConstructionCompleted ();
 }
 
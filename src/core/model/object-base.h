@@ -265,6 +265,14 @@ protected:
    *        the member variables of this object's instance.
    */
   void ConstructSelf (const AttributeConstructionList &attributes);
+  /**
+   * Complete construction of ObjectBase from attributes gathered
+   * beforehand, typically by an ObjectFactory.
+   *
+   * \param [in] construction The attributes to set and their values,
+   *        in construction order.
+   */
+  void ConstructSelf (const TypeId::ConstructionInformation &construction);
 
 private:
   /**
@@ -18,6 +18,7 @@
  * Authors: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "object-factory.h"
+#include "pointer.h"
 #include "log.h"
 #include <sstream>
 
@@ -41,18 +42,21 @@ ObjectFactory::SetTypeId (TypeId tid)
 {
   NS_LOG_FUNCTION (this << tid.GetName ());
   m_tid = tid;
+  m_tidConstruction = 0;
 }
 void
 ObjectFactory::SetTypeId (std::string tid)
 {
   NS_LOG_FUNCTION (this << tid);
   m_tid = TypeId::LookupByName (tid);
+  m_tidConstruction = 0;
 }
 void
 ObjectFactory::SetTypeId (const char *tid)
 {
   NS_LOG_FUNCTION (this << tid);
   m_tid = TypeId::LookupByName (tid);
+  m_tidConstruction = 0;
 }
 bool
 ObjectFactory::IsTypeIdSet (void) const
@@ -84,7 +88,16 @@ ObjectFactory::DoSet (const std::string &name, const AttributeValue &value)
       NS_FATAL_ERROR ("Invalid value for attribute set (" << name << ") on " << m_tid.GetName ());
       return;
     }
-  m_parameters.Add (name, info.checker, value.Copy ());
+  // Keep the converted value, unless the conversion creates an object
+  // (a random variable from a string, for example) which each new
+  // object must get its own copy of.
+  if (!info.checker->Check (value)
+      && dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+    {
+      v = value.Copy ();
+    }
+  m_parameters.Add (name, info.checker, v);
+  m_tidConstruction = 0;
 }
 
 TypeId
@@ -103,11 +116,47 @@ ObjectFactory::Create (void) const
   Object *derived = dynamic_cast<Object *> (base);
   NS_ASSERT (derived != 0);
   derived->SetTypeId (m_tid);
-  derived->Construct (m_parameters);
+  derived->Construct (*GetConstructionInformation ());
   Ptr<Object> object = Ptr<Object> (derived, false);
   return object;
 }
 
+Ptr<const TypeId::ConstructionInformation>
+ObjectFactory::GetConstructionInformation (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<const TypeId::ConstructionInformation> tidConstruction = m_tid.GetConstructionInformation ();
+  if (tidConstruction == m_tidConstruction)
+    {
+      return m_construction;
+    }
+  Ptr<TypeId::ConstructionInformation> construction = ns3::Create<TypeId::ConstructionInformation> ();
+  for (std::vector<struct TypeId::AttributeConstructionInformation>::const_iterator i = tidConstruction->attributes.begin ();
+       i != tidConstruction->attributes.end (); ++i)
+    {
+      Ptr<AttributeValue> value = m_parameters.Find (i->checker);
+      if (!(i->flags & TypeId::ATTR_CONSTRUCT))
+        {
+          if (value == 0)
+            {
+              // not set on construction
+              continue;
+            }
+          NS_FATAL_ERROR ("Attribute name=" << i->name << " tid=" << i->tidName << ": initial value cannot be set using attributes");
+        }
+      struct TypeId::AttributeConstructionInformation info = *i;
+      if (value != 0)
+        {
+          info.initialValue = value;
+          info.checked = i->checker->Check (*value);
+        }
+      construction->attributes.push_back (info);
+    }
+  m_tidConstruction = tidConstruction;
+  m_construction = construction;
+  return m_construction;
+}
+
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory)
 {
   os << factory.m_tid.GetName () << "[";
@@ -187,6 +236,7 @@ std::istream & operator >> (std::istream &is, ObjectFactory &factory)
               else
                 {
                   factory.m_parameters.Add (name, info.checker, val);
+                  factory.m_tidConstruction = 0;
                 }
             }
         }
@@ -42,6 +42,12 @@ class AttributeValue;
  * This class can also hold a set of attributes to set
  * automatically during the object construction.
  *
+ * The attribute values are checked and converted when they are set.
+ * The first Create() merges them with the initial values of the
+ * other attributes of the TypeId into a construction list, which
+ * later calls reuse, so creating many objects from one factory
+ * only copies values into each new object.
+ *
  * \see attribute_ObjectFactory
  */
 class ObjectFactory
@@ -139,6 +145,13 @@ private:
    * \param [in] value The value of the attribute to set.
    */
   void DoSet (const std::string &name, const AttributeValue &value);
+  /**
+   * Get the attributes to set on a new object, merging the attributes
+   * of this factory with the initial values of the TypeId.
+   *
+   * \returns The attributes, in construction order.
+   */
+  Ptr<const TypeId::ConstructionInformation> GetConstructionInformation (void) const;
   /**
    * Print the factory configuration on an output stream.
    *
@@ -169,6 +182,13 @@ private:
    * objects by this factory.
    */
   AttributeConstructionList m_parameters;
+  /**
+   * The construction information of the TypeId which m_construction
+   * was built from, or 0 if m_construction must be built again.
+   */
+  mutable Ptr<const TypeId::ConstructionInformation> m_tidConstruction;
+  /** The attributes to set on a new object. */
+  mutable Ptr<const TypeId::ConstructionInformation> m_construction;
 };
 
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory);
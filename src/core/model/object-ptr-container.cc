@@ -139,5 +139,44 @@ ObjectPtrContainerAccessor::HasSetter (void) const
   NS_LOG_FUNCTION (this);
   return false;
 }
+bool
+ObjectPtrContainerAccessor::GetIndexedN (const ObjectBase *object, std::size_t *n) const
+{
+  NS_LOG_FUNCTION (this << object << n);
+  return DoIsIndexedByPosition () && DoGetN (object, n);
+}
+Ptr<Object>
+ObjectPtrContainerAccessor::GetByIndex (const ObjectBase *object, std::size_t index) const
+{
+  NS_LOG_FUNCTION (this << object << index);
+  NS_ASSERT (DoIsIndexedByPosition ());
+  std::size_t found;
+  Ptr<Object> item = DoGet (object, index, &found);
+  NS_ASSERT (found == index);
+  return item;
+}
+bool
+ObjectPtrContainerAccessor::GetIndicesByPath (const ObjectBase *object,
+                                              const std::vector<std::string> &path,
+                                              std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << object << indices);
+  NS_ASSERT (DoIsIndexedByPosition ());
+  return DoGetIndicesByPath (object, path, indices);
+}
+bool
+ObjectPtrContainerAccessor::DoGetIndicesByPath (const ObjectBase *object,
+                                                const std::vector<std::string> &path,
+                                                std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << object << indices);
+  return false;
+}
+bool
+ObjectPtrContainerAccessor::DoIsIndexedByPosition (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return false;
+}
 
 } // name
@@ -21,6 +21,8 @@
 #define OBJECT_PTR_CONTAINER_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include "object.h"
 #include "ptr.h"
 #include "attribute.h"
@@ -228,8 +230,70 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the number of instances in a container whose instances can be
+   * accessed by index with GetByIndex(), without copying the whole
+   * container as Get() does.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns \c false if the container cannot be accessed by index:
+   *          the caller must then use Get().
+   */
+  bool GetIndexedN (const ObjectBase *object, std::size_t *n) const;
+  /**
+   * Get the instance of a container with a given index.
+   *
+   * GetIndexedN() must have succeeded on the same container.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance, smaller than the
+   *            number of instances.
+   * \returns The instance.
+   */
+  Ptr<Object> GetByIndex (const ObjectBase *object, std::size_t index) const;
+  /**
+   * Get the indices of the instances of a container from which a Config
+   * path may reach an object of a given type, when the container keeps
+   * an index of the types of its instances.
+   *
+   * GetIndexedN() must have succeeded on the same container.
+   *
+   * \param [in] object The container object.
+   * \param [in] path The elements of the Config path which follow the
+   *            index of the instance, up to and including the first
+   *            \c $TypeId element.
+   * \param [out] indices The indices, in increasing order: the other
+   *            instances cannot match \pname{path}.
+   * \returns \c false if the container cannot narrow the instances
+   *          down: the caller must then visit all of them.
+   */
+  bool GetIndicesByPath (const ObjectBase *object,
+                         const std::vector<std::string> &path,
+                         std::vector<std::size_t> *indices) const;
 
 private:
+  /**
+   * Get the indices of the instances from which a Config path may reach
+   * an object of a given type.
+   *
+   * The default implementation does not narrow the instances down.
+   *
+   * \param [in] object The container object.
+   * \param [in] path The elements of the Config path.
+   * \param [out] indices The indices, in increasing order.
+   * \returns \c false if the container cannot narrow the instances down.
+   */
+  virtual bool DoGetIndicesByPath (const ObjectBase *object,
+                                   const std::vector<std::string> &path,
+                                   std::vector<std::size_t> *indices) const;
+  /**
+   * Check whether the index of each instance is its position in the
+   * container, which allows GetIndexedN() and GetByIndex().
+   *
+   * \returns \c true if the index of each instance is its position.
+   */
+  virtual bool DoIsIndexedByPosition (void) const;
   /**
    * Get the number of instances in the container.
    *
@@ -272,6 +336,10 @@ MakeObjectPtrContainerAccessor (Ptr<U> (T::*get)(INDEX) const,
       *index = i;
       return (obj->*m_get)(i);
     }
+    virtual bool DoIsIndexedByPosition (void) const
+    {
+      return true;
+    }
     Ptr<U> (T::*m_get)(INDEX) const;
     INDEX (T::*m_getN)(void) const;
   } *spec = new MemberGetters ();
@@ -111,6 +111,10 @@ MakeObjectVectorAccessor (U T::*memberVector)
       // quiet compiler.
       return 0;
     }
+    virtual bool DoIsIndexedByPosition (void) const
+    {
+      return true;
+    }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
   spec->m_memberVector = memberVector;
@@ -29,6 +29,9 @@
 #include <sstream>
 #include <cstdlib>
 #include <cstring>
+#ifdef NS3_MTP
+#include <mutex>
+#endif
 
 /**
  * \file
@@ -40,6 +43,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Object");
 
+/** The generation of each type, by TypeId uid, see Object::GetGraphGeneration(). */
+static std::vector<uint64_t> g_graphGenerations;
+#ifdef NS3_MTP
+/** Serializes the accesses to g_graphGenerations. */
+static std::mutex g_graphGenerationsMutex;
+#endif
+
 /*********************************************************************
  *         The Object implementation
  *********************************************************************/
@@ -145,6 +155,13 @@ Object::Construct (const AttributeConstructionList &attributes)
   ConstructSelf (attributes);
 }
 
+void
+Object::Construct (const TypeId::ConstructionInformation &construction)
+{
+  NS_LOG_FUNCTION (this << &construction);
+  ConstructSelf (construction);
+}
+
 Ptr<Object>
 Object::DoGetObject (TypeId tid) const
 {
@@ -179,6 +196,46 @@ Object::DoGetObject (TypeId tid) const
     }
   return 0;
 }
+uint64_t
+Object::GetGraphGeneration (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_graphGenerationsMutex);
+#endif
+  uint16_t uid = tid.GetUid ();
+  return uid < g_graphGenerations.size () ? g_graphGenerations[uid] : 0;
+}
+
+void
+Object::NotifyGraphChange (void) const
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  std::lock_guard<std::mutex> lock (g_graphGenerationsMutex);
+#endif
+  TypeId objectTid = Object::GetTypeId ();
+  for (uint32_t i = 0; i < m_aggregates->n; i++)
+    {
+      // the object is found by GetObject for its type and all its parents
+      TypeId tid = m_aggregates->buffer[i]->GetInstanceTypeId ();
+      while (true)
+        {
+          uint16_t uid = tid.GetUid ();
+          if (uid >= g_graphGenerations.size ())
+            {
+              g_graphGenerations.resize (uid + 1, 0);
+            }
+          g_graphGenerations[uid]++;
+          if (tid == objectTid)
+            {
+              break;
+            }
+          tid = tid.GetParent ();
+        }
+    }
+}
+
 void
 Object::Initialize (void)
 {
@@ -296,6 +353,7 @@ Object::AggregateObject (Ptr<Object> o)
       Object *current = aggregates->buffer[i];
       current->m_aggregates = aggregates;
     }
+  NotifyGraphChange ();
 
   // Finally, call NotifyNewAggregate on all the objects aggregates together.
   // We purposely use the old aggregate buffers to iterate over the objects
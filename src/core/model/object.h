@@ -210,6 +210,27 @@ public:
    */
   AggregateIterator GetAggregateIterator (void) const;
 
+  /**
+   * Get the generation of a type in the object graph.
+   *
+   * The generation of a TypeId changes whenever an Object of this type,
+   * or of a subclass, is aggregated or passed to NotifyGraphChange(),
+   * which lets the containers which keep an index of the types of their
+   * items, such as the NodeList, tell when the index of this type must
+   * be rebuilt.
+   *
+   * \param [in] tid The TypeId.
+   * \returns The generation of \pname{tid}.
+   */
+  static uint64_t GetGraphGeneration (TypeId tid);
+  /**
+   * Notify a change of the object graph other than an aggregation,
+   * such as a new item in a container indexed by type, which changes
+   * the generation of the types of all the Objects aggregated to this
+   * one.
+   */
+  void NotifyGraphChange (void) const;
+
   /**
    * Invoke DoInitialize on all Objects aggregated to this one.
    *
@@ -396,6 +417,15 @@ private:
    * registered with the associated TypeId.
   */
   void Construct (const AttributeConstructionList &attributes);
+  /**
+   * Initialize all member variables registered as Attributes of this TypeId.
+   *
+   * \param [in] construction The attributes to set and their values,
+   *        in construction order.
+   *
+   * Invoked from ns3::ObjectFactory::Create only.
+   */
+  void Construct (const TypeId::ConstructionInformation &construction);
 
   /**
    * Keep the list of aggregates in most-recently-used order
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "process.h"
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+
+/**
+ * \file
+ * \ingroup process
+ * ns3::Process implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Process");
+
+/**
+ * \ingroup process
+ * The event which resumes a Process.  The process keeps it across its
+ * waits, and the simulator drops its reference after each invocation.
+ */
+class Process::Resumer : public EventImpl
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] process The process to resume.
+   */
+  Resumer (Process *process)
+    : m_process (process)
+  {}
+
+private:
+  virtual void Notify (void)
+  {
+    m_process->Resume ();
+  }
+
+  Process *m_process;  //!< The process to resume.
+};
+
+Process::Process ()
+  : m_resumePoint (0),
+    m_state (IDLE),
+    m_pending (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Process::~Process ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+}
+
+void
+Process::Start (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT_MSG (m_state == IDLE, "Process::Start(): the process is running");
+  m_resumePoint = 0;
+  m_state = SLEEPING;
+  Schedule (delay);
+}
+
+void
+Process::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_pending)
+    {
+      // A cancelled event cannot be scheduled again.
+      m_event.Cancel ();
+      m_resumer = 0;
+      m_pending = false;
+    }
+  m_state = IDLE;
+}
+
+void
+Process::Wake (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == WAITING && !m_pending)
+    {
+      Schedule (Seconds (0));
+    }
+}
+
+bool
+Process::IsRunning (void) const
+{
+  return m_state != IDLE;
+}
+
+void
+Process::Sleep (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  if (m_state == RUNNING)
+    {
+      m_state = SLEEPING;
+      Schedule (delay);
+    }
+}
+
+void
+Process::Suspend (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == RUNNING)
+    {
+      m_state = WAITING;
+    }
+}
+
+void
+Process::Finish (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == RUNNING)
+    {
+      m_state = IDLE;
+    }
+}
+
+void
+Process::Resume (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_pending = false;
+  if (m_state != SLEEPING && m_state != WAITING)
+    {
+      return;
+    }
+  m_state = RUNNING;
+  DoRun ();
+  NS_ASSERT_MSG (m_state != RUNNING,
+                 "Process::Resume(): DoRun() returned without waiting or finishing");
+}
+
+void
+Process::Schedule (const Time &delay)
+{
+  if (!m_resumer)
+    {
+      m_resumer = Create<Resumer> (this);
+    }
+  m_event = Simulator::Schedule (delay, m_resumer);
+  m_pending = true;
+}
+
+} // namespace ns3
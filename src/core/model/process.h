@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include "event-id.h"
+#include "event-impl.h"
+#include "nstime.h"
+#include "ptr.h"
+#include "simple-ref-count.h"
+
+/**
+ * \file
+ * \ingroup process
+ * ns3::Process declaration and the NS_PROCESS macros.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \defgroup process Processes
+ *
+ * A Process is a sequential activity, like a traffic generator, written
+ * as one function that waits for simulated time or for conditions,
+ * instead of a set of callbacks that pass its state along in members
+ * and EventIds.
+ */
+
+/**
+ * \ingroup process
+ * \brief A lightweight sequential process, resumed by simulation events.
+ *
+ * A subclass writes the process in DoRun(), between NS_PROCESS_BEGIN()
+ * and NS_PROCESS_END().  At each NS_PROCESS_SLEEP() or
+ * NS_PROCESS_WAIT_UNTIL(), DoRun() records where it stopped and returns
+ * to the simulator; the next event of the process calls DoRun() again,
+ * which continues after the wait.  The process has no stack of its own:
+ * the state that must survive a wait is kept in members of the
+ * subclass, and the local variables of DoRun() do not survive a wait.
+ *
+ * \code
+ *   class Sender : public Process
+ *   {
+ *   private:
+ *     virtual void DoRun (void)
+ *     {
+ *       NS_PROCESS_BEGIN ();
+ *       for (m_sent = 0; m_sent < 10; ++m_sent)
+ *         {
+ *           NS_PROCESS_WAIT_UNTIL (m_socket->GetTxAvailable () >= 1000);
+ *           m_socket->Send (Create<Packet> (1000));
+ *           NS_PROCESS_SLEEP (MilliSeconds (10));
+ *         }
+ *       NS_PROCESS_END ();
+ *     }
+ *     void Writable (Ptr<Socket> socket, uint32_t available)
+ *     {
+ *       Wake ();
+ *     }
+ *     Ptr<Socket> m_socket;
+ *     uint32_t m_sent;
+ *   };
+ * \endcode
+ *
+ * A process waits for a condition, like a readable or writable socket,
+ * until something calls Wake(), typically the callback which reports
+ * the change, here the send callback of the socket.  Then it evaluates
+ * the condition again, at the same simulation time.
+ *
+ * A process reuses one event to resume itself, so that sleeping and
+ * waking do not allocate memory; only a Stop() while an event is
+ * pending makes it allocate a new one.
+ *
+ * DoRun() resumes by jumping to the wait it stopped at, so a local
+ * variable initialized before a wait in the same scope does not
+ * compile (the jump "crosses initialization"), and a local variable
+ * declared without initializer has an undefined value after a wait.
+ */
+class Process : public SimpleRefCount<Process>
+{
+public:
+  /** Constructor. */
+  Process ();
+  /** Destructor, which stops the process. */
+  virtual ~Process ();
+
+  /**
+   * Start the process, from the beginning of DoRun(), after a delay.
+   *
+   * \param [in] delay The delay.
+   */
+  void Start (const Time &delay = Seconds (0));
+  /**
+   * Stop the process.  It can be started again, from the beginning.
+   *
+   * From DoRun(), use NS_PROCESS_EXIT() instead.
+   */
+  void Stop (void);
+  /**
+   * Evaluate again the condition the process waits for, if any.
+   *
+   * The process resumes in a new event at the current time, so that
+   * Wake() can be called from any callback.
+   */
+  void Wake (void);
+  /**
+   * Check if the process is started and not finished.
+   *
+   * \returns \c true if the process is running.
+   */
+  bool IsRunning (void) const;
+
+protected:
+  /**
+   * The body of the process, which starts with NS_PROCESS_BEGIN() and
+   * ends with NS_PROCESS_END().
+   */
+  virtual void DoRun (void) = 0;
+
+  /**
+   * Resume DoRun() after a delay.  Called by NS_PROCESS_SLEEP().
+   *
+   * \param [in] delay The delay.
+   */
+  void Sleep (const Time &delay);
+  /**
+   * Resume DoRun() at the next Wake().  Called by NS_PROCESS_WAIT_UNTIL().
+   */
+  void Suspend (void);
+  /**
+   * Mark the process finished.  Called by NS_PROCESS_END() and
+   * NS_PROCESS_EXIT().
+   */
+  void Finish (void);
+
+  /**
+   * Where DoRun() resumes: 0 at the beginning, and otherwise the
+   * resume point of the wait it returned from, see
+   * NS_PROCESS_RESUME_POINT.
+   */
+  int m_resumePoint;
+
+private:
+  class Resumer;
+
+  /** The state of a process. */
+  enum State
+  {
+    IDLE,      //!< Not started, stopped or finished.
+    SLEEPING,  //!< Waiting for a delay.
+    WAITING,   //!< Waiting for a condition.
+    RUNNING    //!< In DoRun().
+  };
+
+  /** Run DoRun() from the resumption point.  Called by the Resumer. */
+  void Resume (void);
+  /**
+   * Schedule the Resumer.
+   *
+   * \param [in] delay The delay.
+   */
+  void Schedule (const Time &delay);
+
+  State m_state;              //!< The state.
+  bool m_pending;             //!< Whether the Resumer is scheduled.
+  Ptr<Resumer> m_resumer;     //!< The event which resumes the process.
+  EventId m_event;            //!< The scheduled Resumer.
+};
+
+} // namespace ns3
+
+/**
+ * \ingroup process
+ * Start the body of Process::DoRun().
+ */
+#define NS_PROCESS_BEGIN()                      \
+  switch (m_resumePoint)                        \
+    {                                           \
+    case 0:
+
+/**
+ * \ingroup process
+ * A new resume point of Process::DoRun(), unique in the translation
+ * unit.  Without \c __COUNTER__ it is the line number, and two waits
+ * written on the same line fail to compile with a duplicate case value.
+ */
+#ifdef __COUNTER__
+#define NS_PROCESS_RESUME_POINT (__COUNTER__ + 1)
+#else
+#define NS_PROCESS_RESUME_POINT __LINE__
+#endif
+
+/**
+ * \ingroup process
+ * Wait in Process::DoRun() for a delay.
+ *
+ * The local variables of Process::DoRun() do not survive the wait, and
+ * one initialized before it in the same scope fails to compile, as the
+ * jump back to the wait crosses its initialization.  Keep the state of
+ * the process in members.
+ *
+ * \param [in] delay The delay, a Time.
+ */
+#define NS_PROCESS_SLEEP(delay)                 \
+  NS_PROCESS_SLEEP_AT (delay, NS_PROCESS_RESUME_POINT)
+
+/**
+ * \ingroup process
+ * Implement NS_PROCESS_SLEEP() with a resume point.
+ *
+ * \param [in] delay The delay, a Time.
+ * \param [in] point The resume point.
+ */
+#define NS_PROCESS_SLEEP_AT(delay, point)       \
+  do                                            \
+    {                                           \
+      m_resumePoint = point;                    \
+      Sleep (delay);                            \
+      return;                                   \
+    case point:;                                \
+    }                                           \
+  while (false)
+
+/**
+ * \ingroup process
+ * Wait in Process::DoRun() until a condition is true.  The condition is
+ * evaluated at once, then at each Process::Wake().
+ *
+ * The local variables of Process::DoRun() do not survive the wait, and
+ * one initialized before it in the same scope fails to compile, as the
+ * jump back to the wait crosses its initialization.  The condition
+ * should therefore only use members.
+ *
+ * \param [in] condition The condition, a boolean expression.
+ */
+#define NS_PROCESS_WAIT_UNTIL(condition)        \
+  NS_PROCESS_WAIT_UNTIL_AT (condition, NS_PROCESS_RESUME_POINT)
+
+/**
+ * \ingroup process
+ * Implement NS_PROCESS_WAIT_UNTIL() with a resume point.
+ *
+ * \param [in] condition The condition, a boolean expression.
+ * \param [in] point The resume point.
+ */
+#define NS_PROCESS_WAIT_UNTIL_AT(condition, point) \
+  do                                            \
+    {                                           \
+      m_resumePoint = point;                    \
+    case point:                                 \
+      if (!(condition))                         \
+        {                                       \
+          Suspend ();                           \
+          return;                               \
+        }                                       \
+    }                                           \
+  while (false)
+
+/**
+ * \ingroup process
+ * Finish the process from Process::DoRun().
+ */
+#define NS_PROCESS_EXIT()                       \
+  do                                            \
+    {                                           \
+      Finish ();                                \
+      return;                                   \
+    }                                           \
+  while (false)
+
+/**
+ * \ingroup process
+ * End the body of Process::DoRun(), which finishes the process.
+ */
+#define NS_PROCESS_END()                        \
+    }                                           \
+  Finish ()
+
+#endif /* PROCESS_H */
@@ -33,10 +33,12 @@
 #include "log.h"
 #include "rng-stream.h"
 #include "rng-seed-manager.h"
+#include "simulation-instance.h"
 #include "unused.h"
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <map>
 
 /**
  * \file
@@ -50,6 +52,39 @@ NS_LOG_COMPONENT_DEFINE ("RandomVariableStream");
 
 NS_OBJECT_ENSURE_REGISTERED (RandomVariableStream);
 
+namespace {
+
+/** The random variables of a simulation, by stream index. */
+typedef std::map<uint64_t, RandomVariableStream *> StreamMap;
+
+/**
+ * Get the random variables of the current simulation.
+ * \returns The random variables, by stream index.
+ */
+StreamMap *
+GetStreams (void)
+{
+  return InstanceSingleton<StreamMap, RandomVariableStream>::Get ();
+}
+
+/**
+ * Forget a random variable.
+ * \param [in] index The stream index of the random variable.
+ * \param [in] stream The random variable.
+ */
+void
+RemoveStream (uint64_t index, RandomVariableStream *stream)
+{
+  StreamMap *streams = GetStreams ();
+  StreamMap::iterator i = streams->find (index);
+  if (i != streams->end () && i->second == stream)
+    {
+      streams->erase (i);
+    }
+}
+
+} // unnamed namespace
+
 TypeId
 RandomVariableStream::GetTypeId (void)
 {
@@ -74,13 +109,18 @@ RandomVariableStream::GetTypeId (void)
 }
 
 RandomVariableStream::RandomVariableStream ()
-  : m_rng (0)
+  : m_rng (0),
+    m_streamIndex (0)
 {
   NS_LOG_FUNCTION (this);
 }
 RandomVariableStream::~RandomVariableStream ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_rng != 0)
+    {
+      RemoveStream (m_streamIndex, this);
+    }
   delete m_rng;
 }
 
@@ -97,11 +137,24 @@ RandomVariableStream::IsAntithetic (void) const
   return m_isAntithetic;
 }
 void
+RandomVariableStream::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+void
 RandomVariableStream::SetStream (int64_t stream)
 {
   NS_LOG_FUNCTION (this << stream);
   // negative values are not legal.
   NS_ASSERT (stream >= -1);
+  if (m_rng != 0)
+    {
+      RemoveStream (m_streamIndex, this);
+    }
   delete m_rng;
   if (stream == -1)
     {
@@ -112,6 +165,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
+      m_streamIndex = nextStream;
     }
   else
     {
@@ -122,8 +176,10 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
+      m_streamIndex = target;
     }
   m_stream = stream;
+  (*GetStreams ())[m_streamIndex] = this;
 }
 int64_t
 RandomVariableStream::GetStream (void) const
@@ -139,6 +195,54 @@ RandomVariableStream::Peek (void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::SaveStreams (std::ostream &os)
+{
+  NS_LOG_FUNCTION (&os);
+  StreamMap *streams = GetStreams ();
+  uint64_t n = streams->size ();
+  os.write (reinterpret_cast<const char *> (&n), sizeof (n));
+  for (StreamMap::const_iterator i = streams->begin (); i != streams->end (); ++i)
+    {
+      os.write (reinterpret_cast<const char *> (&i->first), sizeof (i->first));
+      i->second->m_rng->Save (os);
+    }
+}
+
+int64_t
+RandomVariableStream::RestoreStreams (std::istream &is)
+{
+  NS_LOG_FUNCTION (&is);
+  StreamMap *streams = GetStreams ();
+  uint64_t n;
+  if (!is.read (reinterpret_cast<char *> (&n), sizeof (n)))
+    {
+      return -1;
+    }
+  int64_t restored = 0;
+  RngStream unused (1, 0, 0);
+  for (uint64_t k = 0; k < n; ++k)
+    {
+      uint64_t index;
+      if (!is.read (reinterpret_cast<char *> (&index), sizeof (index)))
+        {
+          return -1;
+        }
+      StreamMap::iterator i = streams->find (index);
+      RngStream *rng = i == streams->end () ? &unused : i->second->m_rng;
+      if (!rng->Restore (is))
+        {
+          return -1;
+        }
+      if (rng != &unused)
+        {
+          restored++;
+        }
+    }
+  NS_LOG_INFO ("restored " << restored << " of " << n << " streams");
+  return restored;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (UniformRandomVariable);
 
 TypeId
@@ -209,6 +313,21 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      double v = m_min + values[i] * (m_max - m_min);
+      if (IsAntithetic ())
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (ConstantRandomVariable);
 
@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <iosfwd>
 
 /**
  * \file
@@ -149,6 +150,38 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next random values as doubles drawn from the distribution.
+   *
+   * The values are the same as those of \pname{n} calls to GetValue(void).
+   * The default implementation makes those calls; distributions
+   * which draw one uniform value per random value override it to
+   * draw all the uniform values at once.
+   *
+   * \param [out] values The floating point random values.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
+  /**
+   * \brief Write the state of the RngStream of every random variable
+   * of the current simulation, identified by their stream index.
+   *
+   * \param [in] os The binary output stream.
+   */
+  static void SaveStreams (std::ostream &os);
+  /**
+   * \brief Restore the states written by SaveStreams() into the random
+   * variables of the current simulation with the same stream indices.
+   *
+   * The states of the streams which no longer exist are skipped.
+   *
+   * \param [in] is The binary input stream.
+   * \returns The number of random variables restored, or -1 if the
+   *          states could not be read.
+   */
+  static int64_t RestoreStreams (std::istream &is);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -187,6 +220,9 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The index of the RngStream among all the streams of the run. */
+  uint64_t m_streamIndex;
+
 };  // class RandomVariableStream
 
 
@@ -294,6 +330,13 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  /**
+   * \brief Get the next random values as doubles drawn from the distribution.
+   * \param [out] values The floating point random values.
+   * \param [in] n The number of random values.
+   * \note The upper limit is excluded from the output range.
+   */
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -33,6 +33,7 @@
 #include "enum.h"
 
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -75,6 +76,7 @@ RealtimeSimulatorImpl::GetTypeId (void)
 
 
 RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
+  : m_eventsWithContext (EVENTS_WITH_CONTEXT_CAPACITY)
 {
   NS_LOG_FUNCTION (this);
 
@@ -108,6 +110,7 @@ void
 RealtimeSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  ProcessEventsWithContext ();
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
@@ -229,6 +232,13 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         //
         // tsNext is the simulation time of the next event we want to execute.
         //
+        // The synchronizer is reset before the events scheduled by other
+        // threads are collected, so that an event scheduled after this
+        // point signals it, and interrupts the wait below.
+        //
+        m_synchronizer->SetCondition (false);
+        ProcessEventsWithContext ();
+
         tsNow = m_synchronizer->GetCurrentRealtime ();
         tsNext = NextTs ();
 
@@ -254,10 +264,9 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         // We've figured out how long we need to delay in order to pace the
         // simulation time with the real time.  We're going to sleep, but need
         // to work with the synchronizer to make sure we're awakened if something
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
+        // external happens (like a packet is received).  The synchronizer was
+        // reset above, so that any later event will cause it to interrupt.
         //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -407,6 +416,31 @@ RealtimeSimulatorImpl::IsFinished (void) const
   return rc;
 }
 
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext (void)
+{
+  EventWithContext event;
+  while (m_eventsWithContext.Pop (event))
+    {
+      uint64_t ts = event.timestamp;
+      if (event.relative)
+        {
+          ts += m_currentTs;
+        }
+      // The realtime clock was read before the event was pushed, while
+      // the main thread may have executed an event since.
+      ts = std::max (ts, m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = event.event;
+      ev.key.m_ts = ts;
+      ev.key.m_context = event.context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+}
+
 //
 // Peeks into event list.  Should be called with critical section locked.
 //
@@ -431,8 +465,10 @@ RealtimeSimulatorImpl::Run (void)
   m_main = SystemThread::Self ();
 
   m_stop = false;
-  m_running = true;
+  // The origin is set first: other threads read the realtime clock
+  // as soon as they see m_running.
   m_synchronizer->SetOrigin (m_currentTs);
+  m_running = true;
 
   // Sleep until signalled
   uint64_t tsNow = 0;
@@ -444,6 +480,8 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        m_synchronizer->SetCondition (false);
+        ProcessEventsWithContext ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -544,25 +582,34 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 {
   NS_LOG_FUNCTION (this << context << delay << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // Other threads, like the readers of the emulated devices, do not
+      // take the mutex: their events are pushed to a lock-free queue, and
+      // moved to the event list by the main thread.
+      //
+      // If the simulator is running, we're pacing and have a meaningful
+      // realtime clock.  If we're not, then the delay is added to the
+      // time where we stopped, when the event is moved.
+      //
+      EventWithContext ev;
+      ev.context = context;
+      ev.relative = !m_running;
+      ev.timestamp = delay.GetTimeStep ();
+      if (!ev.relative)
+        {
+          ev.timestamp += m_synchronizer->GetCurrentRealtime ();
+        }
+      ev.event = impl;
+      m_eventsWithContext.Push (ev);
+      m_synchronizer->Signal ();
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + delay.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        //
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += delay.GetTimeStep ();
-      }
-
-    NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
+    uint64_t ts = m_currentTs + delay.GetTimeStep ();
     Scheduler::Event ev;
     ev.impl = impl;
     ev.key.m_ts = ts;
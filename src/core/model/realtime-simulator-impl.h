@@ -30,7 +30,9 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -174,17 +176,52 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Move the events scheduled by other threads into the event list.
+   * Should be called with #m_mutex locked.
+   */
+  void ProcessEventsWithContext (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
+  /** An event scheduled by another thread. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /**
+     * The event timestamp, or its delay if the simulator was not
+     * running when it was scheduled.
+     */
+    uint64_t timestamp;
+    /** \c true if #timestamp is a delay from the current time. */
+    bool relative;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /**
+   * The capacity of the ring of #m_eventsWithContext.  Beyond it, the
+   * events of other threads spill into a locked list, since the main
+   * thread may not be running to move them.
+   */
+  static const uint32_t EVENTS_WITH_CONTEXT_CAPACITY = 16384;
+  /**
+   * The events scheduled by other threads, not yet moved to the
+   * event list.
+   */
+  MpscQueue<EventWithContext> m_eventsWithContext;
+
   /** Container type for events to be run at destroy time. */
   typedef std::list<EventId> DestroyEvents;
   /** Container for events to be run at destroy time. */
   DestroyEvents m_destroyEvents;
   /** Has the stopping condition been reached? */
   bool m_stop;
-  /** Is the simulator currently running. */
-  bool m_running;
+  /**
+   * Is the simulator currently running.  Atomic, because the threads
+   * which schedule events read it.
+   */
+  std::atomic<bool> m_running;
 
   /**
    * \name Mutex-protected variables.
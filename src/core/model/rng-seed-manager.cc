@@ -23,6 +23,7 @@
 #include "uinteger.h"
 #include "config.h"
 #include "log.h"
+#include "simulation-instance.h"
 
 /**
  * \file
@@ -34,12 +35,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
 
-/**
- * \relates RngSeedManager
- * The next random number generator stream number to use
- * for automatic assignment.
- */
-static uint64_t g_nextStreamIndex = 0;
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -102,9 +97,8 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
-  return next;
+  uint64_t *next = InstanceSingleton<uint64_t, RngSeedManager>::Get ();
+  return (*next)++;
 }
 
 } // namespace ns3
@@ -26,6 +26,10 @@
 #include "fatal-error.h"
 #include "log.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /**
  * \file
  * \ingroup rngimpl
@@ -332,42 +336,92 @@ namespace ns3 {
 
 using namespace MRG32k3a;
 
-double RngStream::RandU01 ()
+void
+RngStream::Generate (double *u, std::size_t n)
 {
-  int32_t k;
-  double p1, p2, u;
-
-  /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
-  k = static_cast<int32_t> (p1 / m1);
-  p1 -= k * m1;
-  if (p1 < 0.0)
+#ifdef __SSE2__
+  // Component 1 in the low lane, component 2 in the high lane.
+  __m128d s0 = _mm_set_pd (m_currentState[3], m_currentState[0]);
+  __m128d s1 = _mm_set_pd (m_currentState[4], m_currentState[1]);
+  __m128d s2 = _mm_set_pd (m_currentState[5], m_currentState[2]);
+  const __m128d a = _mm_set_pd (a21, a12);
+  const __m128d b = _mm_set_pd (a23n, a13n);
+  const __m128d m = _mm_set_pd (m2, m1);
+  const __m128d zero = _mm_setzero_pd ();
+
+  for (std::size_t i = 0; i < n; ++i)
     {
-      p1 += m1;
+      // p1 = a12 * s[1] - a13n * s[0], p2 = a21 * s[5] - a23n * s[3]
+      __m128d x = _mm_move_sd (s2, s1);
+      __m128d p = _mm_sub_pd (_mm_mul_pd (a, x), _mm_mul_pd (b, s0));
+      __m128d k = _mm_cvtepi32_pd (_mm_cvttpd_epi32 (_mm_div_pd (p, m)));
+      p = _mm_sub_pd (p, _mm_mul_pd (k, m));
+      p = _mm_add_pd (p, _mm_and_pd (_mm_cmplt_pd (p, zero), m));
+      s0 = s1;
+      s1 = s2;
+      s2 = p;
+
+      /* Combination */
+      double p1 = _mm_cvtsd_f64 (p);
+      double p2 = _mm_cvtsd_f64 (_mm_unpackhi_pd (p, p));
+      u[i] = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
     }
-  m_currentState[0] = m_currentState[1];
-  m_currentState[1] = m_currentState[2];
-  m_currentState[2] = p1;
-
-  /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
-  k = static_cast<int32_t> (p2 / m2);
-  p2 -= k * m2;
-  if (p2 < 0.0)
+
+  _mm_storel_pd (&m_currentState[0], s0);
+  _mm_storel_pd (&m_currentState[1], s1);
+  _mm_storel_pd (&m_currentState[2], s2);
+  _mm_storeh_pd (&m_currentState[3], s0);
+  _mm_storeh_pd (&m_currentState[4], s1);
+  _mm_storeh_pd (&m_currentState[5], s2);
+#else
+  for (std::size_t i = 0; i < n; ++i)
     {
-      p2 += m2;
-    }
-  m_currentState[3] = m_currentState[4];
-  m_currentState[4] = m_currentState[5];
-  m_currentState[5] = p2;
+      int32_t k;
+      double p1, p2;
+
+      /* Component 1 */
+      p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
+      k = static_cast<int32_t> (p1 / m1);
+      p1 -= k * m1;
+      if (p1 < 0.0)
+        {
+          p1 += m1;
+        }
+      m_currentState[0] = m_currentState[1];
+      m_currentState[1] = m_currentState[2];
+      m_currentState[2] = p1;
+
+      /* Component 2 */
+      p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
+      k = static_cast<int32_t> (p2 / m2);
+      p2 -= k * m2;
+      if (p2 < 0.0)
+        {
+          p2 += m2;
+        }
+      m_currentState[3] = m_currentState[4];
+      m_currentState[4] = m_currentState[5];
+      m_currentState[5] = p2;
 
-  /* Combination */
-  u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+      /* Combination */
+      u[i] = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+    }
+#endif
+}
 
-  return u;
+void
+RngStream::RandU01 (double *u, std::size_t n)
+{
+  while (n > 0 && m_next < PREFETCH)
+    {
+      *u++ = m_prefetched[m_next++];
+      --n;
+    }
+  Generate (u, n);
 }
 
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
+  : m_next (PREFETCH)
 {
   if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
     {
@@ -382,11 +436,50 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
 }
 
 RngStream::RngStream (const RngStream& r)
+  : m_next (r.m_next)
 {
   for (int i = 0; i < 6; ++i)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (std::size_t i = 0; i < PREFETCH; ++i)
+    {
+      m_prefetched[i] = r.m_prefetched[i];
+    }
+}
+
+void
+RngStream::Save (std::ostream &os) const
+{
+  uint64_t next = m_next;
+  os.write (reinterpret_cast<const char *> (m_currentState), sizeof (m_currentState));
+  os.write (reinterpret_cast<const char *> (m_prefetched), sizeof (m_prefetched));
+  os.write (reinterpret_cast<const char *> (&next), sizeof (next));
+}
+
+bool
+RngStream::Restore (std::istream &is)
+{
+  double state[6];
+  double prefetched[PREFETCH];
+  uint64_t next;
+  if (!is.read (reinterpret_cast<char *> (state), sizeof (state))
+      || !is.read (reinterpret_cast<char *> (prefetched), sizeof (prefetched))
+      || !is.read (reinterpret_cast<char *> (&next), sizeof (next))
+      || next > PREFETCH)
+    {
+      return false;
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+      m_currentState[i] = state[i];
+    }
+  for (std::size_t i = 0; i < PREFETCH; ++i)
+    {
+      m_prefetched[i] = prefetched[i];
+    }
+  m_next = next;
+  return true;
 }
 
 void
@@ -20,6 +20,8 @@
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
 #include <string>
+#include <iosfwd>
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -45,6 +47,14 @@ namespace ns3 {
  * holds a static instance of this class.  The details of this
  * class are explained in:
  * http://www.iro.umontreal.ca/~lecuyer/myftp/papers/streams00.pdf
+ *
+ * The numbers are generated a few at a time, which lets RandU01(void)
+ * return most of them inline, and RandU01(double*,std::size_t) fills
+ * whole arrays.  Where SSE2 is available, the two components of the
+ * generator run in the two lanes of a vector register.  Every
+ * intermediate result is an integer below 2<sup>53</sup>, so the
+ * numbers are exactly those of the scalar recurrence, for any seed,
+ * stream and substream.
  */
 class RngStream
 {
@@ -70,8 +80,40 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \pname{n} random numbers for this stream.
+   * Uniformly distributed between 0 and 1.
+   *
+   * The numbers are the same as those of \pname{n} calls to RandU01(void).
+   *
+   * \param [out] u The random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *u, std::size_t n);
+  /**
+   * Write the state of this stream, with the numbers generated ahead,
+   * in binary form.
+   *
+   * \param [in] os The output stream.
+   */
+  void Save (std::ostream &os) const;
+  /**
+   * Read a state written by Save(): this stream then generates the
+   * same numbers as the saved one.
+   *
+   * \param [in] is The input stream.
+   * \returns \c true if a state was read.
+   */
+  bool Restore (std::istream &is);
 
 private:
+  /**
+   * Run the recurrence, without the prefetched numbers.
+   *
+   * \param [out] u The random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void Generate (double *u, std::size_t n);
   /**
    * Advance \pname{state} of the RNG by leaps and bounds.
    *
@@ -81,10 +123,28 @@ private:
    */
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
 
+  /** The number of random numbers generated ahead. */
+  static const std::size_t PREFETCH = 16;
+
   /** The RNG state vector. */
   double m_currentState[6];
+  /** The random numbers generated ahead of the calls to RandU01. */
+  double m_prefetched[PREFETCH];
+  /** The index of the next prefetched random number. */
+  std::size_t m_next;
 };
 
+inline double
+RngStream::RandU01 (void)
+{
+  if (m_next == PREFETCH)
+    {
+      Generate (m_prefetched, PREFETCH);
+      m_next = 0;
+    }
+  return m_prefetched[m_next++];
+}
+
 } // namespace ns3
 
 #endif
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulation-instance.h"
+#include "abort.h"
+
+#include <atomic>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationInstance implementation.
+ */
+
+// Note:  There is no logging in this file, because the log time and
+// node printers are kept in a SimulationInstance.
+
+namespace ns3 {
+
+namespace {
+
+/** The number of allocated slots. */
+std::atomic<uint32_t> g_nSlots (0);
+
+/** The deleters of the allocated slots. */
+SimulationInstance::SlotDeleter g_deleters[SimulationInstance::MAX_SLOTS];
+
+/**
+ * The number of threads with a current instance.  While there is
+ * none, GetCurrent() does not need to look up the thread local
+ * instance.
+ */
+std::atomic<uint32_t> g_nCurrent (0);
+
+/** The current instance of this thread, or 0 for the default instance. */
+thread_local SimulationInstance *t_current = 0;
+
+} // unnamed namespace
+
+SimulationInstance::SimulationInstance ()
+{
+  for (uint32_t i = 0; i < MAX_SLOTS; ++i)
+    {
+      m_slots[i] = 0;
+    }
+}
+
+SimulationInstance::~SimulationInstance ()
+{
+  for (uint32_t i = g_nSlots.load (); i-- > 0; )
+    {
+      void *value = m_slots[i];
+      m_slots[i] = 0;
+      if (value != 0 && g_deleters[i] != 0)
+        {
+          g_deleters[i] (value);
+        }
+    }
+}
+
+uint32_t
+SimulationInstance::AllocateSlot (SlotDeleter deleter)
+{
+  uint32_t slot = g_nSlots++;
+  NS_ABORT_MSG_IF (slot >= MAX_SLOTS, "SimulationInstance: too many slots");
+  g_deleters[slot] = deleter;
+  return slot;
+}
+
+SimulationInstance *
+SimulationInstance::GetCurrent (void)
+{
+  if (g_nCurrent.load (std::memory_order_relaxed) != 0 && t_current != 0)
+    {
+      return t_current;
+    }
+  return GetDefault ();
+}
+
+void
+SimulationInstance::SetCurrent (SimulationInstance *instance)
+{
+  if (instance == GetDefault ())
+    {
+      instance = 0;
+    }
+  if (t_current == 0 && instance != 0)
+    {
+      g_nCurrent++;
+    }
+  else if (t_current != 0 && instance == 0)
+    {
+      g_nCurrent--;
+    }
+  t_current = instance;
+}
+
+SimulationInstance *
+SimulationInstance::GetDefault (void)
+{
+  // Never deleted: the singletons of the default instance live as long
+  // as the process, and some of them are used during its exit.
+  static SimulationInstance *instance = new SimulationInstance ();
+  return instance;
+}
+
+} // namespace ns3
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATION_INSTANCE_H
+#define SIMULATION_INSTANCE_H
+
+#include "non-copyable.h"
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationInstance and ns3::InstanceSingleton declarations, and
+ * inline and template implementations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief The state of one simulation: the simulator, the global values,
+ * the configuration namespace, the names, the node and channel lists...
+ *
+ * A program has one default instance, shared by all its threads.
+ * Ensemble runs each replication in its own instance, which is the
+ * current instance of the thread running the replication, and of the
+ * threads working for it.
+ *
+ * Each kind of state is kept in a slot of the instances, allocated
+ * once with AllocateSlot().  InstanceSingleton wraps the slots of the
+ * singletons which are created on demand.
+ */
+class SimulationInstance : private NonCopyable
+{
+public:
+  /**
+   * The function which deletes the value of a slot, when its instance
+   * is deleted.
+   *
+   * \param [in] value The value of the slot.
+   */
+  typedef void (* SlotDeleter)(void *value);
+
+  /** The maximum number of slots. */
+  static const uint32_t MAX_SLOTS = 64;
+
+  /** Constructor. */
+  SimulationInstance ();
+  /**
+   * Destructor.
+   *
+   * The values of the slots are deleted in the reverse order of the
+   * allocation of the slots.
+   */
+  ~SimulationInstance ();
+
+  /**
+   * Allocate a slot in all the instances.
+   *
+   * \param [in] deleter The function which deletes the value of the slot,
+   *             or 0 if the value is not owned by the instance.
+   * \returns The slot.
+   */
+  static uint32_t AllocateSlot (SlotDeleter deleter);
+
+  /**
+   * Get the instance of this thread.
+   *
+   * \returns The current instance of this thread, or the default instance.
+   */
+  static SimulationInstance * GetCurrent (void);
+  /**
+   * Set the instance of this thread.
+   *
+   * \param [in] instance The instance, or 0 for the default instance.
+   */
+  static void SetCurrent (SimulationInstance *instance);
+  /**
+   * Get the default instance of the program.
+   *
+   * \returns The default instance.
+   */
+  static SimulationInstance * GetDefault (void);
+
+  /**
+   * Get the value of a slot.
+   *
+   * \param [in] slot The slot.
+   * \returns The value of the slot, initially 0.
+   */
+  void * GetSlot (uint32_t slot) const;
+  /**
+   * Set the value of a slot.
+   *
+   * \param [in] slot The slot.
+   * \param [in] value The value of the slot.
+   */
+  void SetSlot (uint32_t slot, void *value);
+
+private:
+  /** The values of the slots. */
+  void *m_slots[MAX_SLOTS];
+};
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A singleton of each SimulationInstance.
+ *
+ * Like Singleton, with one object per SimulationInstance instead
+ * of one object per process: the object is created, value-initialized,
+ * on the first call to Get() in an instance, and deleted with the
+ * instance.  The object of the default instance is never deleted.
+ *
+ * Plain counters are identified by the class they belong to:
+ * \code
+ *   uint64_t *id = InstanceSingleton<uint64_t, Mac48Address>::Get ();
+ * \endcode
+ *
+ * \tparam T \explicit The type of the singleton.
+ * \tparam Tag \explicit The type which identifies the singleton.
+ */
+template <typename T, typename Tag = T>
+class InstanceSingleton : private NonCopyable
+{
+public:
+  /**
+   * Get a pointer to the object of the current instance.
+   *
+   * \return A pointer to the object of the current instance.
+   */
+  static T * Get (void);
+
+private:
+  /**
+   * Delete the object of an instance.
+   *
+   * \param [in] object The object.
+   */
+  static void Delete (void *object);
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the inline functions and templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+inline void *
+SimulationInstance::GetSlot (uint32_t slot) const
+{
+  return m_slots[slot];
+}
+
+inline void
+SimulationInstance::SetSlot (uint32_t slot, void *value)
+{
+  m_slots[slot] = value;
+}
+
+template <typename T, typename Tag>
+T *
+InstanceSingleton<T, Tag>::Get (void)
+{
+  static const uint32_t slot = SimulationInstance::AllocateSlot (&InstanceSingleton<T, Tag>::Delete);
+  SimulationInstance *instance = SimulationInstance::GetCurrent ();
+  void *object = instance->GetSlot (slot);
+  if (object == 0)
+    {
+      object = new T ();
+      instance->SetSlot (slot, object);
+    }
+  return static_cast<T *> (object);
+}
+
+template <typename T, typename Tag>
+void
+InstanceSingleton<T, Tag>::Delete (void *object)
+{
+  delete static_cast<T *> (object);
+}
+
+} // namespace ns3
+
+#endif /* SIMULATION_INSTANCE_H */
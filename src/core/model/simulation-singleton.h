@@ -34,7 +34,8 @@ namespace ns3 {
  * for which we want a singleton has a lifetime bounded
  * by the simulation run lifetime. That it, the underlying
  * type will be automatically deleted upon a call
- * to Simulator::Destroy.
+ * to Simulator::Destroy.  Each SimulationInstance has its
+ * own instance of the type.
  *
  * For a singleton with a lifetime bounded by the process,
  * not the simulation run, see Singleton.
@@ -99,6 +100,7 @@ private:
  ********************************************************************/
 
 #include "simulator.h"
+#include "simulation-instance.h"
 
 namespace ns3 {
 
@@ -114,13 +116,13 @@ template <typename T>
 T **
 SimulationSingleton<T>::GetObject (void)
 {
-  static T *pobject = 0;
-  if (pobject == 0)
+  T **ppobject = InstanceSingleton<T *, SimulationSingleton<T> >::Get ();
+  if (*ppobject == 0)
     {
-      pobject = new T ();
+      *ppobject = new T ();
       Simulator::ScheduleDestroy (&SimulationSingleton<T>::DeleteObject);
     }
-  return &pobject;
+  return ppobject;
 }
 
 template <typename T>
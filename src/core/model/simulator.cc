@@ -23,7 +23,9 @@
 #include "scheduler.h"
 #include "map-scheduler.h"
 #include "event-impl.h"
+#include "event-memory-pool.h"
 #include "des-metrics.h"
+#include "simulation-instance.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -89,8 +91,7 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
  */
 static SimulatorImpl ** PeekImpl (void)
 {
-  static SimulatorImpl *impl = 0;
-  return &impl;
+  return InstanceSingleton<SimulatorImpl *, Simulator>::Get ();
 }
 
 /**
@@ -159,6 +160,7 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+  EventMemoryPool::Trim ();
 }
 
 void
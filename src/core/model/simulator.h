@@ -119,6 +119,9 @@ public:
    * After this method has been invoked, it is actually possible
    * to restart a new simulation with a set of calls to Simulator::Run,
    * Simulator::Schedule and Simulator::ScheduleWithContext.
+   *
+   * The event storage cached by the EventMemoryPool of the calling
+   * thread is given back to the system allocator.
    */
   static void Destroy (void);
 
@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "size-class-pool.h"
+#include "abort.h"
+#include "assert.h"
+#include "valgrind.h"
+#include "log.h"
+#include <atomic>
+#include <new>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SizeClassPool implementation.
+ */
+
+#if defined (__SANITIZE_ADDRESS__)
+#define NS3_SIZE_CLASS_POOL_DISABLED 1
+#elif defined (__has_feature)
+#if __has_feature (address_sanitizer)
+#define NS3_SIZE_CLASS_POOL_DISABLED 1
+#endif
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SizeClassPool");
+
+/** A released block, linked into the free list of its size class. */
+struct FreeBlock
+{
+  FreeBlock *next; //!< Next released block of the same size class.
+};
+
+struct SizeClassPool::State
+{
+  /**
+   * Constructor.
+   * \param [in] nClasses The number of size classes.
+   */
+  State (std::size_t nClasses)
+    : heads (new FreeBlock *[nClasses] ()),
+      lengths (new uint32_t[nClasses] ()),
+      nClasses (nClasses),
+      stats ()
+  {}
+  /** Destructor, which releases the cached blocks. */
+  ~State ()
+  {
+    Release ();
+    delete [] heads;
+    delete [] lengths;
+  }
+  /** Give all the cached blocks back to `::operator delete`. */
+  void Release (void)
+  {
+    for (std::size_t i = 0; i < nClasses; ++i)
+      {
+        while (heads[i] != 0)
+          {
+            FreeBlock *block = heads[i];
+            heads[i] = block->next;
+            ::operator delete (block);
+          }
+        lengths[i] = 0;
+      }
+    stats.cached = 0;
+  }
+
+  FreeBlock **heads;                 //!< Free list heads, by size class.
+  uint32_t *lengths;                 //!< Free list lengths, by size class.
+  std::size_t nClasses;              //!< The number of size classes.
+  SizeClassPool::Statistics stats;   //!< Counters.
+};
+
+namespace {
+
+/** The largest number of pools with free lists per thread. */
+const int MAX_THREAD_POOLS = 8;
+
+/** The number of pools with free lists per thread. */
+std::atomic<int> g_nThreadPools (0);
+
+/** The free lists of this thread, by pool, created on first use. */
+thread_local SizeClassPool::State *t_states[MAX_THREAD_POOLS];
+/** Set once the free lists of this thread have been torn down at thread exit. */
+thread_local bool t_statesGone = false;
+
+/**
+ * Tear down the free lists of a thread when the thread exits, before
+ * the objects held by static objects are destroyed.
+ */
+class StateReaper
+{
+public:
+  /** Make sure the reaper of this thread is constructed. */
+  void Arm (void)
+  {}
+  ~StateReaper ()
+  {
+    for (int i = 0; i < MAX_THREAD_POOLS; ++i)
+      {
+        delete t_states[i];
+        t_states[i] = 0;
+      }
+    t_statesGone = true;
+  }
+};
+
+/** The reaper of this thread. */
+thread_local StateReaper t_reaper;
+
+} // unnamed namespace
+
+SizeClassPool::SizeClassPool (std::size_t granularity, std::size_t allocatorOverhead,
+                              std::size_t maxBlockSize, uint32_t maxCachedBlocks,
+                              bool perThread)
+  : m_granularity (granularity),
+    m_allocatorOverhead (allocatorOverhead),
+    m_maxBlockSize (maxBlockSize),
+    m_maxCachedBlocks (maxCachedBlocks),
+    m_nClasses ((maxBlockSize + allocatorOverhead) / granularity),
+    m_id (-1),
+    m_shared (0)
+{
+  NS_LOG_FUNCTION (this << granularity << allocatorOverhead << maxBlockSize <<
+                   maxCachedBlocks << perThread);
+  NS_ASSERT ((maxBlockSize + allocatorOverhead) % granularity == 0);
+#ifdef NS3_SIZE_CLASS_POOL_DISABLED
+  m_enabled = false;
+#else
+  m_enabled = (RUNNING_ON_VALGRIND == 0);
+#endif
+  if (perThread)
+    {
+      m_id = g_nThreadPools++;
+      NS_ABORT_MSG_IF (m_id >= MAX_THREAD_POOLS, "Too many SizeClassPool per thread");
+    }
+  else
+    {
+      m_shared = new State (m_nClasses);
+    }
+}
+
+SizeClassPool::~SizeClassPool ()
+{
+  NS_LOG_FUNCTION (this);
+  delete m_shared;
+}
+
+SizeClassPool::State *
+SizeClassPool::GetState (void)
+{
+  if (m_shared != 0)
+    {
+      return m_shared;
+    }
+  State *state = t_states[m_id];
+  if (state == 0 && !t_statesGone)
+    {
+      state = new State (m_nClasses);
+      t_states[m_id] = state;
+      t_reaper.Arm ();
+    }
+  return state;
+}
+
+std::size_t
+SizeClassPool::GetBlockSize (std::size_t size) const
+{
+  if (size == 0 || size > m_maxBlockSize)
+    {
+      return size;
+    }
+  std::size_t granules = (size + m_allocatorOverhead + m_granularity - 1) / m_granularity;
+  return granules * m_granularity - m_allocatorOverhead;
+}
+
+std::size_t
+SizeClassPool::GetClass (std::size_t blockSize) const
+{
+  return (blockSize + m_allocatorOverhead) / m_granularity - 1;
+}
+
+void *
+SizeClassPool::Allocate (std::size_t size)
+{
+  // Small blocks are always allocated with their size class size,
+  // since they may be released into a free list by another thread.
+  std::size_t blockSize = GetBlockSize (size);
+  State *state = GetState ();
+  if (state == 0)
+    {
+      return ::operator new (blockSize);
+    }
+  ++state->stats.allocations;
+  state->stats.bytesInUse += blockSize;
+  if (m_enabled && size > 0 && size <= m_maxBlockSize)
+    {
+      std::size_t index = GetClass (blockSize);
+      FreeBlock *block = state->heads[index];
+      if (block != 0)
+        {
+          state->heads[index] = block->next;
+          --state->lengths[index];
+          --state->stats.cached;
+          ++state->stats.recycled;
+          return block;
+        }
+    }
+  ++state->stats.heapAllocations;
+  return ::operator new (blockSize);
+}
+
+void
+SizeClassPool::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  State *state = GetState ();
+  if (state == 0)
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::size_t blockSize = GetBlockSize (size);
+  ++state->stats.deallocations;
+  state->stats.bytesInUse -= blockSize;
+  if (!m_enabled || size == 0 || size > m_maxBlockSize)
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::size_t index = GetClass (blockSize);
+  if (state->lengths[index] >= m_maxCachedBlocks)
+    {
+      ::operator delete (p);
+      return;
+    }
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = state->heads[index];
+  state->heads[index] = block;
+  ++state->lengths[index];
+  ++state->stats.cached;
+}
+
+SizeClassPool::Statistics
+SizeClassPool::GetStatistics (void)
+{
+  State *state = GetState ();
+  if (state == 0)
+    {
+      return Statistics ();
+    }
+  return state->stats;
+}
+
+bool
+SizeClassPool::IsEnabled (void) const
+{
+  return m_enabled;
+}
+
+void
+SizeClassPool::Trim (void)
+{
+  NS_LOG_FUNCTION (this);
+  State *state = GetState ();
+  if (state == 0)
+    {
+      return;
+    }
+  NS_LOG_INFO ("allocations " << state->stats.allocations <<
+               " recycled " << state->stats.recycled <<
+               " heap " << state->stats.heapAllocations <<
+               " cached " << state->stats.cached <<
+               " in use " << state->stats.bytesInUse);
+  state->Release ();
+}
+
+} // namespace ns3
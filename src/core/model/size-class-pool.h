@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIZE_CLASS_POOL_H
+#define SIZE_CLASS_POOL_H
+
+#include "non-copyable.h"
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SizeClassPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief Size-class free lists of small blocks.
+ *
+ * Requests are rounded up to the next size class, and GetBlockSize()
+ * tells the callers the rounded size.  The size classes are a multiple
+ * of the granularity less the overhead of the general-purpose
+ * allocator, so that a block and its allocator header fill the granules
+ * of the allocator exactly.  Each size class up to the largest block
+ * size keeps a singly linked list of released blocks, of bounded
+ * length; larger requests go straight to `::operator new`.  Each block
+ * is allocated individually, so a block can be released by a different
+ * thread than the one which allocated it.
+ *
+ * The free lists and the counters are either kept per thread, and
+ * need no locking, or shared by all the threads, which must then not
+ * use the pool concurrently.  Per thread, the blocks are released when
+ * the thread exits.
+ *
+ * The pool is bypassed when running under valgrind or when built with
+ * AddressSanitizer, so that use-after-free is still detected; the
+ * statistics are kept in either case.
+ *
+ * EventMemoryPool and PacketMemoryPool are the pools of the events and
+ * of the packet metadata and tags.
+ */
+class SizeClassPool : private NonCopyable
+{
+public:
+  /** Allocation counters. */
+  struct Statistics
+  {
+    uint64_t allocations;     /**< Number of blocks handed out. */
+    uint64_t recycled;        /**< Allocations served from a free list. */
+    uint64_t heapAllocations; /**< Allocations served by `::operator new`. */
+    uint64_t deallocations;   /**< Number of blocks given back. */
+    uint64_t cached;          /**< Blocks currently held in the free lists. */
+    uint64_t bytesInUse;      /**< Bytes of the blocks handed out and not given back. */
+  };
+
+  /**
+   * Constructor.
+   *
+   * \param [in] granularity The size classes are multiples of this
+   *             many bytes, less the overhead.
+   * \param [in] allocatorOverhead The bytes taken by the general-purpose
+   *             allocator for each block.
+   * \param [in] maxBlockSize The largest size served from the free lists.
+   * \param [in] maxCachedBlocks The maximum number of blocks cached per
+   *             size class.
+   * \param [in] perThread Whether each thread has its own free lists.
+   */
+  SizeClassPool (std::size_t granularity, std::size_t allocatorOverhead,
+                 std::size_t maxBlockSize, uint32_t maxCachedBlocks,
+                 bool perThread);
+  /** Destructor. */
+  ~SizeClassPool ();
+
+  /**
+   * Get the size of the block which serves a request.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The size of the block, at least \pname{size}.
+   */
+  std::size_t GetBlockSize (std::size_t size) const;
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns A block of GetBlockSize(\pname{size}) bytes.
+   */
+  void * Allocate (std::size_t size);
+  /**
+   * Release a block obtained from Allocate().
+   *
+   * \param [in] p The block.
+   * \param [in] size The size which was passed to Allocate(), or the
+   *             size of the block.
+   */
+  void Deallocate (void *p, std::size_t size);
+  /**
+   * Get the counters of the free lists of the calling thread.
+   *
+   * \returns The pool statistics.
+   */
+  Statistics GetStatistics (void);
+  /**
+   * Check whether the pool recycles blocks: it is bypassed under
+   * valgrind and AddressSanitizer.
+   *
+   * \returns \c true if released blocks are cached for reuse.
+   */
+  bool IsEnabled (void) const;
+  /**
+   * Give all the blocks cached in the free lists of the calling thread
+   * back to the general-purpose allocator.  The counters are kept.
+   */
+  void Trim (void);
+
+  /** The free lists and the counters of a thread, or of all of them. */
+  struct State;
+
+private:
+  /**
+   * Get the free lists of the calling thread.
+   *
+   * \returns The free lists, or 0 once the thread is exiting.
+   */
+  State * GetState (void);
+  /**
+   * Get the size class of a block.
+   *
+   * \param [in] blockSize The size of the block, from GetBlockSize().
+   * \returns The index of the size class.
+   */
+  std::size_t GetClass (std::size_t blockSize) const;
+
+  std::size_t m_granularity;       //!< The granularity of the size classes.
+  std::size_t m_allocatorOverhead; //!< The overhead of the allocator.
+  std::size_t m_maxBlockSize;      //!< The largest size served from the free lists.
+  uint32_t m_maxCachedBlocks;      //!< The maximum length of a free list.
+  std::size_t m_nClasses;          //!< The number of size classes.
+  bool m_enabled;                  //!< \c false when bypassed.
+  /** The index of the free lists of this pool in those of a thread, or -1. */
+  int m_id;
+  /** The free lists shared by all the threads, without m_id. */
+  State *m_shared;
+};
+
+} // namespace ns3
+
+#endif /* SIZE_CLASS_POOL_H */
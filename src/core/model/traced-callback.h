@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,17 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * Invoking a TracedCallback with no Callbacks connected costs only a
+ * size check, but the arguments are still built by the caller.  When
+ * building an argument is expensive (a Packet copy, for example),
+ * guard the call with IsEmpty():
+ * \code
+ *   if (!m_rxTrace.IsEmpty ())
+ *     {
+ *       m_rxTrace (packet->Copy ());
+ *     }
+ * \endcode
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -89,6 +100,15 @@ public:
    * \param [in] args The arguments to the functor
    */
   void operator() (Ts... args) const;
+  /**
+   * Check whether any Callback is connected to this TracedCallback.
+   *
+   * Call sites can use this to skip building expensive arguments
+   * when nobody is listening.
+   *
+   * \return \c true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
 
   /**
    *  TracedCallback signature for POD.
@@ -107,7 +127,7 @@ private:
    *
    * \tparam Ts \deduced Types of the functor arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
+  typedef std::vector<Callback<void,Ts...> > CallbackList;
   /** The chain of Callbacks. */
   CallbackList m_callbackList;
 };
@@ -181,12 +201,19 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  // Iterate by index: a Callback may connect another one to this
+  // TracedCallback, which can reallocate the chain.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(args...);
+      m_callbackList[i](args...);
     }
 }
+template<typename... Ts>
+bool
+TracedCallback<Ts...>::IsEmpty (void) const
+{
+  return m_callbackList.empty ();
+}
 
 } // namespace ns3
 
@@ -22,9 +22,16 @@
 #include "type-id.h"
 #include "singleton.h"
 #include "trace-source-accessor.h"
+#include "string.h"
+#include "pointer.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <cstdlib>  // getenv
+#ifdef NS3_MTP
+#include <mutex>
+#endif
 #include <sstream>
 #include <iomanip>
 
@@ -51,7 +58,8 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * \brief TypeId information manager
  *
  * Information records are stored in a vector.  Name and hash lookup
- * are performed by maps to the vector index.
+ * are performed by hash tables to the vector index, and each record
+ * indexes its attributes by name.
  *
  * \internal
  * <b>Hash Chaining</b>
@@ -78,6 +86,8 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor. */
+  IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -229,6 +239,21 @@ public:
    * \returns The information associated to attribute whose index is \pname{i}.
    */
   struct TypeId::AttributeInformation GetAttribute (uint16_t uid, std::size_t i) const;
+  /**
+   * Find an Attribute registered by a type id, without looking at its
+   * parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \param [out] i The index of the Attribute, if found.
+   * \returns \c true if \pname{uid} registered the Attribute \pname{name}.
+   */
+  bool FindAttribute (uint16_t uid, const std::string &name, std::size_t *i) const;
+  /**
+   * Get the attributes to set on a new object of a type id.
+   * \param [in] uid The id.
+   * \returns The attributes, in construction order.
+   */
+  Ptr<const TypeId::ConstructionInformation> GetConstructionInformation (uint16_t uid);
   /**
    * Record a new TraceSource.
    * \param [in] uid The id.
@@ -292,6 +317,12 @@ private:
    * \returns The hashed value of \pname{name}.
    */
   static TypeId::hash_t Hasher (const std::string name);
+  /**
+   * Gather the attributes to set on a new object of a type id.
+   * \param [in] uid The id.
+   * \returns The attributes, in construction order.
+   */
+  Ptr<TypeId::ConstructionInformation> DoGetConstructionInformation (uint16_t uid) const;
 
   /** The information record about a single type id. */
   struct IidInformation
@@ -314,6 +345,12 @@ private:
     bool mustHideFromDocumentation;
     /** The container of Attributes. */
     std::vector<struct TypeId::AttributeInformation> attributes;
+    /** The by-name index of the Attributes. */
+    std::unordered_map<std::string, std::size_t> attributeIndex;
+    /** The attributes to set on construction, or 0 if not gathered yet. */
+    Ptr<const TypeId::ConstructionInformation> construction;
+    /** The value of m_generation when \c construction was gathered. */
+    uint32_t constructionGeneration;
     /** The container of TraceSources. */
     std::vector<struct TypeId::TraceSourceInformation> traceSources;
     /** Support level/deprecation. */
@@ -335,15 +372,25 @@ private:
   std::vector<struct IidInformation> m_information;
 
   /** Type of the by-name index. */
-  typedef std::map<std::string, uint16_t> namemap_t;
+  typedef std::unordered_map<std::string, uint16_t> namemap_t;
   /** The by-name index. */
   namemap_t m_namemap;
 
   /** Type of the by-hash index. */
-  typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+  typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /**
+   * Count of the changes to parents, attributes and initial values,
+   * which invalidate the gathered construction information.
+   */
+  uint32_t m_generation;
+#ifdef NS3_MTP
+  /** Serializes the gathering of construction information. */
+  std::mutex m_constructionMutex;
+#endif
+
 
   /** IidManager constants. */
   enum
@@ -359,6 +406,10 @@ private:
 };
 
 
+IidManager::IidManager ()
+  : m_generation (0)
+{}
+
 //static
 TypeId::hash_t
 IidManager::Hasher (const std::string name)
@@ -443,6 +494,7 @@ IidManager::AllocateUid (std::string name)
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
   information.supportLevel = TypeId::SUPPORTED;
+  information.constructionGeneration = 0;
   m_information.push_back (information);
   std::size_t tuid = m_information.size ();
   NS_ASSERT (tuid <= 0xffff);
@@ -471,6 +523,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  m_generation++;
 }
 void
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -620,14 +673,10 @@ IidManager::HasAttribute (uint16_t uid,
   struct IidInformation *information  = LookupInformation (uid);
   while (true)
     {
-      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = information->attributes.begin ();
-           i != information->attributes.end (); ++i)
+      if (information->attributeIndex.count (name) != 0)
         {
-          if (i->name == name)
-            {
-              NS_LOG_LOGIC (IIDL << true);
-              return true;
-            }
+          NS_LOG_LOGIC (IIDL << true);
+          return true;
         }
       struct IidInformation *parent = LookupInformation (information->parent);
       if (parent == information)
@@ -681,6 +730,8 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  information->attributeIndex[name] = information->attributes.size () - 1;
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void
@@ -692,6 +743,7 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  m_generation++;
 }
 
 
@@ -714,6 +766,116 @@ IidManager::GetAttribute (uint16_t uid, std::size_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->attributes[i];
 }
+bool
+IidManager::FindAttribute (uint16_t uid, const std::string &name, std::size_t *i) const
+{
+  NS_LOG_FUNCTION (IID << uid << name << i);
+  struct IidInformation *information = LookupInformation (uid);
+  std::unordered_map<std::string, std::size_t>::const_iterator it = information->attributeIndex.find (name);
+  if (it == information->attributeIndex.end ())
+    {
+      NS_LOG_LOGIC (IIDL << false);
+      return false;
+    }
+  *i = it->second;
+  NS_LOG_LOGIC (IIDL << true);
+  return true;
+}
+Ptr<const TypeId::ConstructionInformation>
+IidManager::GetConstructionInformation (uint16_t uid)
+{
+  NS_LOG_FUNCTION (IID << uid);
+#ifdef NS3_MTP
+  // objects may be created concurrently by the partitions
+  std::lock_guard<std::mutex> lock (m_constructionMutex);
+#endif
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->construction == 0
+      || information->constructionGeneration != m_generation)
+    {
+      information->construction = DoGetConstructionInformation (uid);
+      information->constructionGeneration = m_generation;
+    }
+  return information->construction;
+}
+Ptr<TypeId::ConstructionInformation>
+IidManager::DoGetConstructionInformation (uint16_t uid) const
+{
+  NS_LOG_FUNCTION (IID << uid);
+  // Split the environment variable into full attribute names and values.
+  std::map<std::string, std::string> env;
+  const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0)
+    {
+      std::string tmp = envVar;
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = tmp.find (";", cur);
+          std::string item = std::string (tmp, cur, next - cur);
+          std::string::size_type equal = item.find ("=");
+          if (equal != std::string::npos)
+            {
+              env.insert (std::make_pair (item.substr (0, equal), item.substr (equal + 1)));
+            }
+          cur = next + 1;
+        }
+    }
+
+  Ptr<TypeId::ConstructionInformation> construction = Create<TypeId::ConstructionInformation> ();
+  struct IidInformation *information = LookupInformation (uid);
+  while (true)
+    {
+      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = information->attributes.begin ();
+           i != information->attributes.end (); ++i)
+        {
+          struct TypeId::AttributeConstructionInformation info;
+          info.tidName = information->name;
+          info.name = i->name;
+          info.flags = i->flags;
+          info.accessor = i->accessor;
+          info.checker = i->checker;
+          info.initialValue = i->initialValue;
+          std::map<std::string, std::string>::const_iterator e = env.find (information->name + "::" + i->name);
+          if (e != env.end ())
+            {
+              StringValue envValue (e->second);
+              if (i->checker->CreateValidValue (envValue) != 0)
+                {
+                  info.initialValue = envValue.Copy ();
+                }
+            }
+          // Convert the value once, unless the conversion creates an
+          // object (a random variable from a string, for example)
+          // which each new object must get its own copy of.
+          info.checked = i->checker->Check (*info.initialValue);
+          if (!info.checked
+              && dynamic_cast<const PointerChecker *> (PeekPointer (i->checker)) == 0)
+            {
+              Ptr<const AttributeValue> value = i->checker->CreateValidValue (*info.initialValue);
+              if (value != 0)
+                {
+                  info.initialValue = value;
+                  info.checked = true;
+                }
+            }
+          construction->attributes.push_back (info);
+        }
+      if (information->parent == 0)
+        {
+          break;
+        }
+      struct IidInformation *parent = LookupInformation (information->parent);
+      if (parent == information)
+        {
+          // top of inheritance tree
+          break;
+        }
+      information = parent;
+    }
+  return construction;
+}
 
 bool
 IidManager::HasTraceSource (uint16_t uid,
@@ -888,29 +1050,27 @@ TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInforma
   do
     {
       tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
+      std::size_t i;
+      if (IidManager::Get ()->FindAttribute (tid.m_tid, name, &i))
         {
           struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
+          if (tmp.supportLevel == TypeId::SUPPORTED)
             {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                            << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name <<
-                                  "' is obsolete, with no fallback: " <<
-                                  tmp.supportMsg);
-                }
+              *info = tmp;
+              return true;
+            }
+          else if (tmp.supportLevel == TypeId::DEPRECATED)
+            {
+              std::cerr << "Attribute '" << name << "' is deprecated: "
+                        << tmp.supportMsg << std::endl;
+              *info = tmp;
+              return true;
+            }
+          else if (tmp.supportLevel == TypeId::OBSOLETE)
+            {
+              NS_FATAL_ERROR ("Attribute '" << name <<
+                              "' is obsolete, with no fallback: " <<
+                              tmp.supportMsg);
             }
         }
       nextTid = tid.GetParent ();
@@ -918,6 +1078,12 @@ TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInforma
   while (nextTid != tid);
   return false;
 }
+Ptr<const TypeId::ConstructionInformation>
+TypeId::GetConstructionInformation (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return IidManager::Get ()->GetConstructionInformation (m_tid);
+}
 
 TypeId
 TypeId::SetParent (TypeId tid)
@@ -28,6 +28,7 @@
 #include "deprecated.h"
 #include "hash.h"
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 /**
@@ -111,6 +112,39 @@ public:
     /** Support message. */
     std::string supportMsg;
   };
+  /** Attribute prepared for object construction. */
+  struct AttributeConstructionInformation
+  {
+    /** Name of the TypeId which registered the attribute. */
+    std::string tidName;
+    /** Attribute name. */
+    std::string name;
+    /** AttributeFlags value. */
+    uint32_t flags;
+    /**
+     * Value to set when the object is not given one: the configured
+     * initial value, or the NS_ATTRIBUTE_DEFAULT environment variable.
+     */
+    Ptr<const AttributeValue> initialValue;
+    /**
+     * \c true if \c initialValue was accepted by the checker and can be
+     * set without conversion.
+     */
+    bool checked;
+    /** Accessor object. */
+    Ptr<const AttributeAccessor> accessor;
+    /** Checker object. */
+    Ptr<const AttributeChecker> checker;
+  };
+  /**
+   * The attributes of a TypeId and of all its parents, in the order
+   * in which ObjectBase::ConstructSelf sets them.
+   */
+  struct ConstructionInformation : public SimpleRefCount<ConstructionInformation>
+  {
+    /** The attributes. */
+    std::vector<struct AttributeConstructionInformation> attributes;
+  };
 
   /** Type of hash values. */
   typedef uint32_t hash_t;
@@ -472,6 +506,16 @@ public:
    * \returns \c true if the requested attribute could be found.
    */
   bool LookupAttributeByName (std::string name, struct AttributeInformation *info) const;
+  /**
+   * Get the attributes to set on a new object of this TypeId.
+   *
+   * The information is gathered once from this TypeId and its parents,
+   * and gathered again only after an attribute or an initial value of
+   * any TypeId was changed.
+   *
+   * \returns The attributes, in construction order.
+   */
+  Ptr<const ConstructionInformation> GetConstructionInformation (void) const;
   /**
    * Find a TraceSource by name.
    *
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// The test compares the binary log with the text NS_LOG prints, so it
+// needs the NS_LOG macros even when ns-3 is built without logging.
+#ifndef NS3_LOG_ENABLE
+#define NS3_LOG_ENABLE
+#endif
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/binary-log.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * \ingroup logging-tests
+ * BinaryLog test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \ingroup logging
+ * \defgroup logging-tests Logging test suite
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BinaryLogTestSuite");
+
+/**
+ * \ingroup logging-tests
+ *
+ * Run the same NS_LOG statements with and without a binary log, and
+ * check that the decoded binary log matches the text log.
+ */
+class BinaryLogTestCase : public TestCase
+{
+public:
+  BinaryLogTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Log each kind of argument, at each level. */
+  void Log (void);
+  /** Schedule Log() at different times and contexts, and run. */
+  void Run (void);
+};
+
+BinaryLogTestCase::BinaryLogTestCase ()
+  : TestCase ("Check that a decoded BinaryLog matches the text log")
+{}
+
+void
+BinaryLogTestCase::Log (void)
+{
+  NS_LOG_FUNCTION (this << 3 << "literal" << std::string ("string") << int8_t (-2) << 1.5);
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_DEBUG ("int " << -7 << " unsigned " << 7u << " char " << 'x'
+                << " double " << 0.1 << " bool " << true);
+  NS_LOG_INFO ("pointer " << this << " time " << Simulator::Now ()
+               << " string " << std::string ("s"));
+  NS_LOG_LOGIC ("hex " << std::hex << 255 << " " << 16
+                << " width " << std::setw (5) << 3 << std::dec);
+  NS_LOG_WARN ("after the manipulators " << 255 << " " << Seconds (1.5).As (Time::MS));
+  NS_LOG_ERROR ("error");
+}
+
+void
+BinaryLogTestCase::Run (void)
+{
+  Simulator::Schedule (Seconds (1), &BinaryLogTestCase::Log, this);
+  Simulator::ScheduleWithContext (3, MilliSeconds (1500), &BinaryLogTestCase::Log, this);
+  Log ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+BinaryLogTestCase::DoRun (void)
+{
+  LogComponentEnable ("BinaryLogTestSuite", LOG_LEVEL_ALL);
+  LogComponentEnable ("BinaryLogTestSuite", LOG_PREFIX_ALL);
+
+  std::ostringstream text;
+  std::streambuf *clog = std::clog.rdbuf (text.rdbuf ());
+  Run ();
+  std::clog.rdbuf (clog);
+
+  std::string filename = CreateTempDirFilename ("binary-log.bin");
+  BinaryLog::Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (BinaryLog::IsOpen (), true, "The binary log is not open");
+  Run ();
+  BinaryLog::Close ();
+  NS_TEST_ASSERT_MSG_EQ (BinaryLog::IsOpen (), false, "The binary log is still open");
+
+  LogComponentDisable ("BinaryLogTestSuite", LOG_LEVEL_ALL);
+  LogComponentDisable ("BinaryLogTestSuite", LOG_PREFIX_ALL);
+
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  std::ostringstream decoded;
+  NS_TEST_ASSERT_MSG_EQ (BinaryLog::Decode (is, decoded), true, "Could not decode the binary log");
+  NS_TEST_EXPECT_MSG_EQ (decoded.str (), text.str (), "The decoded binary log differs from the text log");
+
+  std::ifstream whole (filename.c_str (), std::ios::binary);
+  std::string bytes ((std::istreambuf_iterator<char> (whole)), std::istreambuf_iterator<char> ());
+  std::istringstream truncated (bytes.substr (0, bytes.size () - 1));
+  std::ostringstream ignored;
+  NS_TEST_EXPECT_MSG_EQ (BinaryLog::Decode (truncated, ignored), false, "Decoded a truncated binary log");
+}
+
+/**
+ * \ingroup logging-tests
+ *
+ * BinaryLog test suite.
+ */
+class BinaryLogTestSuite : public TestSuite
+{
+public:
+  BinaryLogTestSuite ()
+    : TestSuite ("binary-log")
+  {
+    AddTestCase (new BinaryLogTestCase, TestCase::QUICK);
+  }
+};
+
+static BinaryLogTestSuite g_binaryLogTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/checkpoint.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/random-variable-stream.h"
+#include <cstdio>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * Checkpoint test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Fork a warmed-up simulation into variants which each run for a
+ * different time, and check that each variant continues from the
+ * warmed-up state.
+ */
+class CheckpointTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] type The simulator implementation.
+   */
+  CheckpointTestCase (std::string type);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Count the ticks of each context, every millisecond.
+   * \param [in] context The context of the event.
+   */
+  void Tick (uint32_t context);
+
+  std::string m_type;        //!< The simulator implementation.
+  uint32_t m_ticks[2];       //!< The ticks of each context.
+};
+
+CheckpointTestCase::CheckpointTestCase (std::string type)
+  : TestCase ("Check Checkpoint::Fork with " + type),
+    m_type (type)
+{}
+
+void
+CheckpointTestCase::Tick (uint32_t context)
+{
+  m_ticks[context]++;
+  Simulator::Schedule (MilliSeconds (1), &CheckpointTestCase::Tick, this, context);
+}
+
+void
+CheckpointTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (m_type));
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      impl->SetThreadCount (2);
+      impl->SetLookahead (MilliSeconds (1));
+    }
+  m_ticks[0] = m_ticks[1] = 0;
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      Simulator::ScheduleWithContext (i, MicroSeconds (500), &CheckpointTestCase::Tick, this, i);
+    }
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_ticks[0], 100u, "Warm-up ticks of context 0");
+  NS_TEST_ASSERT_MSG_EQ (m_ticks[1], 100u, "Warm-up ticks of context 1");
+
+  uint32_t variant = Checkpoint::Fork (3);
+  Simulator::Stop (MilliSeconds (10 * (variant + 1)));
+  Simulator::Run ();
+  // the children must not return to the test framework
+  bool ok = Checkpoint::GetVariant () == variant
+    && Simulator::Now () == MilliSeconds (100 + 10 * (variant + 1))
+    && m_ticks[0] == 100 + 10 * (variant + 1)
+    && m_ticks[1] == m_ticks[0];
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  if (variant != 0)
+    {
+      Checkpoint::Exit (ok ? 0 : 1);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Variant 0 did not continue from the warm-up state");
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::Wait (), 0u, "Failed variants");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Save the attributes and the random number streams of a simulation,
+ * and restore them into a simulation built again.
+ */
+class CheckpointSaveTestCase : public TestCase
+{
+public:
+  CheckpointSaveTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a random variable in the configuration namespace.
+   * \returns The random variable.
+   */
+  Ptr<UniformRandomVariable> Build (void);
+};
+
+CheckpointSaveTestCase::CheckpointSaveTestCase ()
+  : TestCase ("Check Checkpoint::Save and Checkpoint::Restore")
+{}
+
+Ptr<UniformRandomVariable>
+CheckpointSaveTestCase::Build (void)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (42);
+  Config::RegisterRootNamespaceObject (uniform);
+  return uniform;
+}
+
+void
+CheckpointSaveTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("checkpoint.bin");
+  Ptr<UniformRandomVariable> uniform = Build ();
+  uniform->SetAttribute ("Min", DoubleValue (10));
+  uniform->SetAttribute ("Max", DoubleValue (20));
+  // an odd number of values, so that some are generated ahead
+  for (uint32_t i = 0; i < 7; ++i)
+    {
+      uniform->GetValue ();
+    }
+  Checkpoint::Save (filename);
+  std::vector<double> expected;
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      expected.push_back (uniform->GetValue ());
+    }
+  Config::UnregisterRootNamespaceObject (uniform);
+
+  uniform = Build ();
+  NS_TEST_ASSERT_MSG_EQ (Checkpoint::Restore (filename), true, "Could not restore " << filename);
+  DoubleValue max;
+  uniform->GetAttribute ("Max", max);
+  NS_TEST_EXPECT_MSG_EQ (max.Get (), 20, "The attribute was not restored");
+  IntegerValue stream;
+  uniform->GetAttribute ("Stream", stream);
+  NS_TEST_EXPECT_MSG_EQ (stream.Get (), 42, "Wrong stream");
+  for (uint32_t i = 0; i < expected.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (uniform->GetValue (), expected[i], "Wrong random number " << i);
+    }
+  Config::UnregisterRootNamespaceObject (uniform);
+  std::remove (filename.c_str ());
+
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::Restore (filename), false, "Restored a missing file");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+public:
+  CheckpointTestSuite ()
+    : TestSuite ("checkpoint")
+  {
+    AddTestCase (new CheckpointTestCase ("ns3::DefaultSimulatorImpl"), TestCase::QUICK);
+    AddTestCase (new CheckpointTestCase ("ns3::MultithreadedSimulatorImpl"), TestCase::QUICK);
+    AddTestCase (new CheckpointSaveTestCase (), TestCase::QUICK);
+  }
+};
+
+static CheckpointTestSuite g_checkpointTestSuite; //!< Static variable for test initialization
@@ -840,6 +840,64 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test the matches of index expressions on vectors of objects.
+ */
+class LookupMatchesConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  LookupMatchesConfigTestCase ();
+  /** Destructor. */
+  virtual ~LookupMatchesConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LookupMatchesConfigTestCase::LookupMatchesConfigTestCase ()
+  : TestCase ("Check the objects and paths matched by index expressions")
+{}
+
+void
+LookupMatchesConfigTestCase::DoRun (void)
+{
+  //
+  // Use the name service so that the objects registered in the root
+  // namespace by the other test cases do not match.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("LookupMatchesRoot", root);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeB (objects.back ());
+    }
+
+  //
+  // Alternatives are visited once each, in index order, and indices
+  // beyond the end of the vector are ignored.
+  //
+  Config::MatchContainer matches = Config::LookupMatches ("/Names/LookupMatchesRoot/NodesB/3|[0-1]|1|9|[2-1]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3u, "Wrong number of matches");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (0), objects[0], "Wrong first match");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (1), objects[1], "Wrong second match");
+  NS_TEST_EXPECT_MSG_EQ (matches.Get (2), objects[3], "Wrong third match");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetMatchedPath (2), "/Names/LookupMatchesRoot/NodesB/3/", "Wrong matched path");
+
+  matches = Config::LookupMatches ("/Names/LookupMatchesRoot/NodesB/2|*");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 4u, "Wrong number of matches of *");
+  matches = Config::LookupMatches ("/Names/LookupMatchesRoot/NodesB/[4-9]");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 0u, "Unexpected match beyond the end of the vector");
+  matches = Config::LookupMatches ("/Names/LookupMatchesRoot/NodesB");
+  NS_TEST_EXPECT_MSG_EQ (matches.GetN (), 0u, "Unexpected match of the vector itself");
+
+  Names::Clear ();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +916,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new LookupMatchesConfigTestCase);
 }
 
 /**
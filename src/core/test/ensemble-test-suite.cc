@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ensemble.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/global-value.h"
+#include "ns3/names.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * Ensemble test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Run replications which each change the simulator, global values,
+ * names and random numbers, and check that each replication starts
+ * from a fresh state and leaves the calling thread unchanged.
+ */
+class EnsembleTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] threads The number of threads.
+   */
+  EnsembleTestCase (uint32_t threads);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run a replication.
+   * \param [in] index The index of the replication.
+   */
+  void Replication (uint32_t index);
+  /**
+   * Count the ticks of each context, every millisecond.
+   * \param [in] index The index of the replication.
+   * \param [in] context The context of the event.
+   */
+  void Tick (uint32_t index, uint32_t context);
+
+  /** The observations of a replication. */
+  struct Result
+  {
+    bool fresh;         //!< Whether the replication started from a fresh state.
+    double value;       //!< The first random value of the replication.
+    Time end;           //!< The end time of the replication.
+    uint32_t ticks[2];  //!< The ticks of each context.
+  };
+
+  uint32_t m_threads;             //!< The number of threads.
+  uint64_t m_run;                 //!< The run of the calling thread.
+  std::vector<Result> m_results;  //!< The observations of each replication.
+};
+
+EnsembleTestCase::EnsembleTestCase (uint32_t threads)
+  : TestCase ("Check Ensemble::Run with threads=" + std::to_string (threads)),
+    m_threads (threads)
+{}
+
+void
+EnsembleTestCase::Tick (uint32_t index, uint32_t context)
+{
+  m_results[index].ticks[context]++;
+  Simulator::Schedule (MilliSeconds (1), &EnsembleTestCase::Tick, this, index, context);
+}
+
+void
+EnsembleTestCase::Replication (uint32_t index)
+{
+  Result &result = m_results[index];
+  result.fresh = Names::Find<Object> ("replication") == 0
+    && RngSeedManager::GetRun () == m_run;
+
+  RngSeedManager::SetRun (index + 1);
+  Names::Add ("replication", CreateObject<Object> ());
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  result.value = uniform->GetValue ();
+
+  if (index % 2 == 1)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+      // the simulator of the replication is created now
+      Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+      if (impl == 0)
+        {
+          result.fresh = false;
+          return;
+        }
+      impl->SetThreadCount (2);
+      impl->SetLookahead (MilliSeconds (1));
+    }
+  result.ticks[0] = result.ticks[1] = 0;
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      Simulator::ScheduleWithContext (i, MicroSeconds (500), &EnsembleTestCase::Tick, this, index, i);
+    }
+  Simulator::Stop (MilliSeconds (10 * (index + 1)));
+  Simulator::Run ();
+  result.end = Simulator::Now ();
+}
+
+void
+EnsembleTestCase::DoRun (void)
+{
+  const uint32_t replications = 6;
+  m_run = RngSeedManager::GetRun ();
+  m_results.resize (replications);
+
+  Ensemble::Run (replications, MakeCallback (&EnsembleTestCase::Replication, this), m_threads);
+
+  for (uint32_t i = 0; i < replications; ++i)
+    {
+      const Result &result = m_results[i];
+      NS_TEST_EXPECT_MSG_EQ (result.fresh, true, "Replication " << i << " did not start from a fresh state");
+      RngStream stream (RngSeedManager::GetSeed (), 0, i + 1);
+      NS_TEST_EXPECT_MSG_EQ (result.value, stream.RandU01 (), "Replication " << i << " drew the wrong random value");
+      NS_TEST_EXPECT_MSG_EQ (result.end, MilliSeconds (10 * (i + 1)), "Replication " << i << " ended at the wrong time");
+      NS_TEST_EXPECT_MSG_EQ (result.ticks[0], 10 * (i + 1), "Replication " << i << " ticks of context 0");
+      NS_TEST_EXPECT_MSG_EQ (result.ticks[1], 10 * (i + 1), "Replication " << i << " ticks of context 1");
+    }
+
+  StringValue type;
+  GlobalValue::GetValueByName ("SimulatorImplementationType", type);
+  NS_TEST_EXPECT_MSG_EQ (type.Get (), "ns3::DefaultSimulatorImpl", "A replication changed the global values of the caller");
+  NS_TEST_EXPECT_MSG_EQ (RngSeedManager::GetRun (), m_run, "A replication changed the run of the caller");
+  NS_TEST_EXPECT_MSG_EQ ((Names::Find<Object> ("replication") == 0), true, "A replication named an object of the caller");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Ensemble test suite.
+ */
+class EnsembleTestSuite : public TestSuite
+{
+public:
+  EnsembleTestSuite ()
+    : TestSuite ("ensemble")
+  {
+    AddTestCase (new EnsembleTestCase (1), TestCase::QUICK);
+    AddTestCase (new EnsembleTestCase (3), TestCase::QUICK);
+  }
+};
+
+static EnsembleTestSuite g_ensembleTestSuite; //!< Static variable for test initialization
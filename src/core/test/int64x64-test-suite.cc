@@ -24,6 +24,7 @@
 #endif
 
 #include <cmath>    // fabs
+#include <cstdlib>  // abs
 #include <iomanip>
 #include <limits>   // numeric_limits<>::epsilon ()
 
@@ -1237,6 +1238,119 @@ Int64x64DoubleTestCase::DoRun (void)
 }
 
 
+class Int64x64DoubleBitsTestCase : public TestCase
+{
+public:
+  Int64x64DoubleBitsTestCase ();
+  virtual void DoRun (void);
+  void Check (const double value);
+};
+
+Int64x64DoubleBitsTestCase::Int64x64DoubleBitsTestCase ()
+  : TestCase ("Construct from double as from long double")
+{}
+
+void
+Int64x64DoubleBitsTestCase::Check (const double value)
+{
+  const int64x64_t result = int64x64_t (value);
+  const int64x64_t expect = int64x64_t (static_cast<long double> (value));
+  NS_TEST_EXPECT_MSG_EQ (result, expect,
+                         "int64x64_t (double) differs for " << value);
+}
+
+void
+Int64x64DoubleBitsTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Double bits: " << GetName ()
+            << std::endl;
+
+  // Values around the rounding of the last fraction bit and the limits
+  // of the exact conversion.
+  Check (0.0);
+  Check (-0.0);
+  Check (std::ldexp (1.0, -66));
+  Check (std::ldexp (1.0, -65));
+  Check (std::ldexp (1.0, -64));
+  Check (std::ldexp (3.0, -66));
+  Check (std::ldexp (3.0, -65));
+  Check (-std::ldexp (3.0, -65));
+  Check (std::numeric_limits<double>::denorm_min ());
+  Check (std::numeric_limits<double>::min ());
+  Check (0.1);
+  Check (-0.5);
+  Check (1e-9);
+  Check (1.0 - std::numeric_limits<double>::epsilon () / 2);
+  Check (1234567.000000001);
+  Check (-std::ldexp (1.0, 62));
+  Check (std::ldexp (1.0, 63) - 1024);
+  Check (-std::ldexp (1.0, 63) + 1024);
+
+  // Pseudo-random bit patterns, of magnitude less than 2^63.
+  uint64_t state = 12345;
+  for (int i = 0; i < 100000; ++i)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      const double mantissa = static_cast<double> (state >> 11);
+      const int exponent = static_cast<int> (state % 136) - 126;
+      Check (((state >> 10) & 1) ? -std::ldexp (mantissa, exponent) : std::ldexp (mantissa, exponent));
+    }
+}
+
+
+class Int64x64IntegerDivisionTestCase : public TestCase
+{
+public:
+  Int64x64IntegerDivisionTestCase ();
+  virtual void DoRun (void);
+  void Check (const int64x64_t & a, const int64_t n);
+};
+
+Int64x64IntegerDivisionTestCase::Int64x64IntegerDivisionTestCase ()
+  : TestCase ("Divide by an integer")
+{}
+
+void
+Int64x64IntegerDivisionTestCase::Check (const int64x64_t & a, const int64_t n)
+{
+  // The quotient is truncated toward zero, to the nearest 2^-64:
+  // the remainder has the sign of a, and is less than n * 2^-64.
+  const int64x64_t q = a / int64x64_t (n);
+  const int64x64_t r = a - q * n;
+  const bool pass = Abs (r) < int64x64_t (0, std::abs (n))
+    && (r == int64x64_t () || (r < int64x64_t ()) == (a < int64x64_t ()));
+  NS_TEST_EXPECT_MSG_EQ (pass, true,
+                         "int64x64_t division by " << n << " failed for " << a);
+}
+
+void
+Int64x64IntegerDivisionTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Integer division: " << GetName ()
+            << std::endl;
+
+  if (int64x64_t::implementation == int64x64_t::ld_impl)
+    {
+      std::cout << "skipping for the long double implementation" << std::endl;
+      return;
+    }
+
+  const int64_t divisors[] = {1, -1, 2, 3, -7, 1000, 1000000000, -1000000007, 1LL << 40};
+  uint64_t state = 54321;
+  for (int i = 0; i < 10000; ++i)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      const int64x64_t a (static_cast<int64_t> (state) >> 24, state * 0x9e3779b97f4a7c15ULL);
+      for (std::size_t j = 0; j < sizeof (divisors) / sizeof (divisors[0]); ++j)
+        {
+          Check (a, divisors[j]);
+        }
+    }
+}
+
+
 class Int64x64ImplTestCase : public TestCase
 {
 public:
@@ -1298,6 +1412,8 @@ public:
     AddTestCase (new Int64x64Bug1786TestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64InvertTestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64DoubleTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64DoubleBitsTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64IntegerDivisionTestCase (), TestCase::QUICK);
   }
 }  g_int64x64TestSuite;
 
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/mpsc-queue.h"
+
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * MpscQueue test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Check the order and the capacity of a queue used by a single thread.
+ */
+class MpscQueueOrderTestCase : public TestCase
+{
+public:
+  MpscQueueOrderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpscQueueOrderTestCase::MpscQueueOrderTestCase ()
+  : TestCase ("Check the order and the capacity of MpscQueue")
+{}
+
+void
+MpscQueueOrderTestCase::DoRun (void)
+{
+  MpscQueue<uint32_t> queue (5);
+  uint32_t value;
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "New queue is not empty");
+  NS_TEST_EXPECT_MSG_EQ (queue.Pop (value), false, "Popped from an empty queue");
+
+  uint32_t next = 0;
+  uint32_t expected = 0;
+  // Several laps of the ring, with 1 to 8 values in the queue.
+  for (uint32_t lap = 0; lap < 10; ++lap)
+    {
+      uint32_t n = 1 + lap % 8;
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue.TryPush (next), true, "Could not push value " << next);
+          next++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), false, "Queue with values is empty");
+      while (queue.Pop (value))
+        {
+          NS_TEST_EXPECT_MSG_EQ (value, expected, "Values out of order");
+          expected++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (expected, next, "Values lost");
+    }
+
+  // The capacity is rounded up to 8.
+  for (uint32_t i = 0; i < 8; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue.TryPush (i), true, "Could not push value " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue.TryPush (8), false, "Pushed to a full queue");
+  NS_TEST_EXPECT_MSG_EQ (queue.Pop (value), true, "Could not pop from a full queue");
+  NS_TEST_EXPECT_MSG_EQ (value, 0, "Wrong value");
+  NS_TEST_EXPECT_MSG_EQ (queue.TryPush (8), true, "Could not push after a pop");
+  while (queue.Pop (value))
+    {
+    }
+
+  // Push does not wait for a consumer: the values beyond the ring spill,
+  // and are popped in order.
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      queue.Push (i);
+    }
+  for (uint32_t i = 0; i < 50; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue.Pop (value), true, "Could not pop spilled values");
+      NS_TEST_EXPECT_MSG_EQ (value, i, "Spilled values out of order");
+    }
+  // The ring has room again, but the new values stay behind the spilled ones.
+  for (uint32_t i = 100; i < 110; ++i)
+    {
+      queue.Push (i);
+    }
+  for (uint32_t i = 50; i < 110; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue.Pop (value), true, "Could not pop spilled values");
+      NS_TEST_EXPECT_MSG_EQ (value, i, "Spilled values out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "Values were left in the queue");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Check that the values of several producer threads reach the consumer
+ * thread, each in the order of its producer.
+ */
+class MpscQueueThreadsTestCase : public TestCase
+{
+public:
+  MpscQueueThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Push values to the queue.
+   * \param [in] producer The producer.
+   */
+  void Produce (uint32_t producer);
+
+  /** The number of producer threads. */
+  static const uint32_t PRODUCERS = 4;
+  /** The number of values of each producer. */
+  static const uint32_t VALUES = 20000;
+
+  /** The queue, smaller than the values so that they spill. */
+  MpscQueue<uint64_t> m_queue;
+};
+
+MpscQueueThreadsTestCase::MpscQueueThreadsTestCase ()
+  : TestCase ("Check MpscQueue with several producer threads"),
+    m_queue (64)
+{}
+
+void
+MpscQueueThreadsTestCase::Produce (uint32_t producer)
+{
+  for (uint32_t i = 0; i < VALUES; ++i)
+    {
+      m_queue.Push (((uint64_t) producer << 32) | i);
+    }
+}
+
+void
+MpscQueueThreadsTestCase::DoRun (void)
+{
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < PRODUCERS; ++i)
+    {
+      threads.push_back (std::thread (&MpscQueueThreadsTestCase::Produce, this, i));
+    }
+
+  std::vector<uint32_t> next (PRODUCERS, 0);
+  uint32_t errors = 0;
+  for (uint32_t received = 0; received < PRODUCERS * VALUES; )
+    {
+      uint64_t value;
+      if (!m_queue.Pop (value))
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      uint32_t producer = value >> 32;
+      if (producer >= PRODUCERS || (value & 0xffffffff) != next[producer])
+        {
+          errors++;
+        }
+      else
+        {
+          next[producer]++;
+        }
+      received++;
+    }
+  for (uint32_t i = 0; i < PRODUCERS; ++i)
+    {
+      threads[i].join ();
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (errors, 0, "Values were lost, duplicated or reordered");
+  NS_TEST_EXPECT_MSG_EQ (m_queue.IsEmpty (), true, "Values were left in the queue");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * MpscQueue test suite.
+ */
+class MpscQueueTestSuite : public TestSuite
+{
+public:
+  MpscQueueTestSuite ()
+    : TestSuite ("mpsc-queue")
+  {
+    AddTestCase (new MpscQueueOrderTestCase (), TestCase::QUICK);
+    AddTestCase (new MpscQueueThreadsTestCase (), TestCase::QUICK);
+  }
+};
+
+static MpscQueueTestSuite g_mpscQueueTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,317 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+using namespace ns3;
+
+namespace {
+
+const uint32_t N_CONTEXTS = 16;   //!< Number of contexts.
+const uint32_t N_TOKENS = 64;     //!< Number of tokens.
+const uint32_t N_HOPS = 200;      //!< Hops per token.
+const uint64_t LOOKAHEAD = 10000; //!< Lookahead in ns.
+const uint64_t STOP = 2000000;    //!< Stop time in ns.
+const uint64_t STOP_DELAY = 9000; //!< Delay of the stop called from a partition, in ns.
+const uint32_t STOP_CONTEXT = 3;  //!< Context which calls the stop.
+
+} // unnamed namespace
+
+/**
+ * \ingroup simulator-tests
+ *
+ * Run a set of tokens which hop between contexts, with
+ * DefaultSimulatorImpl and with MultithreadedSimulatorImpl, and
+ * check that each context sees the same events.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  /** How the simulation is stopped. */
+  enum StopMode
+  {
+    NO_STOP,            //!< Run until the end of the tokens.
+    STOP_FROM_MAIN,     //!< Simulator::Stop(delay) before Simulator::Run.
+    STOP_FROM_PARTITION //!< Simulator::Stop(delay) from an event of a partition.
+  };
+  /**
+   * Constructor.
+   * \param [in] threads The number of threads.
+   * \param [in] stop How the simulation is stopped.
+   */
+  MultithreadedSimulatorTestCase (uint32_t threads, StopMode stop);
+
+private:
+  virtual void DoRun (void);
+
+  /** An event seen by a context. */
+  struct Record
+  {
+    uint64_t ts;    //!< Time of the event.
+    uint32_t token; //!< Token id.
+    uint32_t hop;   //!< Hop number of the token.
+    /**
+     * Compare two records.
+     * \param [in] o The other record.
+     * \returns \c true if this record is before \pname{o}.
+     */
+    bool operator < (const Record &o) const
+    {
+      return ts < o.ts || (ts == o.ts && (token < o.token || (token == o.token && hop < o.hop)));
+    }
+    /**
+     * Compare two records.
+     * \param [in] o The other record.
+     * \returns \c true if the records are equal.
+     */
+    bool operator == (const Record &o) const
+    {
+      return ts == o.ts && token == o.token && hop == o.hop;
+    }
+  };
+  /** The records of each context. */
+  typedef std::vector<std::vector<Record> > Logs;
+
+  /**
+   * Run the tokens.
+   * \param [in] type The simulator implementation.
+   * \returns The records of each context.
+   */
+  Logs RunTokens (std::string type);
+  /**
+   * Record a token and send it further.
+   * \param [in] context The current context.
+   * \param [in] token The token id.
+   * \param [in] hop The hop number.
+   * \param [in] state The random state of the token.
+   */
+  void Hop (uint32_t context, uint32_t token, uint32_t hop, uint64_t state);
+  /** An event which is always removed before it expires. */
+  void Removed (void);
+  /** Call Simulator::Stop(delay) from the current event. */
+  static void StopFromEvent (void);
+  /**
+   * Get the records earlier than the stop time.
+   * \param [in] records The records of a context.
+   * \returns The records earlier than STOP.
+   */
+  static std::vector<Record> BeforeStop (const std::vector<Record> &records);
+
+  uint32_t m_threads;       //!< Number of threads.
+  StopMode m_stop;          //!< How the simulation is stopped.
+  Logs m_logs;              //!< The records of each context.
+  std::vector<uint32_t> m_errors; //!< Errors seen by each context.
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (uint32_t threads, StopMode stop)
+  : TestCase ("Check that MultithreadedSimulatorImpl with " + std::to_string (threads) +
+              " threads runs the same events as DefaultSimulatorImpl" +
+              (stop == STOP_FROM_MAIN ? " until Simulator::Stop" :
+               stop == STOP_FROM_PARTITION ? " until Simulator::Stop called from a partition" : "")),
+    m_threads (threads),
+    m_stop (stop)
+{}
+
+void
+MultithreadedSimulatorTestCase::Removed (void)
+{
+  m_errors[Simulator::GetContext ()]++;
+}
+
+void
+MultithreadedSimulatorTestCase::StopFromEvent (void)
+{
+  Simulator::Stop (NanoSeconds (STOP_DELAY));
+}
+
+std::vector<MultithreadedSimulatorTestCase::Record>
+MultithreadedSimulatorTestCase::BeforeStop (const std::vector<Record> &records)
+{
+  std::vector<Record> before;
+  for (std::vector<Record>::const_iterator i = records.begin (); i != records.end (); ++i)
+    {
+      if (i->ts < STOP)
+        {
+          before.push_back (*i);
+        }
+    }
+  return before;
+}
+
+void
+MultithreadedSimulatorTestCase::Hop (uint32_t context, uint32_t token, uint32_t hop, uint64_t state)
+{
+  if (Simulator::GetContext () != context)
+    {
+      m_errors[context]++;
+    }
+  Record record;
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.token = token;
+  record.hop = hop;
+  m_logs[context].push_back (record);
+
+  EventId removed = Simulator::Schedule (NanoSeconds (1), &MultithreadedSimulatorTestCase::Removed, this);
+  Simulator::Remove (removed);
+
+  if (hop == N_HOPS)
+    {
+      return;
+    }
+  // a small linear congruential generator, private to the token
+  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+  uint32_t r = static_cast<uint32_t> (state >> 33);
+  if (r % 3 == 0)
+    {
+      Simulator::Schedule (NanoSeconds (r % 5000), &MultithreadedSimulatorTestCase::Hop,
+                           this, context, token, hop + 1, state);
+    }
+  else
+    {
+      uint32_t next = (r >> 8) % N_CONTEXTS;
+      Simulator::ScheduleWithContext (next, NanoSeconds (LOOKAHEAD + (r >> 16) % 20000),
+                                      &MultithreadedSimulatorTestCase::Hop,
+                                      this, next, token, hop + 1, state);
+    }
+}
+
+MultithreadedSimulatorTestCase::Logs
+MultithreadedSimulatorTestCase::RunTokens (std::string type)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (type));
+  m_logs = Logs (N_CONTEXTS);
+  m_errors = std::vector<uint32_t> (N_CONTEXTS, 0);
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      impl->SetThreadCount (m_threads);
+      impl->SetLookahead (NanoSeconds (LOOKAHEAD));
+      // keep context 0 and 1 together, the others modulo the threads
+      impl->SetPartition (1, 0);
+    }
+  for (uint32_t i = 0; i < N_TOKENS; ++i)
+    {
+      uint32_t context = i % N_CONTEXTS;
+      Simulator::ScheduleWithContext (context, NanoSeconds (i), &MultithreadedSimulatorTestCase::Hop,
+                                      this, context, i, 0, i + 1);
+    }
+  if (m_stop == STOP_FROM_MAIN)
+    {
+      Simulator::Stop (NanoSeconds (STOP));
+    }
+  else if (m_stop == STOP_FROM_PARTITION)
+    {
+      Simulator::ScheduleWithContext (STOP_CONTEXT, NanoSeconds (STOP - STOP_DELAY),
+                                      &MultithreadedSimulatorTestCase::StopFromEvent);
+    }
+  Simulator::Run ();
+  if (m_stop == STOP_FROM_MAIN)
+    {
+      NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), NanoSeconds (STOP), "Simulator::Stop time");
+    }
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_errors[i], 0u, "Wrong context or removed event run in context " << i);
+    }
+  return m_logs;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  Logs expected = RunTokens ("ns3::DefaultSimulatorImpl");
+  Logs first = RunTokens ("ns3::MultithreadedSimulatorImpl");
+  Logs second = RunTokens ("ns3::MultithreadedSimulatorImpl");
+
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      // the execution is deterministic
+      NS_TEST_ASSERT_MSG_EQ ((first[i] == second[i]), true, "Different events in context " << i);
+      // the order of simultaneous events may differ
+      std::sort (expected[i].begin (), expected[i].end ());
+      std::sort (first[i].begin (), first[i].end ());
+      if (m_stop == STOP_FROM_PARTITION)
+        {
+          // The partition which stops runs no event after the stop
+          // time, the others may finish their window.
+          if ((i == STOP_CONTEXT || m_threads == 1) && !first[i].empty ())
+            {
+              NS_TEST_EXPECT_MSG_LT_OR_EQ (first[i].back ().ts, STOP,
+                                           "Event after Simulator::Stop in context " << i);
+            }
+          expected[i] = BeforeStop (expected[i]);
+          first[i] = BeforeStop (first[i]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (first[i].size (), expected[i].size (), "Wrong number of events in context " << i);
+      NS_TEST_ASSERT_MSG_EQ ((first[i] == expected[i]), true, "Wrong events in context " << i);
+      total += first[i].size ();
+      if (m_stop == STOP_FROM_MAIN && !first[i].empty ())
+        {
+          NS_TEST_EXPECT_MSG_LT (first[i].back ().ts, STOP, "Event after Simulator::Stop in context " << i);
+        }
+    }
+  if (m_stop == NO_STOP)
+    {
+      NS_TEST_EXPECT_MSG_EQ (total, static_cast<uint64_t> (N_TOKENS * (N_HOPS + 1)), "Lost tokens");
+    }
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase (1, MultithreadedSimulatorTestCase::NO_STOP), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (1, MultithreadedSimulatorTestCase::STOP_FROM_MAIN), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (1, MultithreadedSimulatorTestCase::STOP_FROM_PARTITION), TestCase::QUICK);
+#ifdef NS3_MTP
+    // Without NS3_MTP a single partition is run whatever the thread
+    // count, so these cases only exercise the parallel path with it.
+    AddTestCase (new MultithreadedSimulatorTestCase (4, MultithreadedSimulatorTestCase::NO_STOP), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, MultithreadedSimulatorTestCase::STOP_FROM_MAIN), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4, MultithreadedSimulatorTestCase::STOP_FROM_PARTITION), TestCase::QUICK);
+#endif
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite; //!< Static variable for test initialization
@@ -21,6 +21,11 @@
 #include "ns3/test.h"
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
+#include "ns3/config.h"
+#include "ns3/integer.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/assert.h"
 
 /**
@@ -151,10 +156,54 @@ protected:
   }
 };
 
+/**
+ * \ingroup object-tests
+ * Class with attributes, created by an ObjectFactory.
+ */
+class Attributes : public ns3::Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static ns3::TypeId GetTypeId (void)
+  {
+    static ns3::TypeId tid = ns3::TypeId ("ObjectTest:Attributes")
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<Attributes> ()
+      .AddAttribute ("Integer", "An integer.",
+                     ns3::IntegerValue (1),
+                     ns3::MakeIntegerAccessor (&Attributes::m_integer),
+                     ns3::MakeIntegerChecker<int> ())
+      .AddAttribute ("Other", "Another integer.",
+                     ns3::IntegerValue (2),
+                     ns3::MakeIntegerAccessor (&Attributes::m_other),
+                     ns3::MakeIntegerChecker<int> ())
+      .AddAttribute ("Random", "A random variable.",
+                     ns3::StringValue ("ns3::ConstantRandomVariable[Constant=3]"),
+                     ns3::MakePointerAccessor (&Attributes::m_random),
+                     ns3::MakePointerChecker<ns3::RandomVariableStream> ());
+    return tid;
+  }
+  /** Constructor. */
+  Attributes ()
+    : m_integer (0),
+      m_other (0)
+  {}
+
+  int m_integer;                                //!< An integer.
+  int m_other;                                  //!< Another integer.
+  ns3::Ptr<ns3::RandomVariableStream> m_random; //!< A random variable.
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BaseA);
 NS_OBJECT_ENSURE_REGISTERED (DerivedA);
 NS_OBJECT_ENSURE_REGISTERED (BaseB);
 NS_OBJECT_ENSURE_REGISTERED (DerivedB);
+NS_OBJECT_ENSURE_REGISTERED (Attributes);
 
 }  // unnamed namespace
 
@@ -475,6 +524,57 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+/**
+ * \ingroup object-tests
+ * Test an Object factory creates many Objects with the values of
+ * its attributes, and the initial values of the other attributes.
+ */
+class ObjectFactoryAttributesTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ObjectFactoryAttributesTestCase ();
+  /** Destructor. */
+  virtual ~ObjectFactoryAttributesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ObjectFactoryAttributesTestCase::ObjectFactoryAttributesTestCase ()
+  : TestCase ("Check ObjectFactory attributes")
+{}
+
+ObjectFactoryAttributesTestCase::~ObjectFactoryAttributesTestCase ()
+{}
+
+void
+ObjectFactoryAttributesTestCase::DoRun (void)
+{
+  ObjectFactory factory ("ObjectTest:Attributes",
+                         "Integer", StringValue ("4"),
+                         "Random", StringValue ("ns3::ConstantRandomVariable[Constant=5]"));
+
+  Ptr<Attributes> first = factory.Create<Attributes> ();
+  Ptr<Attributes> second = factory.Create<Attributes> ();
+  NS_TEST_ASSERT_MSG_EQ (first->m_integer, 4, "Value of the factory not set");
+  NS_TEST_ASSERT_MSG_EQ (second->m_integer, 4, "Value of the factory not set");
+  NS_TEST_ASSERT_MSG_EQ (first->m_other, 2, "Initial value not set");
+  NS_TEST_ASSERT_MSG_EQ (first->m_random->GetInteger (), 5u, "Object of the factory not set");
+  NS_TEST_ASSERT_MSG_NE (first->m_random, second->m_random, "Objects share the object of the factory");
+
+  //
+  // The factory must see initial values changed after its first use,
+  // and attributes set after its first use.
+  //
+  Config::SetDefault ("ObjectTest:Attributes::Other", IntegerValue (6));
+  factory.Set ("Integer", IntegerValue (7));
+  first = factory.Create<Attributes> ();
+  NS_TEST_ASSERT_MSG_EQ (first->m_integer, 7, "New value of the factory not set");
+  NS_TEST_ASSERT_MSG_EQ (first->m_other, 6, "New initial value not set");
+  Config::SetDefault ("ObjectTest:Attributes::Other", IntegerValue (2));
+}
+
 /**
  * \ingroup object-tests
  * The Test Suite that glues the Test Cases together.
@@ -492,6 +592,7 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
+  AddTestCase (new ObjectFactoryAttributesTestCase);
 }
 
 /**
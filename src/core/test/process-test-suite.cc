@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/process.h"
+#include "ns3/simulator.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup process
+ * Process test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup process-tests
+ *
+ * A process which records the times of its steps, sleeping between them.
+ */
+class SleepingProcess : public Process
+{
+public:
+  std::vector<Time> m_times;  //!< The times of the steps.
+
+private:
+  virtual void DoRun (void)
+  {
+    NS_PROCESS_BEGIN ();
+    for (m_step = 1; m_step <= 3; ++m_step)
+      {
+        m_times.push_back (Simulator::Now ());
+        // Two waits on one line have their own resume points.
+        NS_PROCESS_SLEEP (MilliSeconds (500 * m_step)); NS_PROCESS_SLEEP (MilliSeconds (500 * m_step));
+      }
+    m_times.push_back (Simulator::Now ());
+    NS_PROCESS_END ();
+  }
+
+  int m_step;  //!< The current step.
+};
+
+/**
+ * \ingroup process-tests
+ *
+ * A process which consumes the items counted by m_items, as soon as
+ * they are available.
+ */
+class ConsumingProcess : public Process
+{
+public:
+  ConsumingProcess ()
+    : m_items (0)
+  {}
+
+  /** Add an item, and wake the process. */
+  void Produce (void)
+  {
+    m_items++;
+    Wake ();
+  }
+
+  uint32_t m_items;           //!< The number of available items.
+  std::vector<Time> m_times;  //!< The times of the consumed items.
+
+private:
+  virtual void DoRun (void)
+  {
+    NS_PROCESS_BEGIN ();
+    for (;;)
+      {
+        NS_PROCESS_WAIT_UNTIL (m_items > 0);
+        m_items--;
+        m_times.push_back (Simulator::Now ());
+        if (m_times.size () == 3)
+          {
+            NS_PROCESS_EXIT ();
+          }
+      }
+    NS_PROCESS_END ();
+  }
+};
+
+/**
+ * \ingroup process-tests
+ *
+ * Check that a process sleeps between its steps, and finishes.
+ */
+class ProcessSleepTestCase : public TestCase
+{
+public:
+  ProcessSleepTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ProcessSleepTestCase::ProcessSleepTestCase ()
+  : TestCase ("Check that a process sleeps between its steps")
+{}
+
+void
+ProcessSleepTestCase::DoRun (void)
+{
+  Ptr<SleepingProcess> process = Create<SleepingProcess> ();
+  process->Start (Seconds (10));
+  NS_TEST_EXPECT_MSG_EQ (process->IsRunning (), true, "Started process is not running");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (process->IsRunning (), false, "Finished process is running");
+
+  const double expected[] = {10, 11, 13, 16};
+  NS_TEST_ASSERT_MSG_EQ (process->m_times.size (), 4, "Wrong number of steps");
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (process->m_times[i], Seconds (expected[i]), "Wrong time of step " << i);
+    }
+
+  // A finished process starts again from the beginning.
+  process->Start ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (process->m_times.size (), 8, "Restarted process did not run");
+  NS_TEST_EXPECT_MSG_EQ (process->m_times[7], Seconds (22), "Wrong time of the restarted process");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup process-tests
+ *
+ * Check that a process waits for its condition, and resumes when it
+ * is woken with the condition true.
+ */
+class ProcessWaitTestCase : public TestCase
+{
+public:
+  ProcessWaitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ProcessWaitTestCase::ProcessWaitTestCase ()
+  : TestCase ("Check that a process waits for its condition")
+{}
+
+void
+ProcessWaitTestCase::DoRun (void)
+{
+  Ptr<ConsumingProcess> process = Create<ConsumingProcess> ();
+  process->m_items = 1;
+  process->Start ();
+  // An item, a Wake with the condition false, and two items, the
+  // last one after the process exited.
+  Simulator::Schedule (Seconds (1), &ConsumingProcess::Produce, process);
+  Simulator::Schedule (Seconds (2), &ConsumingProcess::Wake, process);
+  Simulator::Schedule (Seconds (3), &ConsumingProcess::Produce, process);
+  Simulator::Schedule (Seconds (4), &ConsumingProcess::Produce, process);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (process->m_times.size (), 3, "Wrong number of consumed items");
+  NS_TEST_EXPECT_MSG_EQ (process->m_times[0], Seconds (0), "Wrong time of the available item");
+  NS_TEST_EXPECT_MSG_EQ (process->m_times[1], Seconds (1), "Wrong time of the first item");
+  NS_TEST_EXPECT_MSG_EQ (process->m_times[2], Seconds (3), "Wrong time of the second item");
+  NS_TEST_EXPECT_MSG_EQ (process->m_items, 1, "The exited process consumed an item");
+  NS_TEST_EXPECT_MSG_EQ (process->IsRunning (), false, "Exited process is running");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup process-tests
+ *
+ * Check that a stopped or deleted process is not resumed.
+ */
+class ProcessStopTestCase : public TestCase
+{
+public:
+  ProcessStopTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ProcessStopTestCase::ProcessStopTestCase ()
+  : TestCase ("Check that a stopped process is not resumed")
+{}
+
+void
+ProcessStopTestCase::DoRun (void)
+{
+  Ptr<SleepingProcess> stopped = Create<SleepingProcess> ();
+  stopped->Start ();
+  Simulator::Schedule (Seconds (2), &SleepingProcess::Stop, stopped);
+  Ptr<SleepingProcess> deleted = Create<SleepingProcess> ();
+  deleted->Start (Seconds (1));
+  deleted = 0;
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (stopped->m_times.size (), 2, "Stopped process was resumed");
+  NS_TEST_EXPECT_MSG_EQ (stopped->IsRunning (), false, "Stopped process is running");
+
+  // A stopped process starts again from the beginning.
+  Time restart = Simulator::Now ();
+  stopped->Start ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (stopped->m_times.size (), 6, "Restarted process did not finish");
+  NS_TEST_EXPECT_MSG_EQ (stopped->m_times[2], restart, "Wrong time of the restarted process");
+  NS_TEST_EXPECT_MSG_EQ (stopped->m_times[5], restart + Seconds (6), "Wrong time of the restarted process");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup process-tests
+ *
+ * Process test suite.
+ */
+class ProcessTestSuite : public TestSuite
+{
+public:
+  ProcessTestSuite ()
+    : TestSuite ("process")
+  {
+    AddTestCase (new ProcessSleepTestCase (), TestCase::QUICK);
+    AddTestCase (new ProcessWaitTestCase (), TestCase::QUICK);
+    AddTestCase (new ProcessStopTestCase (), TestCase::QUICK);
+  }
+};
+
+static ProcessTestSuite g_processTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/rng-stream.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * RngStream test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check the numbers of RngStream against those of the scalar MRG32k3a
+ * recurrence, one at a time and in batches.
+ */
+class RngStreamTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RngStreamTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamTestCase::RngStreamTestCase ()
+  : TestCase ("Check the RngStream numbers, one at a time and in batches")
+{}
+
+void
+RngStreamTestCase::DoRun (void)
+{
+  const std::size_t count = 1000;
+
+  // Numbers 0, 1, 2 and 999 of the scalar recurrence.
+  RngStream first (12345, 0, 0);
+  std::vector<double> values (count);
+  for (std::size_t i = 0; i < count; ++i)
+    {
+      values[i] = first.RandU01 ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (values[0], 0.12701112204657714, "Wrong first number");
+  NS_TEST_EXPECT_MSG_EQ (values[1], 0.3185275653967945, "Wrong second number");
+  NS_TEST_EXPECT_MSG_EQ (values[2], 0.30918601558327008, "Wrong third number");
+  NS_TEST_EXPECT_MSG_EQ (values[999], 0.98607848680213228, "Wrong last number");
+
+  RngStream advanced (1, (1ULL << 63) + 7, 3);
+  std::vector<double> batch (count);
+  advanced.RandU01 (&batch[0], count);
+  NS_TEST_EXPECT_MSG_EQ (batch[0], 0.036413934681121828, "Wrong first number");
+  NS_TEST_EXPECT_MSG_EQ (batch[1], 0.448826419738097, "Wrong second number");
+  NS_TEST_EXPECT_MSG_EQ (batch[2], 0.27005278369667451, "Wrong third number");
+  NS_TEST_EXPECT_MSG_EQ (batch[999], 0.47492886166675097, "Wrong last number");
+
+  // Batches of any size, in between single numbers, continue the sequence.
+  RngStream mixed (12345, 0, 0);
+  std::size_t i = 0;
+  for (std::size_t size = 1; i + size + 1 <= count; size += 7)
+    {
+      NS_TEST_EXPECT_MSG_EQ (mixed.RandU01 (), values[i], "Wrong number " << i);
+      ++i;
+      mixed.RandU01 (&batch[0], size);
+      for (std::size_t j = 0; j < size; ++j, ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (batch[j], values[i], "Wrong number " << i);
+        }
+    }
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RandomVariableStream::GetValues returns the values of
+ * GetValue(void).
+ */
+class GetValuesTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  GetValuesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the values of two random variables on the same stream.
+   * \param [in] single The random variable to call GetValue(void) on.
+   * \param [in] batch The random variable to call GetValues on.
+   */
+  void Compare (Ptr<RandomVariableStream> single, Ptr<RandomVariableStream> batch);
+};
+
+GetValuesTestCase::GetValuesTestCase ()
+  : TestCase ("Check that GetValues returns the values of GetValue")
+{}
+
+void
+GetValuesTestCase::Compare (Ptr<RandomVariableStream> single, Ptr<RandomVariableStream> batch)
+{
+  single->SetStream (5);
+  batch->SetStream (5);
+  std::vector<double> values (100);
+  batch->GetValues (&values[0], values.size ());
+  for (std::size_t i = 0; i < values.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (values[i], single->GetValue (), "Wrong value " << i);
+    }
+}
+
+void
+GetValuesTestCase::DoRun (void)
+{
+  Compare (CreateObject<UniformRandomVariable> (), CreateObject<UniformRandomVariable> ());
+
+  Ptr<UniformRandomVariable> single = CreateObject<UniformRandomVariable> ();
+  Ptr<UniformRandomVariable> batch = CreateObject<UniformRandomVariable> ();
+  single->SetAttribute ("Min", DoubleValue (-3));
+  single->SetAttribute ("Max", DoubleValue (8));
+  single->SetAttribute ("Antithetic", BooleanValue (true));
+  batch->SetAttribute ("Min", DoubleValue (-3));
+  batch->SetAttribute ("Max", DoubleValue (8));
+  batch->SetAttribute ("Antithetic", BooleanValue (true));
+  Compare (single, batch);
+
+  // The default GetValues.
+  Compare (CreateObject<NormalRandomVariable> (), CreateObject<NormalRandomVariable> ());
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RngStream test suite.
+ */
+class RngStreamTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RngStreamTestSuite ();
+};
+
+RngStreamTestSuite::RngStreamTestSuite ()
+  : TestSuite ("rng-stream", UNIT)
+{
+  AddTestCase (new RngStreamTestCase);
+  AddTestCase (new GetValuesTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RngStreamTestSuite instance variable.
+ */
+static RngStreamTestSuite g_rngStreamTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -24,6 +24,20 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/event-memory-pool.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/des-metrics.h"
+#include "ns3/make-event.h"
+#include "ns3/event-impl.h"
+#include "ns3/string.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/callback.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -170,6 +184,299 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check event ordering under a hold model with removals with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  const uint32_t population = 2000;
+  const uint32_t total = 20000;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  std::vector<Scheduler::Event> pending;
+
+  // Bursts of identical time stamps and widely spread ones
+  // exercise both the sorted and the spreading paths of the schedulers.
+  for (uint32_t i = 0; i < population; ++i)
+    {
+      Scheduler::Event ev;
+      ev.impl = 0;
+      ev.key.m_ts = (i % 4 == 0) ? 1000 : rng->GetInteger (0, 1000000);
+      ev.key.m_uid = uid++;
+      ev.key.m_context = 0;
+      scheduler->Insert (ev);
+      if (i % 10 == 0)
+        {
+          pending.push_back (ev);
+        }
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = pending.begin ();
+       i != pending.end (); ++i)
+    {
+      scheduler->Remove (*i);
+    }
+
+  Scheduler::EventKey last = {0, 0, 0};
+  uint32_t count = 0;
+  while (!scheduler->IsEmpty ())
+    {
+      Scheduler::Event next = scheduler->PeekNext ();
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, ev.key.m_uid, "PeekNext and RemoveNext disagree");
+      NS_TEST_ASSERT_MSG_EQ ((ev.key.m_uid % 10 == 0 && ev.key.m_uid < population), false,
+                             "Removed event " << ev.key.m_uid << " was dequeued");
+      NS_TEST_ASSERT_MSG_EQ ((count > 0 && ev.key < last), false,
+                             "Event " << ev.key.m_uid << " dequeued out of order");
+      last = ev.key;
+      now = ev.key.m_ts;
+      ++count;
+      if (uid < total)
+        {
+          Scheduler::Event newEv;
+          newEv.impl = 0;
+          newEv.key.m_ts = now + ((uid % 7 == 0) ? 0 : rng->GetInteger (0, 2000));
+          newEv.key.m_uid = uid++;
+          newEv.key.m_context = 0;
+          scheduler->Insert (newEv);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (count, total - population / 10, "Wrong number of events dequeued");
+}
+
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void Hold (uint32_t chain);
+  uint32_t m_count;
+  uint32_t m_limit;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that events are recycled in steady state")
+{}
+
+void
+SimulatorEventPoolTestCase::Hold (uint32_t chain)
+{
+  if (m_count++ < m_limit)
+    {
+      Simulator::Schedule (NanoSeconds (chain % 17 + 1), &SimulatorEventPoolTestCase::Hold, this, chain);
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  if (!EventMemoryPool::IsEnabled ())
+    {
+      // The pool is bypassed under valgrind and AddressSanitizer.
+      return;
+    }
+  ObjectFactory factory;
+  factory.SetTypeId (LadderScheduler::GetTypeId ());
+  Simulator::SetScheduler (factory);
+
+  // Warm up: the pool grows to the largest event population.
+  m_count = 0;
+  m_limit = 5000;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (i), &SimulatorEventPoolTestCase::Hold, this, i);
+    }
+  Simulator::Run ();
+
+  EventMemoryPool::Statistics before = EventMemoryPool::GetStatistics ();
+  NS_TEST_ASSERT_MSG_GT (before.cached, 0, "No event was recycled");
+
+  m_count = 0;
+  m_limit = 10000;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (i), &SimulatorEventPoolTestCase::Hold, this, i);
+    }
+  Simulator::Run ();
+
+  EventMemoryPool::Statistics after = EventMemoryPool::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (after.heapAllocations, before.heapAllocations,
+                         "Steady state events were allocated from the heap");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (after.recycled - before.recycled, m_limit,
+                               "Events were not recycled");
+
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (EventMemoryPool::GetStatistics ().cached, 0,
+                         "Simulator::Destroy did not release the cached events");
+}
+
+class SimulatorProfileTestCase : public TestCase
+{
+public:
+  SimulatorProfileTestCase ();
+  virtual void DoRun (void);
+  void Tick (int n);
+  void Tack (int n);
+  void Tock (double x) const;
+  static void Toss (int n);
+  std::map<std::string, uint64_t> ReadFolded (std::string filename);
+  std::string GetFrames (EventImpl *event);
+  std::string GetFunctionFrame (EventImpl *event);
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase ()
+  : TestCase ("Check the event profile")
+{}
+
+void
+SimulatorProfileTestCase::Tick (int n)
+{
+  if (n > 1)
+    {
+      Simulator::Schedule (MicroSeconds (10), &SimulatorProfileTestCase::Tick, this, n - 1);
+    }
+}
+
+void
+SimulatorProfileTestCase::Tack (int n)
+{}
+
+void
+SimulatorProfileTestCase::Tock (double x) const
+{}
+
+void
+SimulatorProfileTestCase::Toss (int n)
+{}
+
+std::map<std::string, uint64_t>
+SimulatorProfileTestCase::ReadFolded (std::string filename)
+{
+  std::map<std::string, uint64_t> stacks;
+  std::ifstream is (filename.c_str ());
+  std::string line;
+  while (std::getline (is, line))
+    {
+      std::string::size_type space = line.rfind (' ');
+      stacks[line.substr (0, space)] = std::stoull (line.substr (space + 1));
+    }
+  return stacks;
+}
+
+std::string
+SimulatorProfileTestCase::GetFrames (EventImpl *event)
+{
+  std::string frames = DesProfile::GetFrames (typeid (*event));
+  event->Unref ();
+  return frames;
+}
+
+std::string
+SimulatorProfileTestCase::GetFunctionFrame (EventImpl *event)
+{
+  std::size_t size;
+  const std::type_info *callback;
+  const void *function = event->PeekFunction (&size, &callback);
+  uintptr_t address;
+  std::memcpy (&address, function, sizeof (address));
+  event->Unref ();
+  std::ostringstream frame;
+  frame << "0x" << std::hex << address;
+  return frame.str ();
+}
+
+void
+SimulatorProfileTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (GetFrames (MakeEvent (&SimulatorProfileTestCase::Tick, this, 1)),
+                         "SimulatorProfileTestCase;void (int)", "Frames of a member function");
+  NS_TEST_EXPECT_MSG_EQ (GetFrames (MakeEvent (&SimulatorProfileTestCase::Tock, this, 1.0)),
+                         "SimulatorProfileTestCase;void (double) const", "Frames of a const member function");
+  NS_TEST_EXPECT_MSG_EQ (GetFrames (MakeEvent (&SimulatorProfileTestCase::Toss, 1)),
+                         "[function];void (int)", "Frames of a function");
+  NS_TEST_EXPECT_MSG_EQ (GetFrames (MakeEvent (&Simulator::Stop)),
+                         "[function];void ()", "Frames of a function without argument");
+  NS_TEST_EXPECT_MSG_EQ (DesProfile::GetFrames (typeid (int)), "int", "Frames of another type");
+
+  // The member functions of the same signature are told apart.
+  std::string tick = "SimulatorProfileTestCase;void (int);"
+    + GetFunctionFrame (MakeEvent (&SimulatorProfileTestCase::Tick, this, 1));
+  std::string tack = "SimulatorProfileTestCase;void (int);"
+    + GetFunctionFrame (MakeEvent (&SimulatorProfileTestCase::Tack, this, 1));
+  std::string tock = "SimulatorProfileTestCase;void (double) const;"
+    + GetFunctionFrame (MakeEvent (&SimulatorProfileTestCase::Tock, this, 1.0));
+  std::string toss = "[function];void (int);"
+    + GetFunctionFrame (MakeEvent (&SimulatorProfileTestCase::Toss, 1));
+  NS_TEST_EXPECT_MSG_NE (tick, tack, "Member functions with the same frames");
+
+  std::string filename = CreateTempDirFilename ("profile.folded");
+  Simulator::Destroy ();
+  Simulator::GetImplementation ()->SetAttribute ("ProfileFile", StringValue (filename));
+  Simulator::ScheduleWithContext (3, MicroSeconds (5), &SimulatorProfileTestCase::Tick, this, 4);
+  Simulator::ScheduleWithContext (3, MicroSeconds (6), &SimulatorProfileTestCase::Tack, this, 4);
+  Simulator::Schedule (MicroSeconds (20), &SimulatorProfileTestCase::Tock, this, 1.0);
+  Simulator::Schedule (MicroSeconds (30), &SimulatorProfileTestCase::Toss, 1);
+  Simulator::Schedule (MicroSeconds (40), &SimulatorProfileTestCase::Toss, 2);
+  // Cancelled and removed events are counted apart.
+  Simulator::Cancel (Simulator::Schedule (MicroSeconds (45), &SimulatorProfileTestCase::Toss, 3));
+  Simulator::Remove (Simulator::Schedule (MicroSeconds (25), &SimulatorProfileTestCase::Tock, this, 2.0));
+  // Events calling a Callback are told apart by its implementation.
+  Callback<void, int> callback = MakeCallback (&SimulatorProfileTestCase::Tack, this);
+  Simulator::Schedule (MicroSeconds (50),
+                       static_cast<void (Callback<void, int>::*)(int) const> (&Callback<void, int>::operator()),
+                       &callback, 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::map<std::string, uint64_t> count = ReadFolded (filename + ".count");
+  NS_TEST_EXPECT_MSG_EQ (count.size (), 5, "Wrong number of stacks");
+  NS_TEST_EXPECT_MSG_EQ (count[tick + ";node 3"], 4, "Wrong count of Tick");
+  NS_TEST_EXPECT_MSG_EQ (count[tack + ";node 3"], 1, "Wrong count of Tack");
+  NS_TEST_EXPECT_MSG_EQ (count[tock + ";no context"], 1, "Wrong count of Tock");
+  NS_TEST_EXPECT_MSG_EQ (count[toss + ";no context"], 2, "Wrong count of Toss");
+  std::string called;
+  for (std::map<std::string, uint64_t>::const_iterator i = count.begin (); i != count.end (); ++i)
+    {
+      if (i->first.find ("MemPtrCallbackImpl") != std::string::npos)
+        {
+          called = i->first;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (count[called], 1, "Wrong count of the Callback");
+
+  std::map<std::string, uint64_t> residency = ReadFolded (filename + ".residency");
+  NS_TEST_EXPECT_MSG_EQ (residency[tick + ";node 3"],
+                         (uint64_t) MicroSeconds (35).GetTimeStep (), "Wrong residency of Tick");
+  NS_TEST_EXPECT_MSG_EQ (residency[toss + ";no context"],
+                         (uint64_t) MicroSeconds (70).GetTimeStep (), "Wrong residency of Toss");
+  NS_TEST_EXPECT_MSG_EQ (residency[tock + ";no context"],
+                         (uint64_t) MicroSeconds (20).GetTimeStep (), "Wrong residency of Tock");
+  std::map<std::string, uint64_t> cancelled = ReadFolded (filename + ".cancelled");
+  NS_TEST_EXPECT_MSG_EQ (cancelled.size (), 2, "Wrong number of cancelled stacks");
+  NS_TEST_EXPECT_MSG_EQ (cancelled[toss + ";no context"],
+                         (uint64_t) MicroSeconds (45).GetTimeStep (), "Wrong residency of the cancelled Toss");
+  NS_TEST_EXPECT_MSG_EQ (cancelled[tock + ";no context"],
+                         (uint64_t) MicroSeconds (25).GetTimeStep (), "Wrong residency of the removed Tock");
+
+  std::map<std::string, uint64_t> wall = ReadFolded (filename);
+  NS_TEST_EXPECT_MSG_GT (wall.size (), 0, "No wall clock time");
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -483,5 +790,18 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorProfileTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -235,7 +235,8 @@ public:
 #ifdef HAVE_RT
       "ns3::RealtimeSimulatorImpl",
 #endif
-      "ns3::DefaultSimulatorImpl"
+      "ns3::DefaultSimulatorImpl",
+      "ns3::MultithreadedSimulatorImpl"
     };
     std::string schedulerTypes[] = {
       "ns3::ListScheduler",
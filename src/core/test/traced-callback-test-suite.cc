@@ -113,6 +113,74 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class EmptyTracedCallbackTestCase : public TestCase
+{
+public:
+  EmptyTracedCallbackTestCase ();
+  virtual ~EmptyTracedCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a, double b);
+  void CbConnect (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_one;
+};
+
+EmptyTracedCallbackTestCase::EmptyTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback::IsEmpty and connection from a sink")
+{}
+
+void
+EmptyTracedCallbackTestCase::CbOne (uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  m_one++;
+}
+
+void
+EmptyTracedCallbackTestCase::CbConnect (uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  //
+  // Connect enough callbacks to reallocate the chain while it is
+  // being invoked.
+  //
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+    }
+}
+
+void
+EmptyTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback is not empty");
+
+  m_trace.ConnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Connected TracedCallback is empty");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback is not empty");
+
+  //
+  // The callbacks connected by CbConnect while the chain is invoked
+  // are invoked too, and disconnecting CbOne removes all of them.
+  //
+  m_one = 0;
+  m_trace.ConnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbConnect, this));
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 10u, "Callbacks connected during the invocation not called");
+  m_trace.DisconnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbConnect, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback is not empty");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +191,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new EmptyTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
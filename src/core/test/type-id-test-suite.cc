@@ -25,8 +25,13 @@
 #include "ns3/integer.h"
 #include "ns3/double.h"
 #include "ns3/object.h"
+#include "ns3/object-factory.h"
 #include "ns3/traced-value.h"
 #include "ns3/type-id.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 #include "ns3/log.h"
 #include "ns3/unused.h"
@@ -334,6 +339,121 @@ DeprecatedAttributeTestCase::DoRun (void)
 }
 
 
+//----------------------------
+//
+// Construction information test
+
+class ConstructionBase : public Object
+{
+public:
+  int m_base;
+  int m_string;
+  Ptr<RandomVariableStream> m_random;
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ConstructionBase")
+      .SetParent<Object> ()
+      .AddAttribute ("base",
+                     "the base Attribute",
+                     IntegerValue (1),
+                     MakeIntegerAccessor (&ConstructionBase::m_base),
+                     MakeIntegerChecker<int> ())
+      // An initial value which the checker must convert
+      .AddAttribute ("string",
+                     "the Attribute with a string initial value",
+                     StringValue ("2"),
+                     MakeIntegerAccessor (&ConstructionBase::m_string),
+                     MakeIntegerChecker<int> ())
+      // An initial value which the checker converts to a new object
+      .AddAttribute ("random",
+                     "the Attribute which creates an object",
+                     StringValue ("ns3::ConstantRandomVariable[Constant=6]"),
+                     MakePointerAccessor (&ConstructionBase::m_random),
+                     MakePointerChecker<RandomVariableStream> ())
+      ;
+    return tid;
+  }
+};
+
+class ConstructionDerived : public ConstructionBase
+{
+public:
+  int m_derived;
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ConstructionDerived")
+      .SetParent<ConstructionBase> ()
+      .AddConstructor<ConstructionDerived> ()
+      .AddAttribute ("derived",
+                     "the derived Attribute",
+                     IntegerValue (3),
+                     MakeIntegerAccessor (&ConstructionDerived::m_derived),
+                     MakeIntegerChecker<int> ())
+      ;
+    return tid;
+  }
+};
+
+
+class ConstructionInformationTestCase : public TestCase
+{
+public:
+  ConstructionInformationTestCase ();
+  virtual ~ConstructionInformationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+ConstructionInformationTestCase::ConstructionInformationTestCase ()
+  : TestCase ("Check the attributes gathered for object construction")
+{}
+
+ConstructionInformationTestCase::~ConstructionInformationTestCase ()
+{}
+
+void
+ConstructionInformationTestCase::DoRun (void)
+{
+  TypeId tid = ConstructionDerived::GetTypeId ();
+  Ptr<const TypeId::ConstructionInformation> info = tid.GetConstructionInformation ();
+  NS_TEST_ASSERT_MSG_EQ (info->attributes.size (), 4, "attributes of the TypeId and its parents");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[0].name, "derived", "derived attributes first");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[0].tidName, "ConstructionDerived", "TypeId of derived attribute");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[0].checked, true, "IntegerValue accepted by the checker");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[1].name, "base", "then base attributes");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[2].name, "string", "in registration order");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[2].checked, true, "StringValue converted once");
+  NS_TEST_ASSERT_MSG_EQ (info->attributes[3].checked, false, "StringValue converted for each object");
+  NS_TEST_ASSERT_MSG_EQ (tid.GetConstructionInformation (), info, "information gathered once");
+
+  Ptr<ConstructionDerived> object = CreateObject<ConstructionDerived> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_derived, 3, "derived initial value");
+  NS_TEST_ASSERT_MSG_EQ (object->m_base, 1, "base initial value");
+  NS_TEST_ASSERT_MSG_EQ (object->m_string, 2, "converted initial value");
+  NS_TEST_ASSERT_MSG_EQ (object->m_random->GetInteger (), 6, "object initial value");
+  Ptr<RandomVariableStream> random = object->m_random;
+
+  // Changing an initial value gathers the information again
+  Config::SetDefault ("ConstructionBase::base", IntegerValue (4));
+  NS_TEST_ASSERT_MSG_NE (tid.GetConstructionInformation (), info, "information gathered again");
+  object = CreateObject<ConstructionDerived> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_base, 4, "new base initial value");
+  NS_TEST_ASSERT_MSG_NE (object->m_random, random, "object shared by two objects");
+  Config::SetDefault ("ConstructionBase::base", IntegerValue (1));
+
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  factory.Set ("derived", IntegerValue (5));
+  object = factory.Create<ConstructionDerived> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_derived, 5, "value from the factory");
+  NS_TEST_ASSERT_MSG_EQ (object->m_base, 1, "restored base initial value");
+}
+
+
 //----------------------------
 //
 // Performance test
@@ -347,7 +467,7 @@ public:
 private:
   void DoRun (void);
   void DoSetup (void);
-  void Report (const std::string how, const uint32_t delta) const;
+  void Report (const std::string how, const uint32_t delta, const double n) const;
 
   enum
   {
@@ -380,7 +500,7 @@ LookupTimeTestCase::DoRun (void)
         }
     }
   int stop = clock ();
-  Report ("name", stop - start);
+  Report ("name", stop - start, nids);
 
   start = clock ();
   for (uint32_t j = 0; j < REPETITIONS; ++j)
@@ -392,7 +512,34 @@ LookupTimeTestCase::DoRun (void)
         }
     }
   stop = clock ();
-  Report ("hash", stop - start);
+  Report ("hash", stop - start, nids);
+
+  // Look up the last supported attribute of each TypeId
+  std::vector<std::pair<TypeId, std::string> > attributes;
+  for (uint16_t i = 0; i < nids; ++i)
+    {
+      const TypeId tid = TypeId::GetRegistered (i);
+      for (std::size_t k = tid.GetAttributeN (); k > 0; --k)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (k - 1);
+          if (info.supportLevel == TypeId::SUPPORTED)
+            {
+              attributes.push_back (std::make_pair (tid, info.name));
+              break;
+            }
+        }
+    }
+  start = clock ();
+  for (uint32_t j = 0; j < REPETITIONS; ++j)
+    {
+      for (std::size_t i = 0; i < attributes.size (); ++i)
+        {
+          struct TypeId::AttributeInformation info;
+          attributes[i].first.LookupAttributeByName (attributes[i].second, &info);
+        }
+    }
+  stop = clock ();
+  Report ("attribute name", stop - start, attributes.size ());
 
 }
 
@@ -409,10 +556,10 @@ LookupTimeTestCase::DoSetup (void)
 
 void
 LookupTimeTestCase::Report (const std::string how,
-                            const uint32_t    delta) const
+                            const uint32_t    delta,
+                            const double      n) const
 {
-  double nids = TypeId::GetRegisteredN ();
-  double reps = nids * REPETITIONS;
+  double reps = n * REPETITIONS;
 
   double per = 1E6 * double(delta) / (reps * double(CLOCKS_PER_SEC));
 
@@ -447,6 +594,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new ConstructionInformationTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;
@@ -228,11 +228,11 @@ CsmaChannel::TransmitEnd ()
     {
       if (it->IsActive ())
         {
-          // schedule reception events
+          // schedule reception events, which share the packet
           Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
                                           m_delay,
                                           &CsmaNetDevice::Receive, it->devicePtr,
-                                          m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+                                          m_currentPkt, m_deviceList[m_currentSrc].devicePtr);
         }
       devId++;
     }
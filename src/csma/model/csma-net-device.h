@@ -132,6 +132,7 @@ public:
    *
    * \see Queue
    * \see DropTailQueue
+   * \see RingBufferQueue
    * \param queue a Ptr to the queue for being assigned to the device.
    */
   void SetQueue (Ptr<Queue<Packet> > queue);
@@ -162,11 +163,14 @@ public:
    * used by the channel to indicate that the last bit of a packet has 
    * arrived at the device.
    *
+   * The packet is shared by all the devices of the channel, and the
+   * device works on a copy of it.
+   *
    * \see CsmaChannel
    * \param p a reference to the received packet
    * \param sender the CsmaNetDevice that transmitted the packet in the first place
    */
-  void Receive (Ptr<Packet> p, Ptr<CsmaNetDevice> sender);
+  void Receive (Ptr<const Packet> p, Ptr<CsmaNetDevice> sender);
 
   /**
    * Is the send side of the network device enabled?
@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulation-singleton.h"
+#include "ns3/simulation-instance.h"
 #include "global-route-manager.h"
 #include "global-route-manager-impl.h"
 
@@ -62,8 +63,8 @@ uint32_t
 GlobalRouteManager::AllocateRouterId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint32_t routerId = 0;
-  return routerId++;
+  uint32_t *routerId = InstanceSingleton<uint32_t, GlobalRouteManager>::Get ();
+  return (*routerId)++;
 }
 
 
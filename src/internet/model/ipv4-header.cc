@@ -41,6 +41,7 @@ Ipv4Header::Ipv4Header ()
     m_fragmentOffset (0),
     m_checksum (0),
     m_goodChecksum (true),
+    m_checksumValid (false),
     m_headerSize(5*4)
 {
 }
@@ -56,6 +57,7 @@ void
 Ipv4Header::SetPayloadSize (uint16_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  m_checksumValid = false;
   m_payloadSize = size;
 }
 uint16_t
@@ -75,6 +77,7 @@ void
 Ipv4Header::SetIdentification (uint16_t identification)
 {
   NS_LOG_FUNCTION (this << identification);
+  m_checksumValid = false;
   m_identification = identification;
 }
 
@@ -82,6 +85,7 @@ void
 Ipv4Header::SetTos (uint8_t tos)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (tos));
+  m_checksumValid = false;
   m_tos = tos;
 }
 
@@ -89,6 +93,7 @@ void
 Ipv4Header::SetDscp (DscpType dscp)
 {
   NS_LOG_FUNCTION (this << dscp);
+  m_checksumValid = false;
   m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
   m_tos |= (dscp << 2);
 }
@@ -97,6 +102,7 @@ void
 Ipv4Header::SetEcn (EcnType ecn)
 {
   NS_LOG_FUNCTION (this << ecn);
+  m_checksumValid = false;
   m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
   m_tos |= ecn;
 }
@@ -200,12 +206,14 @@ void
 Ipv4Header::SetMoreFragments (void)
 {
   NS_LOG_FUNCTION (this);
+  m_checksumValid = false;
   m_flags |= MORE_FRAGMENTS;
 }
 void
 Ipv4Header::SetLastFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  m_checksumValid = false;
   m_flags &= ~MORE_FRAGMENTS;
 }
 bool 
@@ -219,12 +227,14 @@ void
 Ipv4Header::SetDontFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  m_checksumValid = false;
   m_flags |= DONT_FRAGMENT;
 }
 void 
 Ipv4Header::SetMayFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  m_checksumValid = false;
   m_flags &= ~DONT_FRAGMENT;
 }
 bool 
@@ -238,6 +248,7 @@ void
 Ipv4Header::SetFragmentOffset (uint16_t offsetBytes)
 {
   NS_LOG_FUNCTION (this << offsetBytes);
+  m_checksumValid = false;
   // check if the user is trying to set an invalid offset
   NS_ABORT_MSG_IF ((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
   m_fragmentOffset = offsetBytes;
@@ -259,6 +270,27 @@ void
 Ipv4Header::SetTtl (uint8_t ttl)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (ttl));
+  m_checksumValid = false;
+  m_ttl = ttl;
+}
+void
+Ipv4Header::DecrementTtl (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint8_t ttl = m_ttl - 1;
+  if (m_checksumValid)
+    {
+      // HC' = ~(~HC + ~m + m'), where m is the 16-bit word of the TTL and
+      // the protocol, in the byte order of Buffer::Iterator::ReadU16.
+      uint32_t oldWord = m_ttl | (m_protocol << 8);
+      uint32_t newWord = ttl | (m_protocol << 8);
+      uint32_t sum = (~m_checksum & 0xffff) + (~oldWord & 0xffff) + newWord;
+      while (sum >> 16)
+        {
+          sum = (sum & 0xffff) + (sum >> 16);
+        }
+      m_checksum = ~sum;
+    }
   m_ttl = ttl;
 }
 uint8_t 
@@ -278,6 +310,7 @@ void
 Ipv4Header::SetProtocol (uint8_t protocol)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocol));
+  m_checksumValid = false;
   m_protocol = protocol;
 }
 
@@ -285,6 +318,7 @@ void
 Ipv4Header::SetSource (Ipv4Address source)
 {
   NS_LOG_FUNCTION (this << source);
+  m_checksumValid = false;
   m_source = source;
 }
 Ipv4Address
@@ -298,6 +332,7 @@ void
 Ipv4Header::SetDestination (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
+  m_checksumValid = false;
   m_destination = dst;
 }
 Ipv4Address
@@ -383,13 +418,8 @@ void
 Ipv4Header::Serialize (Buffer::Iterator start) const
 {
   NS_LOG_FUNCTION (this << &start);
-  Buffer::Iterator i = start;
-
-  uint8_t verIhl = (4 << 4) | (5);
-  i.WriteU8 (verIhl);
-  i.WriteU8 (m_tos);
-  i.WriteHtonU16 (m_payloadSize + 5*4);
-  i.WriteHtonU16 (m_identification);
+  // Build the header and write it at once, with a zero checksum.
+  uint16_t totalLength = m_payloadSize + 5*4;
   uint32_t fragmentOffset = m_fragmentOffset / 8;
   uint8_t flagsFrag = (fragmentOffset >> 8) & 0x1f;
   if (m_flags & DONT_FRAGMENT) 
@@ -400,19 +430,30 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
     {
       flagsFrag |= (1<<5);
     }
-  i.WriteU8 (flagsFrag);
-  uint8_t frag = fragmentOffset & 0xff;
-  i.WriteU8 (frag);
-  i.WriteU8 (m_ttl);
-  i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU32 (m_source.Get ());
-  i.WriteHtonU32 (m_destination.Get ());
+  uint32_t source = m_source.Get ();
+  uint32_t destination = m_destination.Get ();
+  uint8_t bytes[20] = {
+    (4 << 4) | (5), static_cast<uint8_t> (m_tos),
+    static_cast<uint8_t> (totalLength >> 8), static_cast<uint8_t> (totalLength & 0xff),
+    static_cast<uint8_t> (m_identification >> 8), static_cast<uint8_t> (m_identification & 0xff),
+    flagsFrag, static_cast<uint8_t> (fragmentOffset & 0xff),
+    static_cast<uint8_t> (m_ttl), static_cast<uint8_t> (m_protocol), 0, 0,
+    static_cast<uint8_t> (source >> 24), static_cast<uint8_t> (source >> 16),
+    static_cast<uint8_t> (source >> 8), static_cast<uint8_t> (source),
+    static_cast<uint8_t> (destination >> 24), static_cast<uint8_t> (destination >> 16),
+    static_cast<uint8_t> (destination >> 8), static_cast<uint8_t> (destination)
+  };
+  Buffer::Iterator i = start;
+  i.Write (bytes, sizeof (bytes));
 
   if (m_calcChecksum) 
     {
-      i = start;
-      uint16_t checksum = i.CalculateIpChecksum (20);
+      uint16_t checksum = m_checksum;
+      if (!m_checksumValid)
+        {
+          i = start;
+          checksum = i.CalculateIpChecksum (20);
+        }
       NS_LOG_LOGIC ("checksum=" <<checksum);
       i = start;
       i.Next (10);
@@ -470,6 +511,9 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
 
       m_goodChecksum = (checksum == 0);
     }
+  // Serialize writes the same bytes, and may reuse the checksum, unless
+  // the header has options or the reserved flag set.
+  m_checksumValid = m_calcChecksum && m_goodChecksum && headerSize == 5*4 && !(flags & (1<<7));
   return GetSerializedSize ();
 }
 
@@ -149,6 +149,14 @@ public:
    * \param ttl the ipv4 TTL
    */
   void SetTtl (uint8_t ttl);
+  /**
+   * \brief Decrement the TTL, as a router forwarding the packet does.
+   *
+   * If the header was deserialized with checksums enabled, with a good
+   * checksum and without options, the checksum is updated incrementally
+   * (\RFC{1624}), and Serialize writes it without computing it again.
+   */
+  void DecrementTtl (void);
   /**
    * \param num the ipv4 protocol field
    */
@@ -259,6 +267,7 @@ private:
   Ipv4Address m_destination; //!< destination address
   uint16_t m_checksum; //!< checksum
   bool m_goodChecksum; //!< true if checksum is correct
+  bool m_checksumValid; //!< true if m_checksum is the checksum of the fields, which Serialize can write
   uint16_t m_headerSize; //!< IP header size
 };
 
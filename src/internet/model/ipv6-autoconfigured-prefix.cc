@@ -20,6 +20,7 @@
 
 #include "ns3/log.h"
 #include "ns3/node.h"
+#include "ns3/simulation-instance.h"
 
 #include "ipv6-l3-protocol.h"
 #include "ipv6-autoconfigured-prefix.h"
@@ -29,8 +30,6 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6AutoconfiguredPrefix");
 
-uint32_t Ipv6AutoconfiguredPrefix::m_prefixId = 0;
-
 Ipv6AutoconfiguredPrefix::Ipv6AutoconfiguredPrefix (Ptr<Node> node, uint32_t interface, Ipv6Address prefix, Ipv6Prefix mask, uint32_t preferredLifeTime, uint32_t validLifeTime, Ipv6Address router)
 {
   if (preferredLifeTime+validLifeTime == 0)
@@ -41,8 +40,9 @@ Ipv6AutoconfiguredPrefix::Ipv6AutoconfiguredPrefix (Ptr<Node> node, uint32_t int
   m_interface = interface;
   m_validLifeTime = validLifeTime;
   m_preferredLifeTime = preferredLifeTime;
-  m_id = m_prefixId;
-  m_prefixId++;
+  uint32_t &prefixId = *InstanceSingleton<uint32_t, Ipv6AutoconfiguredPrefix>::Get ();
+  m_id = prefixId;
+  prefixId++;
   m_preferred = false;
   m_valid = false;
   m_prefix = prefix;
@@ -204,11 +204,6 @@ public:
   void SetMask (Ipv6Prefix mask);
 
 private:
-  /**
-   * \brief a static identifier.
-   */
-  static uint32_t m_prefixId;
-
   /**
    * \brief the identifier of this prefix.
    */
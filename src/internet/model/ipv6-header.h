@@ -309,6 +309,12 @@ private:
   Ipv6Address m_destinationAddress;
 };
 
+/**
+ * \brief Every Ipv6Header is serialized in 40 bytes.
+ */
+template <>
+struct StaticSerializedSize<Ipv6Header> : public std::integral_constant<uint32_t, 40> {};
+
 } /* namespace ns3 */
 
 #endif /* IPV6_HEADER_H */
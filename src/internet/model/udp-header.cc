@@ -183,37 +183,27 @@ UdpHeader::GetSerializedSize (void) const
 void
 UdpHeader::Serialize (Buffer::Iterator start) const
 {
+  // Build the header and write it at once; the checksum is computed
+  // over the written header and the payload which follows it.
+  uint16_t length = m_payloadSize == 0 ? start.GetSize () : m_payloadSize;
+  uint8_t bytes[8] = {
+    static_cast<uint8_t> (m_sourcePort >> 8), static_cast<uint8_t> (m_sourcePort & 0xff),
+    static_cast<uint8_t> (m_destinationPort >> 8), static_cast<uint8_t> (m_destinationPort & 0xff),
+    static_cast<uint8_t> (length >> 8), static_cast<uint8_t> (length & 0xff),
+    static_cast<uint8_t> (m_checksum & 0xff), static_cast<uint8_t> (m_checksum >> 8)
+  };
   Buffer::Iterator i = start;
+  i.Write (bytes, sizeof (bytes));
 
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  if (m_payloadSize == 0)
+  if (m_checksum == 0 && m_calcChecksum)
     {
-      i.WriteHtonU16 (start.GetSize ());
-    }
-  else
-    {
-      i.WriteHtonU16 (m_payloadSize);
-    }
+      uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
+      i = start;
+      uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
 
-  if ( m_checksum == 0)
-    {
-      i.WriteU16 (0);
-
-      if (m_calcChecksum)
-        {
-          uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
-          i = start;
-          uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
-
-          i = start;
-          i.Next (6);
-          i.WriteU16 (checksum);
-        }
-    }
-  else
-    {
-      i.WriteU16 (m_checksum);
+      i = start;
+      i.Next (6);
+      i.WriteU16 (checksum);
     }
 }
 uint32_t
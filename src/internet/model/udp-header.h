@@ -185,6 +185,12 @@ private:
   bool m_goodChecksum;        //!< Flag to indicate that checksum is correct
 };
 
+/**
+ * \brief Every UdpHeader is serialized in 8 bytes.
+ */
+template <>
+struct StaticSerializedSize<UdpHeader> : public std::integral_constant<uint32_t, 8> {};
+
 } // namespace ns3
 
 #endif /* UDP_HEADER */
@@ -42,6 +42,7 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 #include <limits>
 #include <sys/types.h>
 
@@ -270,6 +271,80 @@ Ipv4HeaderTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the checksum updated when the TTL is decremented is
+ * the one computed from the fields.
+ */
+class Ipv4HeaderTtlChecksumTest : public TestCase
+{
+public:
+  Ipv4HeaderTtlChecksumTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Serialize a header.
+   * \param header The header.
+   * \returns The serialized bytes.
+   */
+  static std::vector<uint8_t> Serialize (const Ipv4Header &header);
+};
+
+Ipv4HeaderTtlChecksumTest::Ipv4HeaderTtlChecksumTest ()
+  : TestCase ("Check the incremental checksum update of the TTL decrement")
+{
+}
+
+std::vector<uint8_t>
+Ipv4HeaderTtlChecksumTest::Serialize (const Ipv4Header &header)
+{
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (header);
+  std::vector<uint8_t> bytes (p->GetSize ());
+  p->CopyData (&bytes[0], bytes.size ());
+  return bytes;
+}
+
+void
+Ipv4HeaderTtlChecksumTest::DoRun (void)
+{
+  uint32_t seed = 1;
+  for (uint32_t n = 0; n < 200; n++)
+    {
+      seed = seed * 1103515245 + 12345;
+      Ipv4Header sent;
+      sent.EnableChecksum ();
+      sent.SetSource (Ipv4Address (seed));
+      sent.SetDestination (Ipv4Address (~seed * 7));
+      sent.SetIdentification (seed >> 16);
+      sent.SetPayloadSize ((seed >> 8) & 0x3fff);
+      sent.SetTos (seed >> 24);
+      sent.SetProtocol (n);
+      sent.SetTtl (n < 4 ? n : (seed >> 4) & 0xff);
+
+      Ptr<Packet> p = Create<Packet> ();
+      p->AddHeader (sent);
+      Ipv4Header received;
+      received.EnableChecksum ();
+      p->RemoveHeader (received);
+      NS_TEST_ASSERT_MSG_EQ (received.IsChecksumOk (), true, "Wrong checksum sent");
+
+      // Decrement the TTL through 0, and compare with a header whose
+      // checksum is computed from the fields.
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          received.DecrementTtl ();
+          Ipv4Header computed = received;
+          computed.SetTtl (received.GetTtl ());
+          NS_TEST_EXPECT_MSG_EQ ((Serialize (received) == Serialize (computed)), true,
+                                 "Wrong checksum update from TTL " << (uint32_t) (received.GetTtl () + 1) % 256);
+        }
+    }
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -282,6 +357,7 @@ public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderTtlChecksumTest, TestCase::QUICK);
   }
 };
 
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "partition-helper.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PartitionHelper");
+
+PartitionHelper::PartitionHelper ()
+  : m_lookahead (Time::Max ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+PartitionHelper::Find (uint32_t nodeId)
+{
+  while (m_parent[nodeId] != nodeId)
+    {
+      m_parent[nodeId] = m_parent[m_parent[nodeId]];
+      nodeId = m_parent[nodeId];
+    }
+  return nodeId;
+}
+
+void
+PartitionHelper::Union (uint32_t a, uint32_t b)
+{
+  a = Find (a);
+  b = Find (b);
+  // the smallest node id represents its group
+  if (a < b)
+    {
+      m_parent[b] = a;
+    }
+  else if (b < a)
+    {
+      m_parent[a] = b;
+    }
+}
+
+void
+PartitionHelper::Compute (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ABORT_MSG_IF (n == 0, "PartitionHelper::Compute(): no partition");
+  uint32_t nNodes = NodeList::GetNNodes ();
+  m_parent.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      m_parent[i] = i;
+    }
+
+  // Group the nodes which cannot be separated, and list the links
+  // which may join two partitions.
+  std::vector<Link> links;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<NetDevice> device = node->GetDevice (j);
+          Ptr<Channel> channel = device->GetChannel ();
+          if (channel == 0 || channel->GetNDevices () == 0)
+            {
+              continue;
+            }
+          TimeValue delay;
+          if (device->IsPointToPoint ()
+              && channel->GetNDevices () == 2
+              && channel->GetAttributeFailSafe ("Delay", delay)
+              && delay.Get ().IsStrictlyPositive ())
+            {
+              Ptr<NetDevice> remote = channel->GetDevice (0) == device ? channel->GetDevice (1) : channel->GetDevice (0);
+              Link link;
+              link.a = i;
+              link.b = remote->GetNode ()->GetId ();
+              link.delay = delay.Get ();
+              links.push_back (link);
+            }
+          else
+            {
+              Union (i, channel->GetDevice (0)->GetNode ()->GetId ());
+            }
+        }
+    }
+
+  // Cut the groups, in node id order, into blocks of about nNodes / n
+  // nodes.  Each group joins the block of its first node.
+  m_partition.assign (nNodes, 0);
+  std::vector<uint32_t> groupPartition (nNodes, 0);
+  uint32_t assigned = 0;
+  uint32_t partition = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t group = Find (i);
+      if (group == i)
+        {
+          while (partition + 1 < n && assigned >= static_cast<uint64_t> (partition + 1) * nNodes / n)
+            {
+              partition++;
+            }
+          groupPartition[i] = partition;
+        }
+      m_partition[i] = groupPartition[group];
+      assigned++;
+    }
+
+  m_lookahead = Time::Max ();
+  for (std::vector<Link>::const_iterator i = links.begin (); i != links.end (); ++i)
+    {
+      if (m_partition[i->a] != m_partition[i->b])
+        {
+          m_lookahead = std::min (m_lookahead, i->delay);
+        }
+    }
+  NS_LOG_INFO (nNodes << " nodes in " << n << " partitions, lookahead " << m_lookahead.As (Time::S));
+}
+
+void
+PartitionHelper::Install (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_ABORT_MSG_IF (impl == 0, "PartitionHelper::Install(): the simulator is not a MultithreadedSimulatorImpl");
+  uint32_t n = impl->GetThreadCount ();
+  if (n == 0)
+    {
+      n = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+  Compute (n);
+  for (uint32_t i = 0; i < m_partition.size (); ++i)
+    {
+      impl->SetPartition (i, m_partition[i]);
+    }
+  impl->SetLookahead (m_lookahead);
+}
+
+uint32_t
+PartitionHelper::GetPartition (uint32_t nodeId) const
+{
+  NS_ASSERT (nodeId < m_partition.size ());
+  return m_partition[nodeId];
+}
+
+Time
+PartitionHelper::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PARTITION_HELPER_H
+#define PARTITION_HELPER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \brief Split the nodes of a topology between the threads of a
+ * MultithreadedSimulatorImpl.
+ *
+ * Nodes can only run in different threads if every event between
+ * them is delayed by a known minimum, the lookahead.  Like the
+ * lookahead computation of the distributed simulator, this helper
+ * considers point-to-point links: two nodes linked by a
+ * point-to-point channel with a positive \c Delay attribute may be
+ * separated, and the smallest such delay between two partitions is
+ * the lookahead.  All the nodes attached to any other channel (CSMA,
+ * wireless, ...) are kept in the same partition, since these
+ * channels share state between their devices and have no fixed
+ * propagation delay.
+ *
+ * The groups of nodes which must stay together are then cut, in
+ * node id order, into one block of about the same number of nodes
+ * per thread, so that nodes created together stay together.
+ *
+ * Install() must be called once the topology is complete, before
+ * Simulator::Run, with the MultithreadedSimulatorImpl selected:
+ *
+ * \code
+ *   GlobalValue::Bind ("SimulatorImplementationType",
+ *                      StringValue ("ns3::MultithreadedSimulatorImpl"));
+ *   Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount",
+ *                       UintegerValue (8));
+ *   // build the topology and the applications
+ *   PartitionHelper partition;
+ *   partition.Install ();
+ *   Simulator::Run ();
+ * \endcode
+ */
+class PartitionHelper
+{
+public:
+  PartitionHelper ();
+
+  /**
+   * Compute the partitions of all the nodes of the NodeList for the
+   * number of threads of the simulator, and configure the simulator
+   * with them and with the resulting lookahead.
+   */
+  void Install (void);
+  /**
+   * Compute the partitions of all the nodes of the NodeList.
+   *
+   * \param n The number of partitions.
+   */
+  void Compute (uint32_t n);
+  /**
+   * \param nodeId The id of a node.
+   * \returns The partition of the node, after Compute().
+   */
+  uint32_t GetPartition (uint32_t nodeId) const;
+  /**
+   * \returns The smallest delay of the links between two partitions,
+   * after Compute().  Time::Max() if there is no such link.
+   */
+  Time GetLookahead (void) const;
+
+private:
+  /**
+   * Find the representative of the group of a node.
+   * \param nodeId The id of the node.
+   * \returns The id of the representative.
+   */
+  uint32_t Find (uint32_t nodeId);
+  /**
+   * Merge the groups of two nodes.
+   * \param a The id of the first node.
+   * \param b The id of the second node.
+   */
+  void Union (uint32_t a, uint32_t b);
+
+  /** A point-to-point link between two nodes. */
+  struct Link
+  {
+    uint32_t a;  //!< First node id.
+    uint32_t b;  //!< Second node id.
+    Time delay;  //!< Propagation delay.
+  };
+
+  std::vector<uint32_t> m_parent;    //!< Union-find forest of the node groups.
+  std::vector<uint32_t> m_partition; //!< Partition of each node.
+  Time m_lookahead;                  //!< Smallest delay between two partitions.
+};
+
+} // namespace ns3
+
+#endif /* PARTITION_HELPER_H */
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-profiler.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -43,6 +44,64 @@ static struct Zeroes
   const uint32_t size;  //!< buffer size
 } g_zeroes; //!< Zero-filled buffer
 
+/**
+ * \ingroup packet
+ * \brief Sum contiguous bytes as the 16-bit words read by
+ * Buffer::Iterator::ReadU16, whose first byte is the low-order one.
+ *
+ * The bytes are added eight at a time, as two 32-bit halves of a
+ * 64-bit word in host order, and the sum is folded and swapped to the
+ * order of ReadU16 at the end, which RFC 1071 shows to give the same
+ * one's complement sum.
+ *
+ * \param data the bytes
+ * \param size the number of bytes
+ * \return the one's complement sum, folded to 16 bits
+ */
+uint32_t
+ChecksumAdd (const uint8_t *data, uint32_t size)
+{
+  uint64_t sum = 0;
+  for (; size >= 8; data += 8, size -= 8)
+    {
+      uint64_t word;
+      memcpy (&word, data, 8);
+      sum += (word & 0xffffffff) + (word >> 32);
+    }
+  if (size >= 4)
+    {
+      uint32_t word;
+      memcpy (&word, data, 4);
+      sum += word;
+      data += 4;
+      size -= 4;
+    }
+  if (size >= 2)
+    {
+      uint16_t word;
+      memcpy (&word, data, 2);
+      sum += word;
+      data += 2;
+      size -= 2;
+    }
+  uint16_t one = 1;
+  bool bigEndian = *reinterpret_cast<uint8_t *> (&one) == 0;
+  if (size == 1)
+    {
+      // The low-order byte of the last word, in host order.
+      sum += bigEndian ? data[0] << 8 : data[0];
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  if (bigEndian)
+    {
+      sum = ((sum & 0xff) << 8) | (sum >> 8);
+    }
+  return static_cast<uint32_t> (sum);
+}
+
 }
 
 namespace ns3 {
@@ -50,7 +109,12 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
+bool Buffer::g_scatterGather = false;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -75,9 +139,23 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
+/* With NS3_MTP, the free list and the heuristics are per thread, so
+ * that the threads of a multithreaded simulation never share them.
+ * Otherwise packets are only used by one thread at a time, and plain
+ * statics avoid a thread-local access on each buffer allocation. */
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList *Buffer::g_freeList = 0;
+thread_local struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#else
 uint32_t Buffer::g_maxSize = 0;
 Buffer::FreeList *Buffer::g_freeList = 0;
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+#endif
+
+void
+Buffer::LocalStaticDestructor::Arm (void)
+{}
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
@@ -99,11 +177,15 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyBufferDestroyed (data);
+    }
   g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
+  /* feed into free list; the data may have been created by another
+   * thread, which has its own free list. */
   if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
+      !IS_INITIALIZED (g_freeList) ||
       g_freeList->size () > 1000)
     {
       Buffer::Deallocate (data);
@@ -123,6 +205,7 @@ Buffer::Create (uint32_t dataSize)
   if (IS_UNINITIALIZED (g_freeList))
     {
       g_freeList = new Buffer::FreeList ();
+      g_localStaticDestructor.Arm ();
     }
   else if (IS_INITIALIZED (g_freeList))
     {
@@ -133,6 +216,10 @@ Buffer::Create (uint32_t dataSize)
           if (data->m_size >= dataSize) 
             {
               data->m_count = 1;
+              if (PacketProfiler::IsEnabled ())
+                {
+                  PacketProfiler::NotifyBufferCreated (data, data->m_size);
+                }
               return data;
             }
           Buffer::Deallocate (data);
@@ -140,6 +227,10 @@ Buffer::Create (uint32_t dataSize)
     }
   struct Buffer::Data *data = Buffer::Allocate (dataSize);
   NS_ASSERT (data->m_count == 1);
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyBufferCreated (data, data->m_size);
+    }
   return data;
 }
 #else /* BUFFER_FREE_LIST */
@@ -148,6 +239,10 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyBufferDestroyed (data);
+    }
   Deallocate (data);
 }
 
@@ -155,7 +250,12 @@ Buffer::Data *
 Buffer::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  return Allocate (size);
+  struct Buffer::Data *data = Allocate (size);
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyBufferCreated (data, data->m_size);
+    }
+  return data;
 }
 #endif /* BUFFER_FREE_LIST */
 
@@ -186,18 +286,24 @@ Buffer::Deallocate (struct Buffer::Data *data)
 }
 
 Buffer::Buffer ()
+  : m_fragments (0),
+    m_fragmentsSize (0)
 {
   NS_LOG_FUNCTION (this);
   Initialize (0);
 }
 
 Buffer::Buffer (uint32_t dataSize)
+  : m_fragments (0),
+    m_fragmentsSize (0)
 {
   NS_LOG_FUNCTION (this << dataSize);
   Initialize (dataSize);
 }
 
 Buffer::Buffer (uint32_t dataSize, bool initialize)
+  : m_fragments (0),
+    m_fragmentsSize (0)
 {
   NS_LOG_FUNCTION (this << dataSize << initialize);
   if (initialize == true)
@@ -226,7 +332,10 @@ Buffer::CheckInternalState (void) const
     m_start <= m_data->m_size &&
     m_zeroAreaStart <= m_data->m_size;
 
-  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk;
+  bool fragmentsOk = m_fragments == 0 ||
+    (m_fragments->m_count > 0 && !m_fragments->m_buffers.empty () && m_end > m_start);
+
+  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk && fragmentsOk;
   if (!ok)
     {
       LOG_INTERNAL_STATE ("check " << this << 
@@ -259,6 +368,25 @@ Buffer &
 Buffer::operator = (Buffer const&o)
 {
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != o.m_fragments)
+    {
+      if (o.m_fragments != 0)
+        {
+          o.m_fragments->m_count++;
+        }
+      ReleaseFragments ();
+      m_fragments = o.m_fragments;
+    }
+  m_fragmentsSize = o.m_fragmentsSize;
+  SetHead (o);
+  NS_ASSERT (CheckInternalState ());
+  return *this;
+}
+
+void
+Buffer::SetHead (Buffer const &o)
+{
+  NS_ASSERT (o.m_fragments == 0 || o.m_fragments == m_fragments);
   if (m_data != o.m_data) 
     {
       // not assignment to self.
@@ -276,14 +404,13 @@ Buffer::operator = (Buffer const&o)
   m_zeroAreaEnd = o.m_zeroAreaEnd;
   m_start = o.m_start;
   m_end = o.m_end;
-  NS_ASSERT (CheckInternalState ());
-  return *this;
 }
 
 Buffer::~Buffer ()
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
+  ReleaseFragments ();
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
   m_data->m_count--;
   if (m_data->m_count == 0) 
@@ -305,6 +432,105 @@ Buffer::GetInternalEnd (void) const
   return m_end - (m_zeroAreaEnd - m_zeroAreaStart);
 }
 
+void
+Buffer::EnableScatterGather (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_scatterGather = true;
+}
+
+void
+Buffer::DisableScatterGather (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_scatterGather = false;
+}
+
+void
+Buffer::UnshareFragments (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fragments == 0)
+    {
+      m_fragments = new Buffer::Fragments ();
+      m_fragments->m_count = 1;
+      m_fragments->m_buffers.reserve (8);
+    }
+  else if (m_fragments->m_count > 1)
+    {
+      struct Buffer::Fragments *fragments = new Buffer::Fragments ();
+      fragments->m_count = 1;
+      fragments->m_buffers = m_fragments->m_buffers;
+      m_fragments->m_count--;
+      m_fragments = fragments;
+    }
+}
+
+void
+Buffer::ReleaseFragments (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fragments != 0)
+    {
+      m_fragments->m_count--;
+      if (m_fragments->m_count == 0)
+        {
+          delete m_fragments;
+        }
+      m_fragments = 0;
+      m_fragmentsSize = 0;
+    }
+}
+
+void
+Buffer::AppendFragment (Buffer const &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  NS_ASSERT (o.m_fragments == 0);
+  if (o.GetSize () == 0)
+    {
+      return;
+    }
+  if (GetSize () == 0)
+    {
+      SetHead (o);
+      return;
+    }
+  UnshareFragments ();
+  m_fragments->m_buffers.push_back (o);
+  m_fragmentsSize += o.GetSize ();
+}
+
+void
+Buffer::Gather (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_fragments != 0);
+  Buffer *self = const_cast<Buffer *> (this);
+  /* Keep room for the headers in front of the contiguous bytes, as a
+   * new buffer does. */
+  uint32_t size = GetSize ();
+  struct Buffer::Data *data = Buffer::Create (g_recommendedStart + size);
+  uint32_t start = std::min (data->m_size - size, g_recommendedStart);
+  CopyData (data->m_data + start, size);
+  self->ReleaseFragments ();
+  self->m_data->m_count--;
+  if (self->m_data->m_count == 0)
+    {
+      Buffer::Recycle (self->m_data);
+    }
+  self->m_data = data;
+  self->m_start = start;
+  self->m_zeroAreaStart = start + size;
+  self->m_zeroAreaEnd = start + size;
+  self->m_end = start + size;
+  self->m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
+  data->m_dirtyStart = m_start;
+  data->m_dirtyEnd = m_end;
+  LOG_INTERNAL_STATE ("gather ");
+  NS_ASSERT (CheckInternalState ());
+}
+
 void
 Buffer::AddAtStart (uint32_t start)
 {
@@ -355,6 +581,17 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != 0)
+    {
+      /* add the bytes to the last fragment, which copies it if it
+       * is shared. */
+      UnshareFragments ();
+      m_fragments->m_buffers.back ().AddAtEnd (end);
+      m_fragmentsSize += end;
+      LOG_INTERNAL_STATE ("add end=" << end << ", ");
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
@@ -400,7 +637,9 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
+  if (m_fragments == 0 &&
+      o.m_fragments == 0 &&
+      m_data->m_count == 1 &&
       m_end == m_zeroAreaEnd &&
       m_end == m_data->m_dirtyEnd &&
       o.m_start == o.m_zeroAreaStart &&
@@ -426,6 +665,36 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
+  if (g_scatterGather)
+    {
+      /* Append the contiguous part and the fragments of o, without
+       * copying their bytes. */
+      if (o.m_fragments == 0 && &o != this)
+        {
+          AppendFragment (o);
+        }
+      else
+        {
+          /* The reference held by source keeps the fragments of o
+           * unchanged, even if o is this buffer. */
+          Buffer source = o;
+          Buffer head = source;
+          head.ReleaseFragments ();
+          AppendFragment (head);
+          if (source.m_fragments != 0)
+            {
+              for (std::vector<Buffer>::const_iterator i = source.m_fragments->m_buffers.begin ();
+                   i != source.m_fragments->m_buffers.end (); ++i)
+                {
+                  AppendFragment (*i);
+                }
+            }
+        }
+      LOG_INTERNAL_STATE ("add fragments=" << o.GetSize () << ", ");
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
   *this = CreateFullCopy ();
   AddAtEnd (o.GetSize ());
   Buffer::Iterator destStart = End ();
@@ -439,6 +708,30 @@ Buffer::RemoveAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != 0 && start >= m_end - m_start)
+    {
+      /* remove the contiguous part and the fragments which fit in
+       * start: the next fragment becomes the contiguous part.
+       */
+      start -= m_end - m_start;
+      UnshareFragments ();
+      std::vector<Buffer> &buffers = m_fragments->m_buffers;
+      std::vector<Buffer>::iterator next = buffers.begin ();
+      while (next + 1 != buffers.end () && start >= next->GetSize ())
+        {
+          start -= next->GetSize ();
+          m_fragmentsSize -= next->GetSize ();
+          ++next;
+        }
+      Buffer head = *next;
+      m_fragmentsSize -= head.GetSize ();
+      buffers.erase (buffers.begin (), next + 1);
+      if (buffers.empty ())
+        {
+          ReleaseFragments ();
+        }
+      SetHead (head);
+    }
   uint32_t newStart = m_start + start;
   if (newStart <= m_zeroAreaStart)
     {
@@ -484,6 +777,34 @@ Buffer::RemoveAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != 0)
+    {
+      /* remove the fragments which fit in end, and the end of the
+       * last remaining one.
+       */
+      UnshareFragments ();
+      std::vector<Buffer> &buffers = m_fragments->m_buffers;
+      while (end > 0 && !buffers.empty ())
+        {
+          uint32_t size = buffers.back ().GetSize ();
+          if (size > end)
+            {
+              buffers.back ().RemoveAtEnd (end);
+              m_fragmentsSize -= end;
+              end = 0;
+            }
+          else
+            {
+              buffers.pop_back ();
+              m_fragmentsSize -= size;
+              end -= size;
+            }
+        }
+      if (buffers.empty ())
+        {
+          ReleaseFragments ();
+        }
+    }
   uint32_t newEnd = m_end - std::min (end, m_end - m_start);
   if (newEnd > m_zeroAreaEnd)
     {
@@ -520,6 +841,32 @@ Buffer::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != 0)
+    {
+      /* take the fragment from the parts of the buffer which it
+       * overlaps: the result has fragments only if there are several
+       * of them. */
+      uint32_t end = start + length;
+      Buffer tmp = *this;
+      tmp.ReleaseFragments ();
+      uint32_t offset = tmp.GetSize ();
+      tmp.RemoveAtEnd (offset - std::min (end, offset));
+      tmp.RemoveAtStart (start);
+      for (std::vector<Buffer>::const_iterator i = m_fragments->m_buffers.begin ();
+           i != m_fragments->m_buffers.end () && offset < end; ++i)
+        {
+          uint32_t size = i->GetSize ();
+          if (offset + size > start)
+            {
+              uint32_t from = std::max (start, offset) - offset;
+              uint32_t to = std::min (end, offset + size) - offset;
+              tmp.AppendFragment (to - from == size ? *i : i->CreateFragment (from, to - from));
+            }
+          offset += size;
+        }
+      NS_ASSERT (tmp.GetSize () == length);
+      return tmp;
+    }
   Buffer tmp = *this;
   tmp.RemoveAtStart (start);
   tmp.RemoveAtEnd (GetSize () - (start + length));
@@ -532,6 +879,10 @@ Buffer::CreateFullCopy (void) const
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
+  if (m_fragments != 0)
+    {
+      Gather ();
+    }
   if (m_zeroAreaEnd - m_zeroAreaStart != 0) 
     {
       Buffer tmp;
@@ -556,6 +907,10 @@ uint32_t
 Buffer::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_fragments != 0)
+    {
+      Gather ();
+    }
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -576,6 +931,10 @@ uint32_t
 Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  if (m_fragments != 0)
+    {
+      Gather ();
+    }
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -715,6 +1074,7 @@ void
 Buffer::CopyData (std::ostream *os, uint32_t size) const
 {
   NS_LOG_FUNCTION (this << &os << size);
+  uint32_t fragmentsSize = size - std::min (size, m_end - m_start);
   if (size > 0)
     {
       uint32_t tmpsize = std::min (m_zeroAreaStart-m_start, size);
@@ -738,6 +1098,15 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
             }
         }
     }
+  if (m_fragments != 0)
+    {
+      for (std::vector<Buffer>::const_iterator i = m_fragments->m_buffers.begin ();
+           i != m_fragments->m_buffers.end () && fragmentsSize > 0; ++i)
+        {
+          i->CopyData (os, fragmentsSize);
+          fragmentsSize -= std::min (fragmentsSize, i->GetSize ());
+        }
+    }
 }
 
 uint32_t 
@@ -767,10 +1136,21 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
             {
               tmpsize = std::min (m_end - m_zeroAreaEnd, size);
               memcpy (buffer, (const char*)(m_data->m_data + m_zeroAreaStart), tmpsize);
+              buffer += tmpsize;
               size -= tmpsize;
             }
         }
     }
+  if (m_fragments != 0)
+    {
+      for (std::vector<Buffer>::const_iterator i = m_fragments->m_buffers.begin ();
+           i != m_fragments->m_buffers.end () && size > 0; ++i)
+        {
+          uint32_t copied = i->CopyData (buffer, size);
+          buffer += copied;
+          size -= copied;
+        }
+    }
   return originalSize - size;
 }
 
@@ -783,7 +1163,7 @@ uint32_t
 Buffer::Iterator::GetDistanceFrom (Iterator const &o) const
 {
   NS_LOG_FUNCTION (this << &o);
-  NS_ASSERT (m_data == o.m_data);
+  NS_ASSERT (m_buffer == 0 ? m_data == o.m_data : m_buffer == o.m_buffer);
   int32_t diff = m_current - o.m_current;
   if (diff < 0)
     {
@@ -835,6 +1215,17 @@ void
 Buffer::Iterator::Write (Iterator start, Iterator end)
 {
   NS_LOG_FUNCTION (this << &start << &end);
+  if (m_buffer != 0 || start.m_buffer != 0)
+    {
+      // One of the buffers has fragments.
+      NS_ASSERT (start.m_current <= end.m_current);
+      uint32_t size = end.m_current - start.m_current;
+      for (uint32_t i = 0; i < size; i++)
+        {
+          WriteU8 (start.ReadU8 ());
+        }
+      return;
+    }
   NS_ASSERT (start.m_data == end.m_data);
   NS_ASSERT (start.m_current <= end.m_current);
   NS_ASSERT (start.m_zeroStart == end.m_zeroStart);
@@ -843,27 +1234,28 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // The written bytes are all before, or all after, the zero area.
+  uint8_t *to = &m_data[m_current <= m_zeroStart ? m_current : m_current - (m_zeroEnd - m_zeroStart)];
+  m_current += size;
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
-  m_current += toCopy;
 }
 
 void 
@@ -955,6 +1347,17 @@ Buffer::Iterator::Write (uint8_t const*buffer, uint32_t size)
   NS_LOG_FUNCTION (this << &buffer << size);
   NS_ASSERT_MSG (CheckNoZero (m_current, size),
                  GetWriteErrorMessage ());
+  if (m_buffer != 0 &&
+      !(m_current + size <= m_zeroStart ||
+        (m_current >= m_zeroEnd && m_current + size <= m_windowEnd)))
+    {
+      // The bytes are not all in the current window.
+      for (uint32_t i = 0; i < size; i++)
+        {
+          WriteU8 (buffer[i]);
+        }
+      return;
+    }
   uint8_t *to;
   if (m_current <= m_zeroStart)
     {
@@ -1015,6 +1418,92 @@ Buffer::Iterator::ReadU64 (void)
 
   return data;
 }
+void
+Buffer::Iterator::SelectWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_buffer == 0)
+    {
+      return;
+    }
+  /* find the part of the buffer, the contiguous part or a fragment,
+   * which contains m_current, or the last one at the end. */
+  const Buffer *part = m_buffer;
+  uint32_t start = m_buffer->m_start;
+  if (m_current >= m_buffer->m_end)
+    {
+      start = m_buffer->m_end;
+      const std::vector<Buffer> &buffers = m_buffer->m_fragments->m_buffers;
+      for (std::vector<Buffer>::const_iterator i = buffers.begin (); i != buffers.end (); ++i)
+        {
+          part = &*i;
+          if (m_current < start + i->GetSize () || i + 1 == buffers.end ())
+            {
+              break;
+            }
+          start += i->GetSize ();
+        }
+    }
+  /* The virtual offsets of the part are its own offsets, shifted so
+   * that it starts at start. */
+  uint32_t shift = start - part->m_start;
+  m_zeroStart = part->m_zeroAreaStart + shift;
+  m_zeroEnd = part->m_zeroAreaEnd + shift;
+  m_windowStart = start;
+  m_windowEnd = part->m_end + shift;
+  m_data = reinterpret_cast<uint8_t *> (reinterpret_cast<uintptr_t> (part->m_data->m_data) -
+                                        static_cast<uintptr_t> (static_cast<int32_t> (shift)));
+}
+
+uint8_t
+Buffer::Iterator::SlowPeekU8 (void)
+{
+  NS_LOG_FUNCTION (this);
+  SelectWindow ();
+  if (m_current < m_zeroStart)
+    {
+      return m_data[m_current];
+    }
+  else if (m_current < m_zeroEnd)
+    {
+      return 0;
+    }
+  else
+    {
+      return m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+}
+
+void
+Buffer::Iterator::SlowWriteU8 (uint8_t data, uint32_t len)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (data) << len);
+  if (m_buffer == 0)
+    {
+      // A write which starts before the zero area and ends after it.
+      uint8_t *buffer = &m_data[m_current <= m_zeroStart ? m_current : m_current - (m_zeroEnd - m_zeroStart)];
+      std::memset (buffer, data, len);
+      m_current += len;
+      return;
+    }
+  while (len > 0)
+    {
+      if (m_current < m_windowStart || m_current >= m_windowEnd)
+        {
+          SelectWindow ();
+        }
+      if (m_current >= m_windowEnd || (m_current >= m_zeroStart && m_current < m_zeroEnd))
+        {
+          NS_ASSERT_MSG (false, GetWriteErrorMessage ());
+          return;
+        }
+      // The bytes of the window before, or after, the zero area.
+      uint32_t toWrite = std::min (len, (m_current < m_zeroStart ? m_zeroStart : m_windowEnd) - m_current);
+      WriteU8 (data, toWrite);
+      len -= toWrite;
+    }
+}
+
 uint16_t 
 Buffer::Iterator::SlowReadNtohU16 (void)
 {
@@ -1140,18 +1629,54 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
   NS_LOG_FUNCTION (this << size << initialChecksum);
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
-
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
-
-  if (size & 1)
-    sum += ReadU8 ();
+  NS_ASSERT_MSG (m_current + size <= m_dataEnd, GetReadErrorMessage ());
+  /* see RFC 1071 to understand this code. The bytes are summed by
+   * contiguous runs: the bytes before the zero area of the current
+   * window, the zero area, which adds nothing, and the bytes after it.
+   * A run which starts at an odd offset from the start of the range
+   * has its bytes in the other half of the words, so its sum is
+   * swapped. */
+  uint64_t sum = initialChecksum;
+  uint32_t offset = 0;
+  while (offset < size)
+    {
+      uint32_t n = size - offset;
+      uint32_t part;
+      if (m_current < m_zeroStart)
+        {
+          n = std::min (n, m_zeroStart - m_current);
+          part = ChecksumAdd (&m_data[m_current], n);
+          m_current += n;
+        }
+      else if (m_current < m_zeroEnd)
+        {
+          n = std::min (n, m_zeroEnd - m_current);
+          part = 0;
+          m_current += n;
+        }
+      else if (m_current < m_windowEnd)
+        {
+          n = std::min (n, m_windowEnd - m_current);
+          part = ChecksumAdd (&m_data[m_current - (m_zeroEnd - m_zeroStart)], n);
+          m_current += n;
+        }
+      else
+        {
+          // The next fragment, which ReadU8 selects.
+          n = 1;
+          part = ReadU8 ();
+        }
+      if (offset & 1)
+        {
+          part = ((part & 0xff) << 8) | (part >> 8);
+        }
+      sum += part;
+      offset += n;
+    }
 
   while (sum >> 16)
     sum = (sum & 0xffff) + (sum >> 16);
-  return ~sum;
+  return ~static_cast<uint16_t> (sum);
 }
 
 uint32_t 
@@ -88,6 +88,20 @@ namespace ns3 {
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * In scatter-gather mode, enabled with Buffer::EnableScatterGather,
+ * AddAtEnd (const Buffer &) does not copy the appended buffer: it keeps
+ * a reference to it in a list of fragments which follow the bytes
+ * described above, and CreateFragment, RemoveAtStart and RemoveAtEnd
+ * select fragments without copying them either.  The fragments are
+ * shared with the buffers they come from, and with the copies of the
+ * buffer, under the same copy-on-write rules.  AddAtStart only uses the
+ * first, contiguous, part of the buffer, so that headers are written in
+ * place, and AddAtEnd (uint32_t) only the last fragment.  An Iterator
+ * walks through the fragments: its fast paths use one window, the
+ * contiguous part or a fragment, and the slow paths move to the next
+ * one.  Only PeekData, Serialize and CreateFullCopy gather the
+ * fragments in one contiguous buffer.
  */
 class Buffer 
 {
@@ -438,6 +452,24 @@ private:
      * \warning this is the slow version, please use ReadNtohU32 (void)
      */
     uint32_t SlowReadNtohU32 (void);
+    /**
+     * \brief Select the part of a buffer with fragments which contains
+     * the current position, so that the fast paths can access it.
+     */
+    void SelectWindow (void);
+    /**
+     * \return the byte at the current position.
+     *
+     * \warning this is the slow version, please use PeekU8 (void)
+     */
+    uint8_t SlowPeekU8 (void);
+    /**
+     * \param data data to write in buffer
+     * \param len number of times data must be written in buffer
+     *
+     * \warning this is the slow version, please use WriteU8 (uint8_t, uint32_t)
+     */
+    void SlowWriteU8 (uint8_t data, uint32_t len);
     /**
      * \brief Returns an appropriate message indicating a read error
      * \returns the error message
@@ -455,6 +487,11 @@ private:
     /**
      * offset in virtual bytes from the start of the data buffer to the
      * start of the "virtual zero area".
+     *
+     * In a buffer with fragments, m_zeroStart, m_zeroEnd and m_data
+     * describe the window [m_windowStart, m_windowEnd): the contiguous
+     * part of the buffer or one of its fragments, whose virtual offsets
+     * follow those of the contiguous part.
      */
     uint32_t m_zeroStart;
     /**
@@ -477,11 +514,25 @@ private:
      * current position represented by this iterator.
      */
     uint32_t m_current;
+    /**
+     * offset in virtual bytes from the start of the data buffer to the
+     * start of the window which m_data describes.
+     */
+    uint32_t m_windowStart;
+    /**
+     * offset in virtual bytes from the start of the data buffer to the
+     * end of the window which m_data describes.
+     */
+    uint32_t m_windowEnd;
     /**
      * a pointer to the underlying byte buffer. All offsets are relative
      * to this pointer.
      */
     uint8_t *m_data;
+    /**
+     * the buffer, if it has fragments, or zero.
+     */
+    Buffer const *m_buffer;
   };
 
   /**
@@ -529,6 +580,17 @@ private:
    * pointing to this Buffer.
    */
   void AddAtEnd (const Buffer &o);
+  /**
+   * Enable the scatter-gather mode, in which AddAtEnd (const Buffer &)
+   * keeps a reference to the appended buffer instead of copying it.
+   */
+  static void EnableScatterGather (void);
+  /**
+   * Disable the scatter-gather mode.  The buffers which already have
+   * fragments keep them until they are gathered.
+   */
+  static void DisableScatterGather (void);
+
   /**
    * \param start size to remove
    *
@@ -685,6 +747,39 @@ private:
     uint8_t m_data[1];
   };
 
+  struct Fragments;
+
+  /**
+   * \brief Copy the fragments into one contiguous buffer.
+   *
+   * Like TransformIntoRealBuffer, this modifies the internal
+   * representation of a const buffer, but not its content.
+   */
+  void Gather (void) const;
+  /**
+   * \brief Replace the first, contiguous, part of the buffer,
+   * keeping the fragments.
+   *
+   * \param o the buffer, without fragments, whose content becomes the
+   *        first part of this buffer
+   */
+  void SetHead (Buffer const &o);
+  /**
+   * \brief Append a buffer without fragments to the fragments.
+   *
+   * \param o the buffer to append
+   */
+  void AppendFragment (Buffer const &o);
+  /**
+   * \brief Make sure the fragments exist and are not shared with
+   * another buffer, before modifying them.
+   */
+  void UnshareFragments (void);
+  /**
+   * \brief Drop the reference to the fragments.
+   */
+  void ReleaseFragments (void);
+
   /**
    * \brief Create a full copy of the buffer, including
    * all the internal structures.
@@ -750,6 +845,12 @@ private:
   static void Deallocate (struct Buffer::Data *data);
 
   struct Data *m_data; //!< the buffer data storage
+  /**
+   * the buffers which follow the bytes of m_data in scatter-gather
+   * mode, or zero.
+   */
+  struct Fragments *m_fragments;
+  uint32_t m_fragmentsSize; //!< the number of bytes in m_fragments
 
   /**
    * keep track of the maximum value of m_zeroAreaStart across
@@ -767,7 +868,12 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
+#ifdef NS3_MTP
+  static thread_local uint32_t g_recommendedStart;
+#else
   static uint32_t g_recommendedStart;
+#endif
+  static bool g_scatterGather; //!< Enable the scatter-gather mode
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -796,12 +902,32 @@ private:
   /// Local static destructor structure
   struct LocalStaticDestructor 
   {
+    /// Make sure the destructor of the calling thread runs at exit
+    void Arm (void);
     ~LocalStaticDestructor ();
   };
+#ifdef NS3_MTP
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+#else
   static uint32_t g_maxSize; //!< Max observed data size
   static FreeList *g_freeList; //!< Buffer data container
   static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
+#endif
+};
+
+/**
+ * \brief The fragments of a Buffer in scatter-gather mode.
+ *
+ * A Buffer and its copies share them until one of them modifies its
+ * list of fragments.
+ */
+struct Buffer::Fragments
+{
+  uint32_t m_count; //!< the number of buffers which reference this list
+  std::vector<Buffer> m_buffers; //!< the fragments, none of them empty or fragmented
 };
 
 } // namespace ns3
@@ -817,7 +943,10 @@ Buffer::Iterator::Iterator ()
     m_dataStart (0),
     m_dataEnd (0),
     m_current (0),
-    m_data (0)
+    m_windowStart (0),
+    m_windowEnd (0),
+    m_data (0),
+    m_buffer (0)
 {
 }
 Buffer::Iterator::Iterator (Buffer const*buffer)
@@ -838,7 +967,15 @@ Buffer::Iterator::Construct (const Buffer *buffer)
   m_zeroEnd = buffer->m_zeroAreaEnd;
   m_dataStart = buffer->m_start;
   m_dataEnd = buffer->m_end;
+  m_windowStart = buffer->m_start;
+  m_windowEnd = buffer->m_end;
   m_data = buffer->m_data->m_data;
+  m_buffer = 0;
+  if (buffer->m_fragments != 0)
+    {
+      m_dataEnd += buffer->m_fragmentsSize;
+      m_buffer = buffer;
+    }
 }
 
 void 
@@ -852,6 +989,10 @@ Buffer::Iterator::Prev (void)
 {
   NS_ASSERT (m_current >= 1);
   m_current--;
+  if (m_current < m_windowStart)
+    {
+      SelectWindow ();
+    }
 }
 void 
 Buffer::Iterator::Next (uint32_t delta)
@@ -864,6 +1005,10 @@ Buffer::Iterator::Prev (uint32_t delta)
 {
   NS_ASSERT (m_current >= delta);
   m_current -= delta;
+  if (m_current < m_windowStart)
+    {
+      SelectWindow ();
+    }
 }
 void
 Buffer::Iterator::WriteU8 (uint8_t data)
@@ -876,11 +1021,15 @@ Buffer::Iterator::WriteU8 (uint8_t data)
       m_data[m_current] = data;
       m_current++;
     }
-  else
+  else if (m_current >= m_zeroEnd && m_current < m_windowEnd)
     {
       m_data[m_current - (m_zeroEnd-m_zeroStart)] = data;
       m_current++;
     }
+  else
+    {
+      SlowWriteU8 (data, 1);
+    }
 }
 
 void 
@@ -888,17 +1037,21 @@ Buffer::Iterator::WriteU8 (uint8_t  data, uint32_t len)
 {
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + len),
                  GetWriteErrorMessage ());
-  if (m_current <= m_zeroStart)
+  if (m_current + len <= m_zeroStart)
     {
       std::memset (&(m_data[m_current]), data, len);
       m_current += len;
     }
-  else
+  else if (m_current >= m_zeroEnd && m_current + len <= m_windowEnd)
     {
       uint8_t *buffer = &m_data[m_current - (m_zeroEnd-m_zeroStart)];
       std::memset (buffer, data, len);
       m_current += len;
     }
+  else
+    {
+      SlowWriteU8 (data, len);
+    }
 }
 
 void 
@@ -911,10 +1064,16 @@ Buffer::Iterator::WriteHtonU16 (uint16_t data)
     {
       buffer = &m_data[m_current];
     }
-  else
+  else if (m_current >= m_zeroEnd && m_current + 2 <= m_windowEnd)
     {
       buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
+  else
+    {
+      uint8_t bytes[2] = {uint8_t (data >> 8), uint8_t (data)};
+      Write (bytes, 2);
+      return;
+    }
   buffer[0] = (data >> 8)& 0xff;
   buffer[1] = (data >> 0)& 0xff;
   m_current+= 2;
@@ -931,10 +1090,16 @@ Buffer::Iterator::WriteHtonU32 (uint32_t data)
     {
       buffer = &m_data[m_current];
     }
-  else
+  else if (m_current >= m_zeroEnd && m_current + 4 <= m_windowEnd)
     {
       buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
+  else
+    {
+      uint8_t bytes[4] = {uint8_t (data >> 24), uint8_t (data >> 16), uint8_t (data >> 8), uint8_t (data)};
+      Write (bytes, 4);
+      return;
+    }
   buffer[0] = (data >> 24)& 0xff;
   buffer[1] = (data >> 16)& 0xff;
   buffer[2] = (data >> 8)& 0xff;
@@ -950,7 +1115,7 @@ Buffer::Iterator::ReadNtohU16 (void)
     {
       buffer = &m_data[m_current];
     }
-  else if (m_current >= m_zeroEnd)
+  else if (m_current >= m_zeroEnd && m_current + 2 <= m_windowEnd)
     {
       buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
@@ -974,7 +1139,7 @@ Buffer::Iterator::ReadNtohU32 (void)
     {
       buffer = &m_data[m_current];
     }
-  else if (m_current >= m_zeroEnd)
+  else if (m_current >= m_zeroEnd && m_current + 4 <= m_windowEnd)
     {
       buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
@@ -1010,11 +1175,15 @@ Buffer::Iterator::PeekU8 (void)
     {
       return 0;
     }
-  else
+  else if (m_current < m_windowEnd)
     {
       uint8_t data = m_data[m_current - (m_zeroEnd-m_zeroStart)];
       return data;
     }
+  else
+    {
+      return SlowPeekU8 ();
+    }
 }
 
 uint8_t
@@ -1049,6 +1218,8 @@ Buffer::Iterator::Read (Buffer::Iterator start, uint32_t size)
 
 Buffer::Buffer (Buffer const&o)
   : m_data (o.m_data),
+    m_fragments (o.m_fragments),
+    m_fragmentsSize (o.m_fragmentsSize),
     m_maxZeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
@@ -1056,13 +1227,17 @@ Buffer::Buffer (Buffer const&o)
     m_end (o.m_end)
 {
   m_data->m_count++;
+  if (m_fragments != 0)
+    {
+      m_fragments->m_count++;
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
 uint32_t 
 Buffer::GetSize (void) const
 {
-  return m_end - m_start;
+  return m_end - m_start + m_fragmentsSize;
 }
 
 Buffer::Iterator 
@@ -17,6 +17,7 @@
  */
 
 #include "ns3/simulator.h"
+#include "ns3/simulation-instance.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
@@ -128,14 +129,14 @@ Ptr<ChannelListPriv> *
 ChannelListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<ChannelListPriv> ptr = 0;
-  if (ptr == 0)
+  Ptr<ChannelListPriv> *ptr = InstanceSingleton<Ptr<ChannelListPriv> >::Get ();
+  if (*ptr == 0)
     {
-      ptr = CreateObject<ChannelListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *ptr = CreateObject<ChannelListPriv> ();
+      Config::RegisterRootNamespaceObject (*ptr);
       Simulator::ScheduleDestroy (&ChannelListPriv::Delete);
     }
-  return &ptr;
+  return ptr;
 }
 
 void 
@@ -24,6 +24,7 @@
 #include "chunk.h"
 #include "buffer.h"
 #include <stdint.h>
+#include <type_traits>
 
 namespace ns3 {
 
@@ -113,6 +114,31 @@ public:
  */
 std::ostream & operator << (std::ostream &os, const Header &header);
 
+/**
+ * \ingroup packet
+ *
+ * \brief The serialized size of all the headers of a class, for the
+ * classes whose headers all have the same size.
+ *
+ * Packet::AddHeader, Packet::RemoveHeader and Packet::PeekHeader
+ * take a faster path for the classes which specialize this template:
+ * they use its \c value instead of calling Header::GetSerializedSize,
+ * and they call the Serialize and Deserialize methods of the class
+ * directly instead of through the virtual table.  A class specializes
+ * it, next to its declaration, only if its Serialize method always
+ * writes \c value bytes, and if no class derives from it:
+ *
+ * \code
+ *   template <>
+ *   struct StaticSerializedSize<UdpHeader>
+ *     : public std::integral_constant<uint32_t, 8> {};
+ * \endcode
+ *
+ * \tparam T \explicit The header class.
+ */
+template <typename T>
+struct StaticSerializedSize : public std::integral_constant<uint32_t, 0> {};
+
 } // namespace ns3
 
 #endif /* HEADER_H */
@@ -20,12 +20,18 @@
  */
 
 #include "ns3/simulator.h"
+#include "ns3/simulation-instance.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "node-list.h"
 #include "node.h"
+#include "packet-memory-pool.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace ns3 {
 
@@ -78,6 +84,25 @@ public:
    */
   uint32_t GetNNodes (void);
 
+  /**
+   * \brief Get the indices of the nodes from which a Config path may
+   * reach an object of a given type.
+   *
+   * The nodes are indexed by the types of their aggregates, for the
+   * paths "$TypeId", and of their devices and of the aggregates of
+   * these, for the paths "DeviceList/<index>/$TypeId". The index of a
+   * type is built at its first lookup, and rebuilt once nodes were
+   * added or the generation of the type in the object graph has
+   * changed, see Object::GetGraphGeneration().
+   *
+   * \param [in] path The elements of the Config path after the index
+   *            of the node, up to and including the first "$" element.
+   * \param [out] indices The indices of the nodes, in increasing order.
+   * \returns \c false if the path is not indexed.
+   */
+  bool GetIndicesByPath (const std::vector<std::string> &path,
+                         std::vector<std::size_t> *indices);
+
   /**
    * \brief Get the node list object
    * \returns the node list
@@ -102,6 +127,56 @@ private:
   virtual void DoDispose (void);
 
   std::vector<Ptr<Node> > m_nodes; //!< node objects container
+
+  /** The nodes which reach an object of a type. */
+  struct TypeIndex
+  {
+    uint64_t generation;             //!< The generation of the type.
+    std::size_t nNodes;              //!< The number of nodes of the list.
+    std::vector<std::size_t> nodes;  //!< The indices of the nodes.
+  };
+  /**
+   * The index of the nodes which aggregate (\c false) or hold a device
+   * (\c true) of a type, by TypeId uid.
+   */
+  std::map<std::pair<bool, uint16_t>, TypeIndex> m_typeIndex;
+};
+
+/**
+ * \ingroup network
+ * \brief The accessor of the NodeList attribute, which looks the nodes up
+ * in the type index of NodeListPriv.
+ */
+class NodeListAccessor : public ObjectPtrContainerAccessor
+{
+private:
+  virtual bool DoGetN (const ObjectBase *object, std::size_t *n) const
+  {
+    const NodeListPriv *list = dynamic_cast<const NodeListPriv *> (object);
+    if (list == 0)
+      {
+        return false;
+      }
+    *n = const_cast<NodeListPriv *> (list)->GetNNodes ();
+    return true;
+  }
+  virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const
+  {
+    NodeListPriv *list = const_cast<NodeListPriv *> (static_cast<const NodeListPriv *> (object));
+    *index = i;
+    return list->GetNode (i);
+  }
+  virtual bool DoIsIndexedByPosition (void) const
+  {
+    return true;
+  }
+  virtual bool DoGetIndicesByPath (const ObjectBase *object,
+                                   const std::vector<std::string> &path,
+                                   std::vector<std::size_t> *indices) const
+  {
+    NodeListPriv *list = const_cast<NodeListPriv *> (static_cast<const NodeListPriv *> (object));
+    return list->GetIndicesByPath (path, indices);
+  }
 };
 
 NS_OBJECT_ENSURE_REGISTERED (NodeListPriv);
@@ -114,7 +189,7 @@ NodeListPriv::GetTypeId (void)
     .SetGroupName("Network")
     .AddAttribute ("NodeList", "The list of all nodes created during the simulation.",
                    ObjectVectorValue (),
-                   MakeObjectVectorAccessor (&NodeListPriv::m_nodes),
+                   Ptr<const AttributeAccessor> (new NodeListAccessor (), false),
                    MakeObjectVectorChecker<Node> ())
   ;
   return tid;
@@ -130,14 +205,14 @@ Ptr<NodeListPriv> *
 NodeListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<NodeListPriv> ptr = 0;
-  if (ptr == 0)
+  Ptr<NodeListPriv> *ptr = InstanceSingleton<Ptr<NodeListPriv> >::Get ();
+  if (*ptr == 0)
     {
-      ptr = CreateObject<NodeListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *ptr = CreateObject<NodeListPriv> ();
+      Config::RegisterRootNamespaceObject (*ptr);
       Simulator::ScheduleDestroy (&NodeListPriv::Delete);
     }
-  return &ptr;
+  return ptr;
 }
 void 
 NodeListPriv::Delete (void)
@@ -145,6 +220,8 @@ NodeListPriv::Delete (void)
   NS_LOG_FUNCTION_NOARGS ();
   Config::UnregisterRootNamespaceObject (Get ());
   (*DoGet ()) = 0;
+  // The packets of the simulation went with its nodes.
+  PacketMemoryPool::Trim ();
 }
 
 
@@ -168,6 +245,7 @@ NodeListPriv::DoDispose (void)
       *i = 0;
     }
   m_nodes.erase (m_nodes.begin (), m_nodes.end ());
+  m_typeIndex.clear ();
   Object::DoDispose ();
 }
 
@@ -210,6 +288,67 @@ NodeListPriv::GetNode (uint32_t n)
   return m_nodes[n];
 }
 
+bool
+NodeListPriv::GetIndicesByPath (const std::vector<std::string> &path,
+                                std::vector<std::size_t> *indices)
+{
+  NS_LOG_FUNCTION (this << path.size () << indices);
+  bool device;
+  if (path.size () == 1)
+    {
+      device = false;
+    }
+  else if (path.size () == 3 && path[0] == "DeviceList")
+    {
+      device = true;
+    }
+  else
+    {
+      return false;
+    }
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (path.back ().substr (1), &tid))
+    {
+      return false;
+    }
+
+  uint64_t generation = Object::GetGraphGeneration (tid);
+  std::pair<bool, uint16_t> key (device, tid.GetUid ());
+  std::map<std::pair<bool, uint16_t>, TypeIndex>::iterator found = m_typeIndex.find (key);
+  if (found == m_typeIndex.end ()
+      || found->second.generation != generation
+      || found->second.nNodes != m_nodes.size ())
+    {
+      std::vector<std::size_t> nodes;
+      for (std::size_t i = 0; i < m_nodes.size (); i++)
+        {
+          bool reaches = false;
+          if (device)
+            {
+              for (uint32_t j = 0; !reaches && j < m_nodes[i]->GetNDevices (); j++)
+                {
+                  reaches = m_nodes[i]->GetDevice (j)->GetObject<Object> (tid) != 0;
+                }
+            }
+          else
+            {
+              reaches = m_nodes[i]->GetObject<Object> (tid) != 0;
+            }
+          if (reaches)
+            {
+              nodes.push_back (i);
+            }
+        }
+      NS_LOG_DEBUG ("Indexed " << nodes.size () << " nodes for " << tid.GetName ());
+      found = m_typeIndex.insert (std::make_pair (key, TypeIndex ())).first;
+      found->second.generation = generation;
+      found->second.nNodes = m_nodes.size ();
+      found->second.nodes.swap (nodes);
+    }
+  *indices = found->second.nodes;
+  return true;
+}
+
 }
 
 /**
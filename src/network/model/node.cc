@@ -132,9 +132,13 @@ Node::AddDevice (Ptr<NetDevice> device)
   NS_LOG_FUNCTION (this << device);
   uint32_t index = m_devices.size ();
   m_devices.push_back (device);
+  device->NotifyGraphChange ();
   device->SetNode (this);
   device->SetIfIndex (index);
   device->SetReceiveCallback (MakeCallback (&Node::NonPromiscReceiveFromDevice, this));
+  m_dispatch.resize (m_devices.size ());
+  m_promiscDispatch.resize (m_devices.size ());
+  UpdateDispatchTables (index);
   Simulator::ScheduleWithContext (GetId (), Seconds (0.0), 
                                   &NetDevice::Initialize, device);
   NotifyDeviceAdded (device);
@@ -187,6 +191,8 @@ Node::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_deviceAdditionListeners.clear ();
   m_handlers.clear ();
+  m_dispatch.clear ();
+  m_promiscDispatch.clear ();
   for (std::vector<Ptr<NetDevice> >::iterator i = m_devices.begin ();
        i != m_devices.end (); i++)
     {
@@ -257,6 +263,16 @@ Node::RegisterProtocolHandler (ProtocolHandler handler,
     }
 
   m_handlers.push_back (entry);
+
+  uint32_t index = device != 0 ? device->GetIfIndex () : 0;
+  if (device != 0 && index < m_devices.size () && m_devices[index] == device)
+    {
+      UpdateDispatchTables (index);
+    }
+  else
+    {
+      UpdateDispatchTables ();
+    }
 }
 
 void
@@ -272,6 +288,60 @@ Node::UnregisterProtocolHandler (ProtocolHandler handler)
           break;
         }
     }
+  UpdateDispatchTables ();
+}
+
+void
+Node::UpdateDispatchTables (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  Ptr<NetDevice> device = m_devices[index];
+  m_dispatch[index] = DeviceDispatch ();
+  m_promiscDispatch[index] = DeviceDispatch ();
+
+  // The protocols with handlers of their own get an entry first, so that
+  // the handlers of all the protocols registered before them are added to it.
+  for (ProtocolHandlerList::const_iterator i = m_handlers.begin ();
+       i != m_handlers.end (); i++)
+    {
+      if (i->protocol != 0 && (i->device == 0 || i->device == device))
+        {
+          DeviceDispatch &dispatch = i->promiscuous ? m_promiscDispatch[index] : m_dispatch[index];
+          dispatch.protocols[i->protocol];
+        }
+    }
+  for (ProtocolHandlerList::const_iterator i = m_handlers.begin ();
+       i != m_handlers.end (); i++)
+    {
+      if (i->device != 0 && i->device != device)
+        {
+          continue;
+        }
+      DeviceDispatch &dispatch = i->promiscuous ? m_promiscDispatch[index] : m_dispatch[index];
+      if (i->protocol == 0)
+        {
+          dispatch.others.push_back (i->handler);
+          for (std::unordered_map<uint16_t, ProtocolHandlerVector>::iterator j = dispatch.protocols.begin ();
+               j != dispatch.protocols.end (); j++)
+            {
+              j->second.push_back (i->handler);
+            }
+        }
+      else
+        {
+          dispatch.protocols[i->protocol].push_back (i->handler);
+        }
+    }
+}
+
+void
+Node::UpdateDispatchTables (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t index = 0; index < m_devices.size (); index++)
+    {
+      UpdateDispatchTables (index);
+    }
 }
 
 bool
@@ -310,8 +380,21 @@ Node::ReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16
   NS_LOG_DEBUG ("Node " << GetId () << " ReceiveFromDevice:  dev "
                         << device->GetIfIndex () << " (type=" << device->GetInstanceTypeId ().GetName ()
                         << ") Packet UID " << packet->GetUid ());
-  bool found = false;
+  uint32_t index = device->GetIfIndex ();
+  if (index < m_devices.size () && m_devices[index] == device)
+    {
+      const DeviceDispatch &dispatch = promiscuous ? m_promiscDispatch[index] : m_dispatch[index];
+      std::unordered_map<uint16_t, ProtocolHandlerVector>::const_iterator i = dispatch.protocols.find (protocol);
+      const ProtocolHandlerVector &handlers = i != dispatch.protocols.end () ? i->second : dispatch.others;
+      for (ProtocolHandlerVector::const_iterator j = handlers.begin (); j != handlers.end (); j++)
+        {
+          (*j) (device, packet, protocol, from, to, packetType);
+        }
+      return !handlers.empty ();
+    }
 
+  // The devices not added to this node have no dispatch table.
+  bool found = false;
   for (ProtocolHandlerList::iterator i = m_handlers.begin ();
        i != m_handlers.end (); i++)
     {
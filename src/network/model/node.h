@@ -22,6 +22,7 @@
 #define NODE_H
 
 #include <vector>
+#include <unordered_map>
 
 #include "ns3/object.h"
 #include "ns3/callback.h"
@@ -266,6 +267,17 @@ private:
    */
   void Construct (void);
 
+  /**
+   * \brief Rebuild the dispatch tables of a device from the protocol handlers.
+   * \param index the index of the device
+   */
+  void UpdateDispatchTables (uint32_t index);
+
+  /**
+   * \brief Rebuild the dispatch tables of all the devices.
+   */
+  void UpdateDispatchTables (void);
+
   /**
    * \brief Protocol handler entry.
    * This structure is used to demultiplex all the protocols.
@@ -279,6 +291,18 @@ private:
 
   /// Typedef for protocol handlers container
   typedef std::vector<struct Node::ProtocolHandlerEntry> ProtocolHandlerList;
+  /// Typedef for the handlers a packet is delivered to, in registration order
+  typedef std::vector<ProtocolHandler> ProtocolHandlerVector;
+
+  /**
+   * \brief The protocol handlers of a device, by protocol.
+   */
+  struct DeviceDispatch {
+    /// the handlers of the protocols which have handlers of their own, with the handlers of all the protocols
+    std::unordered_map<uint16_t, ProtocolHandlerVector> protocols;
+    /// the handlers of all the protocols, for the other protocols
+    ProtocolHandlerVector others;
+  };
   /// Typedef for NetDevice addition listeners container
   typedef std::vector<DeviceAdditionListener> DeviceAdditionListenerList;
 
@@ -287,6 +311,8 @@ private:
   std::vector<Ptr<NetDevice> > m_devices; //!< Devices associated to this node
   std::vector<Ptr<Application> > m_applications; //!< Applications associated to this node
   ProtocolHandlerList m_handlers; //!< Protocol handlers in the node
+  std::vector<DeviceDispatch> m_dispatch; //!< Non-promiscuous protocol handlers of each device
+  std::vector<DeviceDispatch> m_promiscDispatch; //!< Promiscuous protocol handlers of each device
   DeviceAdditionListenerList m_deviceAdditionListeners; //!< Device addition listeners in the node
 };
 
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-memory-pool.h"
+#include "ns3/log.h"
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PacketMemoryPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketMemoryPool");
+
+namespace {
+
+/**
+ * Get the pool of the packet metadata and tags.
+ * \returns The pool.
+ */
+SizeClassPool *
+GetPool (void)
+{
+#ifdef NS3_MTP
+  static const bool perThread = true;
+#else
+  static const bool perThread = false;
+#endif
+  static SizeClassPool *pool = new SizeClassPool (PacketMemoryPool::Granularity,
+                                                  PacketMemoryPool::AllocatorOverhead,
+                                                  PacketMemoryPool::MaxBlockSize,
+                                                  PacketMemoryPool::MaxCachedBlocks,
+                                                  perThread);
+  return pool;
+}
+
+} // unnamed namespace
+
+std::size_t
+PacketMemoryPool::GetBlockSize (std::size_t size)
+{
+  return GetPool ()->GetBlockSize (size);
+}
+
+void *
+PacketMemoryPool::Allocate (std::size_t size)
+{
+  return GetPool ()->Allocate (size);
+}
+
+void
+PacketMemoryPool::Deallocate (void *p, std::size_t size)
+{
+  GetPool ()->Deallocate (p, size);
+}
+
+PacketMemoryPool::Statistics
+PacketMemoryPool::GetStatistics (void)
+{
+  return GetPool ()->GetStatistics ();
+}
+
+void
+PacketMemoryPool::Trim (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetPool ()->Trim ();
+}
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_MEMORY_POOL_H
+#define PACKET_MEMORY_POOL_H
+
+#include "ns3/size-class-pool.h"
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PacketMemoryPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief Size-class free lists for the metadata and tags of packets.
+ *
+ * Every packet carries a PacketMetadata block, and often a
+ * ByteTagList and PacketTagList nodes, which are allocated when the
+ * packet is created or tagged and released when its last copy is
+ * gone.  These three share this pool, so that the blocks of past
+ * packets are recycled by the next ones whatever their kind, instead
+ * of each keeping a private free list or calling the general-purpose
+ * allocator.
+ *
+ * This is a SizeClassPool whose size classes are multiples of
+ * \c Granularity bytes less the \c AllocatorOverhead of the
+ * general-purpose allocator, up to \c MaxBlockSize.  GetBlockSize()
+ * tells the callers the rounded size, which they use as the capacity
+ * of the block.
+ *
+ * With NS3_MTP, where partitions create packets concurrently, the free
+ * lists are kept per thread; otherwise a single set of free lists is
+ * shared, since packets are only created and destroyed by the
+ * simulator thread.  The blocks cached by the calling thread are
+ * released when the NodeList of its simulation is destroyed, by
+ * Simulator::Destroy.
+ */
+class PacketMemoryPool
+{
+public:
+  /** Allocation counters of the pool of the calling thread. */
+  typedef SizeClassPool::Statistics Statistics;
+
+  /**
+   * Get the size of the block which serves a request.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The size of the block, at least \pname{size}.
+   */
+  static std::size_t GetBlockSize (std::size_t size);
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns A block of GetBlockSize(\pname{size}) bytes.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block obtained from Allocate().
+   *
+   * \param [in] p The block.
+   * \param [in] size The size which was passed to Allocate(), or the
+   *             size of the block.
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * Get the counters of the pool of the calling thread.
+   *
+   * \returns The pool statistics.
+   */
+  static Statistics GetStatistics (void);
+  /**
+   * Give all the blocks cached by the calling thread back to the
+   * general-purpose allocator.  The counters are kept.
+   */
+  static void Trim (void);
+
+  /** Size classes are multiples of this many bytes, less the overhead. */
+  static const std::size_t Granularity = 16;
+  /** Bytes taken by the general-purpose allocator for each block. */
+  static const std::size_t AllocatorOverhead = 8;
+  /** Largest size served from the free lists. */
+  static const std::size_t MaxBlockSize = 4096 - AllocatorOverhead;
+  /** Maximum number of blocks cached per size class. */
+  static const uint32_t MaxCachedBlocks = 16384;
+};
+
+} // namespace ns3
+
+#endif /* PACKET_MEMORY_POOL_H */
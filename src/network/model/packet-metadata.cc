@@ -23,6 +23,7 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include "packet-metadata.h"
+#include "packet-memory-pool.h"
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -34,19 +35,12 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (iterator i = begin (); i != end (); i++)
-    {
-      PacketMetadata::Deallocate (*i);
-    }
-  PacketMetadata::m_enable = false;
-}
+#ifdef NS3_MTP
+thread_local uint32_t PacketMetadata::m_sizeHint = 0;
+#else
+uint32_t PacketMetadata::m_sizeHint = 0;
+#endif
+std::atomic<uint16_t> PacketMetadata::m_chunkUid (0);
 
 void 
 PacketMetadata::Enable (void)
@@ -74,7 +68,10 @@ void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  struct PacketMetadata::Data *newData = PacketMetadata::Create (m_used + size);
+  // Grow geometrically, so that the metadata of aggregates is not
+  // copied at each item.
+  uint32_t n = std::max<uint32_t> (m_used + size, std::min (m_used * 2, 0xfff0));
+  struct PacketMetadata::Data *newData = PacketMetadata::Create (n);
   memcpy (newData->m_data, m_data->m_data, m_used);
   newData->m_dirtyEnd = m_used;
   m_data->m_count--;
@@ -241,14 +238,18 @@ PacketMetadata::Append16 (uint16_t value, uint8_t *buffer)
   value >>= 8;
   buffer[1] = value;
 }
-void
-PacketMetadata::Append32 (uint32_t value,  uint8_t *buffer)
+uint32_t
+PacketMetadata::ZigZagEncode (uint32_t difference)
 {
-  NS_LOG_FUNCTION (this << value << &buffer);
-  buffer[0] = value & 0xff;
-  buffer[1] = (value >> 8) & 0xff;
-  buffer[2] = (value >> 16) & 0xff;
-  buffer[3] = (value >> 24) & 0xff;
+  NS_LOG_FUNCTION (difference);
+  int32_t delta = static_cast<int32_t> (difference);
+  return (difference << 1) ^ static_cast<uint32_t> (delta >> 31);
+}
+int32_t
+PacketMetadata::ZigZagDecode (uint32_t value)
+{
+  NS_LOG_FUNCTION (value);
+  return static_cast<int32_t> ((value >> 1) ^ (0 - (value & 0x1)));
 }
 
 void
@@ -414,8 +415,12 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   uint32_t typeUidSize = GetUleb128Size (typeUid);
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t fragStartSize = GetUleb128Size (extraItem->fragmentStart);
-  uint32_t fragEndSize = GetUleb128Size (extraItem->fragmentEnd);
-  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
+  uint32_t fragEnd = ZigZagEncode (item->size - extraItem->fragmentEnd);
+  uint32_t fragEndSize = GetUleb128Size (fragEnd);
+  // The uids of a simulation differ in their lower 32 bits only.
+  uint32_t uidDelta = ZigZagEncode (static_cast<uint32_t> (extraItem->packetUid - m_packetUid));
+  uint32_t uidDeltaSize = GetUleb128Size (uidDelta);
+  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + uidDeltaSize;
 
   if (m_used + n > m_data->m_size ||
       (m_head != 0xffff &&
@@ -439,9 +444,9 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   buffer += 2;
   AppendValue (extraItem->fragmentStart, buffer);
   buffer += fragStartSize;
-  AppendValue (extraItem->fragmentEnd, buffer);
+  AppendValue (fragEnd, buffer);
   buffer += fragEndSize;
-  Append32 (extraItem->packetUid, buffer);
+  AppendValue (uidDelta, buffer);
 
   return n;
 }
@@ -472,8 +477,12 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
   uint32_t typeUidSize = GetUleb128Size (typeUid);
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t fragStartSize = GetUleb128Size (extraItem->fragmentStart);
-  uint32_t fragEndSize = GetUleb128Size (extraItem->fragmentEnd);
-  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
+  uint32_t fragEnd = ZigZagEncode (item->size - extraItem->fragmentEnd);
+  uint32_t fragEndSize = GetUleb128Size (fragEnd);
+  // The uids of a simulation differ in their lower 32 bits only.
+  uint32_t uidDelta = ZigZagEncode (static_cast<uint32_t> (extraItem->packetUid - m_packetUid));
+  uint32_t uidDeltaSize = GetUleb128Size (uidDelta);
+  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + uidDeltaSize;
 
   if (available >= n &&
       m_data->m_count == 1)
@@ -491,9 +500,10 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
       buffer += 2;
       AppendValue (extraItem->fragmentStart, buffer);
       buffer += fragStartSize;
-      AppendValue (extraItem->fragmentEnd, buffer);
+      AppendValue (fragEnd, buffer);
       buffer += fragEndSize;
-      Append32 (extraItem->packetUid, buffer);
+      AppendValue (uidDelta, buffer);
+      buffer += uidDeltaSize;
       m_used = std::max (m_used, (uint16_t)(buffer - &m_data->m_data[0]));
       m_data->m_dirtyEnd = m_used;
       return;
@@ -549,12 +559,8 @@ PacketMetadata::ReadItems (uint16_t current,
   if (isExtra)
     {
       extraItem->fragmentStart = ReadUleb128 (&buffer);
-      extraItem->fragmentEnd = ReadUleb128 (&buffer);
-      extraItem->packetUid = buffer[0];
-      extraItem->packetUid |= buffer[1] << 8;
-      extraItem->packetUid |= buffer[2] << 16;
-      extraItem->packetUid |= buffer[3] << 24;
-      buffer += 4;
+      extraItem->fragmentEnd = item->size - ZigZagDecode (ReadUleb128 (&buffer));
+      extraItem->packetUid = m_packetUid + ZigZagDecode (ReadUleb128 (&buffer));
     }
   else
     {
@@ -570,63 +576,39 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
-  if (size > m_maxSize)
-    {
-      m_maxSize = size;
-    }
-  while (!m_freeList.empty ()) 
-    {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
-      PacketMetadata::Deallocate (data);
-    }
-  NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
-  return PacketMetadata::Allocate (m_maxSize);
+  NS_LOG_LOGIC ("create size="<<size<<", hint="<<m_sizeHint);
+  return PacketMetadata::Allocate (std::max (size, m_sizeHint));
 }
 
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
-    {
-      PacketMetadata::Deallocate (data);
-      return;
-    } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
+  if (m_enable)
     {
-      PacketMetadata::Deallocate (data);
-    } 
-  else 
-    {
-      m_freeList.push_back (data);
+      // Follow the size of the metadata of the last packets, which is
+      // the size the next ones are likely to need.  Aggregates grow
+      // their own, and do not weigh more than 256 bytes.
+      uint32_t used = std::min<uint32_t> (data->m_dirtyEnd, 256);
+      m_sizeHint = (7 * m_sizeHint + used + 7) / 8;
     }
+  PacketMetadata::Deallocate (data);
 }
 
 struct PacketMetadata::Data *
 PacketMetadata::Allocate (uint32_t n)
 {
   NS_LOG_FUNCTION (n);
-  uint32_t size = sizeof (struct Data);
+  uint32_t header = sizeof (struct Data) - PACKET_METADATA_DATA_M_DATA_SIZE;
   if (n <= PACKET_METADATA_DATA_M_DATA_SIZE)
     {
       n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
-  size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-  uint8_t *buf = new uint8_t [size];
-  struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
-  data->m_size = n;
+  // The rounding of the block to its size class is free room.
+  std::size_t size = PacketMemoryPool::GetBlockSize (header + n);
+  struct PacketMetadata::Data *data = static_cast<struct PacketMetadata::Data *> (PacketMemoryPool::Allocate (size));
+  data->m_size = size - header;
   data->m_count = 1;
   data->m_dirtyEnd = 0;
   return data;
@@ -635,8 +617,8 @@ void
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  uint32_t header = sizeof (struct Data) - PACKET_METADATA_DATA_M_DATA_SIZE;
+  PacketMemoryPool::Deallocate (data, header + data->m_size);
 }
 
 
@@ -655,6 +637,11 @@ PacketMetadata::AddHeader (const Header &header, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
+  if (!m_enable)
+    {
+      m_metadataSkipped = true;
+      return;
+    }
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   DoAddHeader (uid, size);
   NS_ASSERT (IsStateOk ());
@@ -674,15 +661,13 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = m_chunkUid++;
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
 void 
 PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 {
-  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
@@ -690,6 +675,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_head, &item, &extraItem);
@@ -730,7 +716,6 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
 void 
 PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable)
@@ -738,13 +723,13 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   item.next = 0xffff;
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = m_chunkUid++;
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -752,7 +737,6 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
 void 
 PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
 {
-  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
@@ -760,6 +744,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_tail, &item, &extraItem);
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include <atomic>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -70,10 +71,16 @@ class Trailer;
  *
  * Each item of the linked list is a variable-sized byte buffer
  * made of a number of fields. Some of these fields are stored
- * as fixed-size 32 bit integers, others as fixed-size 16 bit 
- * integers, and some others as variable-size 32-bit integers.
- * The variable-size 32 bit integers are stored using the uleb128
- * encoding.
+ * as fixed-size 16 bit integers, and the others as variable-size
+ * 32-bit integers.  The variable-size 32 bit integers are stored
+ * using the uleb128 encoding.  The packet uid of an extra item is
+ * stored as its zigzag-encoded difference from the uid of the
+ * packet, which takes one byte for the items of the packet itself
+ * and of the packets created just before or after it.
+ *
+ * The data buffers are allocated from the PacketMemoryPool, and are
+ * sized for the metadata of a typical packet of the simulation, so
+ * that most packets never reallocate theirs.
  */
 class PacketMetadata 
 {
@@ -483,27 +490,20 @@ private:
     uint32_t fragmentStart;
     /** offset (in bytes) from start of original header to
        the end of the fragment still present.
-       stored as a variable-size 32 bit integer.
+       stored as a variable-size 32 bit integer, the zigzag-encoded
+       difference from the size of the item, which is 0 unless the
+       end of the header or trailer was removed.
      */
     uint32_t fragmentEnd;
     /** the packetUid of the packet in which this header or trailer
        was first added. It could be different from the m_packetUid
        field if the user has aggregated multiple packets into one.
-       stored as a fixed-size 64 bit integer.
+       stored as a variable-size 32 bit integer, the zigzag-encoded
+       difference from m_packetUid.
      */
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   /// Friend class
   friend class ItemIterator;
 
@@ -566,11 +566,18 @@ public:
    */
   inline void Append16 (uint16_t value, uint8_t *buffer);
   /**
-   * \brief Append a 32-bit value to the buffer
-   * \param value the value to add
-   * \param buffer the buffer to write to
+   * \brief Encode a signed difference so that small magnitudes of
+   * either sign are small unsigned values, for AppendValue
+   * \param difference the difference, modulo 2^32
+   * \returns the zigzag-encoded difference
+   */
+  static inline uint32_t ZigZagEncode (uint32_t difference);
+  /**
+   * \brief Decode a value written by ZigZagEncode
+   * \param value the zigzag-encoded difference
+   * \returns the difference
    */
-  inline void Append32 (uint32_t value, uint8_t *buffer);
+  static inline int32_t ZigZagDecode (uint32_t value);
   /**
    * \brief Append a value to the buffer
    * \param value the value to add
@@ -661,7 +668,6 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -672,8 +678,12 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+#ifdef NS3_MTP
+  static thread_local uint32_t m_sizeHint; //!< typical metadata size, per thread
+#else
+  static uint32_t m_sizeHint; //!< typical metadata size
+#endif
+  static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
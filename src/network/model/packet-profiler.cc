@@ -0,0 +1,558 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-profiler.h"
+#include "packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef HAVE_EXECINFO_H
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PacketProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketProfiler");
+
+namespace {
+
+/** The context of the records created outside of any scope, without a call stack. */
+const char *const UNKNOWN_CONTEXT = "[unknown]";
+/** The number of oldest live packets reported for each context. */
+const uint32_t REPORTED_PACKETS = 5;
+
+/** A live packet. */
+struct PacketRecord
+{
+  uint32_t context; //!< The index of the creation context.
+  uint32_t node;    //!< The simulation context at creation.
+  uint64_t uid;     //!< The packet uid.
+  Time time;        //!< The creation time.
+};
+
+/** A live buffer data area. */
+struct BufferRecord
+{
+  uint32_t context; //!< The index of the creation context.
+  uint32_t size;    //!< The size of the data area, in bytes.
+};
+
+/** The state of the profiler, shared by all the threads. */
+struct ProfilerState
+{
+  std::mutex mutex;                                              //!< Protects the members below.
+  std::vector<std::string> names;                                //!< The names of the contexts.
+  std::unordered_map<std::string, uint32_t> indexes;             //!< The index of each context name.
+  std::vector<PacketProfiler::Counts> counts;                    //!< The counts of each context.
+  PacketProfiler::Counts total;                                  //!< The counts of all the contexts.
+  std::unordered_map<const Packet *, PacketRecord> packets;      //!< The live packets.
+  std::unordered_map<const void *, BufferRecord> buffers;        //!< The live buffer data areas.
+  std::unordered_map<void *, uint32_t> frames;                   //!< The context of each return address.
+  std::ofstream snapshots;                                       //!< The snapshot file.
+  Time interval;                                                 //!< The interval between two snapshots.
+  bool destroyScheduled;                                         //!< Whether the first DestroyNotify is pending.
+};
+
+/**
+ * Get the state of the profiler.  It is never deleted, so that the
+ * packets destroyed by the static destructors can still be recorded.
+ * \returns The state.
+ */
+ProfilerState &
+GetState (void)
+{
+  static ProfilerState *state = new ProfilerState ();
+  return *state;
+}
+
+/**
+ * The labels of the open scopes of the calling thread, innermost last.
+ * \returns The labels.
+ */
+std::vector<std::string> &
+GetScopes (void)
+{
+  static thread_local std::vector<std::string> scopes;
+  return scopes;
+}
+
+/** An index in ProfilerState::frames for the frames of the packet code. */
+const uint32_t SKIPPED_FRAME = 0xffffffff;
+
+/**
+ * Get the index of a context, adding it if needed.  The state is locked.
+ * \param [in] state The profiler state.
+ * \param [in] name The name of the context.
+ * \returns The index of the context.
+ */
+uint32_t
+GetContextIndex (ProfilerState &state, const std::string &name)
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator i = state.indexes.find (name);
+  if (i != state.indexes.end ())
+    {
+      return i->second;
+    }
+  uint32_t index = state.names.size ();
+  state.names.push_back (name);
+  state.indexes[name] = index;
+  PacketProfiler::Counts zero = {0, 0, 0, 0, 0};
+  state.counts.push_back (zero);
+  return index;
+}
+
+#ifdef HAVE_EXECINFO_H
+/**
+ * Get the name of a module from the path of its library or program:
+ * \c "/build/lib/libns3-dev-internet-debug.so" becomes \c "internet".
+ * \param [in] path The path.
+ * \returns The name of the module.
+ */
+std::string
+GetModuleName (std::string path)
+{
+  std::string::size_type slash = path.rfind ('/');
+  std::string name = slash == std::string::npos ? path : path.substr (slash + 1);
+  if (name.compare (0, 3, "lib") == 0)
+    {
+      name = name.substr (3);
+    }
+  name = name.substr (0, name.find (".so"));
+  if (name.compare (0, 3, "ns3") == 0 && name.find ('-') != std::string::npos)
+    {
+      name = name.substr (name.find ('-') + 1);
+      if (name.compare (0, 4, "dev-") == 0)
+        {
+          name = name.substr (4);
+        }
+    }
+  const char *profiles[] = {"-debug", "-release", "-optimized", "-default"};
+  for (uint32_t i = 0; i < sizeof (profiles) / sizeof (profiles[0]); i++)
+    {
+      std::string suffix = profiles[i];
+      if (name.size () > suffix.size ()
+          && name.compare (name.size () - suffix.size (), suffix.size (), suffix) == 0)
+        {
+          name = name.substr (0, name.size () - suffix.size ());
+          break;
+        }
+    }
+  return name;
+}
+
+/**
+ * Remove the return type and the parameters from a demangled function
+ * name: \c "ns3::Ptr<ns3::Packet> ns3::Create<ns3::Packet, int>(int&&)"
+ * becomes \c "ns3::Create<ns3::Packet, int>".
+ * \param [in] function The function name.
+ * \returns The qualified name of the function.
+ */
+std::string
+StripSignature (std::string function)
+{
+  std::string::size_type end = function.rfind (')');
+  if (end != std::string::npos)
+    {
+      int depth = 0;
+      for (std::string::size_type i = end + 1; i-- > 0; )
+        {
+          if (function[i] == ')')
+            {
+              depth++;
+            }
+          else if (function[i] == '(' && --depth == 0)
+            {
+              function = function.substr (0, i);
+              break;
+            }
+        }
+    }
+  // The return type of a template function ends at the last space
+  // outside of the brackets.
+  int depth = 0;
+  for (std::string::size_type i = function.size (); i-- > 0; )
+    {
+      if (function[i] == '>' || function[i] == ')')
+        {
+          depth++;
+        }
+      else if (function[i] == '<' || function[i] == '(')
+        {
+          depth--;
+        }
+      else if (function[i] == ' ' && depth == 0)
+        {
+          return function.substr (i + 1);
+        }
+    }
+  return function;
+}
+
+/**
+ * Resolve a return address into a context, unless it belongs to the
+ * packet, buffer or profiler code.  The state is locked.
+ * \param [in] state The profiler state.
+ * \param [in] address The return address.
+ * \returns The index of the context, or SKIPPED_FRAME.
+ */
+uint32_t
+ResolveFrame (ProfilerState &state, void *address)
+{
+  std::unordered_map<void *, uint32_t>::const_iterator cached = state.frames.find (address);
+  if (cached != state.frames.end ())
+    {
+      return cached->second;
+    }
+  // The symbol has the form "path(mangled+offset) [address]".
+  std::string symbol;
+  char **symbols = backtrace_symbols (&address, 1);
+  if (symbols != 0)
+    {
+      symbol = symbols[0];
+      free (symbols);
+    }
+  std::string::size_type open = symbol.find ('(');
+  std::string::size_type plus = symbol.find_first_of ("+)", open);
+  std::string module = GetModuleName (symbol.substr (0, open));
+  std::string function = "?";
+  if (open != std::string::npos && plus != std::string::npos && plus > open + 1)
+    {
+      std::string mangled = symbol.substr (open + 1, plus - open - 1);
+      int status;
+      char *demangled = abi::__cxa_demangle (mangled.c_str (), 0, 0, &status);
+      function = StripSignature (status == 0 ? demangled : mangled);
+      free (demangled);
+    }
+  const char *skipped[] = {"ns3::Packet::", "ns3::PacketProfiler", "ns3::Buffer::",
+                           "ns3::Create<ns3::Packet>", "ns3::Create<ns3::Packet,", "ns3::Ptr<ns3::Packet>::",
+                           "std::"};
+  for (uint32_t i = 0; i < sizeof (skipped) / sizeof (skipped[0]); i++)
+    {
+      if (function.compare (0, std::string (skipped[i]).size (), skipped[i]) == 0)
+        {
+          state.frames[address] = SKIPPED_FRAME;
+          return SKIPPED_FRAME;
+        }
+    }
+  uint32_t index = GetContextIndex (state, module + ";" + function);
+  state.frames[address] = index;
+  return index;
+}
+#endif /* HAVE_EXECINFO_H */
+
+/**
+ * Get the creation context of a packet or buffer created by the calling
+ * thread.  The state is locked.
+ * \param [in] state The profiler state.
+ * \returns The index of the context.
+ */
+uint32_t
+GetCreationContext (ProfilerState &state)
+{
+  std::vector<std::string> &scopes = GetScopes ();
+  if (!scopes.empty ())
+    {
+      return GetContextIndex (state, scopes.back ());
+    }
+#ifdef HAVE_EXECINFO_H
+  void *frames[32];
+  int n = backtrace (frames, 32);
+  for (int i = 1; i < n; i++)
+    {
+      uint32_t index = ResolveFrame (state, frames[i]);
+      if (index != SKIPPED_FRAME)
+        {
+          return index;
+        }
+    }
+#endif /* HAVE_EXECINFO_H */
+  return GetContextIndex (state, UNKNOWN_CONTEXT);
+}
+
+/**
+ * Write the counts of a context on a line of the snapshot file.
+ * \param [in] os The snapshot file.
+ * \param [in] time The time of the snapshot, in seconds.
+ * \param [in] name The name of the context.
+ * \param [in] counts The counts of the context.
+ */
+void
+WriteCounts (std::ostream &os, double time, const std::string &name,
+             const PacketProfiler::Counts &counts)
+{
+  os << time << "\t" << name << "\t" << counts.packets << "\t" << counts.peakPackets
+     << "\t" << counts.created << "\t" << counts.bytes << "\t" << counts.peakBytes << "\n";
+}
+
+} // unnamed namespace
+
+bool PacketProfiler::g_enabled = false;
+
+PacketProfiler::Scope::Scope (std::string label)
+{
+  GetScopes ().push_back (label);
+}
+
+PacketProfiler::Scope::~Scope ()
+{
+  GetScopes ().pop_back ();
+}
+
+void
+PacketProfiler::Enable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ProfilerState &state = GetState ();
+  {
+    std::lock_guard<std::mutex> lock (state.mutex);
+    state.names.clear ();
+    state.indexes.clear ();
+    state.counts.clear ();
+    PacketProfiler::Counts zero = {0, 0, 0, 0, 0};
+    state.total = zero;
+    state.packets.clear ();
+    state.buffers.clear ();
+    state.frames.clear ();
+  }
+  if (!state.destroyScheduled)
+    {
+      state.destroyScheduled = true;
+      Simulator::ScheduleDestroy (&PacketProfiler::DestroyNotify);
+    }
+  g_enabled = true;
+}
+
+void
+PacketProfiler::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_enabled = false;
+}
+
+void
+PacketProfiler::EnableSnapshots (std::string filename, Time interval)
+{
+  NS_LOG_FUNCTION (filename << interval);
+  NS_ASSERT_MSG (interval.IsStrictlyPositive (), "The interval must be positive");
+  ProfilerState &state = GetState ();
+  state.snapshots.close ();
+  state.snapshots.clear ();
+  state.snapshots.open (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (state.snapshots.is_open (), "Unable to open " << filename);
+  state.snapshots << "# time\tcontext\tpackets\tpeak-packets\tcreated\tbytes\tpeak-bytes\n";
+  state.interval = interval;
+  Simulator::Schedule (interval, &PacketProfiler::Snapshot);
+}
+
+PacketProfiler::Counts
+PacketProfiler::GetCounts (void)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  return state.total;
+}
+
+PacketProfiler::Counts
+PacketProfiler::GetCounts (std::string context)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  std::unordered_map<std::string, uint32_t>::const_iterator i = state.indexes.find (context);
+  if (i == state.indexes.end ())
+    {
+      PacketProfiler::Counts zero = {0, 0, 0, 0, 0};
+      return zero;
+    }
+  return state.counts[i->second];
+}
+
+std::vector<std::string>
+PacketProfiler::GetContexts (void)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  return state.names;
+}
+
+void
+PacketProfiler::Report (std::ostream &os)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  os << "PacketProfiler: " << state.total.packets << " live packets, "
+     << state.total.bytes << " bytes of live buffers" << std::endl;
+
+  std::vector<std::vector<PacketRecord> > live (state.names.size ());
+  for (std::unordered_map<const Packet *, PacketRecord>::const_iterator i = state.packets.begin ();
+       i != state.packets.end (); ++i)
+    {
+      live[i->second.context].push_back (i->second);
+    }
+  for (uint32_t context = 0; context < live.size (); context++)
+    {
+      std::vector<PacketRecord> &records = live[context];
+      if (records.empty ())
+        {
+          continue;
+        }
+      const Counts &counts = state.counts[context];
+      os << "  " << state.names[context] << ": " << counts.packets << " packets (peak "
+         << counts.peakPackets << "), " << counts.bytes << " bytes of buffers" << std::endl;
+      std::sort (records.begin (), records.end (),
+                 [] (const PacketRecord &a, const PacketRecord &b)
+                 { return a.time < b.time || (a.time == b.time && a.uid < b.uid); });
+      for (uint32_t i = 0; i < std::min<std::size_t> (records.size (), REPORTED_PACKETS); i++)
+        {
+          os << "    uid " << records[i].uid << " created at " << records[i].time.As (Time::S);
+          if (records[i].node != Simulator::NO_CONTEXT)
+            {
+              os << " on node " << records[i].node;
+            }
+          os << std::endl;
+        }
+    }
+}
+
+void
+PacketProfiler::Snapshot (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ProfilerState &state = GetState ();
+  if (!state.snapshots.is_open ())
+    {
+      return;
+    }
+  {
+    std::lock_guard<std::mutex> lock (state.mutex);
+    double now = Simulator::Now ().GetSeconds ();
+    for (uint32_t i = 0; i < state.names.size (); i++)
+      {
+        WriteCounts (state.snapshots, now, state.names[i], state.counts[i]);
+      }
+    WriteCounts (state.snapshots, now, "total", state.total);
+    state.snapshots.flush ();
+  }
+  // Do not keep the simulation running on our own.
+  if (!Simulator::IsFinished ())
+    {
+      Simulator::Schedule (state.interval, &PacketProfiler::Snapshot);
+    }
+}
+
+void
+PacketProfiler::DestroyNotify (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ProfilerState &state = GetState ();
+  if (state.destroyScheduled)
+    {
+      // Run again after the destroy events scheduled since Enable, such as
+      // the one of the NodeList, which release the packets of the nodes.
+      state.destroyScheduled = false;
+      Simulator::ScheduleDestroy (&PacketProfiler::DestroyNotify);
+      return;
+    }
+  if (g_enabled && GetCounts ().packets > 0)
+    {
+      std::clog << "Packets never freed at Simulator::Destroy:" << std::endl;
+      Report (std::clog);
+    }
+  g_enabled = false;
+  state.snapshots.close ();
+}
+
+void
+PacketProfiler::NotifyPacketCreated (const Packet *packet)
+{
+  PacketRecord record;
+  record.node = Simulator::GetContext ();
+  record.uid = packet->GetUid ();
+  record.time = Simulator::Now ();
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  record.context = GetCreationContext (state);
+  state.packets[packet] = record;
+  Counts &counts = state.counts[record.context];
+  counts.created++;
+  counts.packets++;
+  counts.peakPackets = std::max (counts.peakPackets, counts.packets);
+  state.total.created++;
+  state.total.packets++;
+  state.total.peakPackets = std::max (state.total.peakPackets, state.total.packets);
+}
+
+void
+PacketProfiler::NotifyPacketDestroyed (const Packet *packet)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  std::unordered_map<const Packet *, PacketRecord>::iterator i = state.packets.find (packet);
+  if (i == state.packets.end ())
+    {
+      // Created before the profiler was enabled.
+      return;
+    }
+  state.counts[i->second.context].packets--;
+  state.total.packets--;
+  state.packets.erase (i);
+}
+
+void
+PacketProfiler::NotifyBufferCreated (const void *data, uint32_t size)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  BufferRecord record;
+  record.context = GetCreationContext (state);
+  record.size = size;
+  state.buffers[data] = record;
+  Counts &counts = state.counts[record.context];
+  counts.bytes += size;
+  counts.peakBytes = std::max (counts.peakBytes, counts.bytes);
+  state.total.bytes += size;
+  state.total.peakBytes = std::max (state.total.peakBytes, state.total.bytes);
+}
+
+void
+PacketProfiler::NotifyBufferDestroyed (const void *data)
+{
+  ProfilerState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.mutex);
+  std::unordered_map<const void *, BufferRecord>::iterator i = state.buffers.find (data);
+  if (i == state.buffers.end ())
+    {
+      return;
+    }
+  state.counts[i->second.context].bytes -= i->second.size;
+  state.total.bytes -= i->second.size;
+  state.buffers.erase (i);
+}
+
+} // namespace ns3
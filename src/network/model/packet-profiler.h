@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_PROFILER_H
+#define PACKET_PROFILER_H
+
+#include "ns3/nstime.h"
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PacketProfiler declaration.
+ */
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup packet
+ * \brief Accounting of the live packets and packet buffers, by the
+ * context which created them.
+ *
+ * When it is enabled, the profiler records each Packet when it is
+ * constructed and forgets it when it is destroyed, and likewise each
+ * data area of a Buffer, with its size in bytes.  Each record is charged
+ * to a creation context:
+ *
+ *   - the label of the innermost PacketProfiler::Scope of the creating
+ *     thread, if any;
+ *   - otherwise, where the call stack is available, the module and the
+ *     function of the first caller outside of the Packet, Buffer and
+ *     profiler code, such as \c "internet;ns3::Ipv4L3Protocol::Send";
+ *   - otherwise \c "[unknown]".
+ *
+ * The live, peak and total counts of each context are returned by
+ * GetCounts(), and EnableSnapshots() writes them to a file at regular
+ * intervals of simulation time.  The first Simulator::Destroy after
+ * Enable() writes the packets which are still alive, that is, those
+ * never freed by the simulation, to \c std::clog, then stops the
+ * profiler; the counts remain available until the next Enable().
+ *
+ * \code
+ *   PacketProfiler::Enable ();
+ *   PacketProfiler::EnableSnapshots ("packets.txt", Seconds (1));
+ *   ...
+ *   Simulator::Run ();
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * The profiler is disabled by default, and then costs a test of a flag
+ * in the constructor and the destructor of the packets and buffers.
+ * When it is enabled, the creation of a packet or buffer outside of
+ * any Scope walks the call stack, which slows the simulation down
+ * several times; the scopes make it cheaper.
+ */
+class PacketProfiler
+{
+public:
+  /** The counts of a creation context, or of all of them. */
+  struct Counts
+  {
+    uint64_t packets;      /**< Number of live packets. */
+    uint64_t peakPackets;  /**< Largest number of live packets. */
+    uint64_t created;      /**< Number of packets created. */
+    uint64_t bytes;        /**< Number of bytes of the live buffers. */
+    uint64_t peakBytes;    /**< Largest number of bytes of the live buffers. */
+  };
+
+  /**
+   * \brief Charge the packets and buffers created by the calling thread
+   * to a label, as long as the scope exists.
+   *
+   * The scopes of a thread nest: the innermost one applies.
+   */
+  class Scope
+  {
+public:
+    /**
+     * Open a scope.
+     * \param [in] label The creation context of the packets and buffers.
+     */
+    Scope (std::string label);
+    /** Close the scope. */
+    ~Scope ();
+
+private:
+    /** Not copyable. */
+    Scope (const Scope &);
+    /**
+     * Not assignable.
+     * \returns This scope.
+     */
+    Scope &operator = (const Scope &);
+  };
+
+  /**
+   * Clear the counts and start profiling the packets created from now
+   * on, until the next Simulator::Destroy.
+   */
+  static void Enable (void);
+  /**
+   * Stop profiling.  The counts are kept.
+   */
+  static void Disable (void);
+  /**
+   * \returns true if the profiler is enabled.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Write the counts of each context to a file, at regular intervals
+   * of simulation time, while there are other events to run.
+   *
+   * Each line of the file holds, separated by tabulations, the time in
+   * seconds, the context, or \c "total", and the fields of its Counts.
+   *
+   * \param [in] filename The name of the file.
+   * \param [in] interval The interval between two snapshots.
+   */
+  static void EnableSnapshots (std::string filename, Time interval);
+  /**
+   * \returns The counts of all the contexts.
+   */
+  static Counts GetCounts (void);
+  /**
+   * \param [in] context A creation context.
+   * \returns The counts of the context, zero if it is unknown.
+   */
+  static Counts GetCounts (std::string context);
+  /**
+   * \returns The creation contexts met so far.
+   */
+  static std::vector<std::string> GetContexts (void);
+  /**
+   * Write the live packets, grouped by creation context, with the uid,
+   * creation time and node of the oldest packets of each context.
+   *
+   * \param [in] os The output stream.
+   */
+  static void Report (std::ostream &os);
+
+  /**
+   * Record the creation of a packet.
+   * \param [in] packet The packet.
+   */
+  static void NotifyPacketCreated (const Packet *packet);
+  /**
+   * Record the destruction of a packet.
+   * \param [in] packet The packet.
+   */
+  static void NotifyPacketDestroyed (const Packet *packet);
+  /**
+   * Record the allocation of the data area of a buffer.
+   * \param [in] data The data area.
+   * \param [in] size Its size, in bytes.
+   */
+  static void NotifyBufferCreated (const void *data, uint32_t size);
+  /**
+   * Record the release of the data area of a buffer.
+   * \param [in] data The data area.
+   */
+  static void NotifyBufferDestroyed (const void *data);
+
+private:
+  /** Write a snapshot, and schedule the next one. */
+  static void Snapshot (void);
+  /** Report the packets never freed, at the end of Simulator::Destroy. */
+  static void DestroyNotify (void);
+
+  static bool g_enabled; //!< True if the profiler is enabled.
+};
+
+inline bool
+PacketProfiler::IsEnabled (void)
+{
+  return g_enabled;
+}
+
+} // namespace ns3
+
+#endif /* PACKET_PROFILER_H */
@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "packet-memory-pool.h"
 
 namespace ns3 {
 
@@ -252,6 +253,13 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destroy a TagData struct made by CreateTagData, and release its
+   * memory.
+   *
+   * \param [in] tag The TagData object.
+   */
+  static inline void FreeTagData (TagData *tag);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -352,6 +360,14 @@ PacketTagList::~PacketTagList ()
   RemoveAll ();
 }
 
+void
+PacketTagList::FreeTagData (TagData *tag)
+{
+  std::size_t size = sizeof (TagData) + tag->size - 1;
+  tag->~TagData ();
+  PacketMemoryPool::Deallocate (tag, size);
+}
+
 void
 PacketTagList::RemoveAll (void)
 {
@@ -365,15 +381,13 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagData (prev);
     }
   m_next = 0;
 }
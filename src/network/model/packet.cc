@@ -18,17 +18,19 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "packet.h"
+#include "packet-profiler.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include <string>
 #include <cstdarg>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid (0);
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -126,6 +128,17 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t size = GetSerializedSize ();
+  std::vector<uint32_t> buffer ((size + 3) / 4);
+  uint8_t *data = reinterpret_cast<uint8_t *> (&buffer[0]);
+  Serialize (data, size);
+  return Ptr<Packet> (new Packet (data, size, true), false);
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -136,10 +149,13 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, 0),
     m_nixVector (0)
 {
-  m_globalUid++;
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
 }
 
 Packet::Packet (const Packet &o)
@@ -150,6 +166,18 @@ Packet::Packet (const Packet &o)
 {
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
+}
+
+Packet::~Packet ()
+{
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketDestroyed (this);
+    }
 }
 
 Packet &
@@ -178,10 +206,13 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
     m_nixVector (0)
 {
-  m_globalUid++;
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -192,6 +223,10 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
 {
   NS_ASSERT (magic);
   Deserialize (buffer, size);
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
 }
 
 Packet::Packet (uint8_t const*buffer, uint32_t size)
@@ -204,13 +239,16 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
 }
 
 Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList, 
@@ -221,6 +259,10 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_metadata (metadata),
     m_nixVector (0)
 {
+  if (PacketProfiler::IsEnabled ())
+    {
+      PacketProfiler::NotifyPacketCreated (this);
+    }
 }
 
 Ptr<Packet>
@@ -252,16 +294,28 @@ Packet::GetNixVector (void) const
   return m_nixVector;
 } 
 
-void
-Packet::AddHeader (const Header &header)
+Buffer::Iterator
+Packet::ReserveHeader (const Header &header, uint32_t size)
 {
-  uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
   m_buffer.AddAtStart (size);
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
-  header.Serialize (m_buffer.Begin ());
   m_metadata.AddHeader (header, size);
+  return m_buffer.Begin ();
+}
+void
+Packet::ConsumeHeader (const Header &header, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  m_buffer.RemoveAtStart (size);
+  m_byteTagList.Adjust (-size);
+  m_metadata.RemoveHeader (header, size);
+}
+void
+Packet::AddHeader (const Header &header)
+{
+  header.Serialize (ReserveHeader (header, header.GetSerializedSize ()));
 }
 uint32_t
 Packet::RemoveHeader (Header &header, uint32_t size)
@@ -270,20 +324,14 @@ Packet::RemoveHeader (Header &header, uint32_t size)
   end = m_buffer.Begin ();
   end.Next (size);
   uint32_t deserialized = header.Deserialize (m_buffer.Begin (), end);
-  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
-  m_buffer.RemoveAtStart (deserialized);
-  m_byteTagList.Adjust (-deserialized);
-  m_metadata.RemoveHeader (header, deserialized);
+  ConsumeHeader (header, deserialized);
   return deserialized;
 }
 uint32_t
 Packet::RemoveHeader (Header &header)
 {
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
-  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
-  m_buffer.RemoveAtStart (deserialized);
-  m_byteTagList.Adjust (-deserialized);
-  m_metadata.RemoveHeader (header, deserialized);
+  ConsumeHeader (header, deserialized);
   return deserialized;
 }
 uint32_t
@@ -582,6 +630,13 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableScatterGather (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Buffer::EnableScatterGather ();
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
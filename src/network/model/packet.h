@@ -21,6 +21,7 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <atomic>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -242,6 +243,10 @@ public:
    * \param o object to copy
    */
   Packet (const Packet &o);
+  /**
+   * \brief Destructor
+   */
+  ~Packet ();
   /**
    * \brief Basic assignment
    * \param o object to copy
@@ -356,6 +361,48 @@ public:
    * \returns the number of bytes read from the packet.
    */
   uint32_t PeekHeader (Header &header, uint32_t size) const;
+  /**
+   * \brief Add a header of fixed size to this packet.
+   *
+   * This overload is selected for the header classes which specialize
+   * StaticSerializedSize: it reserves StaticSerializedSize<T>::value
+   * bytes and calls T::Serialize, without going through the virtual
+   * methods of Header.
+   *
+   * \tparam T \deduced The header class.
+   * \param header a reference to the header to add to this packet.
+   */
+  template <typename T>
+  typename std::enable_if<(StaticSerializedSize<T>::value > 0)>::type
+  AddHeader (const T &header);
+  /**
+   * \brief Deserialize and remove a header of fixed size from the
+   * internal buffer.
+   *
+   * This overload is selected for the header classes which specialize
+   * StaticSerializedSize, and calls T::Deserialize (begin) directly.
+   *
+   * \tparam T \deduced The header class.
+   * \param header a reference to the header to remove from the internal buffer.
+   * \returns the number of bytes removed from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<(StaticSerializedSize<T>::value > 0), uint32_t>::type
+  RemoveHeader (T &header);
+  /**
+   * \brief Deserialize but does _not_ remove a header of fixed size
+   * from the internal buffer.
+   *
+   * This overload is selected for the header classes which specialize
+   * StaticSerializedSize, and calls T::Deserialize (begin) directly.
+   *
+   * \tparam T \deduced The header class.
+   * \param header a reference to the header to read from the internal buffer.
+   * \returns the number of bytes read from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<(StaticSerializedSize<T>::value > 0), uint32_t>::type
+  PeekHeader (T &header) const;
   /**
    * \brief Add trailer to this packet.
    *
@@ -453,6 +500,20 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \brief performs a deep copy of the packet.
+   *
+   * \returns a copy of the packet which shares no data with the
+   * original.
+   *
+   * The packet is serialized and deserialized, like packets sent
+   * to another MPI process, so the copy keeps the uid, the tags,
+   * the metadata and the nix-vector of the original.  This is much
+   * slower than Copy(): it is meant for packets handed over to
+   * another thread, see MultithreadedSimulatorImpl::IsRemote.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * \brief Returns the packet's Uid.
    *
@@ -530,6 +591,17 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable the scatter-gather mode of the packet buffers.
+   *
+   * In this mode, AddAtEnd keeps a reference to the bytes of the
+   * appended packet instead of copying them, and CreateFragment and
+   * RemoveAtStart share the fragments of such packets, so that
+   * aggregation, deaggregation and reassembly do not copy the payload.
+   * Headers and trailers are still written and read in place.  See
+   * Buffer::EnableScatterGather.
+   */
+  static void EnableScatterGather (void);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -779,6 +851,25 @@ private:
    */
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \brief Make room for a header at the start of the packet, and
+   * record it in the metadata.
+   *
+   * \param [in] header the header which is added.
+   * \param [in] size the serialized size of the header.
+   * \returns an iterator at the start of the room, to serialize the
+   *          header into.
+   */
+  Buffer::Iterator ReserveHeader (const Header &header, uint32_t size);
+  /**
+   * \brief Remove a deserialized header from the start of the packet,
+   * and from the metadata.
+   *
+   * \param [in] header the header which was deserialized.
+   * \param [in] size the number of deserialized bytes.
+   */
+  void ConsumeHeader (const Header &header, uint32_t size);
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
@@ -787,7 +878,7 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
 };
 
 /**
@@ -854,6 +945,29 @@ Packet::GetSize (void) const
   return m_buffer.GetSize ();
 }
 
+template <typename T>
+typename std::enable_if<(StaticSerializedSize<T>::value > 0)>::type
+Packet::AddHeader (const T &header)
+{
+  header.T::Serialize (ReserveHeader (header, StaticSerializedSize<T>::value));
+}
+
+template <typename T>
+typename std::enable_if<(StaticSerializedSize<T>::value > 0), uint32_t>::type
+Packet::RemoveHeader (T &header)
+{
+  uint32_t deserialized = header.T::Deserialize (m_buffer.Begin ());
+  ConsumeHeader (header, deserialized);
+  return deserialized;
+}
+
+template <typename T>
+typename std::enable_if<(StaticSerializedSize<T>::value > 0), uint32_t>::type
+Packet::PeekHeader (T &header) const
+{
+  return header.T::Deserialize (m_buffer.Begin ());
+}
+
 } // namespace ns3
 
 #endif /* PACKET_H */
@@ -23,6 +23,9 @@
 #include "ns3/double.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -387,6 +390,337 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Append a buffer which starts with zeros and ends with data: its
+  // data is written after the zero area of the result.
+  buffer = Buffer ();
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  other = Buffer (3);
+  other.AddAtEnd (2);
+  i = other.End ();
+  i.Prev (2);
+  i.WriteU8 (0x3);
+  i.WriteU8 (0x4);
+  buffer.AddAtEnd (other);
+  ENSURE_WRITTEN_BYTES (buffer, 7, 0x1, 0x2, 0x00, 0x00, 0x00, 0x3, 0x4);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Scatter-gather Buffer tests: random sequences of operations on
+ * buffers made of several fragments, checked against the expected bytes.
+ */
+class BufferScatterGatherTest : public TestCase
+{
+public:
+  BufferScatterGatherTest ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Build a buffer with a zero area and some bytes before and after it.
+   * \param [out] buffer The buffer.
+   * \param [out] bytes The expected bytes of the buffer.
+   */
+  void Build (Buffer &buffer, std::vector<uint8_t> &bytes);
+  /**
+   * Write random bytes, with the various Write methods of an iterator.
+   * \param [in] i The iterator, at the first byte to write.
+   * \param [in,out] bytes The expected bytes of the buffer.
+   * \param [in] start The offset of the first byte to write.
+   * \param [in] size The number of bytes to write.
+   */
+  void WriteRandom (Buffer::Iterator i, std::vector<uint8_t> &bytes, uint32_t start, uint32_t size);
+  /**
+   * Check the bytes of a buffer, read with CopyData and with iterators.
+   * \param [in] buffer The buffer.
+   * \param [in] bytes The expected bytes.
+   * \returns \c true if the bytes are the expected ones.
+   */
+  bool Check (const Buffer &buffer, const std::vector<uint8_t> &bytes);
+  /**
+   * Get a random integer.
+   * \param [in] max The maximum value.
+   * \returns A random integer in [0, max].
+   */
+  uint32_t Random (uint32_t max);
+
+  Ptr<UniformRandomVariable> m_rng;  //!< The random integers.
+};
+
+BufferScatterGatherTest::BufferScatterGatherTest ()
+  : TestCase ("Check the buffers made of several fragments")
+{}
+
+uint32_t
+BufferScatterGatherTest::Random (uint32_t max)
+{
+  return m_rng->GetInteger (0, max);
+}
+
+void
+BufferScatterGatherTest::Build (Buffer &buffer, std::vector<uint8_t> &bytes)
+{
+  uint32_t zeros = Random (2) == 0 ? 0 : Random (300);
+  buffer = Buffer (zeros);
+  bytes.assign (zeros, 0);
+  uint32_t start = Random (40);
+  buffer.AddAtStart (start);
+  bytes.insert (bytes.begin (), start, 0);
+  WriteRandom (buffer.Begin (), bytes, 0, start);
+  uint32_t end = Random (10);
+  buffer.AddAtEnd (end);
+  bytes.resize (bytes.size () + end);
+  Buffer::Iterator i = buffer.End ();
+  i.Prev (end);
+  WriteRandom (i, bytes, bytes.size () - end, end);
+}
+
+void
+BufferScatterGatherTest::WriteRandom (Buffer::Iterator i, std::vector<uint8_t> &bytes, uint32_t start, uint32_t size)
+{
+  uint32_t end = start + size;
+  while (start < end)
+    {
+      uint32_t value = Random (0xffff) << 16 | Random (0xffff);
+      uint32_t n = 1 + Random (end - start - 1);
+      switch (Random (4))
+        {
+        case 0:
+          if (end - start >= 2)
+            {
+              i.WriteHtonU16 (value);
+              bytes[start++] = value >> 8;
+              bytes[start++] = value;
+            }
+          break;
+        case 1:
+          if (end - start >= 4)
+            {
+              i.WriteHtonU32 (value);
+              bytes[start++] = value >> 24;
+              bytes[start++] = value >> 16;
+              bytes[start++] = value >> 8;
+              bytes[start++] = value;
+            }
+          break;
+        case 2:
+          i.WriteU8 (value, n);
+          std::fill (bytes.begin () + start, bytes.begin () + start + n, static_cast<uint8_t> (value));
+          start += n;
+          break;
+        case 3:
+          {
+            std::vector<uint8_t> data (n);
+            for (uint32_t j = 0; j < n; j++)
+              {
+                data[j] = Random (255);
+              }
+            i.Write (&data[0], n);
+            std::copy (data.begin (), data.end (), bytes.begin () + start);
+            start += n;
+          }
+          break;
+        default:
+          i.WriteU8 (value);
+          bytes[start++] = value;
+          break;
+        }
+    }
+}
+
+bool
+BufferScatterGatherTest::Check (const Buffer &buffer, const std::vector<uint8_t> &bytes)
+{
+  uint32_t size = bytes.size ();
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSize (), size, "Wrong size");
+  if (buffer.GetSize () != size)
+    {
+      return false;
+    }
+  std::vector<uint8_t> copy (size + 1);
+  NS_TEST_EXPECT_MSG_EQ (buffer.CopyData (&copy[0], size), size, "Wrong CopyData size");
+  copy.resize (size);
+  NS_TEST_EXPECT_MSG_EQ ((copy == bytes), true, "Wrong bytes copied");
+
+  // Read forwards, then backwards.
+  Buffer::Iterator i = buffer.Begin ();
+  bool ok = copy == bytes;
+  for (uint32_t j = 0; j < size && ok; j++)
+    {
+      ok = i.ReadU8 () == bytes[j];
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Wrong bytes read forwards");
+  NS_TEST_EXPECT_MSG_EQ (i.IsEnd (), true, "Not at the end");
+  for (uint32_t j = size; j > 0 && ok; j--)
+    {
+      i.Prev ();
+      ok = i.PeekU8 () == bytes[j - 1];
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Wrong bytes read backwards");
+
+  // Read integers at random offsets, possibly across fragments.
+  for (uint32_t k = 0; k < 8 && size >= 4 && ok; k++)
+    {
+      uint32_t offset = Random (size - 4);
+      i = buffer.Begin ();
+      i.Next (offset);
+      uint32_t u32 = i.ReadNtohU32 ();
+      ok = u32 == (uint32_t (bytes[offset]) << 24 | uint32_t (bytes[offset + 1]) << 16 |
+                   uint32_t (bytes[offset + 2]) << 8 | bytes[offset + 3]);
+      i = buffer.End ();
+      i.Prev (size - offset);
+      uint16_t u16 = i.ReadNtohU16 ();
+      ok = ok && u16 == (bytes[offset] << 8 | bytes[offset + 1]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Wrong integers read");
+
+  // Checksum a random range, possibly across the zero area and the
+  // fragments, against the bytes summed one by one.
+  if (size > 0 && ok)
+    {
+      uint32_t start = Random (size - 1);
+      uint32_t length = Random (size - start);
+      uint32_t sum = 0;
+      for (uint32_t j = 0; j < length; j++)
+        {
+          sum += (j & 1) ? bytes[start + j] << 8 : bytes[start + j];
+        }
+      while (sum >> 16)
+        {
+          sum = (sum & 0xffff) + (sum >> 16);
+        }
+      i = buffer.Begin ();
+      i.Next (start);
+      ok = i.CalculateIpChecksum (length) == static_cast<uint16_t> (~sum);
+      NS_TEST_EXPECT_MSG_EQ (ok, true, "Wrong checksum of " << length << " bytes at " << start);
+      NS_TEST_EXPECT_MSG_EQ (i.GetRemainingSize (), size - start - length, "Wrong position after the checksum");
+    }
+
+  if (size > 0 && ok)
+    {
+      uint32_t start = Random (size - 1);
+      uint32_t length = Random (size - start);
+      Buffer fragment = buffer.CreateFragment (start, length);
+      std::vector<uint8_t> fragmentBytes (length + 1);
+      fragment.CopyData (&fragmentBytes[0], length);
+      ok = std::equal (bytes.begin () + start, bytes.begin () + start + length, fragmentBytes.begin ());
+      NS_TEST_EXPECT_MSG_EQ (ok, true, "Wrong fragment");
+    }
+  return ok;
+}
+
+void
+BufferScatterGatherTest::DoRun (void)
+{
+  m_rng = CreateObject<UniformRandomVariable> ();
+  Buffer::EnableScatterGather ();
+
+  // A header written across the boundary of two fragments.
+  Buffer header;
+  header.AddAtStart (2);
+  Buffer other;
+  other.AddAtStart (2);
+  header.AddAtEnd (other);
+  Buffer::Iterator i = header.Begin ();
+  i.WriteHtonU32 (0x01020304);
+  std::vector<uint8_t> headerBytes;
+  for (uint8_t j = 1; j <= 4; j++)
+    {
+      headerBytes.push_back (j);
+    }
+  Check (header, headerBytes);
+  i = header.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU32 (), 0x01020304, "Wrong header across fragments");
+
+  // Random operations on a set of buffers, which share their fragments.
+  const uint32_t n = 8;
+  std::vector<Buffer> buffers (n);
+  std::vector<std::vector<uint8_t> > expected (n);
+  for (uint32_t j = 0; j < n; j++)
+    {
+      Build (buffers[j], expected[j]);
+    }
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      uint32_t a = Random (n - 1);
+      uint32_t b = Random (n - 1);
+      Buffer &buffer = buffers[a];
+      std::vector<uint8_t> &bytes = expected[a];
+      uint32_t size;
+      switch (Random (8))
+        {
+        case 0:
+          Build (buffer, bytes);
+          break;
+        case 1:
+          size = Random (30);
+          buffer.AddAtStart (size);
+          bytes.insert (bytes.begin (), size, 0);
+          WriteRandom (buffer.Begin (), bytes, 0, size);
+          break;
+        case 2:
+          size = Random (30);
+          buffer.AddAtEnd (size);
+          bytes.resize (bytes.size () + size);
+          i = buffer.End ();
+          i.Prev (size);
+          WriteRandom (i, bytes, bytes.size () - size, size);
+          break;
+        case 3:
+        case 4:
+          if (a != b)
+            {
+              buffer.AddAtEnd (buffers[b]);
+              bytes.insert (bytes.end (), expected[b].begin (), expected[b].end ());
+            }
+          break;
+        case 5:
+          size = std::min<uint32_t> (Random (bytes.size () + 4), bytes.size ());
+          buffer.RemoveAtStart (size);
+          bytes.erase (bytes.begin (), bytes.begin () + size);
+          break;
+        case 6:
+          size = std::min<uint32_t> (Random (bytes.size () + 4), bytes.size ());
+          buffer.RemoveAtEnd (size);
+          bytes.resize (bytes.size () - size);
+          break;
+        default:
+          buffers[b] = buffer;
+          expected[b] = bytes;
+          break;
+        }
+      if (bytes.size () > 10000)
+        {
+          Build (buffer, bytes);
+        }
+      if (!Check (buffer, bytes) || !Check (buffers[b], expected[b]))
+        {
+          break;
+        }
+    }
+
+  // Gathering keeps the bytes.
+  for (uint32_t j = 0; j < n; j++)
+    {
+      const uint8_t *data = buffers[j].PeekData ();
+      NS_TEST_EXPECT_MSG_EQ (std::equal (expected[j].begin (), expected[j].end (), data), true,
+                             "Wrong gathered bytes");
+      Check (buffers[j], expected[j]);
+    }
+}
+
+void
+BufferScatterGatherTest::DoTeardown (void)
+{
+  Buffer::DisableScatterGather ();
 }
 
 /**
@@ -405,6 +739,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferScatterGatherTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/compressed-trace-file.h"
+#include "ns3/output-stream-wrapper.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the lines written to a compressed trace file are
+ * read back, from the start and from simulation times.
+ */
+class CompressedTraceFileTest : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param async Whether the blocks are written by the writer thread.
+   */
+  CompressedTraceFileTest (bool async);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write the trace line of an event.
+   * \param i The index of the event.
+   */
+  void WriteLine (uint32_t i);
+
+  bool m_async;                      //!< Whether the blocks are written by the writer thread.
+  std::ostream *m_stream;            //!< The compressed stream.
+  std::vector<std::string> m_lines;  //!< The lines written.
+};
+
+CompressedTraceFileTest::CompressedTraceFileTest (bool async)
+  : TestCase (async ? "Check compressed trace files written asynchronously"
+                    : "Check compressed trace files"),
+    m_async (async),
+    m_stream (0)
+{
+}
+
+void
+CompressedTraceFileTest::WriteLine (uint32_t i)
+{
+  std::ostringstream line;
+  line << "+ " << Simulator::Now ().GetSeconds () << " /NodeList/" << (i % 7)
+       << "/DeviceList/0/TxQueue/Enqueue " << std::string (i % 50, 'x');
+  m_lines.push_back (line.str ());
+  *m_stream << line.str () << std::endl;
+}
+
+void
+CompressedTraceFileTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename (m_async ? "async.tr.gz" : "sync.tr.gz");
+  const uint32_t n = 2000;
+
+  {
+    // Blocks of 512 bytes hold a few lines, and cut most of them.
+    CompressedTraceStream stream (filename, 512, m_async);
+    NS_TEST_ASSERT_MSG_EQ (stream.good (), true, "Unable to create " << filename);
+    m_stream = &stream;
+    for (uint32_t i = 0; i < n; i++)
+      {
+        Simulator::Schedule (MilliSeconds (i), &CompressedTraceFileTest::WriteLine, this, i);
+      }
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  CompressedTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  NS_TEST_EXPECT_MSG_GT (reader.GetBlockCount (), 100, "Too few blocks");
+  std::string line;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reader.GetLine (line), true, "Missing line " << i);
+      NS_TEST_ASSERT_MSG_EQ (line, m_lines[i], "Wrong line " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (reader.GetLine (line), false, "Extra line");
+
+  // The line of event i is written at i ms.
+  uint32_t targets[] = {0, 1, 999, 1000, 1500, 1999};
+  for (uint32_t t = 0; t < sizeof (targets) / sizeof (targets[0]); t++)
+    {
+      Time start = reader.Seek (MilliSeconds (targets[t]));
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (start, MilliSeconds (targets[t]), "Block after the time");
+      NS_TEST_ASSERT_MSG_EQ (reader.GetLine (line), true, "Missing line");
+      uint32_t first = 0;
+      while (first < n && m_lines[first] != line)
+        {
+          first++;
+        }
+      NS_TEST_ASSERT_MSG_LT (first, n, "The block does not start with a line");
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (first, targets[t], "The lines of the time were skipped");
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (first + 50, targets[t], "The block is too early");
+    }
+  reader.Seek (Seconds (1));
+  while (reader.GetLine (line))
+    {
+    }
+  reader.Seek (Seconds (0));
+  NS_TEST_EXPECT_MSG_EQ (reader.GetLine (line), true, "Missing line after the end");
+  NS_TEST_EXPECT_MSG_EQ (line, m_lines[0], "Wrong first line");
+
+  std::remove (filename.c_str ());
+  std::remove ((filename + ".idx").c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that OutputStreamWrapper compresses the files whose
+ * name ends with ".gz".
+ */
+class CompressedOutputStreamWrapperTest : public TestCase
+{
+public:
+  CompressedOutputStreamWrapperTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CompressedOutputStreamWrapperTest::CompressedOutputStreamWrapperTest ()
+  : TestCase ("Check that OutputStreamWrapper compresses .gz files")
+{
+}
+
+void
+CompressedOutputStreamWrapperTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("wrapper.tr.gz");
+  {
+    Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_NE (dynamic_cast<CompressedTraceStream *> (stream->GetStream ()), 0,
+                           "The stream is not compressed");
+    *stream->GetStream () << "first line" << std::endl << "second line" << std::endl;
+  }
+
+  std::ifstream raw (filename.c_str (), std::ios::binary);
+  unsigned char magic[2] = {0, 0};
+  raw.read (reinterpret_cast<char *> (magic), 2);
+  NS_TEST_EXPECT_MSG_EQ ((magic[0] == 0x1f && magic[1] == 0x8b), true, "Not a gzip file");
+
+  CompressedTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to read " << filename);
+  std::string line;
+  NS_TEST_EXPECT_MSG_EQ (reader.GetLine (line), true, "Missing line");
+  NS_TEST_EXPECT_MSG_EQ (line, "first line", "Wrong line");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetLine (line), true, "Missing line");
+  NS_TEST_EXPECT_MSG_EQ (line, "second line", "Wrong line");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetLine (line), false, "Extra line");
+
+  std::remove (filename.c_str ());
+  std::remove ((filename + ".idx").c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that a block takes the time of its first write, not the
+ * time the stream was opened.
+ */
+class CompressedTraceBlockTimeTest : public TestCase
+{
+public:
+  CompressedTraceBlockTimeTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write a line.
+   * \param stream The compressed stream.
+   */
+  static void WriteLine (std::ostream *stream);
+};
+
+CompressedTraceBlockTimeTest::CompressedTraceBlockTimeTest ()
+  : TestCase ("Check the time of the blocks of compressed trace files")
+{
+}
+
+void
+CompressedTraceBlockTimeTest::WriteLine (std::ostream *stream)
+{
+  *stream << "line at " << Simulator::Now ().GetSeconds () << std::endl;
+}
+
+void
+CompressedTraceBlockTimeTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("time.tr.gz");
+  {
+    // Closed after Simulator::Destroy, as traces usually are.
+    CompressedTraceStream stream (filename, 512, false);
+    Simulator::Schedule (Seconds (5), &CompressedTraceBlockTimeTest::WriteLine, &stream);
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  std::ifstream index ((filename + ".idx").c_str ());
+  int64_t start = -1;
+  uint64_t offset;
+  index >> start >> offset;
+  NS_TEST_EXPECT_MSG_EQ (start, Seconds (5).GetNanoSeconds (), "Wrong block time");
+  NS_TEST_EXPECT_MSG_EQ ((index >> start >> offset).fail (), true, "Extra block");
+
+  std::remove (filename.c_str ());
+  std::remove ((filename + ".idx").c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compressed trace file TestSuite
+ */
+class CompressedTraceFileTestSuite : public TestSuite
+{
+public:
+  CompressedTraceFileTestSuite ();
+};
+
+CompressedTraceFileTestSuite::CompressedTraceFileTestSuite ()
+  : TestSuite ("compressed-trace-file", UNIT)
+{
+  AddTestCase (new CompressedTraceFileTest (false), TestCase::QUICK);
+  AddTestCase (new CompressedTraceFileTest (true), TestCase::QUICK);
+  AddTestCase (new CompressedTraceBlockTimeTest, TestCase::QUICK);
+  AddTestCase (new CompressedOutputStreamWrapperTest, TestCase::QUICK);
+}
+
+static CompressedTraceFileTestSuite g_compressedTraceFileTestSuite; //!< Static variable for test initialization
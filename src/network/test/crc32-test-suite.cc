@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/crc32.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check CRC32Calculate against the check value of CRC-32 and
+ * against a bitwise computation, for all the lengths and alignments
+ * of the input.
+ */
+class Crc32TestCase : public TestCase
+{
+public:
+  Crc32TestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compute the CRC-32 of some bytes one bit at a time.
+   * \param data The bytes.
+   * \param length The number of bytes.
+   * \returns The CRC-32.
+   */
+  static uint32_t BitwiseCrc32 (const uint8_t *data, int length);
+};
+
+Crc32TestCase::Crc32TestCase ()
+  : TestCase ("Check the CRC-32 computation")
+{
+}
+
+uint32_t
+Crc32TestCase::BitwiseCrc32 (const uint8_t *data, int length)
+{
+  uint32_t crc = 0xffffffff;
+  for (int i = 0; i < length; i++)
+    {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++)
+        {
+          crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+  return ~crc;
+}
+
+void
+Crc32TestCase::DoRun (void)
+{
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  NS_TEST_EXPECT_MSG_EQ (CRC32Calculate (check, sizeof (check)), 0xCBF43926, "Wrong check value");
+  NS_TEST_EXPECT_MSG_EQ (CRC32Calculate (check, 0), 0, "Wrong CRC of no bytes");
+
+  std::vector<uint8_t> data (100);
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < data.size (); i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      data[i] = seed >> 16;
+    }
+  for (int start = 0; start < 8; start++)
+    {
+      for (int length = 0; length + start <= static_cast<int> (data.size ()); length++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (CRC32Calculate (&data[start], length), BitwiseCrc32 (&data[start], length),
+                                 "Wrong CRC of " << length << " bytes at " << start);
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief CRC-32 TestSuite
+ */
+class Crc32TestSuite : public TestSuite
+{
+public:
+  Crc32TestSuite ();
+};
+
+Crc32TestSuite::Crc32TestSuite ()
+  : TestSuite ("crc32", UNIT)
+{
+  AddTestCase (new Crc32TestCase, TestCase::QUICK);
+}
+
+static Crc32TestSuite g_crc32TestSuite; //!< Static variable for test initialization
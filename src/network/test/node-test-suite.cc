@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/error-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that Node delivers the received packets to the protocol
+ * handlers of their device and protocol, in registration order, and
+ * keeps the promiscuous handlers apart.
+ */
+class NodeProtocolHandlerTest : public TestCase
+{
+public:
+  NodeProtocolHandlerTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record the delivery of a packet to a handler.
+   * \param log The log of the deliveries.
+   * \param name The name of the handler.
+   * \param device The receiving device.
+   * \param packet The packet.
+   * \param protocol The protocol number.
+   * \param from The sender address.
+   * \param to The destination address.
+   * \param packetType The packet type.
+   */
+  static void Handle (std::vector<std::string> *log, std::string name,
+                      Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                      const Address &from, const Address &to, NetDevice::PacketType packetType);
+  /**
+   * Send a packet and collect the handlers it was delivered to.
+   * \param from The sending device.
+   * \param to The receiving device.
+   * \param protocol The protocol number.
+   * \returns The names of the handlers, separated by spaces.
+   */
+  std::string Send (Ptr<NetDevice> from, Ptr<NetDevice> to, uint16_t protocol);
+
+  std::vector<std::string> m_log; //!< The log of the deliveries.
+};
+
+NodeProtocolHandlerTest::NodeProtocolHandlerTest ()
+  : TestCase ("Check the dispatch of received packets to the protocol handlers")
+{
+}
+
+void
+NodeProtocolHandlerTest::Handle (std::vector<std::string> *log, std::string name,
+                                 Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                 const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  log->push_back (name);
+}
+
+std::string
+NodeProtocolHandlerTest::Send (Ptr<NetDevice> from, Ptr<NetDevice> to, uint16_t protocol)
+{
+  m_log.clear ();
+  from->Send (Create<Packet> (10), to->GetAddress (), protocol);
+  Simulator::Run ();
+  std::string names;
+  for (std::vector<std::string>::const_iterator i = m_log.begin (); i != m_log.end (); ++i)
+    {
+      names += (names.empty () ? "" : " ") + *i;
+    }
+  return names;
+}
+
+void
+NodeProtocolHandlerTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Node::ProtocolHandler all = MakeBoundCallback (&Handle, &m_log, std::string ("all"));
+  // Registered before the devices are added.
+  b->RegisterProtocolHandler (all, 0, 0);
+
+  SimpleNetDeviceHelper helper;
+  Ptr<SimpleChannel> channel0 = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  Ptr<NetDevice> a0 = helper.Install (a, channel0).Get (0);
+  Ptr<NetDevice> b0 = helper.Install (b, channel0).Get (0);
+  Ptr<NetDevice> a1 = helper.Install (a, channel1).Get (0);
+  Ptr<NetDevice> b1 = helper.Install (b, channel1).Get (0);
+
+  b->RegisterProtocolHandler (MakeBoundCallback (&Handle, &m_log, std::string ("ipv4")), 0x0800, 0);
+  b->RegisterProtocolHandler (MakeBoundCallback (&Handle, &m_log, std::string ("arp1")), 0x0806, b1);
+  b->RegisterProtocolHandler (MakeBoundCallback (&Handle, &m_log, std::string ("dev0")), 0, b0);
+  b->RegisterProtocolHandler (MakeBoundCallback (&Handle, &m_log, std::string ("promisc")), 0x0800, 0, true);
+
+  NS_TEST_EXPECT_MSG_EQ (Send (a0, b0, 0x0800), "all ipv4 dev0 promisc", "Wrong handlers");
+  NS_TEST_EXPECT_MSG_EQ (Send (a1, b1, 0x0800), "all ipv4 promisc", "Wrong handlers");
+  NS_TEST_EXPECT_MSG_EQ (Send (a1, b1, 0x0806), "all arp1", "Wrong handlers");
+  NS_TEST_EXPECT_MSG_EQ (Send (a0, b0, 0x0806), "all dev0", "Wrong handlers");
+  NS_TEST_EXPECT_MSG_EQ (Send (a1, b1, 0x86dd), "all", "Wrong handlers");
+
+  b->UnregisterProtocolHandler (all);
+  NS_TEST_EXPECT_MSG_EQ (Send (a0, b0, 0x0800), "ipv4 dev0 promisc", "Wrong handlers");
+  NS_TEST_EXPECT_MSG_EQ (Send (a1, b1, 0x86dd), "", "Wrong handlers");
+
+  // A device added after the handlers of all the devices reaches them.
+  Ptr<SimpleChannel> channel2 = CreateObject<SimpleChannel> ();
+  Ptr<NetDevice> a2 = helper.Install (a, channel2).Get (0);
+  Ptr<NetDevice> b2 = helper.Install (b, channel2).Get (0);
+  NS_TEST_EXPECT_MSG_EQ (Send (a2, b2, 0x0800), "ipv4", "Wrong handlers");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the Config paths to the aggregates and devices of a
+ * type resolve to the same objects through the type index of the NodeList,
+ * as the object graph changes.
+ */
+class NodeListTypeIndexTest : public TestCase
+{
+public:
+  NodeListTypeIndexTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Resolve a Config path.
+   * \param path The Config path.
+   * \returns The matched paths, separated by spaces.
+   */
+  static std::string Lookup (std::string path);
+  /**
+   * Get the Config path of the first device of a node.
+   * \param node The node.
+   * \returns The path.
+   */
+  static std::string DevicePath (Ptr<Node> node);
+};
+
+NodeListTypeIndexTest::NodeListTypeIndexTest ()
+  : TestCase ("Check the Config paths resolved through the NodeList type index")
+{
+}
+
+std::string
+NodeListTypeIndexTest::Lookup (std::string path)
+{
+  Config::MatchContainer matches = Config::LookupMatches (path);
+  std::string paths;
+  for (std::size_t i = 0; i < matches.GetN (); i++)
+    {
+      paths += (paths.empty () ? "" : " ") + matches.GetMatchedPath (i);
+    }
+  return paths;
+}
+
+std::string
+NodeListTypeIndexTest::DevicePath (Ptr<Node> node)
+{
+  std::ostringstream oss;
+  oss << "/NodeList/" << node->GetId () << "/DeviceList/0/$ns3::SimpleNetDevice/";
+  return oss.str ();
+}
+
+void
+NodeListTypeIndexTest::DoRun (void)
+{
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodes.push_back (CreateObject<Node> ());
+    }
+  SimpleNetDeviceHelper helper;
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  helper.Install (nodes[1], channel);
+  helper.Install (nodes[3], channel);
+
+  std::string devices = "/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice";
+  std::string models = "/NodeList/*/$ns3::RateErrorModel";
+  NS_TEST_EXPECT_MSG_EQ (Lookup (devices), DevicePath (nodes[1]) + " " + DevicePath (nodes[3]),
+                         "Wrong devices");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (models), "", "Wrong aggregates");
+  // Looked up again from the index.
+  NS_TEST_EXPECT_MSG_EQ (Lookup (devices), DevicePath (nodes[1]) + " " + DevicePath (nodes[3]),
+                         "Wrong devices");
+
+  // The aggregation of an object, a new device and a new node are seen.
+  // An aggregation only changes the generation of the types aggregated.
+  uint64_t deviceGeneration = Object::GetGraphGeneration (SimpleNetDevice::GetTypeId ());
+  uint64_t modelGeneration = Object::GetGraphGeneration (ErrorModel::GetTypeId ());
+  nodes[2]->AggregateObject (CreateObject<RateErrorModel> ());
+  NS_TEST_EXPECT_MSG_EQ (Object::GetGraphGeneration (SimpleNetDevice::GetTypeId ()), deviceGeneration,
+                         "Devices invalidated by the aggregation of an error model");
+  NS_TEST_EXPECT_MSG_NE (Object::GetGraphGeneration (ErrorModel::GetTypeId ()), modelGeneration,
+                         "Error models not invalidated by their aggregation");
+  std::ostringstream model;
+  model << "/NodeList/" << nodes[2]->GetId () << "/$ns3::RateErrorModel/";
+  NS_TEST_EXPECT_MSG_EQ (Lookup (models), model.str (), "Wrong aggregates");
+  helper.Install (nodes[0], channel);
+  nodes.push_back (CreateObject<Node> ());
+  helper.Install (nodes[4], channel);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (devices), DevicePath (nodes[0]) + " " + DevicePath (nodes[1])
+                         + " " + DevicePath (nodes[3]) + " " + DevicePath (nodes[4]),
+                         "Wrong devices");
+
+  // The indices of the path still apply.
+  std::ostringstream range;
+  range << "/NodeList/" << nodes[1]->GetId () << "-" << nodes[2]->GetId ()
+        << "/DeviceList/*/$ns3::SimpleNetDevice";
+  NS_TEST_EXPECT_MSG_EQ (Lookup (range.str ()), DevicePath (nodes[1]), "Wrong devices");
+  // A path which is not indexed.
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("/NodeList/*/DeviceList/*/TxQueue/$ns3::Queue<Packet>").empty (), false,
+                         "Missing queues");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Node TestSuite
+ */
+class NodeTestSuite : public TestSuite
+{
+public:
+  NodeTestSuite ();
+};
+
+NodeTestSuite::NodeTestSuite ()
+  : TestSuite ("node", UNIT)
+{
+  AddTestCase (new NodeProtocolHandlerTest, TestCase::QUICK);
+  AddTestCase (new NodeListTypeIndexTest, TestCase::QUICK);
+}
+
+static NodeTestSuite g_nodeTestSuite; //!< Static variable for test initialization
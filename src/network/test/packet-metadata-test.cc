@@ -18,13 +18,16 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include <cstdarg>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include "ns3/test.h"
 #include "ns3/header.h"
 #include "ns3/trailer.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-memory-pool.h"
 
 using namespace ns3;
 
@@ -903,6 +906,125 @@ PacketMetadataTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet Metadata memory test: the uids of aggregated packets, and
+ * the memory taken by the metadata of a packet
+ */
+class PacketMetadataMemoryTest : public TestCase {
+public:
+  PacketMetadataMemoryTest ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Checks that the serialized form of a packet contains a packet uid
+   * \param p The packet
+   * \param uid The uid
+   * \returns true if the uid is found
+   */
+  bool HasUid (Ptr<Packet> p, uint64_t uid);
+};
+
+PacketMetadataMemoryTest::PacketMetadataMemoryTest ()
+  : TestCase ("Packet metadata memory")
+{
+}
+
+bool
+PacketMetadataMemoryTest::HasUid (Ptr<Packet> p, uint64_t uid)
+{
+  std::vector<uint8_t> buffer (p->GetSerializedSize ());
+  p->Serialize (&buffer[0], buffer.size ());
+  for (uint32_t i = 0; i + sizeof (uid) <= buffer.size (); ++i)
+    {
+      if (std::memcmp (&buffer[i], &uid, sizeof (uid)) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+PacketMetadataMemoryTest::DoRun (void)
+{
+  PacketMetadata::Enable ();
+
+  // The uids of aggregated packets are stored as differences from the
+  // uid of the aggregate, of either sign and of any size.
+  Ptr<Packet> before = Create<Packet> (10);
+  std::vector<Ptr<Packet> > others;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      others.push_back (Create<Packet> (1));
+    }
+  Ptr<Packet> p = Create<Packet> (10);
+  Ptr<Packet> after = Create<Packet> (10);
+  ADD_HEADER (before, 4);
+  ADD_HEADER (after, 5);
+  p->AddAtEnd (before);
+  p->AddAtEnd (after);
+  p->AddAtEnd (others.back ());
+  NS_TEST_EXPECT_MSG_EQ (HasUid (p, before->GetUid ()), true, "Lost the uid of an older packet");
+  NS_TEST_EXPECT_MSG_EQ (HasUid (p, after->GetUid ()), true, "Lost the uid of a newer packet");
+  NS_TEST_EXPECT_MSG_EQ (HasUid (p, others.back ()->GetUid ()), true, "Lost the uid of a distant packet");
+  std::vector<uint8_t> buffer (p->GetSerializedSize ());
+  p->Serialize (&buffer[0], buffer.size ());
+  Ptr<Packet> deserialized = Create<Packet> (&buffer[0], buffer.size (), true);
+  NS_TEST_EXPECT_MSG_EQ (HasUid (deserialized, before->GetUid ()), true, "Lost the uid of a deserialized packet");
+  Ptr<Packet> fragment = p->CreateFragment (12, 20);
+  NS_TEST_EXPECT_MSG_EQ (HasUid (fragment, before->GetUid ()), true, "Lost the uid of a fragment");
+  NS_TEST_EXPECT_MSG_EQ (HasUid (fragment, after->GetUid ()), true, "Lost the uid of a fragment");
+  others.clear ();
+
+  // The end of a fragment is stored as a difference from the size of
+  // its header, of either sign.
+  Ptr<Packet> large = Create<Packet> (10);
+  ADD_HEADER (large, 200);
+  Ptr<Packet> trimmed = large->CreateFragment (20, 40);
+  trimmed->AddAtEnd (large->CreateFragment (180, 20));
+  std::vector<uint8_t> serialized (trimmed->GetSerializedSize ());
+  trimmed->Serialize (&serialized[0], serialized.size ());
+  Ptr<Packet> copy = Create<Packet> (&serialized[0], serialized.size (), true);
+  PacketMetadata::ItemIterator k = copy->BeginItem ();
+  NS_TEST_ASSERT_MSG_EQ (k.HasNext (), true, "Lost the first fragment");
+  PacketMetadata::Item item = k.Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.isFragment, true, "Not a fragment");
+  NS_TEST_EXPECT_MSG_EQ (item.currentTrimedFromStart, 20, "Wrong start of the first fragment");
+  NS_TEST_EXPECT_MSG_EQ (item.currentSize, 40, "Wrong end of the first fragment");
+  NS_TEST_ASSERT_MSG_EQ (k.HasNext (), true, "Lost the second fragment");
+  item = k.Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.isFragment, true, "Not a fragment");
+  NS_TEST_EXPECT_MSG_EQ (item.currentTrimedFromStart, 180, "Wrong start of the second fragment");
+  NS_TEST_EXPECT_MSG_EQ (item.currentSize, 20, "Wrong end of the second fragment");
+
+  // A large aggregate does not make the metadata of the packets which
+  // follow it any larger.
+  Ptr<Packet> aggregate = Create<Packet> ();
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      Ptr<Packet> msdu = Create<Packet> (10);
+      ADD_HEADER (msdu, 8);
+      aggregate->AddAtEnd (msdu);
+    }
+  aggregate = 0;
+  uint64_t bytesInUse = PacketMemoryPool::GetStatistics ().bytesInUse;
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Ptr<Packet> packet = Create<Packet> (1000);
+      ADD_HEADER (packet, 8);
+      ADD_HEADER (packet, 20);
+      ADD_HEADER (packet, 14);
+      packets.push_back (packet);
+    }
+  uint64_t perPacket = (PacketMemoryPool::GetStatistics ().bytesInUse - bytesInUse) / packets.size ();
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (perPacket, 128, "Metadata of a packet is too large");
+}
+
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -919,6 +1041,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
+  AddTestCase (new PacketMetadataMemoryTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
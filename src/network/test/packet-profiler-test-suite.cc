@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/packet-profiler.h"
+#include "ns3/simulator.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the live, peak and total counts of the packets and
+ * buffers created in a scope.
+ */
+class PacketProfilerCountsTest : public TestCase
+{
+public:
+  PacketProfilerCountsTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PacketProfilerCountsTest::PacketProfilerCountsTest ()
+  : TestCase ("Check the counts of the packets and buffers of a scope")
+{
+}
+
+void
+PacketProfilerCountsTest::DoRun (void)
+{
+  Ptr<Packet> kept = Create<Packet> (10);
+  PacketProfiler::Enable ();
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::IsEnabled (), true, "The profiler should be enabled");
+
+  uint8_t data[200] = {0};
+  Ptr<Packet> p;
+  Ptr<Packet> copy;
+  {
+    PacketProfiler::Scope scope ("outer");
+    p = Create<Packet> (data, sizeof (data));
+    {
+      PacketProfiler::Scope inner ("inner");
+      copy = p->Copy ();
+    }
+  }
+  PacketProfiler::Counts outer = PacketProfiler::GetCounts ("outer");
+  NS_TEST_EXPECT_MSG_EQ (outer.packets, 1, "Wrong number of live packets");
+  NS_TEST_EXPECT_MSG_EQ (outer.created, 1, "Wrong number of packets created");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (outer.bytes, sizeof (data), "The buffer of the packet is not counted");
+  PacketProfiler::Counts inner = PacketProfiler::GetCounts ("inner");
+  NS_TEST_EXPECT_MSG_EQ (inner.packets, 1, "Wrong number of live packets");
+  NS_TEST_EXPECT_MSG_EQ (inner.bytes, 0, "The copy should share the buffer");
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::GetCounts ().packets, 2, "Wrong number of live packets");
+
+  copy = 0;
+  p = 0;
+  // The packet created before Enable is not counted.
+  kept = 0;
+  outer = PacketProfiler::GetCounts ("outer");
+  NS_TEST_EXPECT_MSG_EQ (outer.packets, 0, "The packet should be freed");
+  NS_TEST_EXPECT_MSG_EQ (outer.peakPackets, 1, "Wrong peak number of packets");
+  NS_TEST_EXPECT_MSG_EQ (outer.bytes, 0, "The buffer should be freed");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (outer.peakBytes, sizeof (data), "Wrong peak number of bytes");
+  PacketProfiler::Counts total = PacketProfiler::GetCounts ();
+  NS_TEST_EXPECT_MSG_EQ (total.packets, 0, "Wrong number of live packets");
+  NS_TEST_EXPECT_MSG_EQ (total.peakPackets, 2, "Wrong peak number of packets");
+  NS_TEST_EXPECT_MSG_EQ (total.created, 2, "Wrong number of packets created");
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::GetCounts ("none").created, 0, "Unknown contexts have no counts");
+
+  PacketProfiler::Disable ();
+  Ptr<Packet> ignored = Create<Packet> (10);
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::GetCounts ().created, 2, "The profiler should be disabled");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the packets created outside of any scope are charged
+ * to their caller.
+ */
+class PacketProfilerCallStackTest : public TestCase
+{
+public:
+  PacketProfilerCallStackTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PacketProfilerCallStackTest::PacketProfilerCallStackTest ()
+  : TestCase ("Check the creation context of the packets created outside of any scope")
+{
+}
+
+void
+PacketProfilerCallStackTest::DoRun (void)
+{
+  PacketProfiler::Enable ();
+  Ptr<Packet> p = Create<Packet> (10);
+  Ptr<Packet> fragment = p->CreateFragment (0, 5);
+  PacketProfiler::Disable ();
+
+  std::vector<std::string> contexts = PacketProfiler::GetContexts ();
+  NS_TEST_ASSERT_MSG_EQ (contexts.size (), 1, "The packets should share their context");
+#ifdef HAVE_EXECINFO_H
+  NS_TEST_EXPECT_MSG_EQ ((contexts[0].find ("network-test;") == 0), true,
+                         "Wrong module in " << contexts[0]);
+  NS_TEST_EXPECT_MSG_NE (contexts[0].find ("PacketProfilerCallStackTest::DoRun"), std::string::npos,
+                         "Wrong function in " << contexts[0]);
+#else
+  NS_TEST_EXPECT_MSG_EQ (contexts[0], "[unknown]", "Wrong context");
+#endif
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::GetCounts (contexts[0]).packets, 2, "Wrong number of live packets");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the snapshot file, and the report of the packets never
+ * freed at Simulator::Destroy.
+ */
+class PacketProfilerReportTest : public TestCase
+{
+public:
+  PacketProfilerReportTest ();
+
+private:
+  virtual void DoRun (void);
+  /** Create a packet, and keep it if it is the second one. */
+  void CreatePacket (void);
+
+  uint32_t m_created;    //!< The number of packets created.
+  Ptr<Packet> m_leaked;  //!< The packet which is never freed.
+};
+
+PacketProfilerReportTest::PacketProfilerReportTest ()
+  : TestCase ("Check the snapshots and the report of the packets never freed"),
+    m_created (0)
+{
+}
+
+void
+PacketProfilerReportTest::CreatePacket (void)
+{
+  PacketProfiler::Scope scope ("report");
+  Ptr<Packet> p = Create<Packet> (100);
+  if (++m_created == 2)
+    {
+      m_leaked = p;
+    }
+}
+
+void
+PacketProfilerReportTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("packet-profiler.txt");
+  PacketProfiler::Enable ();
+  PacketProfiler::EnableSnapshots (filename, Seconds (1));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::ScheduleWithContext (7, Seconds (0.5 + i), &PacketProfilerReportTest::CreatePacket, this);
+    }
+  Simulator::Run ();
+
+  std::ostringstream report;
+  std::streambuf *clog = std::clog.rdbuf (report.rdbuf ());
+  Simulator::Destroy ();
+  std::clog.rdbuf (clog);
+
+  NS_TEST_EXPECT_MSG_EQ (PacketProfiler::IsEnabled (), false, "The profiler should stop at Simulator::Destroy");
+  std::ostringstream expected;
+  expected << "uid " << m_leaked->GetUid () << " created at +1.5s on node 7";
+  NS_TEST_EXPECT_MSG_NE (report.str ().find ("report: 1 packets (peak 2)"), std::string::npos,
+                         "Wrong report: " << report.str ());
+  NS_TEST_EXPECT_MSG_NE (report.str ().find (expected.str ()), std::string::npos,
+                         "Wrong report: " << report.str ());
+
+  // One snapshot each second while the packets are created, with the
+  // second packet kept from 1.5 s on: the fields after the context are
+  // the live, peak and created packets.
+  std::ifstream snapshots (filename.c_str ());
+  std::string line;
+  std::vector<std::string> totals;
+  while (std::getline (snapshots, line))
+    {
+      if (line.find ("\ttotal\t") != std::string::npos)
+        {
+          totals.push_back (line);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (totals.size (), 3, "Wrong number of snapshots");
+  NS_TEST_EXPECT_MSG_EQ (totals[0].find ("1\ttotal\t0\t1\t1\t"), 0, "Wrong snapshot " << totals[0]);
+  NS_TEST_EXPECT_MSG_EQ (totals[1].find ("2\ttotal\t1\t1\t2\t"), 0, "Wrong snapshot " << totals[1]);
+  NS_TEST_EXPECT_MSG_EQ (totals[2].find ("3\ttotal\t1\t2\t3\t"), 0, "Wrong snapshot " << totals[2]);
+  m_leaked = 0;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketProfiler TestSuite
+ */
+class PacketProfilerTestSuite : public TestSuite
+{
+public:
+  PacketProfilerTestSuite ();
+};
+
+PacketProfilerTestSuite::PacketProfilerTestSuite ()
+  : TestSuite ("packet-profiler", UNIT)
+{
+  AddTestCase (new PacketProfilerCountsTest, TestCase::QUICK);
+  AddTestCase (new PacketProfilerCallStackTest, TestCase::QUICK);
+  AddTestCase (new PacketProfilerReportTest, TestCase::QUICK);
+}
+
+static PacketProfilerTestSuite g_packetProfilerTestSuite; //!< Static variable for test initialization
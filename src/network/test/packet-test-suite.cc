@@ -27,6 +27,7 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <cstring>
 
 using namespace ns3;
 
@@ -412,8 +413,68 @@ struct Expected
   uint8_t data;   //!< Optional data
 };
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief A header of fixed size, which counts the calls of its
+ * virtual GetSerializedSize method.
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+class AStaticSizeHeader : public Header
+{
+public:
+  AStaticSizeHeader () : m_value (0) {}
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("anon::AStaticSizeHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Network")
+      .HideFromDocumentation ()
+      .AddConstructor<AStaticSizeHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const {
+    ++m_sizeQueries;
+    return 6;
+  }
+  virtual void Serialize (Buffer::Iterator iter) const {
+    iter.WriteHtonU32 (m_value);
+    iter.WriteU16 (0xabcd);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator iter) {
+    m_value = iter.ReadNtohU32 ();
+    iter.ReadU16 ();
+    return 6;
+  }
+  virtual void Print (std::ostream &os) const {
+    os << "value=" << m_value;
+  }
+  uint32_t m_value;              //!< The header value
+  static uint32_t m_sizeQueries; //!< Number of GetSerializedSize calls
+};
+
+uint32_t AStaticSizeHeader::m_sizeQueries = 0;
+
 }
 
+namespace ns3 {
+
+/** AStaticSizeHeader takes the fixed-size path of Packet. */
+template <>
+struct StaticSerializedSize<AStaticSizeHeader> : public std::integral_constant<uint32_t, 6> {};
+
+} // namespace ns3
+
 // tag name, start, end
 #define E(name,start,end) name,start,end
 
@@ -1158,6 +1219,83 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the headers which specialize StaticSerializedSize are
+ * added, removed and peeked as they are through the Header interface.
+ */
+class PacketStaticHeaderTest : public TestCase
+{
+public:
+  PacketStaticHeaderTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that the packet has a single byte tag.
+   * \param p The packet
+   * \param start The expected start of the tag
+   * \param end The expected end of the tag
+   */
+  void CheckTag (Ptr<const Packet> p, uint32_t start, uint32_t end);
+};
+
+PacketStaticHeaderTest::PacketStaticHeaderTest ()
+  : TestCase ("Check the headers of fixed size")
+{}
+
+void
+PacketStaticHeaderTest::CheckTag (Ptr<const Packet> p, uint32_t start, uint32_t end)
+{
+  ByteTagIterator i = p->GetByteTagIterator ();
+  NS_TEST_ASSERT_MSG_EQ (i.HasNext (), true, "Missing byte tag");
+  ByteTagIterator::Item item = i.Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.GetStart (), start, "Wrong tag start");
+  NS_TEST_EXPECT_MSG_EQ (item.GetEnd (), end, "Wrong tag end");
+  NS_TEST_EXPECT_MSG_EQ (i.HasNext (), false, "Extra byte tag");
+}
+
+void
+PacketStaticHeaderTest::DoRun (void)
+{
+  AStaticSizeHeader header;
+  header.m_value = 0x01020304;
+  Ptr<Packet> fast = Create<Packet> (10);
+  Ptr<Packet> slow = Create<Packet> (10);
+  fast->AddByteTag (ATestTag<1> ());
+  slow->AddByteTag (ATestTag<1> ());
+
+  AStaticSizeHeader::m_sizeQueries = 0;
+  fast->AddHeader (header);
+  NS_TEST_EXPECT_MSG_EQ (AStaticSizeHeader::m_sizeQueries, 0, "The fixed-size path asked the size");
+  slow->AddHeader (static_cast<const Header &> (header));
+  NS_TEST_EXPECT_MSG_EQ (AStaticSizeHeader::m_sizeQueries, 1, "The virtual path did not ask the size");
+
+  NS_TEST_ASSERT_MSG_EQ (fast->GetSize (), 16, "Wrong size");
+  uint8_t fastBytes[16];
+  uint8_t slowBytes[16];
+  fast->CopyData (fastBytes, 16);
+  slow->CopyData (slowBytes, 16);
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (fastBytes, slowBytes, 16), 0, "Different bytes");
+  CheckTag (fast, 6, 16);
+  CheckTag (slow, 6, 16);
+
+  AStaticSizeHeader peeked;
+  NS_TEST_EXPECT_MSG_EQ (fast->PeekHeader (peeked), 6, "Wrong peeked size");
+  NS_TEST_EXPECT_MSG_EQ (peeked.m_value, header.m_value, "Wrong peeked value");
+  NS_TEST_EXPECT_MSG_EQ (fast->GetSize (), 16, "Peeking changed the packet");
+
+  AStaticSizeHeader removed;
+  NS_TEST_EXPECT_MSG_EQ (fast->RemoveHeader (removed), 6, "Wrong removed size");
+  NS_TEST_EXPECT_MSG_EQ (removed.m_value, header.m_value, "Wrong removed value");
+  slow->RemoveHeader (static_cast<Header &> (removed));
+  NS_TEST_EXPECT_MSG_EQ (fast->GetSize (), 10, "Wrong size");
+  NS_TEST_EXPECT_MSG_EQ (slow->GetSize (), 10, "Wrong size");
+  CheckTag (fast, 0, 10);
+  CheckTag (slow, 0, 10);
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1175,6 +1313,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketStaticHeaderTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
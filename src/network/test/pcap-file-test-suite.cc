@@ -25,6 +25,13 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcapng-file.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/checkpoint.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -1144,6 +1151,242 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the records written in batches,
+ * in the simulation thread or in the writer thread, make the same file
+ * as the records written immediately.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param async Whether the batches are written by the writer thread.
+   */
+  BufferedWriteTestCase (bool async);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_async; //!< Whether the batches are written by the writer thread.
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase (bool async)
+  : TestCase (async ? "Check that PcapFile writes batches asynchronously"
+                    : "Check that PcapFile writes batches"),
+    m_async (async)
+{
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string known = CreateDataDirFilename ("known.pcap");
+  PcapFile in;
+  in.Open (known, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (in.Fail (), false, "Open (" << known << ", \"std::ios::in\") returns error");
+
+  std::string filename = CreateTempDirFilename (m_async ? "async.pcap" : "batched.pcap");
+  PcapFile out;
+  out.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (out.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  // Smaller than the records of 1070 bytes, and than two records of 46.
+  out.SetWriteBuffer (100, m_async);
+  out.Init (in.GetDataLinkType (), in.GetSnapLen (), in.GetTimeZoneOffset ());
+
+  uint8_t data[2048];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  for (;;)
+    {
+      in.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (in.Eof ())
+        {
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (readLen, origLen, "Truncated known packet");
+      out.Write (tsSec, tsUsec, data, origLen);
+    }
+  NS_TEST_EXPECT_MSG_EQ (out.Fail (), false, "Write must not fail");
+  out.Close ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (known, filename, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "The batched file is different from " << known);
+  NS_TEST_EXPECT_MSG_EQ (packets, N_KNOWN_PACKETS, "Wrong number of packets");
+  remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the records written in the writer
+ * thread before and after Checkpoint::Fork reach their file, in both
+ * the parent and the child process.
+ */
+class ForkWriteTestCase : public TestCase
+{
+public:
+  ForkWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Copy the packets of the known file to a file written in batches by
+   * the writer thread.
+   * \param filename The name of the file.
+   * \param fork Whether to fork in the middle of the copy.
+   * \returns \c true if the file is the same as the known file.
+   */
+  bool Copy (std::string filename, bool fork);
+};
+
+ForkWriteTestCase::ForkWriteTestCase ()
+  : TestCase ("Check that the writer thread writes the batches across Checkpoint::Fork")
+{
+}
+
+bool
+ForkWriteTestCase::Copy (std::string filename, bool fork)
+{
+  std::string known = CreateDataDirFilename ("known.pcap");
+  PcapFile in;
+  in.Open (known, std::ios::in);
+  PcapFile out;
+  out.Open (filename, std::ios::out);
+  out.SetWriteBuffer (100, true);
+  out.Init (in.GetDataLinkType (), in.GetSnapLen (), in.GetTimeZoneOffset ());
+
+  uint8_t data[2048];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  for (uint32_t i = 0; ; ++i)
+    {
+      if (fork && i == N_KNOWN_PACKETS / 2 && Checkpoint::Fork (2) == 1)
+        {
+          // The files of the parent are shared: write another one.
+          bool ok = Copy (CreateTempDirFilename ("fork-child.pcap"), false);
+          Checkpoint::Exit (ok ? 0 : 1);
+        }
+      in.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (in.Eof ())
+        {
+          break;
+        }
+      out.Write (tsSec, tsUsec, data, origLen);
+    }
+  out.Close ();
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (known, filename, sec, usec, packets);
+  remove (filename.c_str ());
+  return !diff && packets == N_KNOWN_PACKETS;
+}
+
+void
+ForkWriteTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (Copy (CreateTempDirFilename ("fork.pcap"), true), true,
+                         "The parent file is different from the known file");
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::Wait (), 0u, "The child file is different from the known file");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that PcapngFile reads back the
+ * interfaces and packets it writes, and that the PcapFileWrapper
+ * objects with the same "PcapngFile" attribute share a file.
+ */
+class PcapngTestCase : public TestCase
+{
+public:
+  PcapngTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngTestCase::PcapngTestCase ()
+  : TestCase ("Check that pcapng files are written and read back")
+{
+}
+
+void
+PcapngTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("shared.pcapng");
+  uint8_t bytes[100];
+  for (uint32_t i = 0; i < sizeof (bytes); i++)
+    {
+      bytes[i] = i;
+    }
+
+  {
+    Ptr<PcapFileWrapper> ppp = CreateObject<PcapFileWrapper> ();
+    Ptr<PcapFileWrapper> csma = CreateObject<PcapFileWrapper> ();
+    ppp->SetAttribute ("PcapngFile", StringValue (filename));
+    csma->SetAttribute ("PcapngFile", StringValue (filename));
+    csma->SetAttribute ("CaptureSize", UintegerValue (10));
+    ppp->Open ("ppp-0-1.pcap", std::ios::out);
+    csma->Open ("csma-1-1.pcap", std::ios::out);
+    ppp->Init (9);
+    csma->Init (1);
+    NS_TEST_ASSERT_MSG_EQ (ppp->Fail (), false, "Open (" << filename << ") returns error");
+    NS_TEST_EXPECT_MSG_EQ (csma->GetSnapLen (), 10, "Wrong snapshot length");
+
+    ppp->Write (NanoSeconds (5000000123ULL), bytes, 47);
+    csma->Write (MicroSeconds (6), Create<Packet> (bytes, 64));
+    ppp->Write (Seconds (7), Create<Packet> (bytes, 100));
+    NS_TEST_EXPECT_MSG_EQ (csma->Fail (), false, "Write must not fail");
+  }
+  NS_TEST_EXPECT_MSG_EQ (CheckFileExists ("ppp-0-1.pcap"), false, "The pcap file was created");
+
+  PcapngFile f;
+  f.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::in\") returns error");
+
+  uint32_t interface;
+  uint64_t timestamp;
+  std::vector<uint8_t> data;
+  uint32_t origLen;
+  f.Read (interface, timestamp, data, origLen);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read must not fail");
+  NS_TEST_ASSERT_MSG_EQ (f.GetInterfaceCount (), 2, "Wrong number of interfaces");
+  NS_TEST_EXPECT_MSG_EQ (f.GetDataLinkType (0), 9, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (f.GetDataLinkType (1), 1, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (f.GetSnapLen (0), PcapFile::SNAPLEN_DEFAULT, "Wrong snapshot length");
+  NS_TEST_EXPECT_MSG_EQ (f.GetSnapLen (1), 10, "Wrong snapshot length");
+  NS_TEST_EXPECT_MSG_EQ (f.GetInterfaceName (0), "ppp-0-1.pcap", "Wrong interface name");
+  NS_TEST_EXPECT_MSG_EQ (f.GetInterfaceName (1), "csma-1-1.pcap", "Wrong interface name");
+  NS_TEST_EXPECT_MSG_EQ (interface, 0, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (timestamp, 5000000123ULL, "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (origLen, 47, "Wrong packet length");
+  NS_TEST_ASSERT_MSG_EQ (data.size (), 47, "Wrong saved length");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (data.data (), bytes, 47), 0, "Wrong packet data");
+
+  f.Read (interface, timestamp, data, origLen);
+  NS_TEST_EXPECT_MSG_EQ (interface, 1, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (timestamp, 6000, "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (origLen, 64, "Wrong packet length");
+  NS_TEST_ASSERT_MSG_EQ (data.size (), 10, "The packet was not truncated to the snapshot length");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (data.data (), bytes, 10), 0, "Wrong packet data");
+
+  f.Read (interface, timestamp, data, origLen);
+  NS_TEST_EXPECT_MSG_EQ (interface, 0, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (timestamp, 7000000000ULL, "Wrong timestamp");
+  NS_TEST_ASSERT_MSG_EQ (data.size (), 100, "Wrong saved length");
+  NS_TEST_EXPECT_MSG_EQ (std::memcmp (data.data (), bytes, 100), 0, "Wrong packet data");
+
+  f.Read (interface, timestamp, data, origLen);
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), true, "Read past the end of the file");
+  f.Close ();
+  remove (filename.c_str ());
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1410,10 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase (false), TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase (true), TestCase::QUICK);
+  AddTestCase (new ForkWriteTestCase, TestCase::QUICK);
+  AddTestCase (new PcapngTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
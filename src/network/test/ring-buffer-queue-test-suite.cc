@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ring-buffer-queue.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/data-rate.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the FIFO order, the drops and the statistics of the ring
+ * buffer queue, while its ring wraps around and grows.
+ */
+class RingBufferQueueTestCase : public TestCase
+{
+public:
+  RingBufferQueueTestCase ();
+  virtual void DoRun (void);
+};
+
+RingBufferQueueTestCase::RingBufferQueueTestCase ()
+  : TestCase ("Sanity check on the ring buffer queue implementation")
+{
+}
+
+void
+RingBufferQueueTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue<Packet> > queue = CreateObject<RingBufferQueue<Packet> > ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxSize", StringValue ("40p")), true,
+                         "Verify that we can actually set the attribute");
+
+  NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Peek () == 0), true, "The queue should be empty");
+
+  // Keep between 10 and 40 packets in the queue, so that the ring wraps
+  // around at each of its sizes.
+  std::list<Ptr<Packet> > expected;
+  uint32_t dropped = 0;
+  for (uint32_t round = 0; round < 20; round++)
+    {
+      for (uint32_t i = 0; i < 3 * round; i++)
+        {
+          Ptr<Packet> p = Create<Packet> (round + 1);
+          if (queue->Enqueue (p))
+            {
+              expected.push_back (p);
+            }
+          else
+            {
+              dropped++;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), expected.size (), "Wrong number of packets");
+      while (expected.size () > 10)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->Peek (), expected.front (), "Wrong packet peeked");
+          Ptr<Packet> p = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ (p, expected.front (), "Wrong packet dequeued");
+          expected.pop_front ();
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (dropped, 0, "The queue never overflowed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsBeforeEnqueue (), dropped, "Wrong drop count");
+
+  uint32_t bytes = 0;
+  for (std::list<Ptr<Packet> >::const_iterator i = expected.begin (); i != expected.end (); ++i)
+    {
+      bytes += (*i)->GetSize ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), bytes, "Wrong number of bytes");
+
+  Ptr<Packet> removed = queue->Remove ();
+  NS_TEST_EXPECT_MSG_EQ (removed, expected.front (), "Wrong packet removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsAfterDequeue (), 1, "Wrong drop count");
+  expected.pop_front ();
+
+  queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue should be empty");
+  for (std::list<Ptr<Packet> >::const_iterator i = expected.begin (); i != expected.end (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((*i)->GetReferenceCount (), 1, "The queue still references a packet");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the batch enqueue and dequeue of the ring buffer queue,
+ * with a limit in bytes.
+ */
+class RingBufferQueueBatchTestCase : public TestCase
+{
+public:
+  RingBufferQueueBatchTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Count a dequeued packet.
+   * \param p The packet.
+   */
+  void Dequeued (Ptr<const Packet> p);
+
+  uint32_t m_dequeued; //!< The number of packets traced as dequeued.
+};
+
+RingBufferQueueBatchTestCase::RingBufferQueueBatchTestCase ()
+  : TestCase ("Check the batch enqueue and dequeue of the ring buffer queue"),
+    m_dequeued (0)
+{
+}
+
+void
+RingBufferQueueBatchTestCase::Dequeued (Ptr<const Packet> p)
+{
+  m_dequeued++;
+}
+
+void
+RingBufferQueueBatchTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue<Packet> > queue = CreateObject<RingBufferQueue<Packet> > ();
+  queue->SetMaxSize (QueueSize ("1000B"));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&RingBufferQueueBatchTestCase::Dequeued, this));
+
+  std::vector<Ptr<Packet> > batch;
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      batch.push_back (Create<Packet> (100));
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->EnqueueBatch (batch), 10, "The batch should be cut at 1000 bytes");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 20, "The rest of the batch should be dropped");
+
+  std::vector<Ptr<Packet> > out;
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (out, 4), 4, "Wrong number of packets dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (out, 100), 6, "Wrong number of packets dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (out, 100), 0, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (out.size (), 10, "Wrong number of packets dequeued");
+  NS_TEST_EXPECT_MSG_EQ (m_dequeued, 10, "Wrong number of packets traced");
+  for (uint32_t i = 0; i < out.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (out[i], batch[i], "Wrong order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue should be empty");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that a SimpleNetDevice transmits through a ring buffer
+ * queue.
+ */
+class RingBufferQueueDeviceTestCase : public TestCase
+{
+public:
+  RingBufferQueueDeviceTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Receive a packet.
+   * \param dev The receiving device.
+   * \param pkt The received packet.
+   * \param mode The protocol number.
+   * \param sender The sender address.
+   * \return true.
+   */
+  bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+
+  std::vector<uint64_t> m_received; //!< The uids of the received packets.
+};
+
+RingBufferQueueDeviceTestCase::RingBufferQueueDeviceTestCase ()
+  : TestCase ("Check that a SimpleNetDevice transmits through a ring buffer queue")
+{
+}
+
+bool
+RingBufferQueueDeviceTestCase::Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_received.push_back (pkt->GetUid ());
+  return true;
+}
+
+void
+RingBufferQueueDeviceTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper helper;
+  helper.SetQueue ("ns3::RingBufferQueue", "MaxSize", StringValue ("50p"));
+  helper.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("1Mb/s")));
+  NetDeviceContainer devices = helper.Install (nodes);
+
+  PointerValue queue;
+  devices.Get (0)->GetAttribute ("TxQueue", queue);
+  NS_TEST_ASSERT_MSG_NE (queue.Get<RingBufferQueue<Packet> > (), 0, "The device does not use the ring buffer queue");
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&RingBufferQueueDeviceTestCase::Receive, this));
+
+  std::vector<uint64_t> sent;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (500);
+      sent.push_back (p->GetUid ());
+      devices.Get (0)->Send (p, devices.Get (1)->GetAddress (), 0x800);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received.size (), sent.size (), "Wrong number of packets received");
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], sent[i], "Wrong order");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Ring buffer Queue TestSuite
+ */
+class RingBufferQueueTestSuite : public TestSuite
+{
+public:
+  RingBufferQueueTestSuite ()
+    : TestSuite ("ring-buffer-queue", UNIT)
+  {
+    AddTestCase (new RingBufferQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new RingBufferQueueBatchTestCase (), TestCase::QUICK);
+    AddTestCase (new RingBufferQueueDeviceTestCase (), TestCase::QUICK);
+  }
+};
+
+static RingBufferQueueTestSuite g_ringBufferQueueTestSuite; //!< Static variable for test initialization
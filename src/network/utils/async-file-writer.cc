@@ -0,0 +1,324 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/checkpoint.h"
+#include "ns3/log.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+/**
+ * \ingroup network
+ * The thread which writes the batches of all the asynchronous
+ * AsyncFileWriter objects, in the order they were handed over.
+ */
+class AsyncFileWriterThread
+{
+public:
+  /**
+   * Get the writer thread.
+   *
+   * \returns The writer thread, or 0 if it was stopped at exit.
+   */
+  static AsyncFileWriterThread * Get (void);
+  /**
+   * Write the queued batches and stop the thread, before
+   * Checkpoint::Fork.  The next Submit() starts it again.
+   */
+  static void StopBeforeFork (void);
+
+  /**
+   * Queue a batch.
+   *
+   * \param [in] writer The writer of the batch.
+   * \param [in,out] batch The batch, which is left empty.
+   */
+  void Submit (AsyncFileWriter *writer, std::string &batch);
+  /**
+   * Wait for the queued batches of a writer to be written.
+   *
+   * \param [in] writer The writer.
+   */
+  void Wait (AsyncFileWriter *writer);
+
+private:
+  AsyncFileWriterThread ();
+  /** Write the queued batches, and stop the thread. */
+  ~AsyncFileWriterThread ();
+
+  /** Write the queued batches, and stop the thread if it runs. */
+  void Stop (void);
+
+  /** The body of the thread. */
+  void Run (void);
+
+  /** A queued batch. */
+  struct Batch
+  {
+    AsyncFileWriter *writer;  //!< The writer of the batch.
+    std::string data;         //!< The bytes.
+  };
+
+  std::mutex m_mutex;              //!< Protects the members below.
+  std::condition_variable m_work;  //!< Signalled when a batch is queued, or at exit.
+  std::condition_variable m_done;  //!< Signalled when a batch is written.
+  std::deque<Batch> m_queue;       //!< The queued batches.
+  uint64_t m_pendingBytes;         //!< The bytes of the queued batches.
+  bool m_stop;                     //!< Whether the thread must stop when the queue is empty.
+  std::thread m_thread;            //!< The thread, started by the first Submit().
+};
+
+/** Whether the writer thread was stopped at exit. */
+static bool g_writerThreadGone = false;
+
+AsyncFileWriterThread *
+AsyncFileWriterThread::Get (void)
+{
+  static AsyncFileWriterThread thread;
+  return g_writerThreadGone ? 0 : &thread;
+}
+
+void
+AsyncFileWriterThread::StopBeforeFork (void)
+{
+  AsyncFileWriterThread *thread = Get ();
+  if (thread != 0)
+    {
+      thread->Stop ();
+    }
+}
+
+AsyncFileWriterThread::AsyncFileWriterThread ()
+  : m_pendingBytes (0),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+  Checkpoint::AddForkCallback (MakeCallback (&AsyncFileWriterThread::StopBeforeFork));
+}
+
+AsyncFileWriterThread::~AsyncFileWriterThread ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  g_writerThreadGone = true;
+}
+
+void
+AsyncFileWriterThread::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_thread.joinable ())
+    {
+      return;
+    }
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_one ();
+  m_thread.join ();
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_stop = false;
+}
+
+void
+AsyncFileWriterThread::Submit (AsyncFileWriter *writer, std::string &batch)
+{
+  NS_LOG_FUNCTION (this << writer << batch.size ());
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (!m_thread.joinable ())
+    {
+      m_thread = std::thread (&AsyncFileWriterThread::Run, this);
+    }
+  while (m_pendingBytes >= AsyncFileWriter::MaxPendingBytes)
+    {
+      m_done.wait (lock);
+    }
+  m_queue.push_back (Batch ());
+  m_queue.back ().writer = writer;
+  m_queue.back ().data.swap (batch);
+  m_pendingBytes += m_queue.back ().data.size ();
+  writer->m_pending++;
+  lock.unlock ();
+  m_work.notify_one ();
+}
+
+void
+AsyncFileWriterThread::Wait (AsyncFileWriter *writer)
+{
+  NS_LOG_FUNCTION (this << writer);
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (writer->m_pending != 0)
+    {
+      m_done.wait (lock);
+    }
+}
+
+void
+AsyncFileWriterThread::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  for (;;)
+    {
+      while (m_queue.empty () && !m_stop)
+        {
+          m_work.wait (lock);
+        }
+      if (m_queue.empty ())
+        {
+          return;
+        }
+      Batch batch;
+      batch.writer = m_queue.front ().writer;
+      batch.data.swap (m_queue.front ().data);
+      m_queue.pop_front ();
+      lock.unlock ();
+      batch.writer->DoWrite (batch.data.data (), batch.data.size ());
+      lock.lock ();
+      m_pendingBytes -= batch.data.size ();
+      batch.writer->m_pending--;
+      m_done.notify_all ();
+    }
+}
+
+
+AsyncFileWriter::AsyncFileWriter (std::ostream *os)
+  : m_os (os),
+    m_size (0),
+    m_async (false),
+    m_pending (0)
+{
+  NS_LOG_FUNCTION (this << os);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Sync ();
+}
+
+void
+AsyncFileWriter::SetBuffer (uint32_t size, bool async)
+{
+  NS_LOG_FUNCTION (this << size << async);
+  Sync ();
+  m_size = size;
+  m_async = async && size != 0;
+  m_batch.reserve (m_size);
+}
+
+bool
+AsyncFileWriter::IsBuffered (void) const
+{
+  return m_size != 0;
+}
+
+bool
+AsyncFileWriter::IsAsync (void) const
+{
+  return m_async;
+}
+
+void
+AsyncFileWriter::Write (const void *data, uint32_t size)
+{
+  if (m_size == 0)
+    {
+      DoWrite (static_cast<const char *> (data), size);
+      return;
+    }
+  if (m_batch.size () + size > m_size)
+    {
+      Flush ();
+    }
+  m_batch.append (static_cast<const char *> (data), size);
+}
+
+uint8_t *
+AsyncFileWriter::Append (uint32_t size)
+{
+  if (m_size == 0)
+    {
+      return 0;
+    }
+  if (m_batch.size () + size > m_size)
+    {
+      Flush ();
+    }
+  std::string::size_type start = m_batch.size ();
+  m_batch.resize (start + size);
+  return reinterpret_cast<uint8_t *> (&m_batch[start]);
+}
+
+void
+AsyncFileWriter::EndBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+void
+AsyncFileWriter::Sync (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  AsyncFileWriterThread *thread = m_async ? AsyncFileWriterThread::Get () : 0;
+  if (thread != 0)
+    {
+      thread->Wait (this);
+    }
+}
+
+void
+AsyncFileWriter::Flush (void)
+{
+  if (m_batch.empty ())
+    {
+      return;
+    }
+  AsyncFileWriterThread *thread = m_async ? AsyncFileWriterThread::Get () : 0;
+  if (thread != 0)
+    {
+      thread->Submit (this, m_batch);
+      m_batch.reserve (m_size);
+    }
+  else
+    {
+      DoWrite (m_batch.data (), m_batch.size ());
+      m_batch.clear ();
+    }
+}
+
+void
+AsyncFileWriter::DoWrite (const char *data, uint32_t size)
+{
+  m_os->write (data, size);
+}
+
+std::ostream *
+AsyncFileWriter::GetStream (void) const
+{
+  return m_os;
+}
+
+} // namespace ns3
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ * \brief Batched output to a stream, optionally written by a
+ * background thread.
+ *
+ * Trace files are written a record at a time from the simulation
+ * thread, which makes tracing many devices dominated by the cost of
+ * the stream operations.  This class gathers the records in batches
+ * of SetBuffer() bytes, and hands each full batch to DoWrite(), which
+ * writes it to the stream.  In asynchronous mode, the batches are
+ * handed to a writer thread shared by all the writers of the process,
+ * so that the simulation thread only copies the records.
+ *
+ * The batches of a writer are written in order.  The stream must not
+ * be used directly while batches are pending: Sync() writes the
+ * current batch and waits for the writer thread to be done with the
+ * writer.  The writer thread stops accepting batches when the pending
+ * batches of all the writers hold more than \c MaxPendingBytes bytes,
+ * until it catches up.  The writer thread is started by the first
+ * batch, and Checkpoint::Fork stops it once the pending batches are
+ * written, so that each variant starts its own.
+ *
+ * Without a buffer, which is the default, Write() writes to the stream
+ * immediately.
+ */
+class AsyncFileWriter
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] os The stream to write to, which must outlive the writer.
+   */
+  AsyncFileWriter (std::ostream *os);
+  /**
+   * Destructor, which calls Sync().  The subclasses which override
+   * DoWrite() must call Sync() in their own destructor.
+   */
+  virtual ~AsyncFileWriter ();
+
+  /**
+   * Set the size of the batches.
+   *
+   * \param [in] size The size of a batch in bytes, or zero to write
+   *             the records immediately.
+   * \param [in] async Whether the batches are written by the writer
+   *             thread.
+   */
+  void SetBuffer (uint32_t size, bool async);
+  /**
+   * \returns Whether the records are gathered in batches.
+   */
+  bool IsBuffered (void) const;
+  /**
+   * \returns Whether the batches are written by the writer thread.
+   */
+  bool IsAsync (void) const;
+
+  /**
+   * Add bytes to the current batch.
+   *
+   * \param [in] data The bytes.
+   * \param [in] size The number of bytes.
+   */
+  void Write (const void *data, uint32_t size);
+  /**
+   * Add room for bytes to the current batch, to be filled in by the
+   * caller before the next call to the writer.
+   *
+   * \param [in] size The number of bytes.
+   * \returns A pointer to the room, or 0 if the writer is not buffered.
+   */
+  uint8_t * Append (uint32_t size);
+  /**
+   * End the current batch, so that the next bytes start a new one,
+   * and write it or hand it to the writer thread.
+   */
+  void EndBatch (void);
+  /**
+   * Write the current batch, and wait for all the batches of this
+   * writer to be written.
+   */
+  void Sync (void);
+
+  /** The pending bytes of all the writers which stop the writer thread from accepting batches. */
+  static const uint32_t MaxPendingBytes = 256 << 20;
+
+protected:
+  /**
+   * Write a batch to the stream.  In asynchronous mode, this is called
+   * from the writer thread.
+   *
+   * \param [in] data The bytes of the batch.
+   * \param [in] size The number of bytes.
+   */
+  virtual void DoWrite (const char *data, uint32_t size);
+
+  /**
+   * \returns The stream.
+   */
+  std::ostream * GetStream (void) const;
+
+private:
+  friend class AsyncFileWriterThread;
+
+  /** Write the current batch, or hand it to the writer thread. */
+  void Flush (void);
+
+  std::ostream *m_os;    //!< The stream.
+  std::string m_batch;   //!< The current batch.
+  uint32_t m_size;       //!< The size of the batches.
+  bool m_async;          //!< Whether the batches are written by the writer thread.
+  uint32_t m_pending;    //!< The number of batches handed to the writer thread.
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "compressed-trace-file.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CompressedTraceFile");
+
+/** The size of the chunks of compressed bytes read and written. */
+static const uint32_t CHUNK_SIZE = 64 * 1024;
+/** The window bits of deflate and inflate for the gzip format. */
+static const int GZIP_WINDOW_BITS = 15 + 16;
+
+CompressedTraceBuffer::CompressedTraceBuffer (std::string const &filename,
+                                              uint32_t blockSize, bool async)
+  : AsyncFileWriter (&m_file),
+    m_block (blockSize),
+    m_blockStart (0),
+    m_zstream (new z_stream),
+    m_output (CHUNK_SIZE),
+    m_offset (0),
+    m_good (true)
+{
+  NS_LOG_FUNCTION (this << filename << blockSize << async);
+  NS_ASSERT (blockSize > 0);
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  m_index.open ((filename + ".idx").c_str (), std::ios::out);
+  std::memset (m_zstream, 0, sizeof (*m_zstream));
+  if (deflateInit2 (m_zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                    GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      m_good = false;
+    }
+  // The block starts at its first write, which takes its time.
+  setp (m_block.data (), m_block.data ());
+  // A block goes to the writer as its time, followed by its text.
+  SetBuffer (sizeof (m_blockStart) + blockSize, async);
+}
+
+CompressedTraceBuffer::~CompressedTraceBuffer ()
+{
+  NS_LOG_FUNCTION (this);
+  EndBlock (true);
+  Sync ();
+  deflateEnd (m_zstream);
+  delete m_zstream;
+}
+
+bool
+CompressedTraceBuffer::IsGood (void)
+{
+  NS_LOG_FUNCTION (this);
+  Sync ();
+  return m_good && m_file.good () && m_index.good ();
+}
+
+CompressedTraceBuffer::int_type
+CompressedTraceBuffer::overflow (int_type c)
+{
+  if (epptr () == pbase ())
+    {
+      // The first write of a block: its lines are written at or after
+      // this time.
+      m_blockStart = Simulator::Now ().GetNanoSeconds ();
+      setp (m_block.data (), m_block.data () + m_block.size ());
+    }
+  else
+    {
+      EndBlock (false);
+    }
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  return sputc (traits_type::to_char_type (c));
+}
+
+int
+CompressedTraceBuffer::sync (void)
+{
+  return 0;
+}
+
+void
+CompressedTraceBuffer::EndBlock (bool all)
+{
+  NS_LOG_FUNCTION (this << all);
+  uint32_t size = pptr () - pbase ();
+  uint32_t end = size;
+  if (!all)
+    {
+      // Keep the last incomplete line for the next block, unless the
+      // block holds a single line.
+      char *newline = std::find (std::reverse_iterator<char *> (pptr ()),
+                                 std::reverse_iterator<char *> (pbase ()),
+                                 '\n').base ();
+      if (newline != pbase ())
+        {
+          end = newline - pbase ();
+        }
+    }
+  if (end != 0)
+    {
+      Write (&m_blockStart, sizeof (m_blockStart));
+      Write (pbase (), end);
+      EndBatch ();
+    }
+  if (end == size)
+    {
+      // Do not take the time now: the last block is ended by the
+      // destructor, possibly after Simulator::Destroy.
+      setp (m_block.data (), m_block.data ());
+      return;
+    }
+  std::memmove (pbase (), pbase () + end, size - end);
+  setp (m_block.data (), m_block.data () + m_block.size ());
+  pbump (size - end);
+  // The lines written from now on are written at or after this time.
+  m_blockStart = Simulator::Now ().GetNanoSeconds ();
+}
+
+void
+CompressedTraceBuffer::DoWrite (const char *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  int64_t start;
+  std::memcpy (&start, data, sizeof (start));
+  uint64_t offset = m_offset;
+
+  deflateReset (m_zstream);
+  m_zstream->next_in = (Bytef *)(data + sizeof (start));
+  m_zstream->avail_in = size - sizeof (start);
+  int status;
+  do
+    {
+      m_zstream->next_out = (Bytef *)m_output.data ();
+      m_zstream->avail_out = m_output.size ();
+      status = deflate (m_zstream, Z_FINISH);
+      if (status == Z_STREAM_ERROR)
+        {
+          m_good = false;
+          return;
+        }
+      uint32_t written = m_output.size () - m_zstream->avail_out;
+      m_file.write (m_output.data (), written);
+      m_offset += written;
+    }
+  while (status != Z_STREAM_END);
+  m_index << start << " " << offset << "\n";
+}
+
+
+CompressedTraceStream::CompressedTraceStream (std::string const &filename,
+                                              uint32_t blockSize, bool async)
+  : std::ostream (0),
+    m_buffer (filename, blockSize, async)
+{
+  NS_LOG_FUNCTION (this << filename << blockSize << async);
+  rdbuf (&m_buffer);
+  if (!m_buffer.IsGood ())
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+
+CompressedTraceReader::CompressedTraceReader ()
+  : m_zstream (new z_stream),
+    m_input (CHUNK_SIZE),
+    m_pos (0)
+{
+  NS_LOG_FUNCTION (this);
+  std::memset (m_zstream, 0, sizeof (*m_zstream));
+  inflateInit2 (m_zstream, GZIP_WINDOW_BITS);
+}
+
+CompressedTraceReader::~CompressedTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  inflateEnd (m_zstream);
+  delete m_zstream;
+}
+
+bool
+CompressedTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ifstream index ((filename + ".idx").c_str ());
+  if (!m_file.is_open () || !index.is_open ())
+    {
+      return false;
+    }
+  m_blocks.clear ();
+  Block block;
+  while (index >> block.start >> block.offset)
+    {
+      m_blocks.push_back (block);
+    }
+  Seek (TimeStep (0));
+  return true;
+}
+
+Time
+CompressedTraceReader::Seek (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  int64_t ns = time.GetNanoSeconds ();
+  std::vector<Block>::const_iterator i = m_blocks.begin ();
+  while (i != m_blocks.end () && (i + 1) != m_blocks.end () && (i + 1)->start < ns)
+    {
+      ++i;
+    }
+  m_text.clear ();
+  m_pos = 0;
+  inflateReset (m_zstream);
+  m_zstream->avail_in = 0;
+  m_file.clear ();
+  m_file.seekg (i != m_blocks.end () ? i->offset : 0);
+  return NanoSeconds (i != m_blocks.end () ? i->start : 0);
+}
+
+uint32_t
+CompressedTraceReader::GetBlockCount (void) const
+{
+  return m_blocks.size ();
+}
+
+bool
+CompressedTraceReader::Fill (void)
+{
+  char output[CHUNK_SIZE];
+  for (;;)
+    {
+      if (m_zstream->avail_in == 0)
+        {
+          m_file.read (m_input.data (), m_input.size ());
+          std::streamsize read = m_file.gcount ();
+          if (read <= 0)
+            {
+              return false;
+            }
+          m_zstream->next_in = (Bytef *)m_input.data ();
+          m_zstream->avail_in = read;
+        }
+      m_zstream->next_out = (Bytef *)output;
+      m_zstream->avail_out = sizeof (output);
+      int status = inflate (m_zstream, Z_NO_FLUSH);
+      uint32_t produced = sizeof (output) - m_zstream->avail_out;
+      m_text.append (output, produced);
+      if (status == Z_STREAM_END)
+        {
+          // The next block is the next gzip member.
+          inflateReset (m_zstream);
+        }
+      else if (status != Z_OK && status != Z_BUF_ERROR)
+        {
+          NS_LOG_WARN ("Corrupt compressed trace file");
+          return false;
+        }
+      if (produced != 0)
+        {
+          return true;
+        }
+    }
+}
+
+bool
+CompressedTraceReader::GetLine (std::string &line)
+{
+  std::string::size_type newline;
+  while ((newline = m_text.find ('\n', m_pos)) == std::string::npos)
+    {
+      if (m_pos != 0)
+        {
+          m_text.erase (0, m_pos);
+          m_pos = 0;
+        }
+      if (!Fill ())
+        {
+          if (m_text.empty ())
+            {
+              return false;
+            }
+          line.swap (m_text);
+          m_text.clear ();
+          return true;
+        }
+    }
+  line.assign (m_text, m_pos, newline - m_pos);
+  m_pos = newline + 1;
+  return true;
+}
+
+} // namespace ns3
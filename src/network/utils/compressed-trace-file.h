@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPRESSED_TRACE_FILE_H
+#define COMPRESSED_TRACE_FILE_H
+
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "async-file-writer.h"
+
+struct z_stream_s;
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ * \brief The stream buffer of a CompressedTraceStream.
+ *
+ * The text is gathered in blocks of whole lines.  Each block is
+ * compressed as a separate gzip member, so that the file is a valid
+ * gzip file which can be decompressed from the start of any block.
+ * The blocks are compressed and written by AsyncFileWriter, in the
+ * writer thread when the writes are asynchronous.
+ *
+ * For each block, the index file, named after the trace file with an
+ * ".idx" suffix, holds a line with the simulation time in nanoseconds
+ * at which the block starts, and the offset of the block in the trace
+ * file.  The lines of a block were all written at or after that time,
+ * and the lines of the blocks before it at or before that time.
+ */
+class CompressedTraceBuffer : public std::streambuf, private AsyncFileWriter
+{
+public:
+  /**
+   * Create the trace file and its index.
+   *
+   * \param [in] filename The name of the trace file.
+   * \param [in] blockSize The size of the uncompressed blocks.
+   * \param [in] async Whether the blocks are compressed and written
+   *             by the writer thread.
+   */
+  CompressedTraceBuffer (std::string const &filename, uint32_t blockSize, bool async);
+  /** Write the last block, and close the files. */
+  virtual ~CompressedTraceBuffer ();
+
+  /**
+   * \returns Whether the files were opened and written without error,
+   *          after the pending blocks are written.
+   */
+  bool IsGood (void);
+
+protected:
+  /**
+   * Start a new block when the current one is full, or at the first
+   * write of a block.
+   * \param [in] c The character which did not fit.
+   * \returns The character, or EOF on error.
+   */
+  virtual int_type overflow (int_type c);
+  /**
+   * The streams flush after each trace line, which does not end a
+   * block: this does nothing.
+   * \returns 0.
+   */
+  virtual int sync (void);
+
+private:
+  /**
+   * Compress a block, and write it to the trace file and the index.
+   * \param [in] data The time of the block, followed by its text.
+   * \param [in] size The number of bytes.
+   */
+  virtual void DoWrite (const char *data, uint32_t size);
+
+  /**
+   * Hand the complete lines of the current block to the writer, and
+   * move the last incomplete line to the start of the next block.
+   * Without such a line, the next block starts at its first write.
+   * \param [in] all Whether to write the incomplete line too.
+   */
+  void EndBlock (bool all);
+
+  std::ofstream m_file;         //!< The trace file.
+  std::ofstream m_index;        //!< The index file.
+  std::vector<char> m_block;    //!< The text of the current block.
+  int64_t m_blockStart;         //!< The time of the current block, in nanoseconds.
+  struct z_stream_s *m_zstream; //!< The deflate state, used by the writer.
+  std::vector<char> m_output;   //!< The compressed bytes, used by the writer.
+  uint64_t m_offset;            //!< The size of the trace file, used by the writer.
+  bool m_good;                  //!< Whether no compression error occurred.
+};
+
+/**
+ * \ingroup network
+ * \brief An output stream which writes a gzip-compressed trace file,
+ * with an index of the simulation times of its blocks.
+ *
+ * OutputStreamWrapper, and thus AsciiTraceHelper::CreateFileStream,
+ * create one for the file names which end with ".gz".  The text is
+ * compressed and written by the writer thread of AsyncFileWriter, so
+ * that the simulation thread only copies it.  The last block is written
+ * when the stream is destroyed.
+ *
+ * CompressedTraceReader reads the file back from a simulation time.
+ */
+class CompressedTraceStream : public std::ostream
+{
+public:
+  /**
+   * Create the trace file and its index.
+   *
+   * \param [in] filename The name of the trace file.
+   * \param [in] blockSize The size of the uncompressed blocks.
+   * \param [in] async Whether the blocks are compressed and written
+   *             by a background thread.
+   */
+  CompressedTraceStream (std::string const &filename,
+                         uint32_t blockSize = DefaultBlockSize,
+                         bool async = true);
+
+  /** The default size of the uncompressed blocks. */
+  static const uint32_t DefaultBlockSize = 1 << 20;
+
+private:
+  CompressedTraceBuffer m_buffer;  //!< The stream buffer.
+};
+
+/**
+ * \ingroup network
+ * \brief Read the lines of a trace file written by a
+ * CompressedTraceStream, from the start or from a simulation time.
+ */
+class CompressedTraceReader
+{
+public:
+  CompressedTraceReader ();
+  ~CompressedTraceReader ();
+
+  /**
+   * Open a trace file and read its index.
+   *
+   * \param [in] filename The name of the trace file.
+   * \returns Whether the trace file and its index could be read.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * Go to the first block which can hold lines written at or after a
+   * time: the lines before it were all written before that time.
+   *
+   * \param [in] time The simulation time.
+   * \returns The time at which the block starts.
+   */
+  Time Seek (Time time);
+  /**
+   * Read the next line.
+   *
+   * \param [out] line The line, without its end of line.
+   * \returns Whether a line was read, or false at the end of the file.
+   */
+  bool GetLine (std::string &line);
+  /**
+   * \returns The number of blocks of the file.
+   */
+  uint32_t GetBlockCount (void) const;
+
+private:
+  /**
+   * Decompress more text from the trace file.
+   * \returns Whether text was decompressed.
+   */
+  bool Fill (void);
+
+  /** An entry of the index. */
+  struct Block
+  {
+    int64_t start;    //!< The time of the block, in nanoseconds.
+    uint64_t offset;  //!< The offset of the block in the trace file.
+  };
+
+  std::ifstream m_file;          //!< The trace file.
+  std::vector<Block> m_blocks;   //!< The index.
+  struct z_stream_s *m_zstream;  //!< The inflate state.
+  std::vector<char> m_input;     //!< The compressed bytes.
+  std::string m_text;            //!< The decompressed text not read yet.
+  std::string::size_type m_pos;  //!< The position of the next line in m_text.
+};
+
+} // namespace ns3
+
+#endif /* COMPRESSED_TRACE_FILE_H */
@@ -67,12 +67,51 @@ static uint32_t crc32table[256] = {
 0xB3667A2E,0xC4614AB8,0x5D681B02,0x2A6F2B94,0xB40BBE37,0xC30C8EA1,0x5A05DF1B,0x2D02EF8D 
 };
 
+namespace {
+
+/**
+ * Tables of CRC-32 values for slice-by-8: crc32tables[k][i] is the CRC
+ * of byte i followed by k zero bytes, so that eight bytes are handled
+ * with eight independent lookups.
+ */
+struct Crc32Tables
+{
+  Crc32Tables ()
+  {
+    for (uint32_t i = 0; i < 256; i++)
+      {
+        table[0][i] = crc32table[i];
+      }
+    for (uint32_t k = 1; k < 8; k++)
+      {
+        for (uint32_t i = 0; i < 256; i++)
+          {
+            uint32_t crc = table[k - 1][i];
+            table[k][i] = (crc >> 8) ^ crc32table[crc & 0xFF];
+          }
+      }
+  }
+  uint32_t table[8][256]; //!< The tables.
+};
+
+} // unnamed namespace
+
 uint32_t
 CRC32Calculate (const uint8_t *data, int length)
 {
+  static const Crc32Tables tables;
+  const uint32_t (*t)[256] = tables.table;
   uint32_t crc = 0xffffffff;
 
-  while (length--)
+  // The bytes are assembled one by one, whatever the host byte order.
+  for (; length >= 8; data += 8, length -= 8)
+    {
+      uint32_t low = crc ^ (data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t> (data[3]) << 24);
+      uint32_t high = data[4] | data[5] << 8 | data[6] << 16 | static_cast<uint32_t> (data[7]) << 24;
+      crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+        ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+  while (length-- > 0)
     {
       crc = (crc >> 8) ^ crc32table[(crc & 0xFF) ^ *data++];
     }
@@ -80,4 +119,3 @@ CRC32Calculate (const uint8_t *data, int length)
 }
 
 } // namespace ns3
-
@@ -26,6 +26,9 @@ namespace ns3 {
 /**
  * Calculates the CRC-32 for a given input
  *
+ * The input is processed eight bytes at a time, with the slice-by-8
+ * tables.
+ *
  * \param data buffer to calculate the checksum for
  * \param length the length of the buffer (bytes)
  * \returns the computed crc-32.
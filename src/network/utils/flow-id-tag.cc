@@ -19,6 +19,7 @@
  */
 #include "flow-id-tag.h"
 #include "ns3/log.h"
+#include "ns3/simulation-instance.h"
 
 namespace ns3 {
 
@@ -95,10 +96,10 @@ uint32_t
 FlowIdTag::AllocateFlowId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint32_t nextFlowId = 1;
-  uint32_t flowId = nextFlowId;
-  nextFlowId++;
-  return flowId;
+  // The flow ids of each simulation instance start from 1.
+  uint32_t &lastFlowId = *InstanceSingleton<uint32_t, FlowIdTag>::Get ();
+  lastFlowId++;
+  return lastFlowId;
 }
 
 } // namespace ns3
@@ -56,7 +56,7 @@ public:
    */
   uint32_t GetFlowId (void) const;
   /**
-   *  Uses a static variable to generate sequential flow id
+   *  Generates sequential flow ids, from 1 in each SimulationInstance
    *  \returns flow id allocated
    */
   static uint32_t AllocateFlowId (void);
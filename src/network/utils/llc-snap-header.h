@@ -69,6 +69,12 @@ private:
   uint16_t m_etherType; //!< the Ethertype
 };
 
+/**
+ * \brief Every LlcSnapHeader is serialized in 8 bytes.
+ */
+template <>
+struct StaticSerializedSize<LlcSnapHeader> : public std::integral_constant<uint32_t, 8> {};
+
 } // namespace ns3
 
 #endif /* LLC_SNAP_HEADER_H */
@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/simulation-instance.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -137,7 +138,7 @@ Mac64Address
 Mac64Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
+  uint64_t &id = *InstanceSingleton<uint64_t, Mac64Address>::Get ();
   id++;
   Mac64Address address;
   address.m_address[0] = (id >> 56) & 0xff;
@@ -20,6 +20,7 @@
 
 #include "mac8-address.h"
 #include "ns3/address.h"
+#include "ns3/simulation-instance.h"
 
 namespace ns3 {
 
@@ -91,7 +92,7 @@ Mac8Address::GetBroadcast ()
 Mac8Address
 Mac8Address::Allocate ()
 {
-  static uint8_t nextAllocated = 0;
+  uint8_t &nextAllocated = *InstanceSingleton<uint8_t, Mac8Address>::Get ();
 
   uint8_t address = nextAllocated++;
   if (nextAllocated == 255)
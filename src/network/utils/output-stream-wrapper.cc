@@ -21,6 +21,9 @@
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
 #include <fstream>
+#ifdef HAVE_ZLIB
+#include "compressed-trace-file.h"
+#endif
 
 namespace ns3 {
 
@@ -30,6 +33,20 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
   : m_destroyable (true)
 {
   NS_LOG_FUNCTION (this << filename << filemode);
+  std::string::size_type suffix = filename.rfind (".gz");
+  if (suffix != std::string::npos && suffix + 3 == filename.size ())
+    {
+#ifdef HAVE_ZLIB
+      m_ostream = new CompressedTraceStream (filename);
+      FatalImpl::RegisterStream (m_ostream);
+      NS_ABORT_MSG_UNLESS (m_ostream->good (), "AsciiTraceHelper::CreateFileStream():  " <<
+                           "Unable to Open " << filename << " for writing");
+#else
+      NS_FATAL_ERROR ("AsciiTraceHelper::CreateFileStream():  " <<
+                      "Unable to compress " << filename << ": ns-3 was built without zlib");
+#endif
+      return;
+    }
   std::ofstream* os = new std::ofstream ();
   os->open (filename.c_str (), filemode);
   m_ostream = os;
@@ -66,14 +66,18 @@ namespace ns3 {
  *
  * This class uses a basic ns-3 reference counting base class but is not 
  * an ns3::Object with attributes, TypeId, or aggregation.
+ *
+ * The files whose name ends with ".gz" are written compressed, in the
+ * background, by a CompressedTraceStream, if ns-3 was built with zlib.
  */
 class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 {
 public:
   /**
    * Constructor
-   * \param filename file name
-   * \param filemode std::ios::openmode flags
+   * \param filename file name, compressed if it ends with ".gz"
+   * \param filemode std::ios::openmode flags, ignored for compressed
+   *        files which are always created
    */
   OutputStreamWrapper (std::string filename, std::ios::openmode filemode);
   /**
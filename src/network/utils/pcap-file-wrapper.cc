@@ -19,9 +19,12 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
+#include <map>
+#include <mutex>
 
 namespace ns3 {
 
@@ -29,6 +32,22 @@ NS_LOG_COMPONENT_DEFINE ("PcapFileWrapper");
 
 NS_OBJECT_ENSURE_REGISTERED (PcapFileWrapper);
 
+/** The shared pcapng files, by name. */
+typedef std::map<std::string, Ptr<PcapngFile> > PcapngFiles;
+
+/**
+ * \returns The shared pcapng files which are open, and the mutex which
+ *          protects them.
+ */
+static PcapngFiles &
+GetPcapngFiles (std::mutex **mutex)
+{
+  static PcapngFiles files;
+  static std::mutex filesMutex;
+  *mutex = &filesMutex;
+  return files;
+}
+
 TypeId 
 PcapFileWrapper::GetTypeId (void)
 {
@@ -46,12 +65,31 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size in bytes of the batches of records written to the file, "
+                   "or zero to write each record immediately.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsyncWrite",
+                   "Whether the batches of records are written by a background thread.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PcapngFile",
+                   "Name of a pcapng file shared by all the files opened for writing, "
+                   "each of which becomes one of its interfaces, or empty to write "
+                   "separate pcap files.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapFileWrapper::m_pcapngName),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +104,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      return m_pcapng->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -73,6 +115,10 @@ bool
 PcapFileWrapper::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      return m_pcapng->Eof ();
+    }
   return m_file.Eof ();
 }
 void 
@@ -86,6 +132,23 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      //
+      // The last wrapper of a shared pcapng file closes it.
+      //
+      std::mutex *mutex;
+      PcapngFiles &files = GetPcapngFiles (&mutex);
+      std::lock_guard<std::mutex> lock (*mutex);
+      PcapngFiles::iterator i = files.find (m_pcapngName);
+      m_pcapng = 0;
+      if (i != files.end () && i->second->GetReferenceCount () == 1)
+        {
+          i->second->Close ();
+          files.erase (i);
+        }
+      return;
+    }
   m_file.Close ();
 }
 
@@ -93,7 +156,27 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  if (!m_pcapngName.empty () && (mode & std::ios::out) && !(mode & std::ios::in))
+    {
+      std::mutex *mutex;
+      PcapngFiles &files = GetPcapngFiles (&mutex);
+      std::lock_guard<std::mutex> lock (*mutex);
+      Ptr<PcapngFile> &file = files[m_pcapngName];
+      if (file == 0)
+        {
+          file = Create<PcapngFile> ();
+          file->SetWriteBuffer (m_bufferSize, m_asyncWrite);
+          file->Open (m_pcapngName, std::ios::out);
+        }
+      m_pcapng = file;
+      m_interfaceName = filename;
+      return;
+    }
   m_file.Open (filename, mode);
+  if (mode & std::ios::out)
+    {
+      m_file.SetWriteBuffer (m_bufferSize, m_asyncWrite);
+    }
 }
 
 void
@@ -105,6 +188,16 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
+  if (m_pcapng != 0)
+    {
+      //
+      // The timestamps of a pcapng file are in UTC, with nanoseconds.
+      //
+      m_interface = m_pcapng->AddInterface (dataLinkType,
+                                            snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen,
+                                            m_interfaceName);
+      return;
+    }
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -119,7 +212,11 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
-  if (m_file.IsNanoSecMode())
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_interface, t.GetNanoSeconds (), p);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -139,7 +236,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
-  if (m_file.IsNanoSecMode())
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_interface, t.GetNanoSeconds (), header, p);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -159,7 +260,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
-  if (m_file.IsNanoSecMode())
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_interface, t.GetNanoSeconds (), buffer, length);
+    }
+  else if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
       uint64_t s       = current / 1000000000;
@@ -246,6 +351,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      return m_pcapng->GetSnapLen (m_interface);
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -253,6 +362,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      return m_pcapng->GetDataLinkType (m_interface);
+    }
   return m_file.GetDataLinkType ();
 }
 
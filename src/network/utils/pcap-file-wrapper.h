@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -35,6 +36,14 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * The "WriteBufferSize" and "AsyncWrite" attributes batch the records
+ * (see PcapFile::SetWriteBuffer), and the "CaptureSize" attribute
+ * limits the bytes saved of each packet, for instance to its headers.
+ * When the "PcapngFile" attribute is set, the files opened for writing
+ * are not created: each of them becomes an interface of the shared
+ * pcapng file of that name, named after the file it replaces, so that
+ * the traces of all the devices of a simulation go to a single file.
  */
 class PcapFileWrapper : public Object
 {
@@ -224,6 +233,12 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_bufferSize; //!< size of the write batches
+  bool     m_asyncWrite; //!< batches written by a background thread
+  std::string m_pcapngName; //!< name of the shared pcapng file, if any
+  std::string m_interfaceName; //!< name of the interface in the pcapng file
+  Ptr<PcapngFile> m_pcapng; //!< shared pcapng file, when writing to one
+  uint32_t m_interface; //!< index of the interface in the pcapng file
 };
 
 } // namespace ns3
@@ -49,6 +49,7 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_writer (&m_file),
     m_swapMode (false),
     m_nanosecMode (false)
 {
@@ -68,6 +69,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
   return m_file.fail ();
 }
 bool 
@@ -88,9 +90,17 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t size, bool async)
+{
+  NS_LOG_FUNCTION (this << size << async);
+  m_writer.SetBuffer (size, async);
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -204,8 +214,9 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file, after the pending records.
   //
+  m_writer.Sync ();
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -422,11 +433,10 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  m_writer.Write (&header.m_tsSec, sizeof(header.m_tsSec));
+  m_writer.Write (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  m_writer.Write (&header.m_inclLen, sizeof(header.m_inclLen));
+  m_writer.Write (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
@@ -435,8 +445,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  m_writer.Write (data, inclLen);
+  DebugFlush ();
 }
 
 void 
@@ -444,8 +454,16 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  uint8_t *room = m_writer.Append (inclLen);
+  if (room != 0)
+    {
+      p->CopyData (room, inclLen);
+    }
+  else
+    {
+      p->CopyData (&m_file, inclLen);
+    }
+  DebugFlush ();
 }
 
 void 
@@ -460,9 +478,27 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
-  inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  uint8_t *room = m_writer.Append (inclLen);
+  if (room != 0)
+    {
+      headerBuffer.CopyData (room, toCopy);
+      p->CopyData (room + toCopy, inclLen - toCopy);
+    }
+  else
+    {
+      headerBuffer.CopyData (&m_file, toCopy);
+      p->CopyData (&m_file, inclLen - toCopy);
+    }
+}
+
+void
+PcapFile::DebugFlush (void)
+{
+  //
+  // Debug builds flush each record, so that the file is complete if the
+  // simulation crashes.  The batches are flushed when they are written.
+  //
+  NS_BUILD_DEBUG (if (!m_writer.IsBuffered ()) { m_file.flush (); });
 }
 
 void
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "async-file-writer.h"
 
 namespace ns3 {
 
@@ -50,6 +51,8 @@ public:
   ~PcapFile ();
 
   /**
+   * Write the pending records first, so that their failures show.
+   *
    * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
    */
   bool Fail (void) const;
@@ -81,10 +84,25 @@ public:
   void Open (std::string const &filename, std::ios::openmode mode);
 
   /**
-   * Close the underlying file.
+   * Write the pending records and close the underlying file.
    */
   void Close (void);
 
+  /**
+   * Gather the records in batches before writing them.
+   *
+   * Batching replaces the stream operations of each record with a
+   * copy into the current batch.  With \p async, the batches are
+   * written by the writer thread of AsyncFileWriter, so that the
+   * simulation does not wait for the file system.
+   *
+   * \param size The size of a batch in bytes, or zero to write each
+   *        record immediately, which is the default.
+   * \param async Whether the batches are written by a background
+   *        thread.
+   */
+  void SetWriteBuffer (uint32_t size, bool async);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -359,6 +377,12 @@ private:
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
 
+  /**
+   * \brief Flush the stream after a record in debug builds, if the
+   * records are not batched
+   */
+  void DebugFlush (void);
+
   /**
    * \brief Read and verify a Pcap file header
    */
@@ -366,6 +390,7 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  mutable AsyncFileWriter m_writer;  //!< batches the records
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/log.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapngFile");
+
+/** Option code of the end of the options. */
+static const uint16_t OPT_ENDOFOPT = 0;
+/** Option code of the name of an interface. */
+static const uint16_t IF_NAME = 2;
+/** Option code of the timestamp resolution of an interface. */
+static const uint16_t IF_TSRESOL = 9;
+/** Timestamp resolution of the written interfaces: 10^-9 s. */
+static const uint8_t TSRESOL_NANOSECONDS = 9;
+
+/**
+ * \param size A number of bytes.
+ * \returns The number of bytes, rounded up to a multiple of 4.
+ */
+static inline uint32_t
+Pad4 (uint32_t size)
+{
+  return (size + 3) & ~3U;
+}
+
+PcapngFile::PcapngFile ()
+  : m_file (),
+    m_writer (&m_file)
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::RegisterStream (&m_file);
+}
+
+PcapngFile::~PcapngFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+PcapngFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
+  return m_file.fail ();
+}
+
+bool
+PcapngFile::Eof (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.eof ();
+}
+
+void
+PcapngFile::Open (std::string const &filename, std::ios::openmode mode)
+{
+  NS_LOG_FUNCTION (this << filename << mode);
+  NS_ASSERT ((mode & std::ios::app) == 0);
+  NS_ASSERT (!m_file.fail ());
+
+  m_filename = filename;
+  m_interfaces.clear ();
+  m_file.open (filename.c_str (), mode | std::ios::binary);
+  if (mode & std::ios::in)
+    {
+      uint32_t type = ReadU32 ();
+      uint32_t length = ReadU32 ();
+      uint32_t magic = ReadU32 ();
+      if (m_file.fail () || type != SECTION_HEADER_BLOCK
+          || magic != BYTE_ORDER_MAGIC || length < 28)
+        {
+          m_file.setstate (std::ios::failbit);
+          return;
+        }
+      m_file.seekg (length - 12, std::ios::cur);
+    }
+  else
+    {
+      WriteSectionHeader ();
+    }
+}
+
+void
+PcapngFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_writer.Sync ();
+  m_file.close ();
+}
+
+void
+PcapngFile::SetWriteBuffer (uint32_t size, bool async)
+{
+  NS_LOG_FUNCTION (this << size << async);
+  m_writer.SetBuffer (size, async);
+}
+
+void
+PcapngFile::WriteU32 (uint32_t value)
+{
+  m_writer.Write (&value, sizeof (value));
+}
+
+void
+PcapngFile::WriteU16Pair (uint16_t first, uint16_t second)
+{
+  uint16_t values[2] = {first, second};
+  m_writer.Write (values, sizeof (values));
+}
+
+uint32_t
+PcapngFile::ReadU32 (void)
+{
+  uint32_t value = 0;
+  m_file.read ((char *)&value, sizeof (value));
+  return value;
+}
+
+void
+PcapngFile::WriteSectionHeader (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t block[7];
+  block[0] = SECTION_HEADER_BLOCK;
+  block[1] = sizeof (block);
+  block[2] = BYTE_ORDER_MAGIC;
+  uint16_t version[2] = {1, 0};
+  std::memcpy (&block[3], version, sizeof (version));
+  block[4] = 0xffffffff;     // unspecified section length
+  block[5] = 0xffffffff;
+  block[6] = sizeof (block);
+  m_writer.Write (block, sizeof (block));
+}
+
+uint32_t
+PcapngFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  Interface interface;
+  interface.dataLinkType = dataLinkType;
+  interface.snapLen = snapLen;
+  interface.name = name;
+  m_interfaces.push_back (interface);
+
+  uint32_t nameLen = name.size ();
+  uint32_t length = 20 + 8 + 4;
+  if (nameLen != 0)
+    {
+      length += 4 + Pad4 (nameLen);
+    }
+  WriteU32 (INTERFACE_DESCRIPTION_BLOCK);
+  WriteU32 (length);
+  WriteU16Pair (dataLinkType, 0);
+  WriteU32 (snapLen);
+  if (nameLen != 0)
+    {
+      WriteU16Pair (IF_NAME, nameLen);
+      uint8_t padding[3] = {0, 0, 0};
+      m_writer.Write (name.data (), nameLen);
+      m_writer.Write (padding, Pad4 (nameLen) - nameLen);
+    }
+  WriteU16Pair (IF_TSRESOL, 1);
+  uint8_t tsresol[4] = {TSRESOL_NANOSECONDS, 0, 0, 0};
+  m_writer.Write (tsresol, sizeof (tsresol));
+  WriteU16Pair (OPT_ENDOFOPT, 0);
+  WriteU32 (length);
+  return m_interfaces.size () - 1;
+}
+
+uint32_t
+PcapngFile::GetInterfaceCount (void) const
+{
+  return m_interfaces.size ();
+}
+
+uint32_t
+PcapngFile::GetDataLinkType (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].dataLinkType;
+}
+
+uint32_t
+PcapngFile::GetSnapLen (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].snapLen;
+}
+
+std::string
+PcapngFile::GetInterfaceName (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].name;
+}
+
+uint32_t
+PcapngFile::WritePacketHeader (uint32_t interface, uint64_t timestamp,
+                               uint32_t totalLen, uint32_t captureLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << totalLen << captureLen);
+  NS_ASSERT (interface < m_interfaces.size ());
+  uint32_t inclLen = std::min (totalLen, std::min (captureLen, m_interfaces[interface].snapLen));
+  uint32_t header[7];
+  header[0] = ENHANCED_PACKET_BLOCK;
+  header[1] = 32 + Pad4 (inclLen);
+  header[2] = interface;
+  header[3] = timestamp >> 32;
+  header[4] = timestamp & 0xffffffff;
+  header[5] = inclLen;
+  header[6] = totalLen;
+  m_writer.Write (header, sizeof (header));
+  return inclLen;
+}
+
+void
+PcapngFile::WritePacketTrailer (uint32_t inclLen)
+{
+  uint8_t trailer[7] = {0, 0, 0, 0, 0, 0, 0};
+  uint32_t padding = Pad4 (inclLen) - inclLen;
+  uint32_t length = 32 + Pad4 (inclLen);
+  std::memcpy (trailer + padding, &length, sizeof (length));
+  m_writer.Write (trailer, padding + sizeof (length));
+}
+
+void
+PcapngFile::Write (uint32_t interface, uint64_t timestamp, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &data << totalLen);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, totalLen, totalLen);
+  m_writer.Write (data, inclLen);
+  WritePacketTrailer (inclLen);
+}
+
+void
+PcapngFile::Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p, uint32_t captureLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << p << captureLen);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, p->GetSize (), captureLen);
+  uint8_t *room = m_writer.Append (inclLen);
+  if (room != 0)
+    {
+      p->CopyData (room, inclLen);
+    }
+  else
+    {
+      p->CopyData (&m_file, inclLen);
+    }
+  WritePacketTrailer (inclLen);
+}
+
+void
+PcapngFile::Write (uint32_t interface, uint64_t timestamp, const Header &header,
+                   Ptr<const Packet> p, uint32_t captureLen)
+{
+  NS_LOG_FUNCTION (this << interface << timestamp << &header << p << captureLen);
+  std::lock_guard<std::mutex> lock (m_mutex);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen = WritePacketHeader (interface, timestamp, headerSize + p->GetSize (), captureLen);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  uint8_t *room = m_writer.Append (inclLen);
+  if (room != 0)
+    {
+      headerBuffer.CopyData (room, toCopy);
+      p->CopyData (room + toCopy, inclLen - toCopy);
+    }
+  else
+    {
+      headerBuffer.CopyData (&m_file, toCopy);
+      p->CopyData (&m_file, inclLen - toCopy);
+    }
+  WritePacketTrailer (inclLen);
+}
+
+void
+PcapngFile::ReadInterface (std::vector<uint8_t> const &body)
+{
+  NS_LOG_FUNCTION (this);
+  Interface interface;
+  uint16_t linkType;
+  std::memcpy (&linkType, &body[0], 2);
+  std::memcpy (&interface.snapLen, &body[4], 4);
+  interface.dataLinkType = linkType;
+  uint32_t offset = 8;
+  while (offset + 4 <= body.size ())
+    {
+      uint16_t code;
+      uint16_t length;
+      std::memcpy (&code, &body[offset], 2);
+      std::memcpy (&length, &body[offset + 2], 2);
+      offset += 4;
+      if (code == OPT_ENDOFOPT || offset + length > body.size ())
+        {
+          break;
+        }
+      if (code == IF_NAME)
+        {
+          interface.name.assign ((const char *)&body[offset], length);
+        }
+      offset += Pad4 (length);
+    }
+  m_interfaces.push_back (interface);
+}
+
+void
+PcapngFile::Read (uint32_t &interface, uint64_t &timestamp,
+                  std::vector<uint8_t> &data, uint32_t &origLen)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<uint8_t> body;
+  for (;;)
+    {
+      uint32_t type = ReadU32 ();
+      uint32_t length = ReadU32 ();
+      if (m_file.fail () || length < 12)
+        {
+          m_file.setstate (std::ios::failbit);
+          return;
+        }
+      body.resize (length - 12);
+      m_file.read ((char *)body.data (), body.size ());
+      uint32_t trailingLength = ReadU32 ();
+      if (m_file.fail () || trailingLength != length)
+        {
+          m_file.setstate (std::ios::failbit);
+          return;
+        }
+      if (type == INTERFACE_DESCRIPTION_BLOCK && body.size () >= 8)
+        {
+          ReadInterface (body);
+        }
+      else if (type == ENHANCED_PACKET_BLOCK && body.size () >= 20)
+        {
+          uint32_t header[5];
+          std::memcpy (header, body.data (), sizeof (header));
+          if (header[3] > body.size () - 20)
+            {
+              m_file.setstate (std::ios::failbit);
+              return;
+            }
+          interface = header[0];
+          timestamp = (static_cast<uint64_t> (header[1]) << 32) | header[2];
+          data.assign (body.begin () + 20, body.begin () + 20 + header[3]);
+          origLen = header[4];
+          return;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "async-file-writer.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A pcapng file, which holds the packets of several interfaces.
+ *
+ * Whereas a pcap file holds the packets of a single link type, a
+ * pcapng file holds a block describing each interface, with its link
+ * type, snapshot length and name, and the packets of all the
+ * interfaces, each referring to its interface.  The interfaces can be
+ * added at any time, so that the traces of all the devices of a
+ * simulation can go to a single file, instead of a file per device.
+ *
+ * The timestamps are written in nanoseconds.  The blocks are written
+ * in the byte order of the host, which the readers detect from the
+ * section header.  The reader of this class only understands the
+ * files written by this class, in the same byte order.
+ *
+ * Like PcapFile, the records can be written in batches, optionally by
+ * the writer thread of AsyncFileWriter.  Interfaces and packets can be
+ * written from several threads, such as the threads of
+ * MultithreadedSimulatorImpl.
+ */
+class PcapngFile : public SimpleRefCount<PcapngFile>
+{
+public:
+  PcapngFile ();
+  ~PcapngFile ();
+
+  /**
+   * Write the pending records first, so that their failures show.
+   *
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+  /**
+   * \return true if the 'eof' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Eof (void) const;
+
+  /**
+   * Create a new pcapng file and write its section header, or open
+   * an existing one to read it.
+   *
+   * \param filename String containing the name of the file.
+   * \param mode std::ios::out to write the file, or std::ios::in to
+   *        read it.
+   */
+  void Open (std::string const &filename, std::ios::openmode mode);
+  /**
+   * Write the pending records and close the file.
+   */
+  void Close (void);
+
+  /**
+   * Gather the records in batches before writing them.
+   *
+   * \param size The size of a batch in bytes, or zero to write each
+   *        record immediately.
+   * \param async Whether the batches are written by a background
+   *        thread.
+   */
+  void SetWriteBuffer (uint32_t size, bool async);
+
+  /**
+   * Add an interface to the file.
+   *
+   * \param dataLinkType The data link type of the interface (see
+   *        PcapHelper::DataLinkType).
+   * \param snapLen The maximum number of bytes of a packet to save.
+   * \param name The name of the interface.
+   * \returns The index of the interface, to write its packets.
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name);
+  /**
+   * \returns The number of interfaces of the file, which are known so
+   *          far when reading.
+   */
+  uint32_t GetInterfaceCount (void) const;
+  /**
+   * \param interface The index of an interface.
+   * \returns The data link type of the interface.
+   */
+  uint32_t GetDataLinkType (uint32_t interface) const;
+  /**
+   * \param interface The index of an interface.
+   * \returns The snapshot length of the interface.
+   */
+  uint32_t GetSnapLen (uint32_t interface) const;
+  /**
+   * \param interface The index of an interface.
+   * \returns The name of the interface.
+   */
+  std::string GetInterfaceName (uint32_t interface) const;
+
+  /**
+   * Write a packet.
+   *
+   * \param interface The index of the interface.
+   * \param timestamp The time of the packet, in nanoseconds.
+   * \param data The bytes of the packet.
+   * \param totalLen The number of bytes of the packet.
+   */
+  void Write (uint32_t interface, uint64_t timestamp, uint8_t const *data, uint32_t totalLen);
+  /**
+   * Write a packet.
+   *
+   * \param interface The index of the interface.
+   * \param timestamp The time of the packet, in nanoseconds.
+   * \param p The packet.
+   * \param captureLen The maximum number of bytes to save, which is
+   *        further limited by the snapshot length of the interface.
+   */
+  void Write (uint32_t interface, uint64_t timestamp, Ptr<const Packet> p,
+              uint32_t captureLen = 0xffffffff);
+  /**
+   * Write a packet, with an extra header in front of it.
+   *
+   * \param interface The index of the interface.
+   * \param timestamp The time of the packet, in nanoseconds.
+   * \param header The header.
+   * \param p The packet.
+   * \param captureLen The maximum number of bytes to save, which is
+   *        further limited by the snapshot length of the interface.
+   */
+  void Write (uint32_t interface, uint64_t timestamp, const Header &header, Ptr<const Packet> p,
+              uint32_t captureLen = 0xffffffff);
+
+  /**
+   * Read the next packet, and the interfaces described before it.
+   * The fail bit is set at the end of the file.
+   *
+   * \param [out] interface The index of the interface.
+   * \param [out] timestamp The time of the packet, in nanoseconds.
+   * \param [out] data The saved bytes of the packet.
+   * \param [out] origLen The number of bytes of the packet.
+   */
+  void Read (uint32_t &interface, uint64_t &timestamp,
+             std::vector<uint8_t> &data, uint32_t &origLen);
+
+  /** Block type of the section header block. */
+  static const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;
+  /** Block type of the interface description block. */
+  static const uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x00000001;
+  /** Block type of the enhanced packet block. */
+  static const uint32_t ENHANCED_PACKET_BLOCK = 0x00000006;
+  /** Byte-order magic of the section header block. */
+  static const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+
+private:
+  /** The description of an interface. */
+  struct Interface
+  {
+    uint32_t dataLinkType;  //!< The data link type.
+    uint32_t snapLen;       //!< The snapshot length.
+    std::string name;       //!< The name.
+  };
+
+  /**
+   * Write the header of an enhanced packet block.
+   *
+   * \param interface The index of the interface.
+   * \param timestamp The time of the packet, in nanoseconds.
+   * \param totalLen The number of bytes of the packet.
+   * \param captureLen The maximum number of bytes to save.
+   * \returns The number of bytes to save.
+   */
+  uint32_t WritePacketHeader (uint32_t interface, uint64_t timestamp,
+                              uint32_t totalLen, uint32_t captureLen);
+  /**
+   * Write the end of an enhanced packet block.
+   *
+   * \param inclLen The number of saved bytes.
+   */
+  void WritePacketTrailer (uint32_t inclLen);
+  /**
+   * Write a 32-bit value in the byte order of the host.
+   *
+   * \param value The value.
+   */
+  void WriteU32 (uint32_t value);
+  /**
+   * Write two 16-bit values in the byte order of the host.
+   *
+   * \param first The first value.
+   * \param second The second value.
+   */
+  void WriteU16Pair (uint16_t first, uint16_t second);
+  /**
+   * Read a 32-bit value in the byte order of the host.
+   *
+   * \returns The value.
+   */
+  uint32_t ReadU32 (void);
+  /** Write the section header block. */
+  void WriteSectionHeader (void);
+  /**
+   * Parse an interface description block.
+   *
+   * \param body The body of the block.
+   */
+  void ReadInterface (std::vector<uint8_t> const &body);
+
+  std::string m_filename;               //!< File name.
+  std::fstream m_file;                  //!< File stream.
+  mutable AsyncFileWriter m_writer;     //!< Batches the records.
+  std::mutex m_mutex;                   //!< Serializes the writes.
+  std::vector<Interface> m_interfaces;  //!< The interfaces.
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
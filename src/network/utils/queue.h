@@ -34,6 +34,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -290,6 +291,23 @@ public:
    */
   virtual Ptr<const Item> Peek (void) const = 0;
 
+  /**
+   * Place a batch of items into the Queue, in order, as if Enqueue were
+   * called on each of them
+   * \param items the items to enqueue
+   * \return the number of items enqueued; the others have been dropped
+   */
+  virtual uint32_t EnqueueBatch (const std::vector<Ptr<Item> > &items);
+
+  /**
+   * Remove up to n items from the Queue, as if Dequeue were called on
+   * each of them, counting them and tracing them as dequeued
+   * \param [out] items the vector the items are appended to
+   * \param n the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  virtual uint32_t DequeueBatch (std::vector<Ptr<Item> > &items, uint32_t n);
+
   /**
    * Flush the queue by calling Remove() on each item enqueued.  Note that
    * this operation will cause dequeue and drop counts to be incremented and
@@ -409,6 +427,36 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * \brief Check that an item fits in the queue, or drop it
+   *
+   * Subclasses which store the items in their own container, rather than
+   * through DoEnqueue, call this method before storing an item, and
+   * NotifyEnqueued once it is stored.
+   *
+   * \param item the item to enqueue
+   * \return true if the item can be stored, false if it has been dropped.
+   */
+  bool PrepareEnqueue (Ptr<Item> item);
+
+  /**
+   * \brief Count and trace an item stored in the queue
+   * \param item the item enqueued
+   */
+  void NotifyEnqueued (Ptr<Item> item);
+
+  /**
+   * \brief Count and trace an item taken out of the queue
+   * \param item the item dequeued
+   */
+  void NotifyDequeued (Ptr<Item> item);
+
+  /**
+   * \brief Count and trace an item taken out of the queue to be dropped
+   * \param item the item removed
+   */
+  void NotifyRemoved (Ptr<Item> item);
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -504,15 +552,35 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
 {
   NS_LOG_FUNCTION (this << item);
 
+  if (!PrepareEnqueue (item))
+    {
+      return false;
+    }
+
+  ret = m_packets.insert (pos, item);
+
+  NotifyEnqueued (item);
+
+  return true;
+}
+
+template <typename Item>
+bool
+Queue<Item>::PrepareEnqueue (Ptr<Item> item)
+{
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
       DropBeforeEnqueue (item);
       return false;
     }
+  return true;
+}
 
-  ret = m_packets.insert (pos, item);
-
+template <typename Item>
+void
+Queue<Item>::NotifyEnqueued (Ptr<Item> item)
+{
   uint32_t size = item->GetSize ();
   m_nBytes += size;
   m_nTotalReceivedBytes += size;
@@ -522,8 +590,30 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item, Iterator& ret)
 
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
   m_traceEnqueue (item);
+}
 
-  return true;
+template <typename Item>
+void
+Queue<Item>::NotifyDequeued (Ptr<Item> item)
+{
+  NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
+  NS_ASSERT (m_nPackets.Get () > 0);
+
+  m_nBytes -= item->GetSize ();
+  m_nPackets--;
+
+  NS_LOG_LOGIC ("m_traceDequeue (p)");
+  m_traceDequeue (item);
+}
+
+template <typename Item>
+void
+Queue<Item>::NotifyRemoved (Ptr<Item> item)
+{
+  // packets are first dequeued and then dropped
+  NotifyDequeued (item);
+
+  DropAfterDequeue (item);
 }
 
 template <typename Item>
@@ -543,14 +633,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      NotifyDequeued (item);
     }
   return item;
 }
@@ -572,19 +655,44 @@ Queue<Item>::DoRemove (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
+      NotifyRemoved (item);
+    }
+  return item;
+}
 
-      // packets are first dequeued and then dropped
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+template <typename Item>
+uint32_t
+Queue<Item>::EnqueueBatch (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+  uint32_t enqueued = 0;
+  for (typename std::vector<Ptr<Item> >::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      if (Enqueue (*i))
+        {
+          enqueued++;
+        }
+    }
+  return enqueued;
+}
 
-      DropAfterDequeue (item);
+template <typename Item>
+uint32_t
+Queue<Item>::DequeueBatch (std::vector<Ptr<Item> > &items, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  uint32_t dequeued = 0;
+  while (dequeued < n && !IsEmpty ())
+    {
+      Ptr<Item> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+      dequeued++;
     }
-  return item;
+  return dequeued;
 }
 
 template <typename Item>
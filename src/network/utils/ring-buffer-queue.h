@@ -0,0 +1,321 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_QUEUE_H
+#define RING_BUFFER_QUEUE_H
+
+#include "ns3/queue.h"
+#include <algorithm>
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO packet queue that drops tail-end packets on overflow,
+ * and stores its items in a ring buffer
+ *
+ * RingBufferQueue behaves as DropTailQueue, but the items are held in a
+ * contiguous array whose size is a power of two, doubled when it is full,
+ * instead of a list: enqueuing and dequeuing an item neither allocates
+ * nor frees memory once the array has grown to the usual occupancy of
+ * the queue, and the reference held by the queue is transferred to the
+ * caller of Dequeue rather than copied.  EnqueueBatch and DequeueBatch
+ * handle a batch of items in a single call.
+ *
+ * The devices which take a Queue<Packet>, such as PointToPointNetDevice,
+ * CsmaNetDevice and SimpleNetDevice, use it when their helper is told so:
+ *
+ * \code
+ *   PointToPointHelper p2p;
+ *   p2p.SetQueue ("ns3::RingBufferQueue", "MaxSize", StringValue ("1000p"));
+ * \endcode
+ */
+template <typename Item>
+class RingBufferQueue : public Queue<Item>
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief RingBufferQueue Constructor
+   *
+   * Creates a ring buffer queue with a maximum size of 100 packets by default
+   */
+  RingBufferQueue ();
+
+  virtual ~RingBufferQueue ();
+
+  virtual bool Enqueue (Ptr<Item> item);
+  virtual Ptr<Item> Dequeue (void);
+  virtual Ptr<Item> Remove (void);
+  virtual Ptr<const Item> Peek (void) const;
+  virtual uint32_t EnqueueBatch (const std::vector<Ptr<Item> > &items);
+  virtual uint32_t DequeueBatch (std::vector<Ptr<Item> > &items, uint32_t n);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  using Queue<Item>::PrepareEnqueue;
+  using Queue<Item>::NotifyEnqueued;
+  using Queue<Item>::NotifyDequeued;
+  using Queue<Item>::NotifyRemoved;
+
+  /**
+   * Store an item at the tail of the ring
+   * \param item the item to enqueue
+   * \return true if success, false if the item has been dropped.
+   */
+  bool Push (Ptr<Item> item);
+  /**
+   * Take the item at the head of the ring
+   * \return the item, which the ring no longer references.
+   */
+  Ptr<Item> Pop (void);
+  /** Double the size of the ring, keeping the items in order. */
+  void Grow (void);
+  /** Release the items of the ring, without counting nor tracing them. */
+  void Clear (void);
+
+  std::vector<Item *> m_ring;  //!< the items, each holding a reference; the size is a power of two
+  uint32_t m_head;             //!< the index of the first item
+  uint32_t m_count;            //!< the number of items
+
+  NS_LOG_TEMPLATE_DECLARE;     //!< redefinition of the log component
+};
+
+
+/**
+ * Implementation of the templates declared above.
+ */
+
+template <typename Item>
+TypeId
+RingBufferQueue<Item>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (("ns3::RingBufferQueue<" + GetTypeParamName<RingBufferQueue<Item> > () + ">").c_str ())
+    .SetParent<Queue<Item> > ()
+    .SetGroupName ("Network")
+    .template AddConstructor<RingBufferQueue<Item> > ()
+    .AddAttribute ("MaxSize",
+                   "The max queue size",
+                   QueueSizeValue (QueueSize ("100p")),
+                   MakeQueueSizeAccessor (&QueueBase::SetMaxSize,
+                                          &QueueBase::GetMaxSize),
+                   MakeQueueSizeChecker ())
+  ;
+  return tid;
+}
+
+template <typename Item>
+RingBufferQueue<Item>::RingBufferQueue () :
+  Queue<Item> (),
+  m_head (0),
+  m_count (0),
+  NS_LOG_TEMPLATE_DEFINE ("RingBufferQueue")
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <typename Item>
+RingBufferQueue<Item>::~RingBufferQueue ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+template <typename Item>
+bool
+RingBufferQueue<Item>::Push (Ptr<Item> item)
+{
+  if (!PrepareEnqueue (item))
+    {
+      return false;
+    }
+  if (m_count == m_ring.size ())
+    {
+      Grow ();
+    }
+  // The ring holds its own reference, released by Pop or Clear.
+  item->Ref ();
+  m_ring[(m_head + m_count) & (m_ring.size () - 1)] = PeekPointer (item);
+  m_count++;
+  NotifyEnqueued (item);
+  return true;
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Pop (void)
+{
+  NS_ASSERT (m_count > 0);
+  // Take over the reference of the ring.
+  Ptr<Item> item (m_ring[m_head], false);
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & (m_ring.size () - 1);
+  m_count--;
+  return item;
+}
+
+template <typename Item>
+void
+RingBufferQueue<Item>::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Item *> ring (m_ring.empty () ? 16 : 2 * m_ring.size (), 0);
+  for (uint32_t i = 0; i < m_count; i++)
+    {
+      ring[i] = m_ring[(m_head + i) & (m_ring.size () - 1)];
+    }
+  m_ring.swap (ring);
+  m_head = 0;
+}
+
+template <typename Item>
+void
+RingBufferQueue<Item>::Clear (void)
+{
+  while (m_count > 0)
+    {
+      Pop ();
+    }
+  std::vector<Item *> ().swap (m_ring);
+  m_head = 0;
+}
+
+template <typename Item>
+bool
+RingBufferQueue<Item>::Enqueue (Ptr<Item> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  return Push (item);
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Dequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_count == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<Item> item = Pop ();
+  NotifyDequeued (item);
+
+  NS_LOG_LOGIC ("Popped " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Remove (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_count == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<Item> item = Pop ();
+  NotifyRemoved (item);
+
+  NS_LOG_LOGIC ("Removed " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<const Item>
+RingBufferQueue<Item>::Peek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_count == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  return m_ring[m_head];
+}
+
+template <typename Item>
+uint32_t
+RingBufferQueue<Item>::EnqueueBatch (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  uint32_t enqueued = 0;
+  for (typename std::vector<Ptr<Item> >::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      if (Push (*i))
+        {
+          enqueued++;
+        }
+    }
+  return enqueued;
+}
+
+template <typename Item>
+uint32_t
+RingBufferQueue<Item>::DequeueBatch (std::vector<Ptr<Item> > &items, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+
+  uint32_t dequeued = std::min (n, m_count);
+  items.reserve (items.size () + dequeued);
+  for (uint32_t i = 0; i < dequeued; i++)
+    {
+      items.push_back (Pop ());
+      NotifyDequeued (items.back ());
+    }
+  return dequeued;
+}
+
+template <typename Item>
+void
+RingBufferQueue<Item>::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  Queue<Item>::DoDispose ();
+}
+
+// The following explicit template instantiation declarations prevent all the
+// translation units including this header file to implicitly instantiate the
+// RingBufferQueue<Packet> class and the RingBufferQueue<QueueDiscItem> class.
+// The unique instances of these classes are explicitly created through the
+// macros NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingBufferQueue,Packet) and
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingBufferQueue,QueueDiscItem), which are
+// included in ring-buffer-queue.cc
+extern template class RingBufferQueue<Packet>;
+extern template class RingBufferQueue<QueueDiscItem>;
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_QUEUE_H */
@@ -57,6 +57,8 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
                      Ptr<SimpleNetDevice> sender)
 {
   NS_LOG_FUNCTION (this << p << protocol << to << from << sender);
+  // The receivers share a single copy, which they do not modify.
+  Ptr<const Packet> copy = p->Copy ();
   for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
     {
       Ptr<SimpleNetDevice> tmp = *i;
@@ -73,7 +75,7 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
             }
         }
       Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
-                                      &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
+                                      &SimpleNetDevice::Receive, tmp, copy, protocol, to, from);
     }
 }
 
@@ -230,16 +230,22 @@ SimpleNetDevice::SimpleNetDevice ()
 }
 
 void
-SimpleNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol,
+SimpleNetDevice::Receive (Ptr<const Packet> packet, uint16_t protocol,
                           Mac48Address to, Mac48Address from)
 {
   NS_LOG_FUNCTION (this << packet << protocol << to << from);
   NetDevice::PacketType packetType;
 
-  if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt (packet) )
+  if (m_receiveErrorModel)
     {
-      m_phyRxDropTrace (packet);
-      return;
+      // The error model takes a packet it may modify.
+      Ptr<Packet> copy = packet->Copy ();
+      if (m_receiveErrorModel->IsCorrupt (copy))
+        {
+          m_phyRxDropTrace (copy);
+          return;
+        }
+      packet = copy;
     }
 
   if (to == m_address)
@@ -21,6 +21,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -97,9 +98,12 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+  uint32_t context = m_link[wire].m_dst->GetNode ()->GetId ();
+  // a packet handed over to another thread must not share its buffers
+  Ptr<Packet> copy = MultithreadedSimulatorImpl::IsRemote (context) ? p->DeepCopy () : p->Copy ();
+  Simulator::ScheduleWithContext (context,
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
-                                  m_link[wire].m_dst, p->Copy ());
+                                  m_link[wire].m_dst, copy);
 
   // Call the tx anim callback on the net device
   m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
@@ -114,7 +114,8 @@ public:
    * Attach a queue to the PointToPointNetDevice.
    *
    * The PointToPointNetDevice "owns" a queue that implements a queueing 
-   * method such as DropTailQueue or RedQueue
+   * method such as DropTailQueue or RedQueue, or RingBufferQueue, which
+   * avoids an allocation per packet on fast links
    *
    * \param queue Ptr to the new queue.
    */
@@ -105,6 +105,12 @@ private:
   uint16_t m_protocol;
 };
 
+/**
+ * \brief Every PppHeader is serialized in 2 bytes.
+ */
+template <>
+struct StaticSerializedSize<PppHeader> : public std::integral_constant<uint32_t, 2> {};
+
 } // namespace ns3
 
 
@@ -29,6 +29,7 @@
 #include "wifi-spectrum-signal-parameters.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/simulation-instance.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include <algorithm>
@@ -69,10 +70,6 @@ std::ostream & operator << (std::ostream &os, const PhyEntity::PhyFieldRxStatus
  *       Abstract base class for PHY entities
  *******************************************************/
 
-#ifndef _MSC_VER
-uint64_t PhyEntity::m_globalPpduUid = 0;
-#endif
-
 PhyEntity::~PhyEntity ()
 {
   NS_LOG_FUNCTION (this);
@@ -1023,7 +1020,13 @@ uint64_t
 PhyEntity::ObtainNextUid (const WifiTxVector& /* txVector */)
 {
   NS_LOG_FUNCTION (this);
-  return m_globalPpduUid++;
+  return GetGlobalPpduUid ()++;
+}
+
+uint64_t &
+PhyEntity::GetGlobalPpduUid (void)
+{
+  return *InstanceSingleton<uint64_t, PhyEntity>::Get ();
 }
 
 uint16_t
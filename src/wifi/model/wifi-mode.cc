@@ -21,12 +21,16 @@
 
 #include <cmath>
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "wifi-mode.h"
 #include "wifi-tx-vector.h"
 #include "ns3/he-ru.h"
 
 namespace ns3 {
 
+/// The largest number of WifiModes, reserved in the item list of the factory.
+static const uint32_t MAX_WIFI_MODES = 256;
+
 bool operator == (const WifiMode &a, const WifiMode &b)
 {
   return a.GetUid () == b.GetUid ();
@@ -236,6 +240,21 @@ ATTRIBUTE_HELPER_CPP (WifiMode);
 
 WifiModeFactory::WifiModeFactory ()
 {
+  m_itemList.reserve (MAX_WIFI_MODES);
+  uint32_t uid = AllocateUid ("Invalid-WifiMode");
+  WifiModeItem *item = Get (uid);
+  item->uniqueUid = "Invalid-WifiMode";
+  item->modClass = WIFI_MOD_CLASS_UNKNOWN;
+  item->isMandatory = false;
+  item->mcsValue = 0;
+  item->GetCodeRateCallback = MakeNullCallback<WifiCodeRate> ();
+  item->GetConstellationSizeCallback = MakeNullCallback<uint16_t> ();
+  item->GetPhyRateCallback = MakeNullCallback<uint64_t, uint16_t, uint16_t, uint8_t> ();
+  item->GetPhyRateFromTxVectorCallback = MakeNullCallback<uint64_t, const WifiTxVector&, uint16_t> ();
+  item->GetDataRateCallback = MakeNullCallback<uint64_t, uint16_t, uint16_t, uint8_t> ();
+  item->GetDataRateFromTxVectorCallback = MakeNullCallback<uint64_t, const WifiTxVector&, uint16_t> ();
+  item->GetNonHtReferenceRateCallback = MakeNullCallback<uint64_t> ();
+  item->IsModeAllowedCallback = MakeNullCallback<bool, uint16_t, uint8_t> ();
 }
 
 WifiMode
@@ -251,7 +270,14 @@ WifiModeFactory::CreateWifiMode (std::string uniqueName,
                                  ModeAllowedCallback isModeAllowedCallback)
 {
   WifiModeFactory *factory = GetFactory ();
+  std::lock_guard<std::mutex> lock (factory->m_mutex);
+  std::size_t n = factory->m_itemList.size ();
   uint32_t uid = factory->AllocateUid (uniqueName);
+  if (uid < n)
+    {
+      // Created by an earlier call, with the same definition.
+      return WifiMode (uid);
+    }
   WifiModeItem *item = factory->Get (uid);
   item->uniqueUid = uniqueName;
   item->modClass = modClass;
@@ -301,7 +327,14 @@ WifiModeFactory::CreateWifiMcs (std::string uniqueName,
                                 ModeAllowedCallback isModeAllowedCallback)
 {
   WifiModeFactory *factory = GetFactory ();
+  std::lock_guard<std::mutex> lock (factory->m_mutex);
+  std::size_t n = factory->m_itemList.size ();
   uint32_t uid = factory->AllocateUid (uniqueName);
+  if (uid < n)
+    {
+      // Created by an earlier call, with the same definition.
+      return WifiMode (uid);
+    }
   WifiModeItem *item = factory->Get (uid);
   item->uniqueUid = uniqueName;
   item->modClass = modClass;
@@ -325,8 +358,9 @@ WifiModeFactory::CreateWifiMcs (std::string uniqueName,
 }
 
 WifiMode
-WifiModeFactory::Search (std::string name) const
+WifiModeFactory::Search (std::string name)
 {
+  std::lock_guard<std::mutex> lock (m_mutex);
   WifiModeItemList::const_iterator i;
   uint32_t j = 0;
   for (i = m_itemList.begin (); i != m_itemList.end (); i++)
@@ -372,6 +406,7 @@ WifiModeFactory::AllocateUid (std::string uniqueUid)
         }
       j++;
     }
+  NS_ABORT_MSG_IF (m_itemList.size () == MAX_WIFI_MODES, "Too many WifiModes");
   uint32_t uid = static_cast<uint32_t> (m_itemList.size ());
   m_itemList.push_back (WifiModeItem ());
   return uid;
@@ -380,33 +415,15 @@ WifiModeFactory::AllocateUid (std::string uniqueUid)
 WifiModeFactory::WifiModeItem *
 WifiModeFactory::Get (uint32_t uid)
 {
-  NS_ASSERT (uid < m_itemList.size ());
-  return &m_itemList[uid];
+  // Does not read the size of the list, which a new mode may be changing.
+  NS_ASSERT (uid < MAX_WIFI_MODES);
+  return m_itemList.data () + uid;
 }
 
 WifiModeFactory *
 WifiModeFactory::GetFactory (void)
 {
-  static bool isFirstTime = true;
   static WifiModeFactory factory;
-  if (isFirstTime)
-    {
-      uint32_t uid = factory.AllocateUid ("Invalid-WifiMode");
-      WifiModeItem *item = factory.Get (uid);
-      item->uniqueUid = "Invalid-WifiMode";
-      item->modClass = WIFI_MOD_CLASS_UNKNOWN;
-      item->isMandatory = false;
-      item->mcsValue = 0;
-      item->GetCodeRateCallback = MakeNullCallback<WifiCodeRate> ();
-      item->GetConstellationSizeCallback = MakeNullCallback<uint16_t> ();
-      item->GetPhyRateCallback = MakeNullCallback<uint64_t, uint16_t, uint16_t, uint8_t> ();
-      item->GetPhyRateFromTxVectorCallback = MakeNullCallback<uint64_t, const WifiTxVector&, uint16_t> ();
-      item->GetDataRateCallback = MakeNullCallback<uint64_t, uint16_t, uint16_t, uint8_t> ();
-      item->GetDataRateFromTxVectorCallback = MakeNullCallback<uint64_t, const WifiTxVector&, uint16_t> ();
-      item->GetNonHtReferenceRateCallback = MakeNullCallback<uint64_t> ();
-      item->IsModeAllowedCallback = MakeNullCallback<bool, uint16_t, uint8_t> ();
-      isFirstTime = false;
-    }
   return &factory;
 }
 
@@ -25,6 +25,7 @@
 #include "wifi-phy-common.h"
 #include "ns3/attribute-helper.h"
 #include "ns3/callback.h"
+#include <mutex>
 #include <vector>
 
 namespace ns3 {
@@ -453,7 +454,7 @@ private:
    *
    * \return the WifiMode
    */
-  WifiMode Search (std::string name) const;
+  WifiMode Search (std::string name);
   /**
    * Allocate a WifiModeItem from a given uniqueUid.
    *
@@ -475,7 +476,13 @@ private:
    * typedef for a vector of WifiModeItem.
    */
   typedef std::vector<WifiModeItem> WifiModeItemList;
-  WifiModeItemList m_itemList; ///< item list
+  /**
+   * The item list, whose capacity is reserved at construction: as it is
+   * never reallocated and its items never change once created, Get() reads
+   * them without locking while concurrent simulations create new modes.
+   */
+  WifiModeItemList m_itemList;
+  std::mutex m_mutex; ///< protects the creation and the search of the items
 };
 
 } //namespace ns3
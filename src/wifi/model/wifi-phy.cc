@@ -1640,6 +1640,10 @@ WifiPhy::GetMaxPsduSize (WifiModulationClass modulation)
 void
 WifiPhy::NotifyTxBegin (WifiConstPsduMap psdus, double txPowerW)
 {
+  if (m_phyTxBeginTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto const& psdu : psdus)
     {
       for (auto& mpdu : *PeekPointer (psdu.second))
@@ -1652,6 +1656,10 @@ WifiPhy::NotifyTxBegin (WifiConstPsduMap psdus, double txPowerW)
 void
 WifiPhy::NotifyTxEnd (WifiConstPsduMap psdus)
 {
+  if (m_phyTxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto const& psdu : psdus)
     {
       for (auto& mpdu : *PeekPointer (psdu.second))
@@ -1664,6 +1672,10 @@ WifiPhy::NotifyTxEnd (WifiConstPsduMap psdus)
 void
 WifiPhy::NotifyTxDrop (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyTxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyTxDropTrace (mpdu->GetProtocolDataUnit ());
@@ -1673,6 +1685,10 @@ WifiPhy::NotifyTxDrop (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyRxBegin (Ptr<const WifiPsdu> psdu, RxPowerWattPerChannelBand rxPowersW)
 {
+  if (m_phyRxBeginTrace.IsEmpty ())
+    {
+      return;
+    }
   if (psdu)
     {
       for (auto& mpdu : *PeekPointer (psdu))
@@ -1685,6 +1701,10 @@ WifiPhy::NotifyRxBegin (Ptr<const WifiPsdu> psdu, RxPowerWattPerChannelBand rxPo
 void
 WifiPhy::NotifyRxEnd (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyRxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   if (psdu)
     {
       for (auto& mpdu : *PeekPointer (psdu))
@@ -1697,6 +1717,10 @@ WifiPhy::NotifyRxEnd (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyRxDrop (Ptr<const WifiPsdu> psdu, WifiPhyRxfailureReason reason)
 {
+  if (m_phyRxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   if (psdu)
     {
       for (auto& mpdu : *PeekPointer (psdu))
@@ -1710,6 +1734,15 @@ void
 WifiPhy::NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, WifiTxVector txVector,
                                SignalNoiseDbm signalNoise, std::vector<bool> statusPerMpdu, uint16_t staId)
 {
+  if (m_phyMonitorSniffRxTrace.IsEmpty ())
+    {
+      // keep the A-MPDU reference numbers of later sinks unchanged
+      if (psdu->IsAggregate ())
+        {
+          ++m_rxMpduReferenceNumber;
+        }
+      return;
+    }
   MpduInfo aMpdu;
   if (psdu->IsAggregate ())
     {
@@ -1740,6 +1773,15 @@ WifiPhy::NotifyMonitorSniffRx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz
 void
 WifiPhy::NotifyMonitorSniffTx (Ptr<const WifiPsdu> psdu, uint16_t channelFreqMhz, WifiTxVector txVector, uint16_t staId)
 {
+  if (m_phyMonitorSniffTxTrace.IsEmpty ())
+    {
+      // keep the A-MPDU reference numbers of later sinks unchanged
+      if (psdu->IsAggregate ())
+        {
+          ++m_rxMpduReferenceNumber;
+        }
+      return;
+    }
   MpduInfo aMpdu;
   if (psdu->IsAggregate ())
     {
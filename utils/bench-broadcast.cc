@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the delivery of broadcast frames to many
+// receivers: the nodes of a dense ad-hoc Wi-Fi network, of a CSMA
+// segment or of a SimpleChannel take turns broadcasting a frame, which
+// every other node receives.
+// Sample usage:  ./waf --run 'bench-broadcast --channel=wifi --nodes=200'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/string.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/** An EtherType for local experiments, which no protocol handles. */
+static const uint16_t BENCH_PROTOCOL = 0x88b5;
+
+/** The number of frames received by all the nodes. */
+static uint64_t g_received = 0;
+
+/**
+ * Count a received frame.
+ * \param device The receiving device.
+ * \param packet The frame.
+ * \param protocol The protocol number.
+ * \param from The sender address.
+ * \param to The destination address.
+ * \param packetType The packet type.
+ */
+static void
+Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+         const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  g_received++;
+}
+
+/**
+ * Broadcast a frame.
+ * \param device The sending device.
+ * \param size The size of the frame.
+ */
+static void
+Broadcast (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), BENCH_PROTOCOL);
+}
+
+/**
+ * Install the devices of a channel on the nodes.
+ * \param channel The type of channel: simple, csma or wifi.
+ * \param nodes The nodes.
+ * \returns The devices.
+ */
+static NetDeviceContainer
+Install (std::string channel, NodeContainer nodes)
+{
+  if (channel == "simple")
+    {
+      SimpleNetDeviceHelper simple;
+      return simple.Install (nodes);
+    }
+  if (channel == "csma")
+    {
+      CsmaHelper csma;
+      csma.SetChannelAttribute ("DataRate", StringValue ("1Gbps"));
+      return csma.Install (nodes);
+    }
+  if (channel == "wifi")
+    {
+      // All the nodes are within 20 m of each other, and hear every frame.
+      MobilityHelper mobility;
+      mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                     "GridWidth", StringValue ("20"),
+                                     "DeltaX", StringValue ("1.0"),
+                                     "DeltaY", StringValue ("1.0"));
+      mobility.Install (nodes);
+
+      WifiHelper wifi;
+      wifi.SetStandard (WIFI_STANDARD_80211a);
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue ("OfdmRate54Mbps"));
+      YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+      YansWifiPhyHelper phy;
+      phy.SetChannel (wifiChannel.Create ());
+      WifiMacHelper mac;
+      mac.SetType ("ns3::AdhocWifiMac");
+      return wifi.Install (phy, mac, nodes);
+    }
+  std::cerr << "Unknown channel " << channel << std::endl;
+  exit (1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string channel = "wifi";
+  uint32_t nodes = 200;
+  uint32_t frames = 1000;
+  uint32_t size = 500;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("channel", "The type of channel: simple, csma or wifi", channel);
+  cmd.AddValue ("nodes", "The number of nodes", nodes);
+  cmd.AddValue ("frames", "The number of frames broadcast", frames);
+  cmd.AddValue ("size", "The size of the frames", size);
+  cmd.Parse (argc, argv);
+
+  NodeContainer c;
+  c.Create (nodes);
+  NetDeviceContainer devices = Install (channel, c);
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      c.Get (i)->RegisterProtocolHandler (MakeCallback (&Receive), BENCH_PROTOCOL, 0);
+    }
+  // The frames are far enough apart not to collide.
+  for (uint32_t i = 0; i < frames; i++)
+    {
+      Ptr<NetDevice> device = devices.Get (i % nodes);
+      Simulator::ScheduleWithContext (device->GetNode ()->GetId (), MilliSeconds (1 + 2 * i),
+                                      &Broadcast, device, size);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << channel << ": " << frames << " frames to " << nodes - 1 << " receivers, "
+            << g_received << " received in " << ms << " ms";
+  if (ms > 0)
+    {
+      std::cout << " (" << (g_received * 1000 / ms) << " receptions/s)";
+    }
+  std::cout << std::endl;
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the serialization and deserialization of the
+// headers of a UDP packet sent over a point-to-point link, through the
+// Header interface and through the fixed-size path of Packet.
+// Sample usage:  ./waf --run 'bench-headers --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ppp-header.h"
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Add and remove the UDP, IPv4 and PPP headers of a packet.
+ * \tparam VIRTUAL Whether the headers go through the Header interface.
+ * \param n The number of packets.
+ */
+template <bool VIRTUAL>
+static void
+benchUdpIpv4 (uint32_t n)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  Ipv4Header ipv4;
+  ipv4.SetSource (Ipv4Address ("10.1.1.1"));
+  ipv4.SetDestination (Ipv4Address ("10.1.1.2"));
+  ipv4.SetProtocol (17);
+  ipv4.SetPayloadSize (1008);
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      if (VIRTUAL)
+        {
+          p->AddHeader (static_cast<const Header &> (udp));
+          p->AddHeader (ipv4);
+          p->AddHeader (static_cast<const Header &> (ppp));
+          p->RemoveHeader (static_cast<Header &> (ppp));
+          p->RemoveHeader (ipv4);
+          p->RemoveHeader (static_cast<Header &> (udp));
+        }
+      else
+        {
+          p->AddHeader (udp);
+          p->AddHeader (ipv4);
+          p->AddHeader (ppp);
+          p->RemoveHeader (ppp);
+          p->RemoveHeader (ipv4);
+          p->RemoveHeader (udp);
+        }
+    }
+}
+
+/**
+ * Add, peek and remove the UDP and IPv6 headers of a packet.
+ * \tparam VIRTUAL Whether the headers go through the Header interface.
+ * \param n The number of packets.
+ */
+template <bool VIRTUAL>
+static void
+benchUdpIpv6 (uint32_t n)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  Ipv6Header ipv6;
+  ipv6.SetSourceAddress (Ipv6Address ("2001:db8::1"));
+  ipv6.SetDestinationAddress (Ipv6Address ("2001:db8::2"));
+  ipv6.SetNextHeader (17);
+  ipv6.SetPayloadLength (1008);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      if (VIRTUAL)
+        {
+          p->AddHeader (static_cast<const Header &> (udp));
+          p->AddHeader (static_cast<const Header &> (ipv6));
+          p->PeekHeader (static_cast<Header &> (ipv6));
+          p->RemoveHeader (static_cast<Header &> (ipv6));
+          p->RemoveHeader (static_cast<Header &> (udp));
+        }
+      else
+        {
+          p->AddHeader (udp);
+          p->AddHeader (ipv6);
+          p->PeekHeader (ipv6);
+          p->RemoveHeader (ipv6);
+          p->RemoveHeader (udp);
+        }
+    }
+}
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      SystemWallClockMs time;
+      time.Start ();
+      (*bench) (n);
+      minDelay = std::min<uint64_t> (minDelay, time.End ());
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " packets/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+  bool enablePrinting = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the serialization of protocol headers");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.AddValue ("enable-printing", "enable packet printing", enablePrinting);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-headers with n=" << n << std::endl;
+  if (enablePrinting)
+    {
+      Packet::EnablePrinting ();
+    }
+
+  runBench (&benchUdpIpv4<true>, n, minIterations, "UDP/IPv4/PPP, virtual");
+  runBench (&benchUdpIpv4<false>, n, minIterations, "UDP/IPv4/PPP, fixed size");
+  runBench (&benchUdpIpv6<true>, n, minIterations, "UDP/IPv6, virtual");
+  runBench (&benchUdpIpv6<false>, n, minIterations, "UDP/IPv6, fixed size");
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/// The operands of the benchmarks.
+struct Operands
+{
+  std::vector<double> doubles;        //!< Doubles in [0, 1000).
+  std::vector<int64x64_t> values;     //!< Fractional values in [0, 1000).
+  std::vector<int64x64_t> integers;   //!< Integer values in [1, 1000].
+  std::vector<Time> times;            //!< Times in [0, 1) s.
+};
+
+/// The running benchmark, and the sink of its results.
+class Bench
+{
+public:
+  /**
+   * Constructor.
+   * \param operands The operands.
+   * \param loops The number of times each benchmark runs over the operands.
+   */
+  Bench (const Operands &operands, uint32_t loops)
+    : m_operands (operands),
+      m_loops (loops),
+      m_sink (0)
+  {
+    std::cout << std::left << std::setw (28) << "operation" << "ns/op" << std::endl;
+  }
+
+  /**
+   * Run a benchmark and print its time per operation.
+   * \param name The name of the operation.
+   * \param operation The benchmark, which returns a result for each operand.
+   */
+  void Run (std::string name, double (*operation)(const Operands &, std::size_t))
+  {
+    std::size_t n = m_operands.doubles.size ();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    for (uint32_t loop = 0; loop < m_loops; ++loop)
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          {
+            m_sink += operation (m_operands, i);
+          }
+      }
+    double ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+    std::cout << std::left << std::setw (28) << name << ns / (n * m_loops) << std::endl;
+  }
+
+  /**
+   * Get the sum of the results, so that they are not optimized away.
+   * \returns The sum of the results.
+   */
+  double GetSink (void) const
+  {
+    return m_sink;
+  }
+
+private:
+  const Operands &m_operands;  //!< The operands.
+  uint32_t m_loops;            //!< The number of loops over the operands.
+  double m_sink;               //!< The sum of the results.
+};
+
+/* *NS_CHECK_STYLE_OFF* */
+double Int64x64FromDouble (const Operands &o, std::size_t i) { return int64x64_t (o.doubles[i]).GetHigh (); }
+double Int64x64GetDouble (const Operands &o, std::size_t i) { return o.values[i].GetDouble (); }
+double Int64x64Compare (const Operands &o, std::size_t i) { return o.values[i] < o.values[i ^ 1]; }
+double Int64x64Add (const Operands &o, std::size_t i) { return (o.values[i] + o.values[i ^ 1]).GetHigh (); }
+double Int64x64Multiply (const Operands &o, std::size_t i) { return (o.values[i] * o.values[i ^ 1]).GetHigh (); }
+double Int64x64DivideByInteger (const Operands &o, std::size_t i) { return (o.values[i] / o.integers[i]).GetLow (); }
+double Int64x64Divide (const Operands &o, std::size_t i) { return (o.values[i] / o.values[i ^ 1]).GetLow (); }
+double TimeFromSeconds (const Operands &o, std::size_t i) { return Seconds (o.doubles[i]).GetTimeStep (); }
+double TimeGetSeconds (const Operands &o, std::size_t i) { return o.times[i].GetSeconds (); }
+double TimeGetMicroSeconds (const Operands &o, std::size_t i) { return o.times[i].GetMicroSeconds (); }
+double TimeMultiply (const Operands &o, std::size_t i) { return (o.times[i] * o.doubles[i]).GetTimeStep (); }
+double TimeDivide (const Operands &o, std::size_t i) { return (o.times[i] / o.times[i ^ 1]).GetDouble (); }
+double TimeCompare (const Operands &o, std::size_t i) { return o.times[i] < o.times[i ^ 1]; }
+/* *NS_CHECK_STYLE_ON* */
+
+/**
+ * Run the benchmarks.
+ * \param bench The benchmark runner.
+ */
+void
+RunBenchmarks (Bench *bench)
+{
+  bench->Run ("int64x64_t (double)", &Int64x64FromDouble);
+  bench->Run ("int64x64_t::GetDouble", &Int64x64GetDouble);
+  bench->Run ("int64x64_t <", &Int64x64Compare);
+  bench->Run ("int64x64_t +", &Int64x64Add);
+  bench->Run ("int64x64_t *", &Int64x64Multiply);
+  bench->Run ("int64x64_t / integer", &Int64x64DivideByInteger);
+  bench->Run ("int64x64_t /", &Int64x64Divide);
+  bench->Run ("Seconds (double)", &TimeFromSeconds);
+  bench->Run ("Time::GetSeconds", &TimeGetSeconds);
+  bench->Run ("Time::GetMicroSeconds", &TimeGetMicroSeconds);
+  bench->Run ("Time * double", &TimeMultiply);
+  bench->Run ("Time / Time", &TimeDivide);
+  bench->Run ("Time <", &TimeCompare);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t operands = 1024;
+  uint32_t loops = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Measure the int64x64_t and Time operations.\n"
+             "The int64x64_t implementation is chosen when ns-3 is\n"
+             "configured, with --int64x64 (waf) or -DINT64X64 (cmake).");
+  cmd.AddValue ("operands", "number of operands", operands);
+  cmd.AddValue ("loops", "number of loops over the operands", loops);
+  cmd.Parse (argc, argv);
+  // The benchmarks pair operand i with operand i ^ 1.
+  operands += operands % 2;
+
+  const char *implementations[] = {"int128", "cairo", "long double"};
+  std::cout << "int64x64_t implementation: "
+            << implementations[int64x64_t::implementation] << std::endl;
+
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  Operands o;
+  for (uint32_t i = 0; i < operands; ++i)
+    {
+      o.doubles.push_back (uniform->GetValue (0, 1000));
+      o.values.push_back (int64x64_t (uniform->GetValue (0, 1000)));
+      o.integers.push_back (int64x64_t (uniform->GetInteger (1, 1000)));
+      o.times.push_back (NanoSeconds (uniform->GetInteger (1, 1000000000)));
+    }
+
+  // The Time constructors are faster after Simulator::Run, which stops
+  // marking the Time objects for a change of resolution.
+  Bench bench (o, loops);
+  Simulator::Schedule (Seconds (0), &RunBenchmarks, &bench);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  std::cout << "(sum " << bench.GetSink () << ")" << std::endl;
+  return 0;
+}
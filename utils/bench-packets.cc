@@ -26,12 +26,15 @@
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-memory-pool.h"
+#include "ns3/traced-callback.h"
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <stdlib.h> // for exit ()
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -310,6 +313,60 @@ benchFragment (uint32_t n)
   }
 }
 
+/// The payload of the benchmarks which need bytes, not a zero area, in their packets.
+static uint8_t g_payload[8000];
+
+static void
+benchReassembly (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (g_payload, sizeof (g_payload));
+    p->AddHeader (udp);
+
+    /* Fragment as IPv4 does, then reassemble */
+    Ptr<Packet> fragments[6];
+    for (uint32_t j = 0; j < 6; j++)
+      {
+        uint32_t size = std::min<uint32_t> (1480, p->GetSize () - j * 1480);
+        fragments[j] = p->CreateFragment (j * 1480, size);
+        fragments[j]->AddHeader (ipv4);
+      }
+    Ptr<Packet> reassembled = Create<Packet> ();
+    for (uint32_t j = 0; j < 6; j++)
+      {
+        fragments[j]->RemoveHeader (ipv4);
+        reassembled->AddAtEnd (fragments[j]);
+      }
+    reassembled->RemoveHeader (udp);
+  }
+}
+
+static void
+benchAggregation (uint32_t n)
+{
+  BenchHeader<14> subframe;
+  Ptr<Packet> msdu = Create<Packet> (g_payload, 1500);
+
+  for (uint32_t i = 0; i < n; i++) {
+    /* Aggregate as an A-MSDU, then deaggregate */
+    Ptr<Packet> amsdu = Create<Packet> ();
+    for (uint32_t j = 0; j < 8; j++)
+      {
+        Ptr<Packet> p = msdu->Copy ();
+        p->AddHeader (subframe);
+        amsdu->AddAtEnd (p);
+      }
+    for (uint32_t j = 0; j < 8; j++)
+      {
+        Ptr<Packet> p = amsdu->CreateFragment (j * 1514, 1514);
+        p->RemoveHeader (subframe);
+      }
+  }
+}
+
 static void
 benchByteTags (uint32_t n)
 {
@@ -328,6 +385,123 @@ benchByteTags (uint32_t n)
     }
 }
 
+/// Trace with the signature of WifiPhy PhyTxBegin
+static TracedCallback<Ptr<const Packet>, double> g_phyTxBeginTrace;
+/// Trace with the signature of EpcEnbApplication RxFromS1u
+static TracedCallback<Ptr<Packet> > g_rxS1uSocketPktTrace;
+
+/**
+ * Trace sink which counts the traced packets.
+ * \param p The packet.
+ * \param txPowerW The transmission power.
+ */
+static void
+PhyTxBeginSink (Ptr<const Packet> p, double txPowerW)
+{
+  static uint32_t count = 0;
+  count++;
+}
+
+/**
+ * Trace sink which counts the traced packets.
+ * \param p The packet.
+ */
+static void
+RxS1uSocketPktSink (Ptr<Packet> p)
+{
+  static uint32_t count = 0;
+  count++;
+}
+
+/**
+ * Trace every MPDU sent by a PHY the way WifiPhy::NotifyTxBegin does:
+ * the traced packet is a copy of the MPDU with its MAC header.
+ * \tparam GUARD Whether the call is guarded by TracedCallback::IsEmpty.
+ * \param n The number of packets.
+ */
+template <bool GUARD>
+static void
+benchTraceWifi (uint32_t n)
+{
+  BenchHeader<26> macHeader;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1500);
+      if (!GUARD || !g_phyTxBeginTrace.IsEmpty ())
+        {
+          Ptr<Packet> mpdu = p->Copy ();
+          mpdu->AddHeader (macHeader);
+          g_phyTxBeginTrace (mpdu, 0.1);
+        }
+    }
+}
+
+/**
+ * Trace every packet forwarded by an eNB the way
+ * EpcEnbApplication::RecvFromS1uSocket does.
+ * \tparam GUARD Whether the call is guarded by TracedCallback::IsEmpty.
+ * \param n The number of packets.
+ */
+template <bool GUARD>
+static void
+benchTraceLte (uint32_t n)
+{
+  BenchHeader<8> gtpu;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1500);
+      p->AddHeader (gtpu);
+      p->RemoveHeader (gtpu);
+      if (!GUARD || !g_rxS1uSocketPktTrace.IsEmpty ())
+        {
+          g_rxS1uSocketPktTrace (p->Copy ());
+        }
+    }
+}
+
+/**
+ * Print the memory taken by the metadata and tags of packets in flight,
+ * each with UDP, IPv4 and Ethernet headers, a packet tag and a byte tag.
+ * \param n The number of packets.
+ * \param metadata Whether the packet metadata is enabled.
+ */
+static void
+reportPacketMemory (uint32_t n, bool metadata)
+{
+  BenchHeader<14> ethernet;
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  BenchTag<16> packetTag;
+  BenchTag<8> byteTag;
+
+  // The second round measures packets sized after the first ones.
+  std::vector<Ptr<Packet> > inFlight;
+  inFlight.reserve (n);
+  uint64_t bytesInUse = 0;
+  for (uint32_t i = 0; i < 2 * n; i++)
+    {
+      if (i == n)
+        {
+          inFlight.clear ();
+          bytesInUse = PacketMemoryPool::GetStatistics ().bytesInUse;
+        }
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddByteTag (byteTag);
+      p->AddHeader (udp);
+      p->AddHeader (ipv4);
+      p->AddPacketTag (packetTag);
+      p->AddHeader (ethernet);
+      inFlight.push_back (p);
+    }
+  double perPacket = PacketMemoryPool::GetStatistics ().bytesInUse - bytesInUse;
+  perPacket /= n;
+  std::cout << perPacket << " bytes/packet of metadata and tags"
+            << (metadata ? ", with" : ", without")
+            << " packet metadata" << std::endl;
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -378,13 +552,35 @@ int main (int argc, char *argv[])
     }
   std::cout << "Running bench-packets with n=" << n << std::endl;
   std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
+  if (enablePrinting)
+    {
+      Packet::EnablePrinting ();
+    }
+
+  reportPacketMemory (n, enablePrinting);
 
   runBench (&benchA, n, minIterations, "Copy packet, remove headers");
   runBench (&benchB, n, minIterations, "Just add headers");
   runBench (&benchC, n, minIterations, "Remove by func call");
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
+  runBench (&benchReassembly, n, minIterations, "IPv4 fragmentation and reassembly");
+  runBench (&benchAggregation, n, minIterations, "A-MSDU aggregation and deaggregation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
 
+  runBench (&benchTraceWifi<false>, n, minIterations, "Wifi PHY trace, no sink");
+  runBench (&benchTraceWifi<true>, n, minIterations, "Wifi PHY trace, no sink, guarded");
+  runBench (&benchTraceLte<false>, n, minIterations, "LTE EPC trace, no sink");
+  runBench (&benchTraceLte<true>, n, minIterations, "LTE EPC trace, no sink, guarded");
+  g_phyTxBeginTrace.ConnectWithoutContext (MakeCallback (&PhyTxBeginSink));
+  g_rxS1uSocketPktTrace.ConnectWithoutContext (MakeCallback (&RxS1uSocketPktSink));
+  runBench (&benchTraceWifi<true>, n, minIterations, "Wifi PHY trace, one sink");
+  runBench (&benchTraceLte<true>, n, minIterations, "LTE EPC trace, one sink");
+
+  Packet::EnableScatterGather ();
+  runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation, scatter-gather");
+  runBench (&benchReassembly, n, minIterations, "IPv4 fragmentation and reassembly, scatter-gather");
+  runBench (&benchAggregation, n, minIterations, "A-MSDU aggregation and deaggregation, scatter-gather");
+
   return 0;
 }
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/// Count the events scheduled by the producer threads.
+class Sink
+{
+public:
+  /**
+   * Constructor.
+   * \param total The number of events to receive.
+   */
+  Sink (uint64_t total)
+    : m_total (total),
+      m_count (0)
+  {}
+
+  /**
+   * Receive an event from a producer, and stop the simulation after the last one.
+   * \param producer The producer.
+   */
+  void Receive (uint32_t producer)
+  {
+    if (++m_count == m_total)
+      {
+        Simulator::Stop ();
+      }
+  }
+
+  /**
+   * Keep the event queue of a DefaultSimulatorImpl busy until the last event.
+   */
+  void Poll (void)
+  {
+    if (m_count < m_total)
+      {
+        Simulator::Schedule (MicroSeconds (1), &Sink::Poll, this);
+      }
+  }
+
+private:
+  uint64_t m_total;  //!< The number of events to receive.
+  uint64_t m_count;  //!< The number of events received.
+};
+
+/**
+ * Schedule events from a thread, like the reader thread of an FdNetDevice.
+ * \param sink The sink of the events.
+ * \param producer The producer, also the context of its events.
+ * \param events The number of events.
+ */
+void
+Produce (Sink *sink, uint32_t producer, uint64_t events)
+{
+  for (uint64_t i = 0; i < events; ++i)
+    {
+      Simulator::ScheduleWithContext (producer, Time (0), &Sink::Receive, sink, producer);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t producers = 4;
+  uint64_t events = 250000;
+  bool realtime = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Measure the rate of the events scheduled with\n"
+             "Simulator::ScheduleWithContext by several threads.");
+  cmd.AddValue ("producers", "number of producer threads", producers);
+  cmd.AddValue ("events", "number of events per producer", events);
+  cmd.AddValue ("realtime", "use the RealtimeSimulatorImpl", realtime);
+  cmd.Parse (argc, argv);
+
+  if (realtime)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+    }
+
+  // The simulator is created before the producers use it.
+  Simulator::GetImplementation ();
+  Sink sink (producers * events);
+  if (!realtime)
+    {
+      Simulator::Schedule (Seconds (0), &Sink::Poll, &sink);
+    }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      threads.push_back (std::thread (&Produce, &sink, i, events));
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < producers; ++i)
+    {
+      threads[i].join ();
+    }
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  Simulator::Destroy ();
+
+  std::cout << (realtime ? "realtime" : "default")
+            << " producers " << producers
+            << " events " << producers * events
+            << " seconds " << seconds
+            << " events/s " << producers * events / seconds
+            << std::endl;
+  return 0;
+}
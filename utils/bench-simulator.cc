@@ -146,17 +146,48 @@ Bench::Cb (void)
 
 
 Ptr<RandomVariableStream>
-GetRandomStream (std::string filename)
+GetRandomStream (std::string filename, std::string model)
 {
   Ptr<RandomVariableStream> stream = 0;
 
-  if (filename == "")
+  if (filename == "" && model == "hold")
     {
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
       erv->SetAttribute ("Mean", DoubleValue (100));
       stream = erv;
     }
+  else if (filename == "" && model == "same")
+    {
+      LOGME ("using constant 100 ns intervals (same time stamps)");
+      Ptr<ConstantRandomVariable> crv = CreateObject<ConstantRandomVariable> ();
+      crv->SetAttribute ("Constant", DoubleValue (100));
+      stream = crv;
+    }
+  else if (filename == "" && model == "bursty")
+    {
+      LOGME ("using bursty distribution: 90% mean 10 ns, 10% mean 10 us");
+      // Precompute the intervals, so drawing from the mixture
+      // does not weigh on the scheduler timings
+      Ptr<UniformRandomVariable> coin = CreateObject<UniformRandomVariable> ();
+      Ptr<ExponentialRandomVariable> shortGap = CreateObject<ExponentialRandomVariable> ();
+      shortGap->SetAttribute ("Mean", DoubleValue (10));
+      Ptr<ExponentialRandomVariable> longGap = CreateObject<ExponentialRandomVariable> ();
+      longGap->SetAttribute ("Mean", DoubleValue (10000));
+
+      std::vector<double> nsValues (1000000);
+      for (std::vector<double>::iterator i = nsValues.begin (); i != nsValues.end (); ++i)
+        {
+          *i = (uint64_t)((coin->GetValue () < 0.9) ? shortGap->GetValue () : longGap->GetValue ());
+        }
+      Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
+      drv->SetValueArray (&nsValues[0], nsValues.size ());
+      stream = drv;
+    }
+  else if (filename == "")
+    {
+      NS_FATAL_ERROR ("unknown workload model \"" << model << "\"");
+    }
   else
     {
       std::istream *input;
@@ -199,27 +230,89 @@ GetRandomStream (std::string filename)
 }
 
 
+/**
+ * Benchmark one scheduler.
+ * \param factory the scheduler factory
+ * \param order description of the scheduler variant
+ * \param bench the benchmark
+ * \param pop the event population size
+ * \param total the total number of events
+ * \param runs the number of runs
+ */
+void
+RunScheduler (ObjectFactory factory, std::string order, Bench *bench,
+              uint32_t pop, uint32_t total, uint32_t runs)
+{
+  Simulator::SetScheduler (factory);
+
+  LOGME ("scheduler: " << factory.GetTypeId ().GetName () << order);
+
+  // table header
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+       std::left << std::setw (3 * g_fwidth) << "Initialization:" <<
+       std::left << std::setw (3 * g_fwidth) << "Simulation:");
+  LOG (std::left << std::setw (g_fwidth) << "" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
+  LOG (std::setfill ('-') <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::setfill (' ')
+       );
+
+  // prime
+  DEB ("priming");
+  std::cout << std::left << std::setw (g_fwidth) << "(prime)";
+  bench->RunBench ();
+
+  bench->SetPopulation (pop);
+  bench->SetTotal (total);
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      std::cout << std::setw (g_fwidth) << i;
+
+      bench->RunBench ();
+    }
+
+  LOG ("");
+}
+
 
 int main (int argc, char *argv[])
 {
 
   bool schedCal           = false;
   bool schedHeap          = false;
+  bool schedLadder        = false;
   bool schedList          = false;
   bool schedMap           = true;
   bool schedPriorityQueue = false;
+  bool schedAll           = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
   uint32_t runs  =       1;
   std::string filename = "";
+  std::string model = "hold";
   bool calRev = false;
 
   CommandLine cmd (__FILE__);
   cmd.Usage ("Benchmark the simulator scheduler.\n"
              "\n"
              "Event intervals are taken from one of:\n"
-             "  an exponential distribution, with mean 100 ns,\n"
+             "  an exponential distribution, with mean 100 ns (--model=hold),\n"
+             "  a mixture of exponentials with means 10 ns and 10 us (--model=bursty),\n"
+             "  a constant 100 ns, so events share time stamps (--model=same),\n"
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
@@ -227,9 +320,12 @@ int main (int argc, char *argv[])
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("calrev", "reverse ordering in the CalendarScheduler", calRev);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPriorityQueue);
+  cmd.AddValue ("all",   "benchmark all schedulers in turn", schedAll);
+  cmd.AddValue ("model", "event interval model: hold, bursty or same", model);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
@@ -250,6 +346,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::HeapScheduler");
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
   if (schedList)
     {
       factory.SetTypeId ("ns3::ListScheduler");
@@ -258,8 +358,6 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::PriorityQueueScheduler");
     }
-      
-  Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
   DEB ("debugging is ON");
@@ -269,52 +367,37 @@ int main (int argc, char *argv[])
     {
       order = ": insertion order: " + std::string (calRev ? "reverse" : "normal");
     }
-  LOGME ("scheduler: " << factory.GetTypeId ().GetName () << order);
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
 
   Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetRandomStream (GetRandomStream (filename, model));
 
-  // table header
-  LOG ("");
-  LOG (std::left << std::setw (g_fwidth) << "Run #" <<
-       std::left << std::setw (3 * g_fwidth) << "Initialization:" <<
-       std::left << std::setw (3 * g_fwidth) << "Simulation:");
-  LOG (std::left << std::setw (g_fwidth) << "" <<
-       std::left << std::setw (g_fwidth) << "Time (s)" <<
-       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
-       std::left << std::setw (g_fwidth) << "Time (s)" <<
-       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
-  LOG (std::setfill ('-') <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::right << std::setw (g_fwidth) << " " <<
-       std::setfill (' ')
-       );
-
-  // prime
-  DEB ("priming");
-  std::cout << std::left << std::setw (g_fwidth) << "(prime)";
-  bench->RunBench ();
-
-  bench->SetPopulation (pop);
-  bench->SetTotal (total);
-  for (uint32_t i = 0; i < runs; i++)
+  if (schedAll)
     {
-      std::cout << std::setw (g_fwidth) << i;
-
-      bench->RunBench ();
+      // The ListScheduler is left out: it is linear in the population.
+      const char *types[] = { "ns3::CalendarScheduler",
+                              "ns3::HeapScheduler",
+                              "ns3::LadderScheduler",
+                              "ns3::MapScheduler",
+                              "ns3::PriorityQueueScheduler" };
+      for (uint32_t i = 0; i < sizeof (types) / sizeof (types[0]); ++i)
+        {
+          ObjectFactory each (types[i]);
+          RunScheduler (each, "", bench, pop, total, runs);
+        }
+    }
+  else
+    {
+      RunScheduler (factory, order, bench, pop, total, runs);
     }
 
-  LOG ("");
+  EventMemoryPool::Statistics pool = EventMemoryPool::GetStatistics ();
+  LOGME ("event pool: " << pool.allocations << " allocations, " <<
+         pool.recycled << " recycled, " <<
+         pool.heapAllocations << " from the heap");
+
   Simulator::Destroy ();
   delete bench;
   return 0;
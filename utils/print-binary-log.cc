@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string filename = "";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Print a binary log, written while the NS_BINARY_LOG\n"
+             "environment variable or BinaryLog::Open named it,\n"
+             "as the NS_LOG statements would have printed it.");
+  cmd.AddNonOption ("file", "the binary log", filename);
+  cmd.Parse (argc, argv);
+
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  if (!is)
+    {
+      std::cerr << cmd.GetName () << ": could not open " << filename << std::endl;
+      return 1;
+    }
+  if (!BinaryLog::Decode (is, std::cout))
+    {
+      std::cerr << cmd.GetName () << ": " << filename
+                << " is not a binary log, or is truncated" << std::endl;
+      return 1;
+    }
+  return 0;
+}